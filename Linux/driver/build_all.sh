@@ -11,6 +11,7 @@ build_help() {
     echo "-h, --help        help"
     echo "-p, --platform    platform supported:"
     echo "                      x86-linux"
+    echo "                      loopback-linux"
     echo "                      juno-linux-4.9"
     echo "                      hybrid-linux-4.9"
     echo "                      440-linux-4.14"
@@ -67,7 +68,7 @@ do
     shift
 done
 
-if [ $PLATFORM != "x86-linux" ]; then
+if [ $PLATFORM != "x86-linux" ] && [ $PLATFORM != "loopback-linux" ]; then
 cd kmd
 ./build.sh -p $PLATFORM $DBG_ARGS -k $KDIR $TDIR_OPT $VER_OPT
 BUILD_KMD_FAIL=$?
@@ -140,6 +140,10 @@ int init_aipu_priv(struct aipu_priv *aipu, struct device *dev)
         aipu->soc = NULL;
         aipu->misc = NULL;
         aipu->is_suspend = 0;
+        aipu->debugfs_root = NULL;
+        aipu->debugfs_sessions = NULL;
+        aipu_latency_init(&aipu->lat_stats);
+        aipu_init_perf_sampler(&aipu->sampler);
 
         /* init memory manager */
         ret = aipu_init_mm(&aipu->mm, dev, aipu->version);
@@ -157,6 +161,18 @@ int init_aipu_priv(struct aipu_priv *aipu, struct device *dev)
                 goto err_handle;
 #endif
 
+#ifdef AIPU_ENABLE_DEBUGFS
+        ret = aipu_create_debugfs(aipu);
+        if (ret)
+                goto err_handle;
+#endif
+
+#ifdef AIPU_ENABLE_PMU
+        ret = aipu_create_pmu(aipu);
+        if (ret)
+                goto err_handle;
+#endif
+
         goto finish;
 
 err_handle:
@@ -277,6 +293,12 @@ void aipu_priv_stop_bw_profiling(struct aipu_priv *aipu)
 
 void aipu_priv_read_profiling_reg(struct aipu_priv *aipu, struct profiling_data *pdata)
 {
+        /* SoC hooks fill the counters they have and set the corresponding valid_mask bits */
+        if (pdata) {
+                pdata->version = AIPU_PROFILING_DATA_VERSION;
+                pdata->valid_mask = 0;
+        }
+
         if (aipu)
                 aipu->soc_ctrl->read_profiling_reg(aipu->soc, pdata);
 }
@@ -325,10 +347,19 @@ int deinit_aipu_priv(struct aipu_priv *aipu)
         if (!aipu)
                 return 0;
 
+#ifdef AIPU_ENABLE_PMU
+        aipu_destroy_pmu(aipu);
+#endif
+        aipu_deinit_perf_sampler(&aipu->sampler);
+
 #ifdef AIPU_ENABLE_SYSFS
         aipu_destroy_sysfs(aipu);
 #endif
 
+#ifdef AIPU_ENABLE_DEBUGFS
+        aipu_destroy_debugfs(aipu);
+#endif
+
         aipu_deinit_mm(&aipu->mm);
         if (aipu->misc)
                 deinit_misc_dev(aipu);
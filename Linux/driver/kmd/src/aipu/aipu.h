@@ -35,6 +35,10 @@
 #include "aipu_job_manager.h"
 #include "aipu_mm.h"
 #include "aipu_sysfs.h"
+#include "aipu_latency.h"
+#include "aipu_debugfs.h"
+#include "aipu_perf_sampler.h"
+#include "aipu_pmu.h"
 
 struct aipu_priv {
         int board;
@@ -53,6 +57,13 @@ struct aipu_priv {
         struct aipu_memory_manager mm;
         int is_suspend;
         int is_reset;
+        struct aipu_latency_stats lat_stats;
+        struct aipu_perf_sampler sampler;
+#ifdef AIPU_ENABLE_PMU
+        struct aipu_pmu pmu;
+#endif
+        struct dentry *debugfs_root;
+        struct dentry *debugfs_sessions;
 };
 
 /**
@@ -51,7 +51,7 @@ struct aipu_soc {
  *
  * @start_bw_profiling: Start bandwidth profiling
  * @stop_bw_profiling: Stop bandwidth profiling
- * @read_profiling_reg: read profiling register values
+ * @read_profiling_reg: read profiling register values and set valid_mask of the groups read
  * @logic_reset: trigger AIPU to run a job
  * @logic_release: Is AIPU hardware idle or not
  * @enable_clk_gating: Read status register value
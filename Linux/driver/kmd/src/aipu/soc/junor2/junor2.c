@@ -41,6 +41,8 @@ static void junor2_stop_bw_profiling(struct aipu_soc *soc)
 
 static void junor2_read_profiling_reg(struct aipu_soc *soc, struct profiling_data *pdata)
 {
+        int id = 0;
+
         if ((soc) && (pdata)) {
                 pdata->rdata_tot_msb = aipu_read32(soc->base0, JUNOR2_ALL_RDATA_TOT_MSB);
                 pdata->rdata_tot_lsb = aipu_read32(soc->base0, JUNOR2_ALL_RDATA_TOT_LSB);
@@ -48,6 +50,29 @@ static void junor2_read_profiling_reg(struct aipu_soc *soc, struct profiling_dat
                 pdata->wdata_tot_lsb = aipu_read32(soc->base0, JUNOR2_ALL_WDATA_TOT_LSB);
                 pdata->tot_cycle_msb = aipu_read32(soc->base0, JUNOR2_TOT_CYCLE_MSB);
                 pdata->tot_cycle_lsb = aipu_read32(soc->base0, JUNOR2_TOT_CYCLE_LSB);
+
+                pdata->id_latency_max_msb = aipu_read32(soc->base0, JUNOR2_ID_LATENCY_MAX_MSB);
+                pdata->id_latency_max_lsb = aipu_read32(soc->base0, JUNOR2_ID_LATENCY_MAX_LSB);
+                pdata->id_latency_single = aipu_read32(soc->base0, JUNOR2_ID_LATENCY_SINGLE);
+                pdata->dma_latency_tot_msb = aipu_read32(soc->base0, JUNOR2_DMA_LATENCY_TOT_MSB);
+                pdata->dma_latency_tot_lsb = aipu_read32(soc->base0, JUNOR2_DMA_LATENCY_TOT_LSB);
+                pdata->dma_rdata_tot_msb = aipu_read32(soc->base0, JUNOR2_DMA_RDATA_TOT_MSB);
+                pdata->dma_rdata_tot_lsb = aipu_read32(soc->base0, JUNOR2_DMA_RDATA_TOT_LSB);
+                pdata->dma_ar_handshake_msb = aipu_read32(soc->base0, JUNOR2_DMA_AR_HANDSHAKE_MSB);
+                pdata->dma_ar_handshake_lsb = aipu_read32(soc->base0, JUNOR2_DMA_AR_HANDSHAKE_LSB);
+                pdata->max_outstanding = aipu_read32(soc->base0, JUNOR2_MAX_OUTSTAND);
+
+                for (id = 0; (id < JUNOR2_LATENCY_ID_CNT) && (id < AIPU_PROFILING_AXI_ID_MAX); id++) {
+                        pdata->latency_tot_id_msb[id] =
+                                aipu_read32(soc->base0, JUNOR2_LATENCY_TOT_ID_MSB(id));
+                        pdata->latency_tot_id_lsb[id] =
+                                aipu_read32(soc->base0, JUNOR2_LATENCY_TOT_ID_LSB(id));
+                        pdata->latency_max_id[id] =
+                                aipu_read32(soc->base0, JUNOR2_LATENCY_MAX_ID(id));
+                }
+
+                pdata->valid_mask = AIPU_PROFILING_VALID_BW | AIPU_PROFILING_VALID_DMA |
+                        AIPU_PROFILING_VALID_ID_LAT | AIPU_PROFILING_VALID_OUTSTAND;
         }
 }
 
@@ -92,6 +92,11 @@
 #define JUNOR2_LATENCY_MAX_ID14               0x3F8
 #define JUNOR2_LATENCY_MAX_ID15               0x3FC
 
+#define JUNOR2_LATENCY_ID_CNT                 16
+#define JUNOR2_LATENCY_TOT_ID_MSB(id)         (JUNOR2_LATENCY_TOT_ID0_MSB + (id) * 8)
+#define JUNOR2_LATENCY_TOT_ID_LSB(id)         (JUNOR2_LATENCY_TOT_ID0_LSB + (id) * 8)
+#define JUNOR2_LATENCY_MAX_ID(id)             (JUNOR2_LATENCY_MAX_ID0 + (id) * 4)
+
 #define JUNOR2_ENABLE_BW_STAT_FLAG        0x1
 #define JUNOR2_DISABLE_BW_STAT_FLAG       0x1
 
@@ -88,13 +88,6 @@ static int zhouyi_v1_trigger(struct aipu_core *core,
         start_pc = phys_addr | 0xD;
         aipu_write32(core->base0, ZHOUYI_START_PC_REG_OFFSET, start_pc);
 
-        if (tid)
-                dev_info(core->dev, "[%u] trigger Job 0x%x done: start pc = 0x%x, dreg0 = 0x%x, dreg1 = 0x%x",
-                        tid, udesc->job_id, start_pc, phys_addr0, phys_addr1);
-        else
-                dev_info(core->dev, "[IRQ] trigger Job 0x%x done: start pc = 0x%x, dreg0 = 0x%x, dreg1 = 0x%x",
-                        udesc->job_id, start_pc, phys_addr0, phys_addr1);
-
 finish:
         return ret;
 }
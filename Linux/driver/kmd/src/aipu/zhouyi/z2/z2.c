@@ -169,13 +169,6 @@ static int zhouyi_v2_trigger(struct aipu_core *core, struct user_job_desc *udesc
         start_pc |= 0xD;
         aipu_write32(core->base0, ZHOUYI_START_PC_REG_OFFSET, start_pc);
 
-        if (tid)
-                dev_info(core->dev, "[%u] trigger Job 0x%x done: start pc = 0x%x, dreg0 = 0x%x, dreg1 = 0x%x",
-                        tid, udesc->job_id, start_pc, data_0_pa, data_1_pa);
-        else
-                dev_info(core->dev, "[IRQ] trigger Job 0x%x done: start pc = 0x%x, dreg0 = 0x%x, dreg1 = 0x%x",
-                        udesc->job_id, start_pc, data_0_pa, data_1_pa);
-
 finish:
         return ret;
 }
@@ -0,0 +1,177 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_debugfs.c
+ * debugfs interface implementation file
+ */
+
+#include <linux/device.h>
+#include <linux/fs.h>
+#include <linux/seq_file.h>
+#include <linux/atomic.h>
+#include <linux/kernel.h>
+#include <linux/uaccess.h>
+#include <linux/math64.h>
+#include "aipu_debugfs.h"
+#include "aipu_latency.h"
+#include "aipu.h"
+
+static atomic_t session_seq = ATOMIC_INIT(0);
+
+static int latency_show(struct seq_file *m, void *data)
+{
+        aipu_latency_show((struct aipu_latency_stats *)m->private, m);
+        return 0;
+}
+
+static int latency_open(struct inode *inode, struct file *filp)
+{
+        return single_open(filp, latency_show, inode->i_private);
+}
+
+static ssize_t latency_write(struct file *filp, const char __user *buf, size_t len, loff_t *off)
+{
+        struct seq_file *m = filp->private_data;
+
+        aipu_latency_reset((struct aipu_latency_stats *)m->private);
+        return len;
+}
+
+static const struct file_operations latency_fops = {
+        .owner = THIS_MODULE,
+        .open = latency_open,
+        .read = seq_read,
+        .write = latency_write,
+        .llseek = seq_lseek,
+        .release = single_release,
+};
+
+static int sampler_show(struct seq_file *m, void *data)
+{
+        struct aipu_perf_sampler *sampler = (struct aipu_perf_sampler *)m->private;
+
+        mutex_lock(&sampler->lock);
+        seq_printf(m, "period_us: %llu\n", div_u64(sampler->period_ns, NSEC_PER_USEC));
+        if (sampler->ring) {
+                seq_printf(m, "capacity: %u\n", sampler->ring->capacity);
+                seq_printf(m, "head: %llu\n", READ_ONCE(sampler->ring->head));
+        }
+        mutex_unlock(&sampler->lock);
+        return 0;
+}
+
+static int sampler_open(struct inode *inode, struct file *filp)
+{
+        return single_open(filp, sampler_show, inode->i_private);
+}
+
+static ssize_t sampler_write(struct file *filp, const char __user *buf, size_t len, loff_t *off)
+{
+        int ret = 0;
+        u64 period_us = 0;
+        struct seq_file *m = filp->private_data;
+
+        ret = kstrtou64_from_user(buf, len, 0, &period_us);
+        if (ret)
+                return ret;
+
+        ret = aipu_perf_sampler_set_period((struct aipu_perf_sampler *)m->private, period_us);
+        return ret ? ret : len;
+}
+
+static const struct file_operations sampler_fops = {
+        .owner = THIS_MODULE,
+        .open = sampler_open,
+        .read = seq_read,
+        .write = sampler_write,
+        .llseek = seq_lseek,
+        .release = single_release,
+};
+
+static int sampler_ring_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+        return aipu_perf_sampler_mmap((struct aipu_perf_sampler *)filp->private_data, vma);
+}
+
+static const struct file_operations sampler_ring_fops = {
+        .owner = THIS_MODULE,
+        .open = simple_open,
+        .mmap = sampler_ring_mmap,
+};
+
+int aipu_create_debugfs(void *aipu_priv)
+{
+        struct aipu_priv *aipu = (struct aipu_priv *)aipu_priv;
+        char name[64];
+
+        if (!aipu)
+                return -EINVAL;
+
+        snprintf(name, sizeof(name), "aipu-%s", dev_name(aipu->dev));
+        aipu->debugfs_root = debugfs_create_dir(name, NULL);
+        if (IS_ERR_OR_NULL(aipu->debugfs_root)) {
+                /* debugfs is for debugging only and its absence should not fail probe */
+                dev_warn(aipu->dev, "create debugfs directory failed\n");
+                aipu->debugfs_root = NULL;
+                return 0;
+        }
+
+        aipu->debugfs_sessions = debugfs_create_dir("sessions", aipu->debugfs_root);
+        debugfs_create_file("latency", 0600, aipu->debugfs_root, &aipu->lat_stats, &latency_fops);
+        debugfs_create_file("sampler", 0600, aipu->debugfs_root, &aipu->sampler, &sampler_fops);
+        /* the debugfs file proxy does not forward mmap; the file lives as long as the device */
+        debugfs_create_file_unsafe("sampler_ring", 0400, aipu->debugfs_root, &aipu->sampler,
+                &sampler_ring_fops);
+        return 0;
+}
+
+void aipu_destroy_debugfs(void *aipu_priv)
+{
+        struct aipu_priv *aipu = (struct aipu_priv *)aipu_priv;
+
+        if (aipu && aipu->debugfs_root) {
+                debugfs_remove_recursive(aipu->debugfs_root);
+                aipu->debugfs_root = NULL;
+                aipu->debugfs_sessions = NULL;
+        }
+}
+
+void aipu_debugfs_add_session(void *aipu_priv, struct aipu_session *session)
+{
+        struct aipu_priv *aipu = (struct aipu_priv *)aipu_priv;
+        char name[32];
+
+        if ((!aipu) || (!session) || IS_ERR_OR_NULL(aipu->debugfs_sessions))
+                return;
+
+        snprintf(name, sizeof(name), "%d-%d", session->user_pid,
+                atomic_inc_return(&session_seq));
+        session->debugfs_lat = debugfs_create_file(name, 0600, aipu->debugfs_sessions,
+                &session->lat_stats, &latency_fops);
+        if (IS_ERR(session->debugfs_lat))
+                session->debugfs_lat = NULL;
+}
+
+void aipu_debugfs_remove_session(struct aipu_session *session)
+{
+        /* debugfs_remove waits for any reader of this file to leave before returning */
+        if (session && session->debugfs_lat) {
+                debugfs_remove(session->debugfs_lat);
+                session->debugfs_lat = NULL;
+        }
+}
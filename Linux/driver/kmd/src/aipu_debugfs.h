@@ -0,0 +1,64 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_debugfs.h
+ * debugfs interface header file
+ *
+ * Layout (under /sys/kernel/debug/aipu-<dev>/):
+ *   latency                    job latency histograms of all sessions
+ *   sessions/<pid>-<seq>       job latency histograms of an open session
+ *   sampler                    counter sampler state; write a period in us to start, 0 to stop
+ *   sampler_ring               read-only mmap of the sampler ring (uk_interface/aipu_sampler.h)
+ * Writing anything into a latency file resets its histograms.
+ */
+
+#ifndef _AIPU_DEBUGFS_H_
+#define _AIPU_DEBUGFS_H_
+
+#include <linux/debugfs.h>
+#include "aipu_session.h"
+
+/*
+ * @brief create debugfs directories and files in probe
+ *
+ * @param aipu_priv: aipu_priv struct pointer
+ *
+ * @return 0 if successful; others if failed.
+ */
+int aipu_create_debugfs(void *aipu_priv);
+/*
+ * @brief remove all debugfs directories and files in remove
+ *
+ * @param aipu_priv: aipu_priv struct pointer
+ */
+void aipu_destroy_debugfs(void *aipu_priv);
+/*
+ * @brief create the latency file of a new session
+ *
+ * @param aipu_priv: aipu_priv struct pointer
+ * @param session: session pointer
+ */
+void aipu_debugfs_add_session(void *aipu_priv, struct aipu_session *session);
+/*
+ * @brief remove the latency file of a session to be destroyed
+ *
+ * @param session: session pointer
+ */
+void aipu_debugfs_remove_session(struct aipu_session *session);
+
+#endif /* _AIPU_DEBUGFS_H_ */
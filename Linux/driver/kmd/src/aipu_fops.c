@@ -110,6 +110,7 @@ static long aipu_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
         struct aipu_io_req io_req;
         struct job_status_query job;
         u32 job_id;
+        u32 defrag_seq;
 
         if (!session) {
                 ret = map_errcode(AIPU_ERRCODE_INTERNAL_NULLPTR);
@@ -195,6 +196,38 @@ static long aipu_ioctl(struct file *filp, unsigned int cmd, unsigned long arg)
                         }
                 }
                 break;
+        case IPUIOC_MIGRATEBUF:
+                ret = copy_from_user(&buf_req, (struct buf_request __user*)arg, sizeof(struct buf_request));
+                if (AIPU_ERRCODE_NO_ERROR != ret)
+                        dev_err(aipu->dev, "KMD ioctl: MIGRATEBUF copy from user failed!");
+                else {
+                        /* only an idle buffer of this session can be migrated; userland frees the source */
+                        ret = aipu_session_check_buf(session, &buf_req.desc);
+                        if (AIPU_ERRCODE_NO_ERROR != ret)
+                                buf_req.errcode = AIPU_ERRCODE_ITEM_NOT_FOUND;
+                        else
+                                ret = aipu_mm_migrate(&aipu->mm, &buf_req, &buf);
+
+                        if ((AIPU_ERRCODE_NO_ERROR == ret) && buf.bytes) {
+                                ret = aipu_session_add_buf(session, &buf_req, &buf);
+                                if (AIPU_ERRCODE_NO_ERROR != ret) {
+                                        dev_err(aipu->dev, "KMD ioctl: add migrated buf failed!");
+                                        desc.pa = buf.pa;
+                                        desc.bytes = buf.bytes;
+                                        aipu_mm_free(&aipu->mm, &desc);
+                                }
+                        }
+
+                        /* desc is unchanged if the buffer is not moved */
+                        cp_ret = copy_to_user((struct buf_request __user*)arg, &buf_req, sizeof(struct buf_request));
+                        if ((AIPU_ERRCODE_NO_ERROR == ret) && (AIPU_ERRCODE_NO_ERROR != cp_ret))
+                                ret = cp_ret;
+                }
+                break;
+        case IPUIOC_QUERYDEFRAG:
+                defrag_seq = aipu_mm_get_defrag_seq(&aipu->mm);
+                ret = copy_to_user((u32 __user*)arg, &defrag_seq, sizeof(__u32));
+                break;
         case IPUIOC_REQSHMMAP:
                 ret = copy_to_user((unsigned long __user*)arg, &aipu->host_to_aipu_map, sizeof(u64));
                 break;
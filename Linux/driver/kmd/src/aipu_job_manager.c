@@ -23,11 +23,15 @@
 #include <linux/slab.h>
 #include <linux/string.h>
 #include <linux/time.h>
+#include <linux/ktime.h>
 #include "uk_interface/aipu_job_desc.h"
 #include "uk_interface/aipu_errcode.h"
 #include "aipu_job_manager.h"
 #include "aipu.h"
 
+#define CREATE_TRACE_POINTS
+#include "aipu_trace.h"
+
 static int init_aipu_job(struct aipu_job *aipu_job, struct user_job_desc *desc,
         struct session_job *kern_job, struct aipu_session *session)
 {
@@ -46,6 +50,7 @@ static int init_aipu_job(struct aipu_job *aipu_job, struct user_job_desc *desc,
         else
                 aipu_job->desc = *desc;
         aipu_job->session = (struct aipu_session *)session;
+        aipu_job->session_pid = session ? aipu_get_session_pid(session) : 0;
         aipu_job->session_job = (struct session_job *)kern_job;
         aipu_job->state = AIPU_JOB_STATE_IDLE;
         aipu_job->exception_flag = AIPU_EXCEP_NO_EXCEPTION;
@@ -88,7 +93,9 @@ static struct aipu_job *create_aipu_job(struct user_job_desc *desc,
 static void aipu_job_manager_trigger_job_sched(struct aipu_priv *aipu, struct aipu_job *aipu_job)
 {
         if (aipu && aipu_job) {
+                aipu_job->ts.trigger_ns = ktime_get_ns();
                 aipu_priv_trigger(aipu, &aipu_job->desc, aipu_job->uthread_id);
+                trace_aipu_job_trigger(aipu_job);
                 if (is_session_job_prof_enabled(aipu_job->session_job)) {
                         session_job_mark_sched(aipu_job->session_job);
                         aipu_priv_start_bw_profiling(aipu);
@@ -108,7 +115,9 @@ int aipu_init_job_manager(struct aipu_job_manager *job_manager, struct device *p
 
         job_manager->scheduled_queue_head = create_aipu_job(NULL, NULL, NULL);
         job_manager->pending_queue_head = create_aipu_job(NULL, NULL, NULL);
-        if ((!job_manager->pending_queue_head) || (!job_manager->scheduled_queue_head))
+        job_manager->blocked_queue_head = create_aipu_job(NULL, NULL, NULL);
+        if ((!job_manager->pending_queue_head) || (!job_manager->scheduled_queue_head) ||
+            (!job_manager->blocked_queue_head))
                 return -ENOMEM;
 
         job_manager->sched_num = 0;
@@ -137,6 +146,7 @@ void aipu_deinit_job_manager(struct aipu_job_manager *job_manager)
         if (job_manager) {
                 delete_queue(job_manager->scheduled_queue_head);
                 delete_queue(job_manager->pending_queue_head);
+                delete_queue(job_manager->blocked_queue_head);
                 job_manager->sched_num = 0;
         }
 }
@@ -193,11 +203,133 @@ static void aipu_schedule_pending_job_no_lock(struct aipu_job_manager *job_manag
         }
 }
 
+static void aipu_job_manager_kick_bh(struct aipu_job_manager *job_manager)
+{
+        struct aipu_priv *aipu = container_of(job_manager, struct aipu_priv, job_manager);
+
+        /* end jobs not passing through the IRQ handler are delivered by the bottom half */
+        if (aipu->core0)
+                aipu_irq_schedulework(aipu->core0->irq_obj);
+}
+
+static struct aipu_job *find_job_no_lock(struct aipu_job *head, struct aipu_session *session,
+        u32 job_id)
+{
+        struct aipu_job *cursor = NULL;
+
+        list_for_each_entry(cursor, &head->node, node) {
+                if ((cursor->session == session) && (cursor->desc.job_id == job_id))
+                        return cursor;
+        }
+
+        return NULL;
+}
+
+static int get_dep_refs(struct aipu_job *job, struct aipu_job *dep)
+{
+        int refs = 0;
+        u32 i = 0;
+
+        if ((job->session != dep->session) || (job->session_pid != dep->session_pid))
+                return 0;
+
+        for (i = 0; i < job->desc.dep_job_cnt; i++) {
+                if (job->desc.dep_job_id[i] == dep->desc.job_id)
+                        refs++;
+        }
+
+        return refs;
+}
+
+static int is_dep_job_failed(struct aipu_job *dep)
+{
+        return dep->exception_flag || (dep->valid_flag != AIPU_JOB_FLAG_VALID);
+}
+
+/**
+ * count the prerequisite jobs of a new job which are still in job manager;
+ * a prerequisite not found has been delivered to its session or collected by userland
+ */
+static void aipu_job_manager_count_deps_no_lock(struct aipu_job_manager *job_manager,
+        struct aipu_job *job)
+{
+        struct aipu_job *dep = NULL;
+        u32 i = 0;
+
+        for (i = 0; i < job->desc.dep_job_cnt; i++) {
+                dep = find_job_no_lock(job_manager->pending_queue_head, job->session,
+                        job->desc.dep_job_id[i]);
+                if (!dep)
+                        dep = find_job_no_lock(job_manager->blocked_queue_head, job->session,
+                                job->desc.dep_job_id[i]);
+                if (!dep)
+                        dep = find_job_no_lock(job_manager->scheduled_queue_head, job->session,
+                                job->desc.dep_job_id[i]);
+
+                if (!dep) {
+                        if (aipu_session_is_job_failed(job->session, job->desc.dep_job_id[i]))
+                                job->dep_failed = 1;
+                } else if ((dep->state == AIPU_JOB_STATE_END) && dep->deps_released) {
+                        if (is_dep_job_failed(dep))
+                                job->dep_failed = 1;
+                } else
+                        job->dep_cnt++;
+        }
+}
+
+/**
+ * move the blocked dependents of end jobs to pending queue, or end them with
+ * exception if any prerequisite failed; such jobs are appended to the scheduled
+ * queue and released in the same walk so that failures propagate along the chain.
+ *
+ * @return number of jobs ended without running (to be delivered by the bottom half)
+ */
+static int aipu_job_manager_release_deps_no_lock(struct aipu_job_manager *job_manager)
+{
+        struct aipu_job *curr = NULL;
+        struct aipu_job *cursor = NULL;
+        struct aipu_job *next = NULL;
+        int refs = 0;
+        int failed_cnt = 0;
+
+        list_for_each_entry(curr, &job_manager->scheduled_queue_head->node, node) {
+                if ((curr->state != AIPU_JOB_STATE_END) || curr->deps_released)
+                        continue;
+
+                curr->deps_released = 1;
+                list_for_each_entry_safe(cursor, next, &job_manager->blocked_queue_head->node, node) {
+                        refs = get_dep_refs(cursor, curr);
+                        if (!refs)
+                                continue;
+
+                        cursor->dep_cnt -= refs;
+                        if (is_dep_job_failed(curr))
+                                cursor->dep_failed = 1;
+                        if (cursor->dep_cnt > 0)
+                                continue;
+
+                        if (cursor->dep_failed) {
+                                cursor->state = AIPU_JOB_STATE_END;
+                                cursor->exception_flag = AIPU_EXCEP_DEP_FAILURE;
+                                list_move_tail(&cursor->node, &job_manager->scheduled_queue_head->node);
+                                failed_cnt++;
+                        } else {
+                                cursor->state = AIPU_JOB_STATE_PENDING;
+                                list_move_tail(&cursor->node, &job_manager->pending_queue_head->node);
+                                trace_aipu_job_pending(cursor);
+                        }
+                }
+        }
+
+        return failed_cnt;
+}
+
 int aipu_job_manager_schedule_new_job(struct aipu_job_manager *job_manager, struct user_job *user_job,
         struct session_job *session_job, struct aipu_session *session)
 {
         int ret = AIPU_ERRCODE_NO_ERROR;
         struct aipu_job *aipu_job = NULL;
+        int kick_bh = 0;
         unsigned long flags;
 
         if ((!job_manager) || (!user_job) || (!session_job) || (!session)) {
@@ -207,6 +339,12 @@ int aipu_job_manager_schedule_new_job(struct aipu_job_manager *job_manager, stru
                 goto finish;
         }
 
+        if (user_job->desc.dep_job_cnt > AIPU_JOB_MAX_DEPS) {
+                user_job->errcode = AIPU_ERRCODE_INVALID_ARGS;
+                ret = map_errcode(AIPU_ERRCODE_INVALID_ARGS);
+                goto finish;
+        }
+
         aipu_job = create_aipu_job(&user_job->desc, session_job, session);
         if (!aipu_job) {
                 user_job->errcode = AIPU_ERRCODE_CREATE_KOBJ_ERR;
@@ -214,17 +352,38 @@ int aipu_job_manager_schedule_new_job(struct aipu_job_manager *job_manager, stru
                 goto finish;
         }
 
+        aipu_job->ts.submit_ns = ktime_get_ns();
+        trace_aipu_job_submit(aipu_job);
+
         /* LOCK */
         spin_lock_irqsave(&job_manager->lock, flags);
 
-        /* pending the flushed job from userland and try to schedule it */
-        aipu_job->state = AIPU_JOB_STATE_PENDING;
-        list_add_tail(&aipu_job->node, &job_manager->pending_queue_head->node);
-        aipu_schedule_pending_job_no_lock(job_manager);
+        aipu_job_manager_count_deps_no_lock(job_manager, aipu_job);
+        if (aipu_job->dep_cnt) {
+                /* wait for the prerequisite jobs; released in the IRQ handler */
+                aipu_job->state = AIPU_JOB_STATE_BLOCKED;
+                list_add_tail(&aipu_job->node, &job_manager->blocked_queue_head->node);
+                trace_aipu_job_blocked(aipu_job);
+        } else if (aipu_job->dep_failed) {
+                aipu_job->state = AIPU_JOB_STATE_END;
+                aipu_job->exception_flag = AIPU_EXCEP_DEP_FAILURE;
+                list_add_tail(&aipu_job->node, &job_manager->scheduled_queue_head->node);
+                aipu_job_manager_release_deps_no_lock(job_manager);
+                kick_bh = 1;
+        } else {
+                /* pending the flushed job from userland and try to schedule it */
+                aipu_job->state = AIPU_JOB_STATE_PENDING;
+                list_add_tail(&aipu_job->node, &job_manager->pending_queue_head->node);
+                trace_aipu_job_pending(aipu_job);
+                aipu_schedule_pending_job_no_lock(job_manager);
+        }
 
         spin_unlock_irqrestore(&job_manager->lock, flags);
         /* UNLOCK */
 
+        if (kick_bh)
+                aipu_job_manager_kick_bh(job_manager);
+
         /* success */
         user_job->errcode = AIPU_ERRCODE_NO_ERROR;
 
@@ -249,7 +408,14 @@ static int aipu_invalidate_job_no_lock(struct aipu_job_manager *job_manager,
                         aipu_schedule_pending_job_no_lock(job_manager);
                 } else
                         job->valid_flag = 0;
-        } else if (job->state == AIPU_JOB_STATE_PENDING) {
+        } else if ((job->state == AIPU_JOB_STATE_PENDING) ||
+                   (job->state == AIPU_JOB_STATE_BLOCKED)) {
+                /* the dependents of a killed job are failed before it is removed */
+                job->state = AIPU_JOB_STATE_END;
+                job->valid_flag = 0;
+                list_move_tail(&job->node, &job_manager->scheduled_queue_head->node);
+                if (aipu_job_manager_release_deps_no_lock(job_manager))
+                        aipu_job_manager_kick_bh(job_manager);
                 remove_aipu_job(job);
         } else
                 return -EINVAL;
@@ -267,8 +433,10 @@ static void aipu_invalidate_canceled_jobs_no_lock(struct aipu_job_manager *job_m
                 return;
 
         list_for_each_entry_safe(cursor, next, &head->node, node) {
-                if (aipu_get_session_pid(cursor->session) == aipu_get_session_pid(session))
+                if (cursor->session_pid == aipu_get_session_pid(session)) {
+                        trace_aipu_job_cancel(cursor);
                         aipu_invalidate_job_no_lock(job_manager, cursor);
+                }
         }
 }
 
@@ -276,6 +444,8 @@ int aipu_job_manager_cancel_session_jobs(struct aipu_job_manager *job_manager,
         struct aipu_session *session)
 {
         int ret = AIPU_ERRCODE_NO_ERROR;
+        struct aipu_job *cursor = NULL;
+        struct aipu_job *next = NULL;
         unsigned long flags;
 
         if (!session) {
@@ -287,8 +457,15 @@ int aipu_job_manager_cancel_session_jobs(struct aipu_job_manager *job_manager,
         spin_lock_irqsave(&job_manager->lock, flags);
 
         /**
-         * invalidate all active jobs of this session in job manager
+         * invalidate all active jobs of this session in job manager;
+         * blocked jobs go first as their prerequisites are all of this session
          */
+        list_for_each_entry_safe(cursor, next, &job_manager->blocked_queue_head->node, node) {
+                if (cursor->session_pid == aipu_get_session_pid(session)) {
+                        trace_aipu_job_cancel(cursor);
+                        remove_aipu_job(cursor);
+                }
+        }
         aipu_invalidate_canceled_jobs_no_lock(job_manager, job_manager->pending_queue_head, session);
         aipu_invalidate_canceled_jobs_no_lock(job_manager, job_manager->scheduled_queue_head, session);
 
@@ -315,6 +492,7 @@ static int aipu_invalidate_timeout_job_no_lock(struct aipu_job_manager *job_mana
         list_for_each_entry_safe(cursor, next, &head->node, node) {
                 if ((cursor->uthread_id == task_pid_nr(current)) &&
                         (cursor->desc.job_id == job_id)) {
+                        trace_aipu_job_timeout_kill(cursor);
                         ret = aipu_invalidate_job_no_lock(job_manager, cursor);
                         break;
                 }
@@ -334,6 +512,8 @@ int aipu_invalidate_timeout_job(struct aipu_job_manager *job_manager, int job_id
         /* LOCK */
         spin_lock_irqsave(&job_manager->lock, flags);
         ret = aipu_invalidate_timeout_job_no_lock(job_manager, job_manager->pending_queue_head, job_id);
+        if (ret)
+                ret = aipu_invalidate_timeout_job_no_lock(job_manager, job_manager->blocked_queue_head, job_id);
         if (ret) {
                 ret = aipu_invalidate_timeout_job_no_lock(job_manager, job_manager->scheduled_queue_head, job_id);
                 pr_debug("Timeout job invalidated from sched queue.");
@@ -354,6 +534,13 @@ static void aipu_job_manager_update_job_profiling_data(struct aipu_priv *aipu, s
             (job->exception_flag == AIPU_EXCEP_NO_EXCEPTION)) {
                 aipu_priv_stop_bw_profiling(aipu);
                 aipu_session_job_update_pdata(job->session, job->session_job);
+                /* keep the counters running for the sampler and perf */
+                if (aipu_perf_sampler_is_running(&aipu->sampler))
+                        aipu_priv_start_bw_profiling(aipu);
+#ifdef AIPU_ENABLE_PMU
+                else if (aipu_pmu_is_active(&aipu->pmu))
+                        aipu_priv_start_bw_profiling(aipu);
+#endif
         }
 }
 
@@ -367,8 +554,10 @@ void aipu_job_manager_update_job_state_irq(void *aipu_priv, int exception_flag)
         spin_lock(&job_manager->lock);
         list_for_each_entry(curr, &job_manager->scheduled_queue_head->node, node) {
                 if (curr->state == AIPU_JOB_STATE_SCHED) {
+                        curr->ts.irq_ns = ktime_get_ns();
                         curr->state = AIPU_JOB_STATE_END;
                         curr->exception_flag = exception_flag;
+                        trace_aipu_job_irq(curr);
 
                         if (curr->exception_flag)
                                 pr_debug("[IRQ] job 0x%x of thread %u EXCEPTION",
@@ -389,6 +578,9 @@ void aipu_job_manager_update_job_state_irq(void *aipu_priv, int exception_flag)
                 }
         }
 
+        /* dependents become pending right away; jobs failed by dependency go with the BH */
+        aipu_job_manager_release_deps_no_lock(job_manager);
+
         /* schedule a new pending job */
         aipu_schedule_pending_job_no_lock(job_manager);
         spin_unlock(&job_manager->lock);
@@ -399,6 +591,7 @@ void aipu_job_manager_update_job_queue_done_irq(struct aipu_job_manager *job_man
 {
         struct aipu_job *curr = NULL;
         struct aipu_job *next = NULL;
+        struct aipu_priv *aipu = container_of(job_manager, struct aipu_priv, job_manager);
         unsigned long flags;
 
         /* LOCK */
@@ -407,6 +600,13 @@ void aipu_job_manager_update_job_queue_done_irq(struct aipu_job_manager *job_man
                 if (AIPU_JOB_STATE_END != curr->state)
                         continue;
 
+                curr->ts.bh_ns = ktime_get_ns();
+                trace_aipu_job_done(curr);
+                aipu_latency_record_job(&aipu->lat_stats, &curr->ts);
+#ifdef AIPU_ENABLE_PMU
+                aipu_pmu_count_job(&aipu->pmu);
+#endif
+
                 /*
                    DO NOT call session API for invalid job because
                    session struct probably not exist on this occasion
@@ -414,6 +614,8 @@ void aipu_job_manager_update_job_queue_done_irq(struct aipu_job_manager *job_man
                 if (AIPU_JOB_FLAG_VALID == curr->valid_flag) {
                         pr_debug("[BH] handling job 0x%x of thread %u...",
                                 curr->desc.job_id, curr->uthread_id);
+                        curr->session_job->ts = curr->ts;
+                        aipu_latency_record_job(&curr->session->lat_stats, &curr->ts);
                         spin_unlock_irqrestore(&job_manager->lock, flags);
                         aipu_session_job_done(curr->session, curr->session_job,
                             curr->exception_flag);
@@ -444,6 +646,8 @@ static int print_job_info(char* buf, int buf_size, struct aipu_job* job)
                 snprintf(state_str, 20, "Pending");
         else if (job->state == AIPU_JOB_STATE_SCHED)
                 snprintf(state_str, 20, "Executing");
+        else if (job->state == AIPU_JOB_STATE_BLOCKED)
+                snprintf(state_str, 20, "Blocked");
         else if (job->state == AIPU_JOB_STATE_END)
                 snprintf(state_str, 20, "Done");
 
@@ -484,6 +688,12 @@ int aipu_job_manager_sysfs_job_show(struct aipu_job_manager *job_manager, char*
                 number++;
         }
         curr = NULL;
+        list_for_each_entry(curr, &job_manager->blocked_queue_head->node, node) {
+                ret += print_job_info(tmp, tmp_size, curr);
+                strcat(buf, tmp);
+                number++;
+        }
+        curr = NULL;
         list_for_each_entry(curr, &job_manager->scheduled_queue_head->node, node) {
                 ret += print_job_info(tmp, tmp_size, curr);
                 strcat(buf, tmp);
@@ -30,6 +30,8 @@
 #include "aipu_thread_waitqueue.h"
 
 #define AIPU_EXCEP_NO_EXCEPTION   0
+/* a prerequisite job ended with exception or was killed; the job is not run */
+#define AIPU_EXCEP_DEP_FAILURE    0x100
 
 /**
  * struct aipu_job - job element struct describing a job under scheduling in job manager
@@ -38,20 +40,30 @@
  * @uthread_id: ID of user thread scheduled this job
  * @desc: job desctiptor from userland
  * @session: session pointer refernece of this job
+ * @session_pid: pid of the session, kept for tracing after the session is closed
  * @session_job: corresponding job object in session
  * @state: job state
  * @exception_flag: exception flag
  * @valid_flag: valid flag, indicating this job canceled by user or not
+ * @ts: timestamps of this job passing through job manager
+ * @dep_cnt: number of prerequisite job references not ended yet
+ * @dep_failed: a prerequisite job ended with exception or was killed
+ * @deps_released: the dependents of this end job have been updated
  * @node: list head struct
  */
  struct aipu_job {
         int uthread_id;
         struct user_job_desc desc;
         struct aipu_session *session;
+        int session_pid;
         struct session_job *session_job;
         int state;
         int exception_flag;
         int valid_flag;
+        struct job_timestamps ts;
+        int dep_cnt;
+        int dep_failed;
+        int deps_released;
         struct list_head node;
 };
 
@@ -61,6 +73,7 @@
  *
  * @scheduled_queue_head: scheduled job queue head
  * @pending_queue_head: pending job queue head
+ * @blocked_queue_head: queue head of jobs waiting for their prerequisite jobs
  * @sched_num: number of jobs have been scheduled
  * @max_sched_num: maximum allowed scheduled job number
  * @lock: spinlock
@@ -69,6 +82,7 @@
 struct aipu_job_manager {
         struct aipu_job *scheduled_queue_head;
         struct aipu_job *pending_queue_head;
+        struct aipu_job *blocked_queue_head;
         int sched_num;
         int max_sched_num;
         int init_done;
@@ -107,7 +121,8 @@ void aipu_deinit_job_manager(struct aipu_job_manager *job_manager);
 int aipu_job_manager_schedule_new_job(struct aipu_job_manager *job_manager, struct user_job *user_job,
     struct session_job *kern_job, struct aipu_session *session);
 /**
- * @brief update job state and indicating if exception happens
+ * @brief update job state and indicating if exception happens;
+ *        the dependents of the end job are moved to the pending queue (or failed)
  *
  * @param aipu_priv: aipu private struct
  * @param exception_flag: exception flag
@@ -0,0 +1,152 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_latency.c
+ * Job latency histogram module implementation file
+ */
+
+#include <linux/bitops.h>
+#include <linux/string.h>
+#include <linux/math64.h>
+#include "aipu_latency.h"
+
+static const char *lat_type_name[AIPU_LAT_TYPE_MAX] = {
+        "pending",
+        "exec",
+        "delivery",
+};
+
+static int get_bucket_idx(u64 ns)
+{
+        int msb = 0;
+
+        if (ns < AIPU_LAT_SUB_CNT)
+                return (int)ns;
+
+        msb = fls64(ns) - 1;
+        if (msb > AIPU_LAT_MAX_MSB)
+                return AIPU_LAT_BUCKET_CNT - 1;
+
+        return (msb - AIPU_LAT_SUB_BITS + 1) * AIPU_LAT_SUB_CNT +
+                (int)((ns >> (msb - AIPU_LAT_SUB_BITS)) & (AIPU_LAT_SUB_CNT - 1));
+}
+
+static u64 get_bucket_upper_bound(int idx)
+{
+        int shift = 0;
+
+        if (idx < AIPU_LAT_SUB_CNT)
+                return idx;
+
+        shift = idx / AIPU_LAT_SUB_CNT - 1;
+        return (((u64)(AIPU_LAT_SUB_CNT + idx % AIPU_LAT_SUB_CNT) + 1) << shift) - 1;
+}
+
+static u64 get_percentile_no_lock(struct aipu_latency_hist *hist, int percent)
+{
+        int i = 0;
+        u64 target = 0;
+        u64 acc = 0;
+        u64 bound = 0;
+
+        if (!hist->count)
+                return 0;
+
+        /* rank of the percentile sample, rounded up */
+        target = div_u64(hist->count * percent + 99, 100);
+        for (i = 0; i < AIPU_LAT_BUCKET_CNT; i++) {
+                acc += hist->buckets[i];
+                if (acc >= target) {
+                        bound = get_bucket_upper_bound(i);
+                        return (bound < hist->max_ns) ? bound : hist->max_ns;
+                }
+        }
+
+        return hist->max_ns;
+}
+
+void aipu_latency_init(struct aipu_latency_stats *stats)
+{
+        if (stats) {
+                memset(stats->hist, 0, sizeof(stats->hist));
+                spin_lock_init(&stats->lock);
+        }
+}
+
+void aipu_latency_reset(struct aipu_latency_stats *stats)
+{
+        unsigned long flags;
+
+        if (!stats)
+                return;
+
+        spin_lock_irqsave(&stats->lock, flags);
+        memset(stats->hist, 0, sizeof(stats->hist));
+        spin_unlock_irqrestore(&stats->lock, flags);
+}
+
+void aipu_latency_record(struct aipu_latency_stats *stats, int type, u64 ns)
+{
+        struct aipu_latency_hist *hist = NULL;
+        unsigned long flags;
+
+        if ((!stats) || (type < 0) || (type >= AIPU_LAT_TYPE_MAX))
+                return;
+
+        hist = &stats->hist[type];
+        spin_lock_irqsave(&stats->lock, flags);
+        hist->buckets[get_bucket_idx(ns)]++;
+        hist->count++;
+        hist->sum_ns += ns;
+        if (ns > hist->max_ns)
+                hist->max_ns = ns;
+        spin_unlock_irqrestore(&stats->lock, flags);
+}
+
+void aipu_latency_record_job(struct aipu_latency_stats *stats, const struct job_timestamps *ts)
+{
+        if ((!stats) || (!ts) || (!ts->submit_ns) || (!ts->trigger_ns) || (!ts->irq_ns))
+                return;
+
+        aipu_latency_record(stats, AIPU_LAT_PENDING, ts->trigger_ns - ts->submit_ns);
+        aipu_latency_record(stats, AIPU_LAT_EXEC, ts->irq_ns - ts->trigger_ns);
+}
+
+void aipu_latency_show(struct aipu_latency_stats *stats, struct seq_file *m)
+{
+        int type = 0;
+        struct aipu_latency_hist *hist = NULL;
+        unsigned long flags;
+
+        if ((!stats) || (!m))
+                return;
+
+        seq_printf(m, "%-10s%12s%14s%14s%14s%14s%14s\n", "Type", "Count", "Mean(ns)",
+                "P50(ns)", "P90(ns)", "P99(ns)", "Max(ns)");
+        seq_puts(m, "------------------------------------------------------------------------------------------\n");
+
+        spin_lock_irqsave(&stats->lock, flags);
+        for (type = 0; type < AIPU_LAT_TYPE_MAX; type++) {
+                hist = &stats->hist[type];
+                seq_printf(m, "%-10s%12llu%14llu%14llu%14llu%14llu%14llu\n", lat_type_name[type],
+                        hist->count, hist->count ? div64_u64(hist->sum_ns, hist->count) : 0,
+                        get_percentile_no_lock(hist, 50), get_percentile_no_lock(hist, 90),
+                        get_percentile_no_lock(hist, 99), hist->max_ns);
+        }
+        spin_unlock_irqrestore(&stats->lock, flags);
+}
@@ -0,0 +1,106 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_latency.h
+ * Job latency histogram module header file
+ */
+
+#ifndef _AIPU_LATENCY_H_
+#define _AIPU_LATENCY_H_
+
+#include <linux/types.h>
+#include <linux/spinlock.h>
+#include <linux/seq_file.h>
+#include "uk_interface/aipu_job_status.h"
+
+/**
+ * log-linear buckets: values < 8ns are counted exactly, others are split into
+ * 8 linear sub-buckets per power of 2 (<= 12.5% relative error), up to 2^40 ns
+ */
+#define AIPU_LAT_SUB_BITS      3
+#define AIPU_LAT_SUB_CNT       (1 << AIPU_LAT_SUB_BITS)
+#define AIPU_LAT_MAX_MSB       40
+#define AIPU_LAT_BUCKET_CNT    ((AIPU_LAT_MAX_MSB - 1) * AIPU_LAT_SUB_CNT)
+
+enum aipu_latency_type {
+        AIPU_LAT_PENDING = 0,  /* job submitted -> triggered on AIPU */
+        AIPU_LAT_EXEC,         /* job triggered -> done/exception interrupt */
+        AIPU_LAT_DELIVERY,     /* done/exception interrupt -> status fetched by userland */
+        AIPU_LAT_TYPE_MAX,
+};
+
+/**
+ * struct aipu_latency_hist - latency histogram
+ * @buckets: sample counters of buckets
+ * @count: total sample number
+ * @sum_ns: sum of all samples
+ * @max_ns: maximum sample
+ */
+struct aipu_latency_hist {
+        u64 buckets[AIPU_LAT_BUCKET_CNT];
+        u64 count;
+        u64 sum_ns;
+        u64 max_ns;
+};
+
+/**
+ * struct aipu_latency_stats - latency histograms of all types
+ * @hist: histograms indexed by enum aipu_latency_type
+ * @lock: spinlock
+ */
+struct aipu_latency_stats {
+        struct aipu_latency_hist hist[AIPU_LAT_TYPE_MAX];
+        spinlock_t lock;
+};
+
+/**
+ * @brief initialize a latency stats struct
+ *
+ * @param stats: latency stats struct pointer
+ */
+void aipu_latency_init(struct aipu_latency_stats *stats);
+/**
+ * @brief clear all histograms of a latency stats struct
+ *
+ * @param stats: latency stats struct pointer
+ */
+void aipu_latency_reset(struct aipu_latency_stats *stats);
+/**
+ * @brief add a latency sample
+ *
+ * @param stats: latency stats struct pointer
+ * @param type: latency type
+ * @param ns: latency in ns
+ */
+void aipu_latency_record(struct aipu_latency_stats *stats, int type, u64 ns);
+/**
+ * @brief add the pending & execution latency samples of an end job
+ *
+ * @param stats: latency stats struct pointer
+ * @param ts: job timestamps
+ */
+void aipu_latency_record_job(struct aipu_latency_stats *stats, const struct job_timestamps *ts);
+/**
+ * @brief print count/mean/p50/p90/p99/max of all histograms
+ *
+ * @param stats: latency stats struct pointer
+ * @param m: seq_file pointer
+ */
+void aipu_latency_show(struct aipu_latency_stats *stats, struct seq_file *m);
+
+#endif /* _AIPU_LATENCY_H_ */
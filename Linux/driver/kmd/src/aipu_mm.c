@@ -24,11 +24,13 @@
 #include <linux/of_reserved_mem.h>
 #include <linux/dma-mapping.h>
 #include <linux/slab.h>
+#include <linux/math64.h>
 #include <asm/div64.h>
 #include "uk_interface/aipu_errcode.h"
 #include "config.h"
 #include "aipu.h"
 #include "aipu_mm.h"
+#include "aipu_sysfs.h"
 
 static inline int get_asid(const struct aipu_memory_manager *mm, enum aipu_mm_data_type type)
 {
@@ -230,7 +232,7 @@ success:
 }
 
 static int aipu_mm_split_block_no_lock(struct aipu_block *target, u64 alloc_base, u64 alloc_bytes,
-        enum aipu_mm_data_type type)
+        enum aipu_mm_data_type type, u32 tag)
 {
         u64 alloc_start = alloc_base;
         u64 alloc_end = alloc_start + alloc_bytes - 1;
@@ -251,6 +253,7 @@ static int aipu_mm_split_block_no_lock(struct aipu_block *target, u64 alloc_base
                 */
                 alloc_blk = target;
                 alloc_blk->tid = task_pid_nr(current);
+                alloc_blk->tag = tag;
                 alloc_blk->type = type;
                 alloc_blk->state = AIPU_BLOCK_STATE_ALLOCATED;
         } else {
@@ -258,6 +261,7 @@ static int aipu_mm_split_block_no_lock(struct aipu_block *target, u64 alloc_base
                         type, AIPU_BLOCK_STATE_ALLOCATED);
                 if (!alloc_blk)
                         return -ENOMEM;
+                alloc_blk->tag = tag;
                 if ((alloc_start == target_start) && (alloc_end < target_end)) {
                         /*
                           alloc block:              |<---alloc--->|<--remaining-->|
@@ -344,7 +348,7 @@ static int aipu_mm_alloc_in_region_strict_no_lock(struct aipu_memory_manager *mm
 
         /* found matching block candidate: update block list */
         if (aipu_mm_split_block_no_lock(blk_cand, alloc_pa, roundup_bytes,
-            (enum aipu_mm_data_type)buf_req->data_type)) {
+            (enum aipu_mm_data_type)buf_req->data_type, buf_req->owner_tag)) {
                 ret = -ENOMEM;
                 goto finish;
         }
@@ -410,7 +414,7 @@ static int aipu_mm_alloc_in_region_compact_no_lock(struct aipu_memory_manager *m
 
         /* found matching block candidate: update block list */
         if (aipu_mm_split_block_no_lock(blk_cand, alloc_pa, compact_bytes,
-            (enum aipu_mm_data_type)buf_req->data_type)) {
+            (enum aipu_mm_data_type)buf_req->data_type, buf_req->owner_tag)) {
                 ret = -ENOMEM;
                 goto finish;
         }
@@ -493,6 +497,8 @@ static int aipu_mm_try_alloc_in_region(struct aipu_memory_manager* mm, struct ai
         ret = region->alloc_in_region(mm, region, buf_req, buf);
         if (!ret) {
                 region->tot_free_bytes -= buf->bytes;
+                if (region->tot_bytes - region->tot_free_bytes > region->peak_used_bytes)
+                        region->peak_used_bytes = region->tot_bytes - region->tot_free_bytes;
                 buf->region_id = region->id;
                 buf->type = region->type;
                 pr_debug("[aipu_mm_try_alloc_in_region] alloc done: PA 0x%llx, size 0x%llx",
@@ -530,6 +536,7 @@ static int aipu_mm_free_in_region(struct aipu_mem_region *region, struct buf_des
 
         /* update target block to be free state */
         target->tid = 0;
+        target->tag = 0;
         target->type = AIPU_MM_DATA_TYPE_NONE;
         target->state = AIPU_BLOCK_STATE_FREE;
 
@@ -603,6 +610,35 @@ static int aipu_mm_scan_regions_alloc(struct aipu_memory_manager *mm, struct aip
         return ret;
 }
 
+static int aipu_mm_is_fragmented(struct aipu_memory_manager *mm, u64 bytes)
+{
+        struct aipu_mem_region *region = NULL;
+
+        list_for_each_entry(region, &mm->ddr_head->list, list) {
+                if (region->tot_free_bytes >= get_alloc_size(mm, region, bytes))
+                        return 1;
+        }
+
+        return 0;
+}
+
+static u64 aipu_mm_get_largest_free_no_lock(struct aipu_mem_region *region, int *free_cnt)
+{
+        u64 largest = 0;
+        struct aipu_block *blk = NULL;
+
+        *free_cnt = 0;
+        list_for_each_entry(blk, &region->blk_head->list, list) {
+                if (blk->state != AIPU_BLOCK_STATE_FREE)
+                        continue;
+                (*free_cnt)++;
+                if (blk->bytes > largest)
+                        largest = blk->bytes;
+        }
+
+        return largest;
+}
+
 static struct aipu_mem_region *aipu_mm_find_region(struct aipu_mem_region *head, u64 pa, u64 bytes)
 {
         struct aipu_mem_region *region = NULL;
@@ -666,6 +702,12 @@ int aipu_init_mm(struct aipu_memory_manager *mm, struct device *dev, int version
         mm->sram_global = AIPU_CONFIG_SRAM_DATA_ASID;
         mm->dev = dev;
         mm->version = version;
+        atomic_set(&mm->sram_req_cnt, 0);
+        atomic_set(&mm->sram_fallback_cnt, 0);
+        atomic_set(&mm->defrag_req_seq, 0);
+        atomic_set(&mm->frag_fail_cnt, 0);
+        atomic_set(&mm->migrate_cnt, 0);
+        atomic64_set(&mm->migrate_bytes, 0);
 
         /* success */
         return 0;
@@ -751,13 +793,21 @@ int aipu_mm_alloc(struct aipu_memory_manager *mm, struct buf_request *buf_req,
 
 #if (defined AIPU_CONFIG_ENABLE_SRAM) && (AIPU_CONFIG_ENABLE_SRAM == 1)
         /**
-         * Try to alloc from SRAM first if the ASID is compatible; if failed then
-         * fall back to alloc from DDR.
+         * SRAM is a managed tier: only buffers UMD marks as hot (placement hint) are
+         * tried in SRAM, and only if their ASID is compatible; if failed then fall
+         * back to alloc from DDR.
          */
-        if (mm->sram_global & asid) {
+        if ((buf_req->placement == AIPU_MEM_PLACEMENT_SRAM) && (mm->sram_global & asid) &&
+            mm->sram_cnt) {
+                atomic_inc(&mm->sram_req_cnt);
                 ret = aipu_mm_scan_regions_alloc(mm, mm->sram_head, buf_req, buf);
-                if ((ret && (AIPU_CONFIG_ENABLE_FALL_BACK_TO_DDR == 0)) || (!ret))
+                if (!ret)
+                        goto finish;
+                atomic_inc(&mm->sram_fallback_cnt);
+                if (AIPU_CONFIG_ENABLE_FALL_BACK_TO_DDR == 0) {
+                        buf_req->errcode = AIPU_ERRCODE_NO_MEMORY;
                         goto finish;
+                }
         }
 #endif
 
@@ -766,6 +816,11 @@ int aipu_mm_alloc(struct aipu_memory_manager *mm, struct buf_request *buf_req,
                 buf_req->errcode = AIPU_ERRCODE_NO_MEMORY;
                 dev_err(mm->dev, "[MM] buffer allocation failed for: bytes 0x%llx, page align %d\n",
                         buf_req->bytes, buf_req->align_in_page);
+                /* enough free bytes but no hole large enough: let userland compact */
+                if (aipu_mm_is_fragmented(mm, buf_req->bytes)) {
+                        atomic_inc(&mm->frag_fail_cnt);
+                        aipu_mm_request_defrag(mm);
+                }
                 goto finish;
         }
 
@@ -773,6 +828,224 @@ finish:
         return ret;
 }
 
+int aipu_mm_migrate(struct aipu_memory_manager *mm, struct buf_request *buf_req,
+        struct aipu_buffer *buf)
+{
+        int ret = 0;
+        int found = 0;
+        int closer = 0;
+        u64 alignment = 0;
+        u64 dst_pa = 0;
+        struct aipu_mem_region *region = NULL;
+        struct aipu_block *src = NULL;
+        struct aipu_block *blk_cand = NULL;
+
+        if ((!mm) || (!buf_req) || (!buf))
+                return -EINVAL;
+
+        if (!buf_req->align_in_page)
+                return -EINVAL;
+
+        memset(buf, 0, sizeof(struct aipu_buffer));
+        buf_req->errcode = AIPU_ERRCODE_NO_ERROR;
+
+        /* SRAM is not compacted; buffer data is copied via the kernel mapping of CMA regions */
+        region = aipu_mm_find_region(mm->ddr_head, buf_req->desc.pa, buf_req->desc.bytes);
+        if ((!region) || (region->type != AIPU_MEM_TYPE_CMA))
+                return 0;
+
+        alignment = buf_req->align_in_page * 4 * 1024;
+
+        mutex_lock(&region->lock);
+        list_for_each_entry(src, &region->blk_head->list, list) {
+                if ((src->pa == buf_req->desc.pa) && (src->bytes == buf_req->desc.bytes) &&
+                    (src->state == AIPU_BLOCK_STATE_ALLOCATED)) {
+                        found = 1;
+                        break;
+                }
+        }
+
+        if (!found) {
+                buf_req->errcode = AIPU_ERRCODE_ITEM_NOT_FOUND;
+                ret = -EINVAL;
+                goto unlock;
+        }
+
+        /**
+         * text/ro/stack are packed from the region start and the other types from
+         * the region end (see aipu_mm_find_block_candidate_no_lock); a buffer is
+         * moved only if the first fitting hole is closer to its packing end, so
+         * that repeated passes converge and the holes merge in the middle.
+         */
+        if (aipu_mm_find_block_candidate_no_lock(region->blk_head, src->bytes, alignment,
+            src->type, &blk_cand, &dst_pa))
+                goto unlock;
+
+        if ((src->type == AIPU_MM_DATA_TYPE_TEXT) || (src->type == AIPU_MM_DATA_TYPE_RO_STACK))
+                closer = (dst_pa < src->pa);
+        else
+                closer = (dst_pa > src->pa);
+        if (!closer)
+                goto unlock;
+
+        if (aipu_mm_split_block_no_lock(blk_cand, dst_pa, src->bytes, src->type, src->tag)) {
+                buf_req->errcode = AIPU_ERRCODE_NO_MEMORY;
+                ret = -ENOMEM;
+                goto unlock;
+        }
+
+        memcpy((void *)((unsigned long)region->va + dst_pa - region->pa),
+                (void *)((unsigned long)region->va + src->pa - region->pa), src->bytes);
+
+        region->tot_free_bytes -= src->bytes;
+        if (region->tot_bytes - region->tot_free_bytes > region->peak_used_bytes)
+                region->peak_used_bytes = region->tot_bytes - region->tot_free_bytes;
+
+        buf->pa = dst_pa;
+        buf->va = (void *)((unsigned long)region->va + dst_pa - region->pa);
+        buf->bytes = src->bytes;
+        buf->region_id = region->id;
+        buf->type = region->type;
+        atomic_inc(&mm->migrate_cnt);
+        atomic64_add(src->bytes, &mm->migrate_bytes);
+        pr_debug("[aipu_mm_migrate] PA 0x%llx -> 0x%llx, size 0x%llx", src->pa, dst_pa, src->bytes);
+
+unlock:
+        mutex_unlock(&region->lock);
+        return ret;
+}
+
+void aipu_mm_request_defrag(struct aipu_memory_manager *mm)
+{
+        if (!mm)
+                return;
+
+        atomic_inc(&mm->defrag_req_seq);
+        dev_info(mm->dev, "[MM] defragmentation requested (seq %d)\n", atomic_read(&mm->defrag_req_seq));
+}
+
+u32 aipu_mm_get_defrag_seq(struct aipu_memory_manager *mm)
+{
+        return mm ? (u32)atomic_read(&mm->defrag_req_seq) : 0;
+}
+
+static const char *get_data_type_name(enum aipu_mm_data_type type)
+{
+        switch (type) {
+        case AIPU_MM_DATA_TYPE_TEXT:
+                return "text";
+        case AIPU_MM_DATA_TYPE_RO_STACK:
+                return "ro/stack";
+        case AIPU_MM_DATA_TYPE_STATIC:
+                return "static";
+        case AIPU_MM_DATA_TYPE_REUSE:
+                return "reuse";
+        default:
+                return "none";
+        }
+}
+
+int aipu_mm_sysfs_sram_show(struct aipu_memory_manager *mm, char *buf)
+{
+        int ret = 0;
+        int size = MAX_CHAR_SYSFS;
+        struct aipu_mem_region *region = NULL;
+        struct aipu_block *blk = NULL;
+
+        if ((!mm) || (!buf))
+                return ret;
+
+        ret += scnprintf(buf + ret, size - ret,
+                "SRAM tier: %s, SRAM ASID mask 0x%x, fall back to DDR: %s\n",
+                AIPU_CONFIG_ENABLE_SRAM ? "enabled" : "disabled", mm->sram_global,
+                AIPU_CONFIG_ENABLE_FALL_BACK_TO_DDR ? "yes" : "no");
+        ret += scnprintf(buf + ret, size - ret, "SRAM requests: %d, fell back to DDR: %d\n",
+                atomic_read(&mm->sram_req_cnt), atomic_read(&mm->sram_fallback_cnt));
+        ret += scnprintf(buf + ret, size - ret,
+                "------------------------------------------------------------------\n");
+        ret += scnprintf(buf + ret, size - ret, "%-8s%-20s%-14s%-14s%-14s\n", "Region", "Base",
+                "Size", "Used", "Peak");
+        ret += scnprintf(buf + ret, size - ret,
+                "------------------------------------------------------------------\n");
+
+        if ((!mm->sram_head) || (!mm->sram_cnt)) {
+                ret += scnprintf(buf + ret, size - ret, "No SRAM region.\n");
+                return ret;
+        }
+
+        list_for_each_entry(region, &mm->sram_head->list, list) {
+                mutex_lock(&region->lock);
+                ret += scnprintf(buf + ret, size - ret, "%-8d0x%-18llx0x%-12llx0x%-12llx0x%-12llx\n",
+                        region->id, region->pa, region->tot_bytes,
+                        region->tot_bytes - region->tot_free_bytes, region->peak_used_bytes);
+                mutex_unlock(&region->lock);
+        }
+
+        /* per-graph placement: tag is the owner graph ID passed by UMD */
+        ret += scnprintf(buf + ret, size - ret,
+                "------------------------------------------------------------------\n");
+        ret += scnprintf(buf + ret, size - ret, "%-8s%-12s%-12s%-10s%-20s%-14s\n", "Region", "PID",
+                "Graph", "Type", "Base", "Size");
+        ret += scnprintf(buf + ret, size - ret,
+                "------------------------------------------------------------------\n");
+        list_for_each_entry(region, &mm->sram_head->list, list) {
+                mutex_lock(&region->lock);
+                list_for_each_entry(blk, &region->blk_head->list, list) {
+                        if (blk->state != AIPU_BLOCK_STATE_ALLOCATED)
+                                continue;
+                        ret += scnprintf(buf + ret, size - ret, "%-8d%-12d0x%-10x%-10s0x%-18llx0x%-12llx\n",
+                                region->id, blk->tid, blk->tag, get_data_type_name(blk->type),
+                                blk->pa, blk->bytes);
+                }
+                mutex_unlock(&region->lock);
+        }
+
+        return ret;
+}
+
+int aipu_mm_sysfs_defrag_show(struct aipu_memory_manager *mm, char *buf)
+{
+        int ret = 0;
+        int size = MAX_CHAR_SYSFS;
+        int free_cnt = 0;
+        u64 largest = 0;
+        u64 frag = 0;
+        struct aipu_mem_region *region = NULL;
+
+        if ((!mm) || (!buf))
+                return ret;
+
+        ret += scnprintf(buf + ret, size - ret,
+                "Defragmentation requests: %d (allocation failures by fragmentation: %d)\n",
+                atomic_read(&mm->defrag_req_seq), atomic_read(&mm->frag_fail_cnt));
+        ret += scnprintf(buf + ret, size - ret, "Migrated buffers: %d, bytes: 0x%llx\n",
+                atomic_read(&mm->migrate_cnt), (u64)atomic64_read(&mm->migrate_bytes));
+        ret += scnprintf(buf + ret, size - ret,
+                "------------------------------------------------------------------------------\n");
+        ret += scnprintf(buf + ret, size - ret, "%-8s%-20s%-14s%-14s%-14s%-8s%-8s\n", "Region",
+                "Base", "Size", "Free", "Largest", "Holes", "Frag(%)");
+        ret += scnprintf(buf + ret, size - ret,
+                "------------------------------------------------------------------------------\n");
+
+        if (!mm->ddr_head)
+                return ret;
+
+        /* fragmentation: share of the free bytes not in the largest free block */
+        list_for_each_entry(region, &mm->ddr_head->list, list) {
+                mutex_lock(&region->lock);
+                largest = aipu_mm_get_largest_free_no_lock(region, &free_cnt);
+                frag = region->tot_free_bytes ?
+                        div64_u64((region->tot_free_bytes - largest) * 100, region->tot_free_bytes) : 0;
+                ret += scnprintf(buf + ret, size - ret, "%-8d0x%-18llx0x%-12llx0x%-12llx0x%-12llx%-8d%-8llu\n",
+                        region->id, region->pa, region->tot_bytes, region->tot_free_bytes,
+                        largest, free_cnt, frag);
+                mutex_unlock(&region->lock);
+        }
+        ret += scnprintf(buf + ret, size - ret, "echo 1 > defrag to request userland compaction\n");
+
+        return ret;
+}
+
 int aipu_mm_free(struct aipu_memory_manager *mm, struct buf_desc *buf)
 {
         int ret = 0;
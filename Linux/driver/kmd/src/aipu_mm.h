@@ -26,6 +26,7 @@
 #include <linux/list.h>
 #include <linux/mutex.h>
 #include <linux/device.h>
+#include <linux/atomic.h>
 #include "aipu_session.h"
 #include "uk_interface/aipu_buf_req.h"
 #include "aipu_buffer.h"
@@ -59,6 +60,7 @@ struct aipu_block {
         u64 pa;
         u64 bytes;
         int tid;
+        u32 tag;
         enum aipu_mm_data_type type;
         enum aipu_blk_state state;
         struct list_head list;
@@ -72,6 +74,7 @@ struct aipu_mem_region {
         void *va;
         u64 tot_bytes;
         u64 tot_free_bytes;
+        u64 peak_used_bytes;
         int flag;
         enum aipu_mem_type type;
         alloc_in_region_t alloc_in_region;
@@ -86,6 +89,12 @@ struct aipu_memory_manager {
         enum aipu_asid sram_global;
         struct device *dev;
         int version;
+        atomic_t sram_req_cnt;
+        atomic_t sram_fallback_cnt;
+        atomic_t defrag_req_seq;
+        atomic_t frag_fail_cnt;
+        atomic_t migrate_cnt;
+        atomic64_t migrate_bytes;
 };
 
 /*
@@ -121,6 +130,33 @@ int aipu_mm_add_region(struct aipu_memory_manager *mm, u64 base, u64 bytes,
  */
 int aipu_mm_alloc(struct aipu_memory_manager *mm, struct buf_request *buf_req,
         struct aipu_buffer *buf);
+/*
+ * @brief migrate an allocated DDR buffer towards the end of its region its data type is
+ *        packed at, if a free block there fits it; the data is copied into the new buffer
+ *        and the source buffer is kept allocated to be freed by the caller
+ *
+ * @param mm: memory manager struct allocated by user
+ * @param buf_req: buffer request struct from userland; desc is the buffer to migrate
+ * @param buf: new buffer descriptor; buf->bytes is 0 if the buffer is not moved
+ *
+ * @return AIPU_ERRCODE_NO_ERROR if successful; others if failed.
+ */
+int aipu_mm_migrate(struct aipu_memory_manager *mm, struct buf_request *buf_req,
+        struct aipu_buffer *buf);
+/*
+ * @brief ask userland to defragment the DDR regions by migrating its idle buffers
+ *
+ * @param mm: memory manager struct allocated by user
+ */
+void aipu_mm_request_defrag(struct aipu_memory_manager *mm);
+/*
+ * @brief get the number of defragmentation requests issued so far
+ *
+ * @param mm: memory manager struct allocated by user
+ *
+ * @return request sequence number
+ */
+u32 aipu_mm_get_defrag_seq(struct aipu_memory_manager *mm);
 /*
  * @brief free buffer allocated by aipu_mm_alloc
  *
@@ -148,5 +184,23 @@ int aipu_mm_free_session_buffers(struct aipu_memory_manager *mm,
  * @return void
  */
 void aipu_deinit_mm(struct aipu_memory_manager *mm);
+/*
+ * @brief show SRAM occupancy, placement counters and the buffers placed in SRAM
+ *
+ * @param mm: memory manager struct allocated by user
+ * @param buf: sysfs buffer of MAX_CHAR_SYSFS bytes
+ *
+ * @return number of characters written
+ */
+int aipu_mm_sysfs_sram_show(struct aipu_memory_manager *mm, char *buf);
+/*
+ * @brief show fragmentation of the DDR regions and the defragmentation counters
+ *
+ * @param mm: memory manager struct allocated by user
+ * @param buf: sysfs buffer of MAX_CHAR_SYSFS bytes
+ *
+ * @return number of characters written
+ */
+int aipu_mm_sysfs_defrag_show(struct aipu_memory_manager *mm, char *buf);
 
 #endif /* _AIPU_MM_H_ */
\ No newline at end of file
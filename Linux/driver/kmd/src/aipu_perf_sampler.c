@@ -0,0 +1,208 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_perf_sampler.c
+ * Performance counter sampler module implementation file
+ */
+
+#include <linux/vmalloc.h>
+#include <linux/mm.h>
+#include <linux/ktime.h>
+#include <linux/compiler.h>
+#include "aipu_perf_sampler.h"
+#include "aipu.h"
+
+static void take_sample(struct aipu_priv *aipu, struct aipu_sample *sample)
+{
+        struct profiling_data pdata;
+        struct aipu_io_req io_req;
+
+        memset(sample, 0, sizeof(*sample));
+        sample->ts_ns = ktime_get_ns();
+        sample->sched_num = READ_ONCE(aipu->job_manager.sched_num);
+
+        /* registers are not accessible while AIPU is suspended or in reset */
+        if (aipu->is_suspend || aipu->is_reset || (!aipu->core0)) {
+                sample->flags = AIPU_SAMPLE_FLAG_POWER_OFF;
+                return;
+        }
+
+        io_req.rw = AIPU_IO_READ;
+        io_req.offset = 0x4;
+        aipu_priv_io_rw(aipu, &io_req);
+        sample->status_reg = io_req.value;
+        if (!aipu_priv_is_idle(aipu))
+                sample->flags |= AIPU_SAMPLE_FLAG_BUSY;
+
+        if (!aipu->soc)
+                return;
+
+        memset(&pdata, 0, sizeof(pdata));
+        aipu_priv_read_profiling_reg(aipu, &pdata);
+        if (pdata.valid_mask & AIPU_PROFILING_VALID_BW) {
+                sample->rdata_tot = ((u64)pdata.rdata_tot_msb << 32) + pdata.rdata_tot_lsb;
+                sample->wdata_tot = ((u64)pdata.wdata_tot_msb << 32) + pdata.wdata_tot_lsb;
+                sample->tot_cycle = ((u64)pdata.tot_cycle_msb << 32) + pdata.tot_cycle_lsb;
+                sample->flags |= AIPU_SAMPLE_FLAG_BW_VALID;
+        }
+        if (pdata.valid_mask & AIPU_PROFILING_VALID_DMA) {
+                sample->dma_latency_tot = ((u64)pdata.dma_latency_tot_msb << 32) +
+                        pdata.dma_latency_tot_lsb;
+                sample->max_outstanding = pdata.max_outstanding;
+                sample->flags |= AIPU_SAMPLE_FLAG_DMA_VALID;
+        }
+}
+
+static enum hrtimer_restart sampler_timer_fn(struct hrtimer *timer)
+{
+        struct aipu_perf_sampler *sampler = container_of(timer, struct aipu_perf_sampler, timer);
+        struct aipu_priv *aipu = container_of(sampler, struct aipu_priv, sampler);
+        struct aipu_sampler_header *hdr = sampler->ring;
+        struct aipu_sample *samples = (struct aipu_sample *)((char *)hdr + hdr->data_offset);
+        u64 head = hdr->head;
+
+        /* single producer: fill the slot, then publish it */
+        take_sample(aipu, &samples[head & (hdr->capacity - 1)]);
+        smp_wmb();
+        WRITE_ONCE(hdr->head, head + 1);
+
+        hrtimer_forward_now(timer, ns_to_ktime(sampler->period_ns));
+        return HRTIMER_RESTART;
+}
+
+static int alloc_ring_no_lock(struct aipu_perf_sampler *sampler)
+{
+        struct aipu_sampler_header *hdr = NULL;
+        size_t size = PAGE_ALIGN(sizeof(struct aipu_sampler_header) +
+                AIPU_SAMPLER_RING_SAMPLES * sizeof(struct aipu_sample));
+
+        if (sampler->ring)
+                return 0;
+
+        /* zeroed and page aligned for remap_vmalloc_range */
+        hdr = vmalloc_user(size);
+        if (!hdr)
+                return -ENOMEM;
+
+        hdr->magic = AIPU_SAMPLER_MAGIC;
+        hdr->version = AIPU_SAMPLER_VERSION;
+        hdr->sample_size = sizeof(struct aipu_sample);
+        hdr->capacity = AIPU_SAMPLER_RING_SAMPLES;
+        hdr->data_offset = sizeof(struct aipu_sampler_header);
+        sampler->ring = hdr;
+        sampler->ring_size = size;
+        return 0;
+}
+
+void aipu_init_perf_sampler(struct aipu_perf_sampler *sampler)
+{
+        if (!sampler)
+                return;
+
+        hrtimer_init(&sampler->timer, CLOCK_MONOTONIC, HRTIMER_MODE_REL);
+        sampler->timer.function = sampler_timer_fn;
+        sampler->ring = NULL;
+        sampler->ring_size = 0;
+        sampler->period_ns = 0;
+        mutex_init(&sampler->lock);
+}
+
+void aipu_deinit_perf_sampler(struct aipu_perf_sampler *sampler)
+{
+        if ((!sampler) || (!sampler->timer.function))
+                return;
+
+        mutex_lock(&sampler->lock);
+        hrtimer_cancel(&sampler->timer);
+        sampler->period_ns = 0;
+        /* pages stay alive for existing userland mappings until they are unmapped */
+        vfree(sampler->ring);
+        sampler->ring = NULL;
+        mutex_unlock(&sampler->lock);
+}
+
+int aipu_perf_sampler_set_period(struct aipu_perf_sampler *sampler, u64 period_us)
+{
+        int ret = 0;
+        struct aipu_priv *aipu = NULL;
+
+        if (!sampler)
+                return -EINVAL;
+
+        if (period_us && (period_us < AIPU_SAMPLER_MIN_PERIOD_US))
+                return -EINVAL;
+
+        aipu = container_of(sampler, struct aipu_priv, sampler);
+
+        mutex_lock(&sampler->lock);
+        hrtimer_cancel(&sampler->timer);
+        if (!period_us) {
+                sampler->period_ns = 0;
+                if (sampler->ring)
+                        WRITE_ONCE(sampler->ring->period_ns, 0);
+                goto unlock;
+        }
+
+        ret = alloc_ring_no_lock(sampler);
+        if (ret)
+                goto unlock;
+
+        /* counters are shared with per-job profiling, which restarts them as well */
+        aipu_priv_start_bw_profiling(aipu);
+        sampler->period_ns = period_us * NSEC_PER_USEC;
+        WRITE_ONCE(sampler->ring->period_ns, sampler->period_ns);
+        hrtimer_start(&sampler->timer, ns_to_ktime(sampler->period_ns), HRTIMER_MODE_REL);
+
+unlock:
+        mutex_unlock(&sampler->lock);
+        return ret;
+}
+
+bool aipu_perf_sampler_is_running(struct aipu_perf_sampler *sampler)
+{
+        return sampler && READ_ONCE(sampler->period_ns);
+}
+
+int aipu_perf_sampler_mmap(struct aipu_perf_sampler *sampler, struct vm_area_struct *vma)
+{
+        int ret = 0;
+
+        if ((!sampler) || (!vma))
+                return -EINVAL;
+
+        if (vma->vm_flags & VM_WRITE)
+                return -EPERM;
+
+        mutex_lock(&sampler->lock);
+        if (!sampler->ring) {
+                ret = -ENODEV;
+                goto unlock;
+        }
+
+        if ((vma->vm_pgoff) || (vma->vm_end - vma->vm_start > sampler->ring_size)) {
+                ret = -EINVAL;
+                goto unlock;
+        }
+
+        vma->vm_flags &= ~VM_MAYWRITE;
+        ret = remap_vmalloc_range(vma, sampler->ring, 0);
+
+unlock:
+        mutex_unlock(&sampler->lock);
+        return ret;
+}
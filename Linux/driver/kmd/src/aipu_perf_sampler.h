@@ -0,0 +1,90 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_perf_sampler.h
+ * Performance counter sampler module header file
+ */
+
+#ifndef _AIPU_PERF_SAMPLER_H_
+#define _AIPU_PERF_SAMPLER_H_
+
+#include <linux/hrtimer.h>
+#include <linux/mutex.h>
+#include <linux/mm_types.h>
+#include "uk_interface/aipu_sampler.h"
+
+#define AIPU_SAMPLER_RING_SAMPLES     16384 /* must be a power of 2 */
+#define AIPU_SAMPLER_MIN_PERIOD_US    100
+
+/**
+ * struct aipu_perf_sampler - hrtimer driven AIPU/SoC counter sampler
+ * @timer: sampling timer
+ * @ring: ring header; samples follow it; allocated on first start and kept until remove
+ *        because it may be mmapped by userland
+ * @ring_size: ring allocation size (page aligned)
+ * @period_ns: sampling period; 0 if stopped
+ * @lock: mutex lock serializing start/stop/mmap
+ */
+struct aipu_perf_sampler {
+        struct hrtimer timer;
+        struct aipu_sampler_header *ring;
+        size_t ring_size;
+        u64 period_ns;
+        struct mutex lock;
+};
+
+/**
+ * @brief initialize a sampler in probe
+ *
+ * @param sampler: sampler struct pointer
+ */
+void aipu_init_perf_sampler(struct aipu_perf_sampler *sampler);
+/**
+ * @brief stop sampling and free the ring in remove
+ *
+ * @param sampler: sampler struct pointer
+ */
+void aipu_deinit_perf_sampler(struct aipu_perf_sampler *sampler);
+/**
+ * @brief start/restart sampling at a new period, or stop sampling
+ *
+ * @param sampler: sampler struct pointer
+ * @param period_us: sampling period in us; 0 to stop
+ *
+ * @return 0 if successful; others if failed.
+ */
+int aipu_perf_sampler_set_period(struct aipu_perf_sampler *sampler, u64 period_us);
+/**
+ * @brief check if sampling is on
+ *
+ * @param sampler: sampler struct pointer
+ *
+ * @return true if sampling
+ */
+bool aipu_perf_sampler_is_running(struct aipu_perf_sampler *sampler);
+/**
+ * @brief map the ring into userland read-only
+ *
+ * @param sampler: sampler struct pointer
+ * @param vma: vm_area_struct
+ *
+ * @return 0 if successful; others if failed.
+ */
+int aipu_perf_sampler_mmap(struct aipu_perf_sampler *sampler, struct vm_area_struct *vma);
+
+#endif /* _AIPU_PERF_SAMPLER_H_ */
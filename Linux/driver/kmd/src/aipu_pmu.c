@@ -0,0 +1,318 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_pmu.c
+ * perf PMU of AIPU/SoC counters module implementation file
+ */
+
+#include <linux/cpumask.h>
+#include <linux/device.h>
+#include <linux/string.h>
+#include <linux/sysfs.h>
+#include "aipu_pmu.h"
+#include "aipu.h"
+
+#ifdef AIPU_ENABLE_PMU
+
+#define to_aipu_pmu(p) container_of(p, struct aipu_pmu, pmu)
+#define pmu_to_aipu(p) container_of(to_aipu_pmu(p), struct aipu_priv, pmu)
+
+/**
+ * @brief read the current value of a counter
+ *
+ * @return true if read; false if the counter is not accessible now
+ */
+static bool aipu_pmu_read_counter(struct aipu_priv *aipu, u64 config, u64 *value)
+{
+        struct profiling_data pdata;
+        int id = 0;
+
+        if (config == AIPU_PMU_EVT_JOBS) {
+                *value = atomic64_read(&aipu->pmu.jobs);
+                return true;
+        }
+
+        /* registers are not accessible while AIPU is suspended or in reset */
+        if (aipu->is_suspend || aipu->is_reset || (!aipu->soc))
+                return false;
+
+        memset(&pdata, 0, sizeof(pdata));
+        aipu_priv_read_profiling_reg(aipu, &pdata);
+        switch (config) {
+        case AIPU_PMU_EVT_CYCLES:
+                *value = ((u64)pdata.tot_cycle_msb << 32) + pdata.tot_cycle_lsb;
+                return pdata.valid_mask & AIPU_PROFILING_VALID_BW;
+        case AIPU_PMU_EVT_RDATA:
+                *value = ((u64)pdata.rdata_tot_msb << 32) + pdata.rdata_tot_lsb;
+                return pdata.valid_mask & AIPU_PROFILING_VALID_BW;
+        case AIPU_PMU_EVT_WDATA:
+                *value = ((u64)pdata.wdata_tot_msb << 32) + pdata.wdata_tot_lsb;
+                return pdata.valid_mask & AIPU_PROFILING_VALID_BW;
+        case AIPU_PMU_EVT_DMA_LATENCY:
+                *value = ((u64)pdata.dma_latency_tot_msb << 32) + pdata.dma_latency_tot_lsb;
+                return pdata.valid_mask & AIPU_PROFILING_VALID_DMA;
+        case AIPU_PMU_EVT_DMA_RDATA:
+                *value = ((u64)pdata.dma_rdata_tot_msb << 32) + pdata.dma_rdata_tot_lsb;
+                return pdata.valid_mask & AIPU_PROFILING_VALID_DMA;
+        case AIPU_PMU_EVT_DMA_AR_HANDSHAKE:
+                *value = ((u64)pdata.dma_ar_handshake_msb << 32) + pdata.dma_ar_handshake_lsb;
+                return pdata.valid_mask & AIPU_PROFILING_VALID_DMA;
+        default:
+                break;
+        }
+
+        id = config - AIPU_PMU_EVT_ID_LATENCY_BASE;
+        *value = ((u64)pdata.latency_tot_id_msb[id] << 32) + pdata.latency_tot_id_lsb[id];
+        return pdata.valid_mask & AIPU_PROFILING_VALID_ID_LAT;
+}
+
+static void aipu_pmu_event_update(struct perf_event *event)
+{
+        struct aipu_priv *aipu = pmu_to_aipu(event->pmu);
+        u64 prev = local64_read(&event->hw.prev_count);
+        u64 now = 0;
+
+        if (!aipu_pmu_read_counter(aipu, event->attr.config, &now))
+                return;
+
+        local64_set(&event->hw.prev_count, now);
+        /* SoC counters are restarted by per-job profiling; count from 0 then */
+        local64_add((now >= prev) ? (now - prev) : now, &event->count);
+}
+
+static int aipu_pmu_event_init(struct perf_event *event)
+{
+        struct aipu_pmu *pmu = to_aipu_pmu(event->pmu);
+
+        if (event->attr.type != event->pmu->type)
+                return -ENOENT;
+
+        /* no overflow interrupt and no per-task counting for a device-wide counter */
+        if (is_sampling_event(event) || (event->attach_state & PERF_ATTACH_TASK))
+                return -EOPNOTSUPP;
+
+        if (event->cpu < 0)
+                return -EOPNOTSUPP;
+
+        if ((event->attr.config >= AIPU_PMU_EVT_MAX) ||
+            ((event->attr.config > AIPU_PMU_EVT_JOBS) &&
+             (event->attr.config < AIPU_PMU_EVT_ID_LATENCY_BASE)))
+                return -EINVAL;
+
+        event->cpu = pmu->cpu;
+        return 0;
+}
+
+static void aipu_pmu_event_start(struct perf_event *event, int flags)
+{
+        struct aipu_priv *aipu = pmu_to_aipu(event->pmu);
+        u64 now = 0;
+
+        if (aipu_pmu_read_counter(aipu, event->attr.config, &now))
+                local64_set(&event->hw.prev_count, now);
+        else
+                local64_set(&event->hw.prev_count, 0);
+        event->hw.state = 0;
+}
+
+static void aipu_pmu_event_stop(struct perf_event *event, int flags)
+{
+        if (event->hw.state & PERF_HES_STOPPED)
+                return;
+
+        if (flags & PERF_EF_UPDATE)
+                aipu_pmu_event_update(event);
+        event->hw.state |= PERF_HES_STOPPED | PERF_HES_UPTODATE;
+}
+
+static int aipu_pmu_event_add(struct perf_event *event, int flags)
+{
+        struct aipu_priv *aipu = pmu_to_aipu(event->pmu);
+
+        /* the first event starts the SoC counters unless the sampler has done that */
+        if ((atomic_inc_return(&aipu->pmu.active) == 1) &&
+            (!aipu_perf_sampler_is_running(&aipu->sampler)) &&
+            (!aipu->is_suspend) && (!aipu->is_reset))
+                aipu_priv_start_bw_profiling(aipu);
+
+        event->hw.state = PERF_HES_STOPPED | PERF_HES_UPTODATE;
+        if (flags & PERF_EF_START)
+                aipu_pmu_event_start(event, flags);
+        return 0;
+}
+
+static void aipu_pmu_event_del(struct perf_event *event, int flags)
+{
+        struct aipu_priv *aipu = pmu_to_aipu(event->pmu);
+
+        aipu_pmu_event_stop(event, PERF_EF_UPDATE);
+        atomic_dec(&aipu->pmu.active);
+}
+
+static void aipu_pmu_event_read(struct perf_event *event)
+{
+        aipu_pmu_event_update(event);
+}
+
+static ssize_t aipu_pmu_cpumask_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+        struct aipu_pmu *pmu = to_aipu_pmu(dev_get_drvdata(dev));
+
+        return cpumap_print_to_pagebuf(true, buf, cpumask_of(pmu->cpu));
+}
+
+static DEVICE_ATTR(cpumask, 0444, aipu_pmu_cpumask_show, NULL);
+
+static struct attribute *aipu_pmu_cpumask_attrs[] = {
+        &dev_attr_cpumask.attr,
+        NULL,
+};
+
+static const struct attribute_group aipu_pmu_cpumask_group = {
+        .attrs = aipu_pmu_cpumask_attrs,
+};
+
+PMU_FORMAT_ATTR(event, "config:0-7");
+
+static struct attribute *aipu_pmu_format_attrs[] = {
+        &format_attr_event.attr,
+        NULL,
+};
+
+static const struct attribute_group aipu_pmu_format_group = {
+        .name = "format",
+        .attrs = aipu_pmu_format_attrs,
+};
+
+#define AIPU_PMU_EVENT_ATTR(_name, _config) \
+        PMU_EVENT_ATTR_STRING(_name, aipu_pmu_evt_##_name, "event=" #_config)
+
+AIPU_PMU_EVENT_ATTR(cycles, 0x00);
+AIPU_PMU_EVENT_ATTR(rdata_bytes, 0x01);
+AIPU_PMU_EVENT_ATTR(wdata_bytes, 0x02);
+AIPU_PMU_EVENT_ATTR(dma_latency, 0x03);
+AIPU_PMU_EVENT_ATTR(dma_rdata_bytes, 0x04);
+AIPU_PMU_EVENT_ATTR(dma_ar_handshakes, 0x05);
+AIPU_PMU_EVENT_ATTR(jobs, 0x06);
+AIPU_PMU_EVENT_ATTR(latency_id0, 0x10);
+AIPU_PMU_EVENT_ATTR(latency_id1, 0x11);
+AIPU_PMU_EVENT_ATTR(latency_id2, 0x12);
+AIPU_PMU_EVENT_ATTR(latency_id3, 0x13);
+AIPU_PMU_EVENT_ATTR(latency_id4, 0x14);
+AIPU_PMU_EVENT_ATTR(latency_id5, 0x15);
+AIPU_PMU_EVENT_ATTR(latency_id6, 0x16);
+AIPU_PMU_EVENT_ATTR(latency_id7, 0x17);
+AIPU_PMU_EVENT_ATTR(latency_id8, 0x18);
+AIPU_PMU_EVENT_ATTR(latency_id9, 0x19);
+AIPU_PMU_EVENT_ATTR(latency_id10, 0x1a);
+AIPU_PMU_EVENT_ATTR(latency_id11, 0x1b);
+AIPU_PMU_EVENT_ATTR(latency_id12, 0x1c);
+AIPU_PMU_EVENT_ATTR(latency_id13, 0x1d);
+AIPU_PMU_EVENT_ATTR(latency_id14, 0x1e);
+AIPU_PMU_EVENT_ATTR(latency_id15, 0x1f);
+
+static struct attribute *aipu_pmu_event_attrs[] = {
+        &aipu_pmu_evt_cycles.attr.attr,
+        &aipu_pmu_evt_rdata_bytes.attr.attr,
+        &aipu_pmu_evt_wdata_bytes.attr.attr,
+        &aipu_pmu_evt_dma_latency.attr.attr,
+        &aipu_pmu_evt_dma_rdata_bytes.attr.attr,
+        &aipu_pmu_evt_dma_ar_handshakes.attr.attr,
+        &aipu_pmu_evt_jobs.attr.attr,
+        &aipu_pmu_evt_latency_id0.attr.attr,
+        &aipu_pmu_evt_latency_id1.attr.attr,
+        &aipu_pmu_evt_latency_id2.attr.attr,
+        &aipu_pmu_evt_latency_id3.attr.attr,
+        &aipu_pmu_evt_latency_id4.attr.attr,
+        &aipu_pmu_evt_latency_id5.attr.attr,
+        &aipu_pmu_evt_latency_id6.attr.attr,
+        &aipu_pmu_evt_latency_id7.attr.attr,
+        &aipu_pmu_evt_latency_id8.attr.attr,
+        &aipu_pmu_evt_latency_id9.attr.attr,
+        &aipu_pmu_evt_latency_id10.attr.attr,
+        &aipu_pmu_evt_latency_id11.attr.attr,
+        &aipu_pmu_evt_latency_id12.attr.attr,
+        &aipu_pmu_evt_latency_id13.attr.attr,
+        &aipu_pmu_evt_latency_id14.attr.attr,
+        &aipu_pmu_evt_latency_id15.attr.attr,
+        NULL,
+};
+
+static const struct attribute_group aipu_pmu_events_group = {
+        .name = "events",
+        .attrs = aipu_pmu_event_attrs,
+};
+
+static const struct attribute_group *aipu_pmu_attr_groups[] = {
+        &aipu_pmu_format_group,
+        &aipu_pmu_events_group,
+        &aipu_pmu_cpumask_group,
+        NULL,
+};
+
+int aipu_create_pmu(void *aipu_priv)
+{
+        int ret = 0;
+        struct aipu_priv *aipu = (struct aipu_priv *)aipu_priv;
+
+        if (!aipu)
+                return -EINVAL;
+
+        memset(&aipu->pmu, 0, sizeof(aipu->pmu));
+        atomic_set(&aipu->pmu.active, 0);
+        atomic64_set(&aipu->pmu.jobs, 0);
+        aipu->pmu.cpu = cpumask_first(cpu_online_mask);
+        aipu->pmu.pmu = (struct pmu) {
+                .module = THIS_MODULE,
+                .task_ctx_nr = perf_invalid_context,
+                .attr_groups = aipu_pmu_attr_groups,
+                .event_init = aipu_pmu_event_init,
+                .add = aipu_pmu_event_add,
+                .del = aipu_pmu_event_del,
+                .start = aipu_pmu_event_start,
+                .stop = aipu_pmu_event_stop,
+                .read = aipu_pmu_event_read,
+                .capabilities = PERF_PMU_CAP_NO_INTERRUPT,
+        };
+
+        ret = perf_pmu_register(&aipu->pmu.pmu, "aipu", -1);
+        if (ret) {
+                /* perf is for profiling only and its absence should not fail probe */
+                dev_warn(aipu->dev, "register perf PMU failed (%d)\n", ret);
+                return 0;
+        }
+
+        aipu->pmu.registered = 1;
+        return 0;
+}
+
+void aipu_destroy_pmu(void *aipu_priv)
+{
+        struct aipu_priv *aipu = (struct aipu_priv *)aipu_priv;
+
+        if (aipu && aipu->pmu.registered) {
+                perf_pmu_unregister(&aipu->pmu.pmu);
+                aipu->pmu.registered = 0;
+        }
+}
+
+bool aipu_pmu_is_active(struct aipu_pmu *pmu)
+{
+        return pmu && atomic_read(&pmu->active);
+}
+#endif /* AIPU_ENABLE_PMU */
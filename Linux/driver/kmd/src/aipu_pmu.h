@@ -0,0 +1,93 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_pmu.h
+ * perf PMU of AIPU/SoC counters module header file
+ *
+ * Usage: perf stat -a -e aipu/rdata_bytes/,aipu/wdata_bytes/,aipu/cycles/ <cmd>
+ * Counters are device-wide: AIPU runs jobs asynchronously to the CPU threads submitting
+ * them, so only system-wide (per-CPU, no task) counting is supported.
+ */
+
+#ifndef _AIPU_PMU_H_
+#define _AIPU_PMU_H_
+
+#include <linux/perf_event.h>
+#include <linux/atomic.h>
+
+enum aipu_pmu_event {
+        AIPU_PMU_EVT_CYCLES = 0x0,
+        AIPU_PMU_EVT_RDATA = 0x1,
+        AIPU_PMU_EVT_WDATA = 0x2,
+        AIPU_PMU_EVT_DMA_LATENCY = 0x3,
+        AIPU_PMU_EVT_DMA_RDATA = 0x4,
+        AIPU_PMU_EVT_DMA_AR_HANDSHAKE = 0x5,
+        AIPU_PMU_EVT_JOBS = 0x6,
+        AIPU_PMU_EVT_ID_LATENCY_BASE = 0x10, /* 0x10 ~ 0x1f: latency total of AXI ID 0 ~ 15 */
+        AIPU_PMU_EVT_MAX = 0x20,
+};
+
+/**
+ * struct aipu_pmu - AIPU perf PMU
+ * @pmu: perf pmu struct
+ * @cpu: the CPU all events are bound to
+ * @active: number of events added
+ * @jobs: number of jobs ended, a software counter
+ * @registered: registered to perf or not
+ */
+struct aipu_pmu {
+        struct pmu pmu;
+        int cpu;
+        atomic_t active;
+        atomic64_t jobs;
+        int registered;
+};
+
+/**
+ * @brief register the AIPU PMU to perf in probe
+ *
+ * @param aipu_priv: aipu_priv struct pointer
+ *
+ * @return 0 if successful; others if failed.
+ */
+int aipu_create_pmu(void *aipu_priv);
+/**
+ * @brief unregister the AIPU PMU in remove
+ *
+ * @param aipu_priv: aipu_priv struct pointer
+ */
+void aipu_destroy_pmu(void *aipu_priv);
+/**
+ * @brief check if any perf event is counting
+ *
+ * @param pmu: pmu struct pointer
+ *
+ * @return true if counting
+ */
+bool aipu_pmu_is_active(struct aipu_pmu *pmu);
+/**
+ * @brief count an ended job
+ *
+ * @param pmu: pmu struct pointer
+ */
+static inline void aipu_pmu_count_job(struct aipu_pmu *pmu)
+{
+        atomic64_inc(&pmu->jobs);
+}
+
+#endif /* _AIPU_PMU_H_ */
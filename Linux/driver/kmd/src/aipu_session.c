@@ -29,6 +29,7 @@
 #include "aipu_session.h"
 #include "aipu_mm.h"
 #include "aipu.h"
+#include "aipu_debugfs.h"
 #include "log.h"
 
 static void init_session_buf(struct session_buf *buf,
@@ -221,6 +222,11 @@ int aipu_create_session(int pid, void *aipu_priv,
         session->wait_queue_head = create_thread_wait_queue_no_lock(NULL, 0);
         init_waitqueue_head(&session->com_wait);
         session->single_thread_poll = 0;
+        aipu_latency_init(&session->lat_stats);
+        session->debugfs_lat = NULL;
+#ifdef AIPU_ENABLE_DEBUGFS
+        aipu_debugfs_add_session(aipu_priv, session);
+#endif
 
         *p_session = session;
         dev_dbg(dev, "[%d] new session created\n", pid);
@@ -240,6 +246,9 @@ int aipu_destroy_session(struct aipu_session *session)
             is_session_all_buffers_freed(session)) {
                 dev = ((struct aipu_priv*)session->aipu_priv)->dev;
                 pid = session->user_pid;
+#ifdef AIPU_ENABLE_DEBUGFS
+                aipu_debugfs_remove_session(session);
+#endif
                 delete_wait_queue(session->wait_queue_head);
                 kfree(session->wait_queue_head);
                 kfree(session);
@@ -301,6 +310,8 @@ int aipu_session_add_buf(struct aipu_session *session,
                 buf_req->desc.dev_offset = buf->pa;
                 buf_req->desc.bytes = buf->bytes;
                 buf_req->desc.region_id = buf->region_id;
+                buf_req->desc.placement = (buf->type == AIPU_MEM_TYPE_SRAM) ?
+                        AIPU_MEM_PLACEMENT_SRAM : AIPU_MEM_PLACEMENT_DDR;
                 buf_req->errcode = AIPU_ERRCODE_NO_ERROR;
                 mutex_unlock(&session->sbuf_lock);
         }
@@ -343,6 +354,23 @@ finish:
         return ret;
 }
 
+int aipu_session_check_buf(struct aipu_session *session, struct buf_desc *buf_desc)
+{
+        int ret = AIPU_ERRCODE_NO_ERROR;
+
+        if ((!session) || (!buf_desc)) {
+                LOG(LOG_ERR, "invalid input session or buf args to be null!");
+                return map_errcode(AIPU_ERRCODE_INTERNAL_NULLPTR);
+        }
+
+        mutex_lock(&session->sbuf_lock);
+        if (!find_buffer_bydesc_no_lock(session, buf_desc))
+                ret = map_errcode(AIPU_ERRCODE_ITEM_NOT_FOUND);
+        mutex_unlock(&session->sbuf_lock);
+
+        return ret;
+}
+
 int aipu_session_mmap_buf(struct aipu_session *session, struct vm_area_struct *vma, struct device *dev)
 {
         int ret = AIPU_ERRCODE_NO_ERROR;
@@ -509,7 +537,7 @@ void aipu_session_job_done(struct aipu_session *session, struct session_job *job
         /* IRQ LOCK */
         spin_lock(&session->job_lock);
         job->state = AIPU_JOB_STATE_END;
-        job->exception_type = AIPU_EXCEP_NO_EXCEPTION;
+        job->exception_type = excep_flag;
 
         if (session->single_thread_poll) {
                 queue = get_thread_wait_queue_no_lock(session->wait_queue_head,
@@ -561,6 +589,7 @@ void aipu_session_job_update_pdata(struct aipu_session *session, struct session_
  *  -- aipu_session_query_pdata                                                 *
  *  -- aipu_session_thread_has_end_job                                          *
  *  -- aipu_session_get_job_status                                              *
+ *  -- aipu_session_is_job_failed                                               *
  ********************************************************************************/
 int aipu_session_thread_has_end_job(struct aipu_session *session, int uthread_id)
 {
@@ -608,6 +637,28 @@ finish:
         return ret;
 }
 
+int aipu_session_is_job_failed(struct aipu_session *session, u32 job_id)
+{
+        int ret = 0;
+        struct session_job *cursor = NULL;
+
+        if (!session)
+                return 0;
+
+        /* called by job manager with IRQ disabled */
+        spin_lock(&session->job_lock);
+        list_for_each_entry(cursor, &session->job_list.head, head) {
+                if (cursor->desc.job_id == job_id) {
+                        ret = (cursor->state == AIPU_JOB_STATE_END) &&
+                                (cursor->exception_type != AIPU_EXCEP_NO_EXCEPTION);
+                        break;
+                }
+        }
+        spin_unlock(&session->job_lock);
+
+        return ret;
+}
+
 int aipu_session_get_job_status(struct aipu_session *session, struct job_status_query *job_status)
 {
         int ret = AIPU_ERRCODE_NO_ERROR;
@@ -616,6 +667,8 @@ int aipu_session_get_job_status(struct aipu_session *session, struct job_status_
         struct session_job *cursor = NULL;
         struct session_job *next = NULL;
         int poll_iter = 0;
+        struct aipu_priv *aipu = NULL;
+        u64 now_ns = 0;
 
         if ((!session) || (!job_status)) {
                 LOG(LOG_ERR, "invalid input session or excep args to be null!");
@@ -640,6 +693,8 @@ int aipu_session_get_job_status(struct aipu_session *session, struct job_status_
                 goto finish;
         }
 
+        aipu = (struct aipu_priv *)session->aipu_priv;
+        now_ns = ktime_get_ns();
         job_status->poll_cnt = 0;
         spin_lock(&session->job_lock);
         list_for_each_entry_safe(cursor, next, &session->job_list.head, head) {
@@ -655,6 +710,13 @@ int aipu_session_get_job_status(struct aipu_session *session, struct job_status_
                         status[poll_iter].state = (cursor->exception_type == AIPU_EXCEP_NO_EXCEPTION) ?
                                 AIPU_JOB_STATE_DONE : AIPU_JOB_STATE_EXCEPTION;
                         status[poll_iter].pdata = cursor->pdata;
+                        status[poll_iter].ts = cursor->ts;
+                        if (cursor->ts.irq_ns) {
+                                aipu_latency_record(&session->lat_stats, AIPU_LAT_DELIVERY,
+                                        now_ns - cursor->ts.irq_ns);
+                                aipu_latency_record(&aipu->lat_stats, AIPU_LAT_DELIVERY,
+                                        now_ns - cursor->ts.irq_ns);
+                        }
 
                         /* remove status from kernel */
                         list_del(&cursor->head);
@@ -37,6 +37,7 @@
 #include "uk_interface/aipu_job_status.h"
 #include "aipu_buffer.h"
 #include "aipu_thread_waitqueue.h"
+#include "aipu_latency.h"
 
 /**
  * struct session_buf: session private buffer list
@@ -64,6 +65,7 @@ struct session_buf {
  * @head: list head struct
  * @sched_time: job scheduled time (in ns)
  * @done_time: job done time (in ns)
+ * @ts: job timestamps reported to userland for timeline tracing
  */
 struct session_job {
         int uthread_id;
@@ -74,6 +76,7 @@ struct session_job {
         struct list_head head;
         ktime_t sched_time;
         ktime_t done_time;
+        struct job_timestamps ts;
 };
 
 /**
@@ -87,6 +90,8 @@ struct session_job {
  * @wait_queue_head: thread waitqueue list head of this session
  * @com_wait: session common waitqueue head
  * @single_thread_poll: flag to indicate the polling method, thread vs. fd
+ * @lat_stats: latency histograms of the jobs of this session
+ * @debugfs_lat: debugfs file of lat_stats
  */
 struct aipu_session {
         int user_pid;
@@ -98,6 +103,8 @@ struct aipu_session {
         struct aipu_thread_wait_queue *wait_queue_head;
         wait_queue_head_t com_wait;
         int single_thread_poll;
+        struct aipu_latency_stats lat_stats;
+        struct dentry *debugfs_lat;
 };
 
 /*
@@ -147,6 +154,15 @@ int aipu_session_add_buf(struct aipu_session *session, struct buf_request *buf_r
  * @return AIPU_KMD_ERR_OK if successful; others if failed.
  */
 int aipu_session_detach_buf(struct aipu_session *session, struct buf_desc *buf);
+/*
+ * @brief check if a buffer is allocated by this session
+ *
+ * @param session: session pointer
+ * @param buf: buffer to be checked
+ *
+ * @return AIPU_KMD_ERR_OK if the buffer belongs to this session; others if not.
+ */
+int aipu_session_check_buf(struct aipu_session *session, struct buf_desc *buf);
 /*
  * @brief mmap an allocated buffer of this session
  *
@@ -209,6 +225,15 @@ void aipu_session_job_update_pdata(struct aipu_session *session, struct session_
  * @return 1 if has don job(s); 0 if no.
  */
 int aipu_session_thread_has_end_job(struct aipu_session *session, int uthread_id);
+/*
+ * @brief check if a job of this session has ended with exception
+ *
+ * @param session: session pointer
+ * @param job_id: job ID
+ *
+ * @return 1 if the job ended with exception; 0 if not ended, done or not found.
+ */
+int aipu_session_is_job_failed(struct aipu_session *session, u32 job_id);
 /*
  * @brief get one or multiple end jobs' status
  *
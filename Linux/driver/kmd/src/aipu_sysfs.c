@@ -289,9 +289,40 @@ static ssize_t sysfs_aipu_job_show(struct device *dev, struct device_attribute *
         return aipu_job_manager_sysfs_job_show(&aipu->job_manager, buf);
 }
 
+static ssize_t sysfs_aipu_sram_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+        if (!aipu)
+                return 0;
+
+        return aipu_mm_sysfs_sram_show(&aipu->mm, buf);
+}
+
+static ssize_t sysfs_aipu_defrag_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+        if (!aipu)
+                return 0;
+
+        return aipu_mm_sysfs_defrag_show(&aipu->mm, buf);
+}
+
+static ssize_t sysfs_aipu_defrag_store(struct device *dev,
+        struct device_attribute *attr, const char *buf, size_t count)
+{
+        if (!aipu)
+                return count;
+
+        /* buffers are migrated by their owner processes on their next job creation */
+        if ((strncmp(buf, "1", 1) == 0))
+                aipu_mm_request_defrag(&aipu->mm);
+
+        return count;
+}
+
 static DEVICE_ATTR(kmd_version, 0444, sysfs_kmd_version_show, NULL);
 static DEVICE_ATTR(ext_register, 0644, sysfs_aipu_ext_register_show, sysfs_aipu_ext_register_store);
 static DEVICE_ATTR(job, 0444, sysfs_aipu_job_show, NULL);
+static DEVICE_ATTR(sram, 0444, sysfs_aipu_sram_show, NULL);
+static DEVICE_ATTR(defrag, 0644, sysfs_aipu_defrag_show, sysfs_aipu_defrag_store);
 #if (defined PLATFORM_HAS_CLOCK_GATING) && (PLATFORM_HAS_CLOCK_GATING == 1)
 static DEVICE_ATTR(clock_gating, 0644, sysfs_aipu_clock_gating_show, sysfs_aipu_clock_gating_store);
 #endif
@@ -310,6 +341,8 @@ int aipu_create_sysfs(void *aipu_priv)
         device_create_file(aipu->dev, &dev_attr_kmd_version);
         device_create_file(aipu->dev, &dev_attr_ext_register);
         device_create_file(aipu->dev, &dev_attr_job);
+        device_create_file(aipu->dev, &dev_attr_sram);
+        device_create_file(aipu->dev, &dev_attr_defrag);
 #if (defined PLATFORM_HAS_CLOCK_GATING) && (PLATFORM_HAS_CLOCK_GATING == 1)
         device_create_file(aipu->dev, &dev_attr_clock_gating);
 #endif
@@ -328,6 +361,8 @@ void aipu_destroy_sysfs(void *aipu_priv)
         device_remove_file(aipu->dev, &dev_attr_kmd_version);
         device_remove_file(aipu->dev, &dev_attr_ext_register);
         device_remove_file(aipu->dev, &dev_attr_job);
+        device_remove_file(aipu->dev, &dev_attr_sram);
+        device_remove_file(aipu->dev, &dev_attr_defrag);
 #if (defined PLATFORM_HAS_CLOCK_GATING) && (PLATFORM_HAS_CLOCK_GATING == 1)
         device_remove_file(aipu->dev, &dev_attr_clock_gating);
 #endif
@@ -0,0 +1,166 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_trace.h
+ * Tracepoints of the job submission and completion path
+ *
+ * Enable with: echo 1 > /sys/kernel/debug/tracing/events/aipu/enable
+ * or record with perf/trace-cmd, e.g. trace-cmd record -e aipu
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM aipu
+
+#if !defined(_AIPU_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define _AIPU_TRACE_H_
+
+#include <linux/tracepoint.h>
+#include "aipu_job_manager.h"
+
+/* job events without latency info: submit, pending/blocked enqueue, cancel & timeout kill */
+DECLARE_EVENT_CLASS(aipu_job_class,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job),
+        TP_STRUCT__entry(
+                __field(int, pid)
+                __field(int, uthread_id)
+                __field(u32, job_id)
+                __field(int, state)
+                __field(u64, submit_ns)
+        ),
+        TP_fast_assign(
+                __entry->pid = job->session_pid;
+                __entry->uthread_id = job->uthread_id;
+                __entry->job_id = job->desc.job_id;
+                __entry->state = job->state;
+                __entry->submit_ns = job->ts.submit_ns;
+        ),
+        TP_printk("pid=%d tid=%d job=0x%x state=%d submit_ns=%llu",
+                __entry->pid, __entry->uthread_id, __entry->job_id, __entry->state,
+                __entry->submit_ns)
+);
+
+DEFINE_EVENT(aipu_job_class, aipu_job_submit,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job)
+);
+
+DEFINE_EVENT(aipu_job_class, aipu_job_pending,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job)
+);
+
+DEFINE_EVENT(aipu_job_class, aipu_job_blocked,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job)
+);
+
+DEFINE_EVENT(aipu_job_class, aipu_job_cancel,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job)
+);
+
+DEFINE_EVENT(aipu_job_class, aipu_job_timeout_kill,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job)
+);
+
+TRACE_EVENT(aipu_job_trigger,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job),
+        TP_STRUCT__entry(
+                __field(int, pid)
+                __field(int, uthread_id)
+                __field(u32, job_id)
+                __field(u32, start_pc)
+                __field(u32, dreg0)
+                __field(u32, dreg1)
+                __field(u64, trigger_ns)
+                __field(u64, pending_ns)
+        ),
+        TP_fast_assign(
+                __entry->pid = job->session_pid;
+                __entry->uthread_id = job->uthread_id;
+                __entry->job_id = job->desc.job_id;
+                __entry->start_pc = (u32)job->desc.start_pc_addr;
+                __entry->dreg0 = (u32)job->desc.data_0_addr;
+                __entry->dreg1 = (u32)job->desc.data_1_addr;
+                __entry->trigger_ns = job->ts.trigger_ns;
+                __entry->pending_ns = job->ts.trigger_ns - job->ts.submit_ns;
+        ),
+        TP_printk("pid=%d tid=%d job=0x%x start_pc=0x%x dreg0=0x%x dreg1=0x%x trigger_ns=%llu pending_ns=%llu",
+                __entry->pid, __entry->uthread_id, __entry->job_id, __entry->start_pc,
+                __entry->dreg0, __entry->dreg1, __entry->trigger_ns, __entry->pending_ns)
+);
+
+TRACE_EVENT(aipu_job_irq,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job),
+        TP_STRUCT__entry(
+                __field(int, pid)
+                __field(u32, job_id)
+                __field(int, exception)
+                __field(u64, irq_ns)
+                __field(u64, exec_ns)
+        ),
+        TP_fast_assign(
+                __entry->pid = job->session_pid;
+                __entry->job_id = job->desc.job_id;
+                __entry->exception = job->exception_flag;
+                __entry->irq_ns = job->ts.irq_ns;
+                __entry->exec_ns = job->ts.irq_ns - job->ts.trigger_ns;
+        ),
+        TP_printk("pid=%d job=0x%x exception=%d irq_ns=%llu exec_ns=%llu",
+                __entry->pid, __entry->job_id, __entry->exception, __entry->irq_ns,
+                __entry->exec_ns)
+);
+
+TRACE_EVENT(aipu_job_done,
+        TP_PROTO(struct aipu_job *job),
+        TP_ARGS(job),
+        TP_STRUCT__entry(
+                __field(int, pid)
+                __field(u32, job_id)
+                __field(int, exception)
+                __field(int, valid)
+                __field(u64, bh_ns)
+                __field(u64, irq_to_bh_ns)
+                __field(u64, total_ns)
+        ),
+        TP_fast_assign(
+                __entry->pid = job->session_pid;
+                __entry->job_id = job->desc.job_id;
+                __entry->exception = job->exception_flag;
+                __entry->valid = job->valid_flag;
+                __entry->bh_ns = job->ts.bh_ns;
+                __entry->irq_to_bh_ns = job->ts.bh_ns - job->ts.irq_ns;
+                __entry->total_ns = job->ts.bh_ns - job->ts.submit_ns;
+        ),
+        TP_printk("pid=%d job=0x%x exception=%d valid=%d bh_ns=%llu irq_to_bh_ns=%llu total_ns=%llu",
+                __entry->pid, __entry->job_id, __entry->exception, __entry->valid,
+                __entry->bh_ns, __entry->irq_to_bh_ns, __entry->total_ns)
+);
+
+#endif /* _AIPU_TRACE_H_ */
+
+/* this part must be outside the multi-read protection */
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE aipu_trace
+#include <trace/define_trace.h>
@@ -23,7 +23,7 @@
 #ifndef _CONFIG_H_
 #define _CONFIG_H_
 
-#define KMD_VERSION  "1.2.35"
+#define KMD_VERSION  "1.2.40"
 
 #define AIPU_ENABLE_RESET_HW_NONE_IDLE 0
 
@@ -46,12 +46,20 @@
 #define KMD_BUILD_DEBUG_FLAG "release"
 #endif /* BUILD_DEBUG_VERSION */
 
+#ifdef CONFIG_DEBUG_FS
+#define AIPU_ENABLE_DEBUGFS  1
+#endif
+
+#ifdef CONFIG_PERF_EVENTS
+#define AIPU_ENABLE_PMU      1
+#endif
+
 #define AIPU_CONFIG_TEXT_ASID      AIPU_ASE_ID_0
 #define AIPU_CONFIG_RO_STACK_ASID  AIPU_ASE_ID_0
 #define AIPU_CONFIG_STATIC_ASID    AIPU_ASE_ID_1
 #define AIPU_CONFIG_REUSE_ASID     AIPU_ASE_ID_2
 
-#define AIPU_CONFIG_ENABLE_SRAM             0
+#define AIPU_CONFIG_ENABLE_SRAM             1
 #define AIPU_CONFIG_ENABLE_FALL_BACK_TO_DDR 1
 #define AIPU_CONFIG_SRAM_DATA_ASID          AIPU_CONFIG_REUSE_ASID
 #define AIPU_CONFIG_MM_ALLOC_FLAG           AIPU_ALLOC_FLAG_COMPACT
@@ -36,5 +36,7 @@
 #define IPUIOC_REQIO             _IOWR(IPUIOC_MAGIC, 5, struct aipu_io_req)
 #define IPUIOC_QUERYSTATUS       _IOWR(IPUIOC_MAGIC, 6, struct job_status_query)
 #define IPUIOC_KILL_TIMEOUT_JOB  _IOW(IPUIOC_MAGIC,  7, __u32)
+#define IPUIOC_MIGRATEBUF        _IOWR(IPUIOC_MAGIC, 8, struct buf_request)
+#define IPUIOC_QUERYDEFRAG       _IOR(IPUIOC_MAGIC,  9, __u32)
 
 #endif /* _AIPU_IOCTL_H_ */
\ No newline at end of file
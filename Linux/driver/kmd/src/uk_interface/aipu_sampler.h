@@ -0,0 +1,87 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file aipu_sampler.h
+ * UMD & KMD interface header of the performance counter sampler ring
+ *
+ * The ring is a read-only shared memory region: a header followed by
+ * capacity samples. KMD writes sample (head % capacity) and then publishes
+ * it by incrementing head; a reader copies samples [tail, head) and re-reads
+ * head afterwards: sample i is intact only if i + capacity > new head.
+ */
+
+#ifndef _AIPU_SAMPLER_H_
+#define _AIPU_SAMPLER_H_
+
+#include <linux/types.h>
+
+#define AIPU_SAMPLER_MAGIC      0x53504941 /* "AIPS" */
+#define AIPU_SAMPLER_VERSION    1
+
+/* sample flags */
+#define AIPU_SAMPLE_FLAG_BUSY          (1 << 0) /* AIPU core not idle */
+#define AIPU_SAMPLE_FLAG_BW_VALID      (1 << 1) /* rdata/wdata/cycle counters captured */
+#define AIPU_SAMPLE_FLAG_DMA_VALID     (1 << 2) /* DMA latency/max outstanding captured */
+#define AIPU_SAMPLE_FLAG_POWER_OFF     (1 << 3) /* AIPU suspended or in reset; no register read */
+
+/**
+ * struct aipu_sample: one sample of AIPU/SoC counters
+ * @ts_ns: sampling time (CLOCK_MONOTONIC)
+ * @rdata_tot: SoC total read data counter
+ * @wdata_tot: SoC total write data counter
+ * @tot_cycle: SoC total cycle counter
+ * @dma_latency_tot: SoC DMA total latency counter
+ * @max_outstanding: SoC max outstanding transaction counter
+ * @status_reg: AIPU status register value
+ * @flags: AIPU_SAMPLE_FLAG_*
+ * @sched_num: number of jobs scheduled on AIPU
+ */
+struct aipu_sample {
+        __u64 ts_ns;
+        __u64 rdata_tot;
+        __u64 wdata_tot;
+        __u64 tot_cycle;
+        __u64 dma_latency_tot;
+        __u32 max_outstanding;
+        __u32 status_reg;
+        __u32 flags;
+        __u32 sched_num;
+};
+
+/**
+ * struct aipu_sampler_header: sampler ring header
+ * @magic: AIPU_SAMPLER_MAGIC
+ * @version: AIPU_SAMPLER_VERSION
+ * @sample_size: sizeof(struct aipu_sample)
+ * @capacity: number of samples in ring, a power of 2
+ * @data_offset: offset of the first sample from the header
+ * @period_ns: current sampling period; 0 if stopped
+ * @head: number of samples ever written, i.e. index of the next sample
+ */
+struct aipu_sampler_header {
+        __u32 magic;
+        __u32 version;
+        __u32 sample_size;
+        __u32 capacity;
+        __u64 data_offset;
+        __u64 period_ns;
+        __u64 head;
+        __u64 reserved[3];
+};
+
+#endif /* _AIPU_SAMPLER_H_ */
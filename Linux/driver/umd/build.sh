@@ -36,6 +36,7 @@ build_help() {
     echo "-d, --debug       build debug version (release if not specified)"
     echo "-p, --platform    platform supported:"
     echo "                      x86-linux"
+    echo "                      loopback-linux (userspace KMD emulation on host, no hardware)"
     echo "                      juno-linux-4.9"
     echo "                      hybrid-linux-4.9"
     echo "                      440-linux-4.14"
@@ -127,6 +128,8 @@ export PATH=$TOOL_DIR:$PATH
 MAKE_FLAG="MAJOR=$V_MAJOR MINOR=$V_MINOR CODE_CHECK=$CHECK BUILD_LIB_TYPE=$LIB_TYPE"
 if [ "$PLATFORM"x = "x86-linux"x ]; then
     MAKE_FLAG="DEBUG_FLAG=$DEBUG CXX=g++ TARGET_PLATFORM=x86-linux $MAKE_FLAG"
+elif [ "$PLATFORM"x = "loopback-linux"x ]; then
+    MAKE_FLAG="DEBUG_FLAG=$DEBUG CXX=g++ TARGET_PLATFORM=loopback-linux $MAKE_FLAG"
 elif [ "$PLATFORM"x = "juno-linux-4.9"x ]; then
     MAKE_FLAG="DEBUG_FLAG=$DEBUG CXX=aarch64-linux-gnu-gcc TARGET_PLATFORM=juno-linux-4.9 $MAKE_FLAG"
 elif [ "$PLATFORM"x = "hybrid-linux-4.9"x ]; then
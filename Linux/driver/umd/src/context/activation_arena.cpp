@@ -0,0 +1,347 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  activation_arena.cpp
+ * @brief AIPU User Mode Driver (UMD) shared activation arena module implementation
+ */
+
+#include "activation_arena.h"
+#include "utils/log.h"
+
+AIRT::ActivationArena::ActivationArena(DeviceCtrl& _ctrl): ctrl(_ctrl)
+{
+    pthread_mutex_init(&lock, NULL);
+}
+
+AIRT::ActivationArena::~ActivationArena()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void AIRT::ActivationArena::get_layout_no_lock(uint32_t arena_id, uint32_t& size,
+    uint32_t& align_in_page, uint32_t& placement) const
+{
+    std::map<uint32_t, arena_member_t>::const_iterator iter;
+
+    size = 0;
+    align_in_page = 1;
+    placement = 0;
+    for (iter = members.begin(); iter != members.end(); iter++)
+    {
+        if (iter->second.arena_id != arena_id)
+        {
+            continue;
+        }
+        if (iter->second.reuse_size > size)
+        {
+            size = iter->second.reuse_size;
+        }
+        if (iter->second.align_in_page > align_in_page)
+        {
+            align_in_page = iter->second.align_in_page;
+        }
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+        /* the region is hot if any member wants its activations in SRAM */
+        if (AIPU_MEM_PLACEMENT_SRAM == iter->second.gobj->get_reuse_placement())
+        {
+            placement = AIPU_MEM_PLACEMENT_SRAM;
+        }
+#endif
+    }
+}
+
+void AIRT::ActivationArena::free_region_no_lock(arena_region_t& region)
+{
+    if (nullptr != region.buf.va)
+    {
+        if (AIPU_STATUS_SUCCESS != ctrl.free_buf(&region.buf))
+        {
+            LOG(LOG_ERR, "free activation arena region failed!");
+        }
+        buffer_desc_init(&region.buf);
+    }
+}
+
+void AIRT::ActivationArena::leave_no_lock(uint32_t graph_id)
+{
+    std::map<uint32_t, arena_member_t>::iterator member = members.find(graph_id);
+    std::map<uint32_t, arena_region_t>::iterator arena;
+    std::set<uint32_t>::iterator handle;
+
+    if (member == members.end())
+    {
+        return;
+    }
+
+    arena = arenas.find(member->second.arena_id);
+    members.erase(member);
+    if (arena == arenas.end())
+    {
+        return;
+    }
+
+    /* tensor buffers & jobs of this graph have been destroyed by the graph itself */
+    handle = arena->second.handles.begin();
+    while (handle != arena->second.handles.end())
+    {
+        if (Graph::handle2graph_id(*handle) == graph_id)
+        {
+            arena->second.handles.erase(handle++);
+        }
+        else
+        {
+            handle++;
+        }
+    }
+    if (arena->second.busy && arena->second.owner_job &&
+        (Graph::job_id2graph_id(arena->second.owner_job) == graph_id))
+    {
+        arena->second.busy = false;
+        arena->second.owner_job = 0;
+    }
+
+    if (arena->second.handles.empty())
+    {
+        free_region_no_lock(arena->second);
+    }
+    if (0 == --arena->second.member_cnt)
+    {
+        arenas.erase(arena);
+    }
+}
+
+aipu_status_t AIRT::ActivationArena::set_member(uint32_t graph_id, Graph* gobj, uint32_t arena_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    arena_member_t member;
+    arena_region_t* region = nullptr;
+
+    if (nullptr == gobj)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    pthread_mutex_lock(&lock);
+    if (gobj->has_thread_buffer())
+    {
+        LOG(LOG_ERR, "graph 0x%x: set the activation arena before allocating tensor buffers", graph_id);
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+        goto unlock;
+    }
+
+    leave_no_lock(graph_id);
+    if (0 == arena_id)
+    {
+        goto unlock;
+    }
+
+    if (0 == arenas.count(arena_id))
+    {
+        region = &arenas[arena_id];
+        buffer_desc_init(&region->buf);
+        region->member_cnt = 0;
+        region->busy = false;
+        region->owner_job = 0;
+    }
+    region = &arenas[arena_id];
+    region->member_cnt++;
+
+    member.gobj = gobj;
+    member.arena_id = arena_id;
+    member.reuse_size = gobj->get_reuse_size();
+    member.align_in_page = gobj->get_reuse_align();
+    members[graph_id] = member;
+    LOG(LOG_DEBUG, "graph 0x%x joins activation arena %u (reuse 0x%x bytes)", graph_id, arena_id,
+        member.reuse_size);
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::ActivationArena::remove(uint32_t graph_id)
+{
+    pthread_mutex_lock(&lock);
+    leave_no_lock(graph_id);
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::ActivationArena::clear()
+{
+    std::map<uint32_t, arena_region_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    for (iter = arenas.begin(); iter != arenas.end(); iter++)
+    {
+        free_region_no_lock(iter->second);
+    }
+    arenas.clear();
+    members.clear();
+    pthread_mutex_unlock(&lock);
+}
+
+aipu_status_t AIRT::ActivationArena::alloc_thread_buffer(uint32_t graph_id, Graph* gobj,
+    aipu_buffer_alloc_info_t* info)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, arena_member_t>::iterator member;
+    arena_region_t* region = nullptr;
+    uint32_t size = 0;
+    uint32_t align_in_page = 0;
+    uint32_t placement = 0;
+
+    pthread_mutex_lock(&lock);
+    member = members.find(graph_id);
+    if (member == members.end())
+    {
+        pthread_mutex_unlock(&lock);
+        return gobj->alloc_thread_buffer(info);
+    }
+
+    region = &arenas[member->second.arena_id];
+    if ((nullptr != region->buf.va) && (region->buf.size < member->second.reuse_size))
+    {
+        /* a member joined after the region was sized */
+        if (!region->handles.empty())
+        {
+            LOG(LOG_ERR, "activation arena %u is in use and too small for graph 0x%x",
+                member->second.arena_id, graph_id);
+            ret = AIPU_STATUS_ERROR_BUF_ALLOC_FAIL;
+            goto unlock;
+        }
+        free_region_no_lock(*region);
+    }
+
+    if (nullptr == region->buf.va)
+    {
+        get_layout_no_lock(member->second.arena_id, size, align_in_page, placement);
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+        ret = ctrl.malloc_buf(AIPU_MM_DATA_TYPE_REUSE, size, align_in_page, &region->buf, 0,
+            placement, graph_id);
+#else
+        /* simulation data buffers are allocated per graph by the simulator */
+        ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            goto unlock;
+        }
+    }
+
+    ret = gobj->alloc_thread_buffer(info, &region->buf);
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        region->handles.insert(info->handle);
+    }
+    else if (region->handles.empty())
+    {
+        free_region_no_lock(*region);
+    }
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::ActivationArena::free_thread_buffer(Graph* gobj, uint32_t handle)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, arena_member_t>::iterator member;
+    arena_region_t* region = nullptr;
+
+    pthread_mutex_lock(&lock);
+    ret = gobj->free_thread_buffer(handle);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto unlock;
+    }
+
+    member = members.find(Graph::handle2graph_id(handle));
+    if (member != members.end())
+    {
+        region = &arenas[member->second.arena_id];
+        region->handles.erase(handle);
+        if (region->handles.empty())
+        {
+            free_region_no_lock(*region);
+        }
+    }
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::ActivationArena::acquire(uint32_t graph_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, arena_member_t>::iterator member;
+    arena_region_t* region = nullptr;
+
+    pthread_mutex_lock(&lock);
+    member = members.find(graph_id);
+    if (member != members.end())
+    {
+        region = &arenas[member->second.arena_id];
+        if (region->busy)
+        {
+            LOG(LOG_DEBUG, "activation arena %u is busy with job 0x%x", member->second.arena_id,
+                region->owner_job);
+            ret = AIPU_STATUS_ERROR_BUSY_HANDLE;
+        }
+        else
+        {
+            region->busy = true;
+            region->owner_job = 0;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::ActivationArena::bind(uint32_t graph_id, uint32_t job_id)
+{
+    std::map<uint32_t, arena_member_t>::iterator member;
+
+    pthread_mutex_lock(&lock);
+    member = members.find(graph_id);
+    if (member != members.end())
+    {
+        arenas[member->second.arena_id].owner_job = job_id;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::ActivationArena::release(uint32_t graph_id, uint32_t job_id)
+{
+    std::map<uint32_t, arena_member_t>::iterator member;
+    arena_region_t* region = nullptr;
+
+    pthread_mutex_lock(&lock);
+    member = members.find(graph_id);
+    if (member != members.end())
+    {
+        region = &arenas[member->second.arena_id];
+        if (region->busy && (region->owner_job == job_id))
+        {
+            region->busy = false;
+            region->owner_job = 0;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
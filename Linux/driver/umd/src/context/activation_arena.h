@@ -0,0 +1,90 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  activation_arena.h
+ * @brief AIPU User Mode Driver (UMD) shared activation arena module header
+ */
+
+#ifndef _ACTIVATION_ARENA_H_
+#define _ACTIVATION_ARENA_H_
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <pthread.h>
+#include "standard_api.h"
+#include "device_ctrl.h"
+#include "graph/graph.h"
+
+namespace AIRT
+{
+typedef struct arena_member {
+    Graph*   gobj;
+    uint32_t arena_id;
+    uint32_t reuse_size;          /**< reuse group size of this graph */
+    uint32_t align_in_page;
+} arena_member_t;
+
+typedef struct arena_region {
+    buffer_desc_t buf;            /**< shared reuse region; allocated with the first tensor buffer */
+    std::set<uint32_t> handles;   /**< tensor buffers carved from this region */
+    uint32_t member_cnt;
+    bool     busy;                /**< a job of a member graph is in flight */
+    uint32_t owner_job;           /**< ID of the in-flight job; 0 while it is being built */
+} arena_region_t;
+
+/**
+ * @brief Graphs put into the same arena by the application never run concurrently, so the
+ *        reuse (activation) buffers of all their tensor buffers are carved from one region
+ *        sized for the largest member. Only one job of the members may exist at a time:
+ *        the arena is taken at job creation and given back at job cleaning.
+ */
+class ActivationArena
+{
+private:
+    DeviceCtrl& ctrl;
+    std::map<uint32_t, arena_region_t> arenas;
+    /* key: graph ID */
+    std::map<uint32_t, arena_member_t> members;
+    pthread_mutex_t lock;
+
+private:
+    void get_layout_no_lock(uint32_t arena_id, uint32_t& size, uint32_t& align_in_page,
+        uint32_t& placement) const;
+    void free_region_no_lock(arena_region_t& region);
+    void leave_no_lock(uint32_t graph_id);
+
+public:
+    aipu_status_t set_member(uint32_t graph_id, Graph* gobj, uint32_t arena_id);
+    void remove(uint32_t graph_id);
+    void clear();
+    aipu_status_t alloc_thread_buffer(uint32_t graph_id, Graph* gobj, aipu_buffer_alloc_info_t* info);
+    aipu_status_t free_thread_buffer(Graph* gobj, uint32_t handle);
+    aipu_status_t acquire(uint32_t graph_id);
+    void bind(uint32_t graph_id, uint32_t job_id);
+    void release(uint32_t graph_id, uint32_t job_id);
+
+public:
+    ActivationArena(DeviceCtrl& _ctrl);
+    ~ActivationArena();
+    ActivationArena(const ActivationArena& arena) = delete;
+    ActivationArena& operator=(const ActivationArena& arena) = delete;
+};
+}
+
+#endif /* _ACTIVATION_ARENA_H_ */
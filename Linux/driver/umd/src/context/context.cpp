@@ -20,6 +20,7 @@
  * @brief AIPU User Mode Driver (UMD) context module implementation
  */
 
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 #include "context.h"
@@ -28,10 +29,16 @@
 #include "utils/debug.h"
 #include "utils/helper.h"
 
-AIRT::MainContext::MainContext(): ctrl()
+AIRT::MainContext::MainContext(): ctrl(), arena(ctrl)
 {
+    char* cache_dir = getenv("AIPU_GRAPH_CACHE_DIR");
+
     rt_cfg.poll_opt = false;
     pthread_rwlock_init(&gt_lock, NULL);
+    if ((nullptr != cache_dir) && (AIPU_STATUS_SUCCESS != graph_cache.init(cache_dir)))
+    {
+        LOG(LOG_WARN, "invalid AIPU_GRAPH_CACHE_DIR %s: prepared graph cache disabled", cache_dir);
+    }
 }
 
 AIRT::MainContext::~MainContext()
@@ -549,6 +556,8 @@ aipu_status_t AIRT::MainContext::parse_graph(const void* graph, uint32_t size, g
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     uint32_t bss_size = 0;
+    bool cache_hit = false;
+    std::string cache_key;
 
     if (nullptr == graph)
     {
@@ -571,11 +580,22 @@ aipu_status_t AIRT::MainContext::parse_graph(const void* graph, uint32_t size, g
     if ((AIPU_LOADABLE_GRAPH_V0003 == GVERSION_MINOR(info.version)) ||
         (AIPU_LOADABLE_GRAPH_V0004 == GVERSION_MINOR(info.version)))
     {
-        ret = parse_bss_section<bss_hdr_v3_t, static_section_desc_v3_t,
-                reuse_section_desc_v3_t, sub_section_desc_v3_t>(info, bss_size);
-        if (AIPU_STATUS_SUCCESS != ret)
+        /* a prepared graph cache hit skips walking the BSS descriptors */
+        if (graph_cache.is_enabled())
         {
-            goto finish;
+            cache_key = GraphCache::get_key(info, bss_size);
+            cache_hit = graph_cache.lookup(cache_key, info);
+        }
+
+        if (!cache_hit)
+        {
+            ret = parse_bss_section<bss_hdr_v3_t, static_section_desc_v3_t,
+                    reuse_section_desc_v3_t, sub_section_desc_v3_t>(info, bss_size);
+            if (AIPU_STATUS_SUCCESS != ret)
+            {
+                goto finish;
+            }
+            graph_cache.store(cache_key, info);
         }
     }
     else
@@ -625,12 +645,30 @@ aipu_status_t AIRT::MainContext::create_graph_object(const graph_info_t& info, b
     }
 
     /* assumed that info is a valid one returned by parse_graph() */
+    residency.reserve(Graph::get_pbuf_size(info.pbuf_templ));
     p_gobj = new Graph(id, ctrl);
     ret = p_gobj->load(info, map_flag);
+
+    /* close the holes between the buffers of idle graphs before evicting any of them */
+    if ((AIPU_STATUS_ERROR_BUF_ALLOC_FAIL == ret) && residency.compact())
+    {
+        ret = p_gobj->reload();
+    }
+
+    /* evict cold graphs one by one until the text & static buffers fit in device memory */
+    while ((AIPU_STATUS_ERROR_BUF_ALLOC_FAIL == ret) && residency.evict_lru())
+    {
+        ret = p_gobj->reload();
+    }
+
     if (AIPU_STATUS_SUCCESS != ret)
     {
         destroy_graph_object(&p_gobj);
     }
+    else
+    {
+        residency.add(id, p_gobj, Graph::get_pbuf_size(info.pbuf_templ));
+    }
 
     /* success or return nullptr */
     *gobj = p_gobj;
@@ -700,12 +738,17 @@ aipu_status_t AIRT::MainContext::init()
 void AIRT::MainContext::force_deinit()
 {
     GraphTable::iterator iter;
+
+    /* drain threads read the printf buffers freed below */
+    drains.clear();
     pthread_rwlock_wrlock(&gt_lock);
     for (iter = graphs.begin(); iter != graphs.end(); iter++)
     {
         iter->second->unload();
     }
     graphs.clear();
+    residency.clear();
+    arena.clear();
     pthread_rwlock_unlock(&gt_lock);
     ctrl.deinit();
 }
@@ -817,11 +860,21 @@ aipu_status_t AIRT::MainContext::unload_graph(const aipu_graph_desc_t* gdesc)
         goto finish;
     }
 
+    /* drains read the printf buffers of the graph until they are stopped */
+    if (!p_gobj->is_unload_ok() || pipelines.is_graph_used(gdesc->id) ||
+        drains.is_graph_used(gdesc->id))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+        goto finish;
+    }
+    residency.remove(gdesc->id);
+
     ret = destroy_graph_object(&p_gobj);
     if (AIPU_STATUS_SUCCESS != ret)
     {
         goto finish;
     }
+    arena.remove(gdesc->id);
 
     /* p_gobj becomes NULL after destroy */
 
@@ -834,6 +887,89 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::MainContext::pin_graph(const aipu_graph_desc_t* gdesc, bool pin)
+{
+    if (nullptr == gdesc)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    return residency.set_pinned(gdesc->id, pin);
+}
+
+aipu_status_t AIRT::MainContext::get_residency_stats(aipu_residency_stats_t* stats)
+{
+    if (nullptr == stats)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    residency.get_stats(stats);
+    return AIPU_STATUS_SUCCESS;
+}
+
+aipu_status_t AIRT::MainContext::set_graph_arena(const aipu_graph_desc_t* gdesc, uint32_t arena_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    Graph* p_gobj = nullptr;
+
+    if (nullptr == gdesc)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_gobj = get_graph_object(gdesc->id);
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_GRAPH_NOT_EXIST;
+        goto finish;
+    }
+
+    ret = arena.set_member(gdesc->id, p_gobj, arena_id);
+
+finish:
+#else
+    ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::set_graph_sram_hint(const aipu_graph_desc_t* gdesc, aipu_sram_hint_t hint)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    Graph* p_gobj = nullptr;
+
+    if (nullptr == gdesc)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if ((AIPU_SRAM_HINT_AUTO != hint) && (AIPU_SRAM_HINT_ALL != hint) && (AIPU_SRAM_HINT_NONE != hint))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    p_gobj = get_graph_object(gdesc->id);
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_GRAPH_NOT_EXIST;
+        goto finish;
+    }
+
+    p_gobj->set_sram_hint(hint);
+
+finish:
+#else
+    ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+    return ret;
+}
+
 aipu_status_t AIRT::MainContext::alloc_tensor_buffers(const aipu_graph_desc_t* gdesc,
     aipu_buffer_alloc_info_t* info)
 {
@@ -852,7 +988,11 @@ aipu_status_t AIRT::MainContext::alloc_tensor_buffers(const aipu_graph_desc_t* g
         goto finish;
     }
 
-    ret = p_gobj->alloc_thread_buffer(info);
+    ret = arena.alloc_thread_buffer(gdesc->id, p_gobj, info);
+    if ((AIPU_STATUS_ERROR_BUF_ALLOC_FAIL == ret) && residency.compact())
+    {
+        ret = arena.alloc_thread_buffer(gdesc->id, p_gobj, info);
+    }
 
 finish:
     return ret;
@@ -868,7 +1008,15 @@ aipu_status_t AIRT::MainContext::free_tensor_buffers(uint32_t handle)
         goto finish;
     }
 
-    ret = p_gobj->free_thread_buffer(handle);
+    /* consumer stages of a pipeline may alias the output tensors of this buffer; a drain
+       thread may read its printf buffers */
+    if (pipelines.is_handle_used(handle) || drains.is_handle_used(handle))
+    {
+        ret = AIPU_STATUS_ERROR_BUSY_HANDLE;
+        goto finish;
+    }
+
+    ret = arena.free_thread_buffer(p_gobj, handle);
 
 finish:
     return ret;
@@ -893,7 +1041,36 @@ aipu_status_t AIRT::MainContext::create_new_job(const aipu_graph_desc_t* gdesc,
         goto finish;
     }
 
-    ret = p_gobj->build_new_job(handle, job_id);
+    /* defragmentation requested by KMD (sysfs or a failed allocation of any process) */
+    if (ctrl.is_defrag_requested())
+    {
+        residency.compact();
+    }
+
+    /* graphs sharing an activation arena run one job at a time */
+    ret = arena.acquire(gdesc->id);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
+    /* reload the text & static buffers if this graph has been evicted */
+    ret = residency.acquire(gdesc->id);
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        ret = p_gobj->build_new_job(handle, job_id);
+        residency.release(gdesc->id);
+    }
+
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        arena.bind(gdesc->id, *job_id);
+        dump_sampler.apply(p_gobj, *job_id);
+    }
+    else
+    {
+        arena.release(gdesc->id, 0);
+    }
 
 finish:
     return ret;
@@ -915,6 +1092,37 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::MainContext::flush_job_async(uint32_t job_id, aipu_job_done_cb_t cb, void* arg)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    Graph* p_gobj = get_graph_object(Graph::job_id2graph_id(job_id));
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+    /* registered before scheduling so that no end of the job is missed */
+    ret = p_gobj->set_job_done_cb(job_id, cb, arg);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
+    ret = p_gobj->flush_job(job_id);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        p_gobj->set_job_done_cb(job_id, nullptr, nullptr);
+        goto finish;
+    }
+
+    /* the simulator has run the job already */
+    p_gobj->notify_job_done(job_id);
+
+finish:
+    return ret;
+}
+
 aipu_status_t AIRT::MainContext::wait_for_job_end(uint32_t job_id, int32_t time_out,
     aipu_job_status_t* status)
 {
@@ -993,10 +1201,17 @@ aipu_status_t AIRT::MainContext::wait_for_job_end(uint32_t job_id, int32_t time_
 
 dump:
     /* success */
+    handoff_pipeline_job(job_id, *status);
     p_gobj->dump_end_job_buffers(job_id);
     goto finish;
 
 error:
+    /* jobs sampled on error are dumped here */
+    if ((nullptr != p_gobj) &&
+        ((AIPU_STATUS_ERROR_JOB_EXCEPTION == ret) || (AIPU_STATUS_ERROR_JOB_TIMEOUT == ret)))
+    {
+        p_gobj->dump_end_job_buffers(job_id, true);
+    }
     *status = AIPU_JOB_STATUS_NO_STATUS;
 
 finish:
@@ -1059,6 +1274,7 @@ aipu_status_t AIRT::MainContext::poll_job_status(uint32_t* job_cnt, int32_t time
         {
             goto finish;
         }
+        handoff_pipeline_job(jobs_status[i].job_id, (aipu_job_status_t)jobs_status[i].state);
     }
 
     *job_cnt = jobs_status.size();
@@ -1067,7 +1283,7 @@ finish:
     return ret;
 }
 
-aipu_status_t AIRT::MainContext::clean_job(uint32_t job_id)
+aipu_status_t AIRT::MainContext::clean_job_inner(uint32_t job_id, bool discard_built)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     Graph* p_gobj = get_graph_object(Graph::job_id2graph_id(job_id));
@@ -1077,12 +1293,322 @@ aipu_status_t AIRT::MainContext::clean_job(uint32_t job_id)
         goto finish;
     }
 
-    ret = p_gobj->clean_job(job_id);
+    ret = p_gobj->clean_job(job_id, discard_built);
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        arena.release(Graph::job_id2graph_id(job_id), job_id);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::clean_job(uint32_t job_id)
+{
+    return clean_job_inner(job_id, false);
+}
+
+void AIRT::MainContext::handoff_pipeline_job(uint32_t job_id, aipu_job_status_t status)
+{
+    uint32_t next = pipelines.take_next_job(job_id);
+
+    if (0 == next)
+    {
+        return;
+    }
+
+    /* the next stage reads the outputs of this job in place; no copy is needed */
+    if ((AIPU_JOB_STATUS_DONE == status) && (AIPU_STATUS_SUCCESS != flush_job(next)))
+    {
+        LOG(LOG_ERR, "flush pipeline job 0x%x failed", next);
+    }
+    pipelines.end_handoff(next);
+}
+
+void AIRT::MainContext::unlink_pipeline(const pipeline_desc_t& desc, uint32_t link_cnt)
+{
+    Graph* p_gobj = nullptr;
+
+    for (uint32_t i = 0; i < link_cnt; i++)
+    {
+        const aipu_pipeline_stage_t& dst = desc.stages[desc.links[i].dst_stage];
+        p_gobj = get_graph_object(dst.graph_id);
+        if (nullptr != p_gobj)
+        {
+            p_gobj->set_input_alias(dst.handle, desc.links[i].dst_input, 0, 0);
+        }
+    }
+}
+
+aipu_status_t AIRT::MainContext::create_pipeline(const aipu_pipeline_stage_t* stages, uint32_t stage_cnt,
+    const aipu_pipeline_link_t* links, uint32_t link_cnt, uint32_t* pipe_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    pipeline_desc_t desc;
+    pipeline_desc_t removed;
+    Graph* src = nullptr;
+    Graph* dst = nullptr;
+    HOST_PA pa = 0;
+    uint32_t size = 0;
+    uint32_t linked = 0;
+    uint32_t id = 0;
+
+    if ((nullptr == stages) || (nullptr == pipe_id) || ((nullptr == links) && (0 != link_cnt)))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (0 == stage_cnt)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    for (uint32_t i = 0; i < stage_cnt; i++)
+    {
+        if (nullptr == get_graph_object(stages[i].graph_id))
+        {
+            ret = AIPU_STATUS_ERROR_GRAPH_NOT_EXIST;
+            goto finish;
+        }
+        if (Graph::handle2graph_id(stages[i].handle) != stages[i].graph_id)
+        {
+            ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+            goto finish;
+        }
+        for (uint32_t j = 0; j < i; j++)
+        {
+            if (stages[j].handle == stages[i].handle)
+            {
+                ret = AIPU_STATUS_ERROR_BUSY_HANDLE;
+                goto finish;
+            }
+        }
+        desc.stages.push_back(stages[i]);
+    }
+
+    for (uint32_t i = 0; i < link_cnt; i++)
+    {
+        if ((links[i].src_stage >= links[i].dst_stage) || (links[i].dst_stage >= stage_cnt))
+        {
+            ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+            goto finish;
+        }
+        for (uint32_t j = 0; j < i; j++)
+        {
+            if ((links[j].dst_stage == links[i].dst_stage) && (links[j].dst_input == links[i].dst_input))
+            {
+                ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+                goto finish;
+            }
+        }
+        desc.links.push_back(links[i]);
+    }
+
+    /* take the tensor buffers before linking them */
+    ret = pipelines.add(desc, &id);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
+    for (linked = 0; linked < link_cnt; linked++)
+    {
+        const aipu_pipeline_stage_t& producer = stages[links[linked].src_stage];
+        const aipu_pipeline_stage_t& consumer = stages[links[linked].dst_stage];
+
+        src = get_graph_object(producer.graph_id);
+        dst = get_graph_object(consumer.graph_id);
+        if ((nullptr == src) || (nullptr == dst))
+        {
+            ret = AIPU_STATUS_ERROR_GRAPH_NOT_EXIST;
+            break;
+        }
+        ret = src->get_output_buffer(producer.handle, links[linked].src_output, &pa, &size);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            break;
+        }
+        ret = dst->set_input_alias(consumer.handle, links[linked].dst_input, pa, size);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            break;
+        }
+    }
+
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        unlink_pipeline(desc, linked);
+        pipelines.remove(id, removed);
+        goto finish;
+    }
+
+    /* success */
+    *pipe_id = id;
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::run_pipeline(uint32_t pipe_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    pipeline_desc_t desc;
+    std::vector<uint32_t> jobs;
+    aipu_graph_desc_t gdesc;
+    uint32_t job_id = 0;
+    uint32_t flushed = 0;
+    bool handoff = true;
+    aipu_job_status_t status = AIPU_JOB_STATUS_NO_STATUS;
+
+    ret = pipelines.get(pipe_id, desc);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
+    if (!desc.jobs.empty())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+        goto finish;
+    }
+
+    /* build all jobs in advance so that a stage hand-off only flushes the next job */
+    for (uint32_t i = 0; i < desc.stages.size(); i++)
+    {
+        memset(&gdesc, 0, sizeof(gdesc));
+        gdesc.id = desc.stages[i].graph_id;
+        ret = create_new_job(&gdesc, desc.stages[i].handle, &job_id);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            goto error;
+        }
+        jobs.push_back(job_id);
+    }
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    /* KMD holds every stage until the former one ends, without a round trip to userland */
+    for (uint32_t i = 1; i < jobs.size(); i++)
+    {
+        ret = get_graph_object(desc.stages[i].graph_id)->set_job_deps(jobs[i], &jobs[i - 1], 1);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            goto error;
+        }
+    }
+    handoff = false;
+#endif
+
+    /* chain the jobs before the first one may end */
+    ret = pipelines.start(pipe_id, jobs, handoff);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto error;
+    }
+
+    for (flushed = 0; flushed < (handoff ? 1 : jobs.size()); flushed++)
+    {
+        ret = flush_job(jobs[flushed]);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            break;
+        }
+    }
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        /* the flushed jobs only depend on each other, so all of them end */
+        for (uint32_t i = 0; i < flushed; i++)
+        {
+            wait_for_job_end(jobs[i], 0, &status);
+        }
+        pipelines.stop(pipe_id);
+        goto error;
+    }
+    goto finish;
+
+error:
+    for (uint32_t i = 0; i < jobs.size(); i++)
+    {
+        clean_job_inner(jobs[i], true);
+    }
 
 finish:
     return ret;
 }
 
+aipu_status_t AIRT::MainContext::finish_pipeline(uint32_t pipe_id, int32_t time_out)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    aipu_status_t stage_ret = AIPU_STATUS_SUCCESS;
+    aipu_job_status_t status = AIPU_JOB_STATUS_NO_STATUS;
+    pipeline_desc_t desc;
+
+    ret = pipelines.get(pipe_id, desc);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
+    if (desc.jobs.empty())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+        goto finish;
+    }
+
+    /**
+     * stages end in order; the later stages of a failed one are never flushed, or
+     * end with exception in KMD, and are waited for to be collected
+     */
+    for (uint32_t i = 0; i < desc.jobs.size(); i++)
+    {
+        /* a job being flushed by the thread which saw the former one end is not built any more */
+        pipelines.wait_handoff(desc.jobs[i]);
+        stage_ret = wait_for_job_end(desc.jobs[i], time_out, &status);
+        if ((AIPU_STATUS_SUCCESS == stage_ret) && (AIPU_JOB_STATUS_DONE != status))
+        {
+            stage_ret = AIPU_STATUS_ERROR_JOB_EXCEPTION;
+        }
+        if ((AIPU_STATUS_SUCCESS != stage_ret) && (AIPU_STATUS_SUCCESS == ret))
+        {
+            LOG(LOG_ERR, "pipeline %u stage %u (job 0x%x) failed", pipe_id, i, desc.jobs[i]);
+            ret = stage_ret;
+        }
+    }
+
+    /**
+     * no job is taken from the chain after stop; one taken before (e.g. the former stage ended
+     * after it timed out here) is cleaned once it is flushed and ends
+     */
+    pipelines.stop(pipe_id);
+    for (uint32_t i = 0; i < desc.jobs.size(); i++)
+    {
+        pipelines.wait_handoff(desc.jobs[i]);
+        if (AIPU_STATUS_ERROR_JOB_NOT_END == clean_job_inner(desc.jobs[i], true))
+        {
+            wait_for_job_end(desc.jobs[i], -1, &status);
+            clean_job_inner(desc.jobs[i], true);
+        }
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::destroy_pipeline(uint32_t pipe_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    pipeline_desc_t desc;
+
+    ret = pipelines.remove(pipe_id, desc);
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        unlink_pipeline(desc, desc.links.size());
+    }
+
+    return ret;
+}
+
 aipu_status_t AIRT::MainContext::set_dump_options(uint32_t job_id, const aipu_dump_option_t* option)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
@@ -1099,6 +1625,80 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::MainContext::set_dump_selection(uint32_t job_id, const aipu_dump_selection_t* selection)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    Graph* p_gobj = get_graph_object(Graph::job_id2graph_id(job_id));
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+    ret = p_gobj->set_dump_selection(job_id, selection);
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::set_dump_policy(const aipu_dump_policy_t* policy)
+{
+    return dump_sampler.set(policy);
+}
+
+aipu_status_t AIRT::MainContext::start_printf_drain(uint32_t handle, const char* redirect_file,
+    uint32_t* drain_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::vector<aipu_buffer_t> bufs;
+    Graph* p_gobj = nullptr;
+
+    if (nullptr == drain_id)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_gobj = get_graph_object(Graph::handle2graph_id(handle));
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+        goto finish;
+    }
+
+    ret = p_gobj->get_printf_buffers(handle, bufs);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
+    if (bufs.empty())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    ret = drains.add(handle, bufs, redirect_file, drain_id);
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::stop_printf_drain(uint32_t drain_id, aipu_printf_drain_stats_t* stats)
+{
+    return drains.remove(drain_id, stats);
+}
+
+aipu_status_t AIRT::MainContext::get_printf_drain_stats(uint32_t drain_id,
+    aipu_printf_drain_stats_t* stats)
+{
+    if (nullptr == stats)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+    return drains.get_stats(drain_id, stats);
+}
+
 aipu_status_t AIRT::MainContext::get_debug_info(uint32_t job_id, aipu_debug_info_t* info)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
@@ -1115,6 +1715,39 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::MainContext::get_job_profiling_data(uint32_t job_id,
+    aipu_job_profiling_data_t* data)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    Graph* p_gobj = get_graph_object(Graph::job_id2graph_id(job_id));
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+    ret = p_gobj->get_job_profiling_data(job_id, data);
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::MainContext::get_job_timestamps(uint32_t job_id, aipu_job_timestamps_t* ts)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    Graph* p_gobj = get_graph_object(Graph::job_id2graph_id(job_id));
+    if (nullptr == p_gobj)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+    ret = p_gobj->get_job_timestamps(job_id, ts);
+
+finish:
+    return ret;
+}
+
 aipu_status_t AIRT::MainContext::get_dev_status(uint32_t* value) const
 {
     return ctrl.get_dev_status(value);
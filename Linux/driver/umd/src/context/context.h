@@ -27,6 +27,12 @@
 #include <pthread.h>
 #include "standard_api.h"
 #include "device_ctrl.h"
+#include "graph_cache.h"
+#include "graph_residency.h"
+#include "activation_arena.h"
+#include "pipeline.h"
+#include "dump_sampler.h"
+#include "printf/printf_drain.h"
 #include "graph/graph.h"
 
 namespace AIRT
@@ -40,6 +46,12 @@ private:
     GraphTable graphs;
     pthread_rwlock_t gt_lock;
     aipu_runtime_config_t rt_cfg;
+    GraphCache graph_cache;
+    GraphResidency residency;
+    ActivationArena arena;
+    PipelineTable pipelines;
+    PrintfDrainTable drains;
+    DumpSampler dump_sampler;
 
 private:
     static char umd_status_string[][1024];
@@ -67,6 +79,9 @@ private:
 private:
     bool is_deinit_ok();
     uint32_t get_max_poll_job_cnt();
+    aipu_status_t clean_job_inner(uint32_t job_id, bool discard_built);
+    void unlink_pipeline(const pipeline_desc_t& desc, uint32_t link_cnt);
+    void handoff_pipeline_job(uint32_t job_id, aipu_job_status_t status);
 
 public:
     aipu_status_t init();
@@ -76,16 +91,33 @@ public:
     aipu_status_t set_runtime_config(const aipu_runtime_config_t* config);
     aipu_status_t load_graph(const void* graph, uint32_t size, bool map_flag, aipu_graph_desc_t* gdesc);
     aipu_status_t unload_graph(const aipu_graph_desc_t* gdesc);
+    aipu_status_t pin_graph(const aipu_graph_desc_t* gdesc, bool pin);
+    aipu_status_t get_residency_stats(aipu_residency_stats_t* stats);
+    aipu_status_t set_graph_arena(const aipu_graph_desc_t* gdesc, uint32_t arena_id);
+    aipu_status_t set_graph_sram_hint(const aipu_graph_desc_t* gdesc, aipu_sram_hint_t hint);
     aipu_status_t alloc_tensor_buffers(const aipu_graph_desc_t* gdesc, aipu_buffer_alloc_info_t* info);
     aipu_status_t free_tensor_buffers(uint32_t handle);
     aipu_status_t create_new_job(const aipu_graph_desc_t* gdesc, uint32_t handle, uint32_t* job_id);
     aipu_status_t flush_job(uint32_t job_id);
+    aipu_status_t flush_job_async(uint32_t job_id, aipu_job_done_cb_t cb, void* arg);
     aipu_status_t wait_for_job_end(uint32_t job_id, int32_t time_out, aipu_job_status_t* status);
     aipu_status_t clean_job(uint32_t job_id);
     aipu_status_t set_dump_options(uint32_t job_id, const aipu_dump_option_t* option);
+    aipu_status_t set_dump_selection(uint32_t job_id, const aipu_dump_selection_t* selection);
+    aipu_status_t set_dump_policy(const aipu_dump_policy_t* policy);
     aipu_status_t get_debug_info(uint32_t job_id, aipu_debug_info_t* info);
+    aipu_status_t get_job_profiling_data(uint32_t job_id, aipu_job_profiling_data_t* data);
+    aipu_status_t get_job_timestamps(uint32_t job_id, aipu_job_timestamps_t* ts);
     aipu_status_t get_dev_status(uint32_t* value) const;
     aipu_status_t poll_job_status(uint32_t* job_cnt, int32_t time_out);
+    aipu_status_t create_pipeline(const aipu_pipeline_stage_t* stages, uint32_t stage_cnt,
+        const aipu_pipeline_link_t* links, uint32_t link_cnt, uint32_t* pipe_id);
+    aipu_status_t run_pipeline(uint32_t pipe_id);
+    aipu_status_t finish_pipeline(uint32_t pipe_id, int32_t time_out);
+    aipu_status_t destroy_pipeline(uint32_t pipe_id);
+    aipu_status_t start_printf_drain(uint32_t handle, const char* redirect_file, uint32_t* drain_id);
+    aipu_status_t stop_printf_drain(uint32_t drain_id, aipu_printf_drain_stats_t* stats);
+    aipu_status_t get_printf_drain_stats(uint32_t drain_id, aipu_printf_drain_stats_t* stats);
 
 public:
     static aipu_status_t get_status_msg(aipu_status_t status, const char** msg);
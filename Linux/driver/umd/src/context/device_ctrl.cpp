@@ -26,8 +26,10 @@
 #include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/syscall.h>
 #include "device_ctrl.h"
+#include "tracer.h"
 #include "graph/common.h"
 #include "utils/log.h"
 #include "utils/helper.h"
@@ -41,6 +43,10 @@ AIRT::DeviceCtrl::DeviceCtrl()
 #endif
     fd = 0;
     host_aipu_shm_offset = 0;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    defrag_seq.store(0);
+    defrag_poll_ns.store(0);
+#endif
 #if (defined X86_LINUX) && (X86_LINUX==1)
     init_aipu_arch();
     has_additional_opt = 0;
@@ -55,6 +61,8 @@ AIRT::DeviceCtrl::DeviceCtrl()
     {
         use_new_arch_sim = 1;
     }
+
+    init_sim_cache();
 #endif
 }
 
@@ -341,6 +349,91 @@ void AIRT::DeviceCtrl::init_aipu_arch()
 }
 #endif
 
+#if (defined X86_LINUX) && (X86_LINUX==1)
+void AIRT::DeviceCtrl::init_sim_cache()
+{
+    char* cache_dir = getenv("AIPU_SIM_CACHE_DIR");
+    char* cache_size = getenv("AIPU_SIM_CACHE_SIZE_MB");
+    uint64_t size_mb = SIM_CACHE_DEFAULT_MB;
+
+    if (cache_dir == NULL)
+    {
+        return;
+    }
+
+    if ((cache_size != NULL) && (strtoul(cache_size, NULL, 0) != 0))
+    {
+        size_mb = strtoul(cache_size, NULL, 0);
+    }
+
+    if (AIPU_STATUS_SUCCESS != sim_cache.init(cache_dir, size_mb << 20))
+    {
+        LOG(LOG_WARN, "Simulation cache disabled: invalid cache directory %s!", cache_dir);
+    }
+}
+#endif
+
+#if (defined X86_LINUX) && (X86_LINUX==1)
+std::string AIRT::DeviceCtrl::get_sim_cache_key(const simulation_res_t& sim, const dev_config_t& config) const
+{
+    SimCacheKey key;
+    struct stat st;
+
+    /* simulator config: a rebuilt simulator must not hit results of the old one */
+    key.update(simulator);
+    if (stat(simulator.c_str(), &st) == 0)
+    {
+        key.update((uint64_t)st.st_size);
+        key.update((uint64_t)st.st_mtime);
+    }
+    key.update(has_additional_opt ? additional_opt : std::string());
+    key.update((uint64_t)use_new_arch_sim);
+    key.update((uint64_t)config.arch);
+    key.update((uint64_t)config.hw_version);
+    key.update((uint64_t)config.hw_config);
+    key.update((uint64_t)config.code.instruction_base_pa);
+    key.update((uint64_t)config.code.start_pc_pa);
+    key.update((uint64_t)config.code.interrupt_pc_pa);
+    key.update((uint64_t)config.rodata_base);
+    key.update((uint64_t)config.stack_base);
+    key.update((uint64_t)config.stack_size);
+
+    /* loaded sections: text, rodata (with descriptor), static data and inputs */
+    key.update(sim.text_digest);
+    key.update((const void*)sim.rodata.va, sim.rodata.size);
+    key.update(sim.static_data.va, sim.static_data.size);
+    for (uint32_t i = 0; i < sim.inputs.size(); i++)
+    {
+        key.update(sim.inputs[i].va, sim.inputs[i].size);
+    }
+
+    /* output layout */
+    for (uint32_t i = 0; i < sim.outputs.size(); i++)
+    {
+        key.update((uint64_t)sim.outputs[i].pa);
+        key.update((uint64_t)sim.outputs[i].size);
+    }
+    return key.digest();
+}
+#endif
+
+#if (defined X86_LINUX) && (X86_LINUX==1)
+void AIRT::DeviceCtrl::get_sim_cache_regions(const simulation_res_t& sim,
+    std::vector<sim_cache_region_t>& regions) const
+{
+    sim_cache_region_t region;
+
+    /* outputs, profiling data and printf log data */
+    regions.clear();
+    for (uint32_t i = 0; i < sim.outputs.size(); i++)
+    {
+        region.va = sim.outputs[i].va;
+        region.size = sim.outputs[i].size;
+        regions.push_back(region);
+    }
+}
+#endif
+
 #if (defined X86_LINUX) && (X86_LINUX==1)
 aipu_status_t AIRT::DeviceCtrl::config_simulation(const aipu_simulation_config_t* config)
 {
@@ -426,12 +519,29 @@ finish:
 }
 
 #if (defined X86_LINUX) && (X86_LINUX==1)
+static uint32_t get_common_align_in_page(uint32_t align_a, uint32_t align_b)
+{
+    uint32_t a = align_a ? align_a : 1;
+    uint32_t b = align_b ? align_b : 1;
+    uint32_t x = a;
+    uint32_t y = b;
+    uint32_t t = 0;
+
+    while (y)
+    {
+        t = x % y;
+        x = y;
+        y = t;
+    }
+    return a / x * b;
+}
+
 aipu_status_t AIRT::DeviceCtrl::simulation_alloc_data_buffer(uint32_t graph_id, const pbuf_alloc_templ_t& pbuf_templ,
     pbuf_info_t& pbuf, const tbuf_alloc_templ_t& tbuf_templ, tbuf_info_t& tbuf)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     uint32_t offset = 0;
-    uint32_t data_phys_base = 0;
+    uint32_t align_in_page = tbuf_templ.stack_align_in_page;
     uint32_t data_buf_alloc_size = 0;
     buffer_desc_t buf;
     std::map<uint32_t, simulation_res_t>::iterator giter = graphs.find(graph_id);
@@ -449,79 +559,89 @@ aipu_status_t AIRT::DeviceCtrl::simulation_alloc_data_buffer(uint32_t graph_id,
     }
     giter->second.rodata = tbuf.rodata;
 
-    /* alloc a whole contiguous data buffer (contains stack, weight, reuse) */
-    /* alloc device pa */
+    /**
+     * alloc a whole contiguous data buffer (contains stack, weight, reuse):
+     * lay out the sections by offsets first, then alloc the buffer aligned
+     * to all the section alignments so that every offset keeps its alignment.
+     */
     /* stack */
-    tbuf.stack.pa = get_aligned_addr(simulation_malloc_top, tbuf_templ.stack_align_in_page);
+    tbuf.stack.pa = 0;
     tbuf.stack.size = ALIGN_PAGE(tbuf_templ.stack_size);
     tbuf.stack.real_size = tbuf_templ.stack_size;
-    simulation_malloc_top = tbuf.stack.pa + tbuf.stack.size;
-    data_phys_base = tbuf.stack.pa;
+    offset = tbuf.stack.size;
 
     /* static data */
     for (uint32_t stensor_iter = 0; stensor_iter < pbuf_templ.static_sections.size(); stensor_iter++)
     {
-        buf.pa = get_aligned_addr(simulation_malloc_top,
-            pbuf_templ.static_sections[stensor_iter].align_in_page);
+        buf.pa = get_aligned_addr(offset, pbuf_templ.static_sections[stensor_iter].align_in_page);
         buf.size = ALIGN_PAGE(pbuf_templ.static_sections[stensor_iter].size);
         buf.real_size = pbuf_templ.static_sections[stensor_iter].size;
         pbuf.static_buf.push_back(buf);
-        simulation_malloc_top = buf.pa + buf.size;
-    }
-
-    if (pbuf.static_buf.size())
-    {
-        pbuf.static_group.pa = pbuf.static_buf[0].pa;
-        pbuf.static_group.va = pbuf.static_buf[0].va;
-        pbuf.static_group.size = simulation_malloc_top - pbuf.static_buf[0].pa;
-        pbuf.static_group.real_size = pbuf.static_group.size;
-    }
-    else
-    {
-        pbuf.static_group.pa = 0;
-        pbuf.static_group.va = nullptr;
-        pbuf.static_group.size = 0;
-        pbuf.static_group.real_size = 0;
+        offset = buf.pa + buf.size;
+        align_in_page = get_common_align_in_page(align_in_page,
+            pbuf_templ.static_sections[stensor_iter].align_in_page);
     }
 
     /* reuse data */
     for (uint32_t reuse_iter = 0; reuse_iter < tbuf_templ.reuse_sections.size(); reuse_iter++)
     {
-        buf.pa = get_aligned_addr(simulation_malloc_top,
-            tbuf_templ.reuse_sections[reuse_iter].align_in_page);
+        buf.pa = get_aligned_addr(offset, tbuf_templ.reuse_sections[reuse_iter].align_in_page);
         buf.size = ALIGN_PAGE(tbuf_templ.reuse_sections[reuse_iter].size);
         buf.real_size = tbuf_templ.reuse_sections[reuse_iter].size;
         tbuf.reuse_buf.push_back(buf);
-        simulation_malloc_top = buf.pa + buf.size;
+        offset = buf.pa + buf.size;
+        align_in_page = get_common_align_in_page(align_in_page,
+            tbuf_templ.reuse_sections[reuse_iter].align_in_page);
     }
-    tbuf.reuse_group.pa = tbuf.reuse_buf[0].pa;
-    tbuf.reuse_group.va = tbuf.reuse_buf[0].va;
-    tbuf.reuse_group.size = simulation_malloc_top - tbuf.reuse_buf[0].pa;
-    tbuf.reuse_group.real_size = tbuf.reuse_group.size;
 
     /* alloc the whole data buffer */
-    data_buf_alloc_size = simulation_malloc_top - data_phys_base;
-    /* TBD */
-    ret = malloc_buf(0, data_buf_alloc_size, 1, &giter->second.data);
+    data_buf_alloc_size = offset;
+    ret = malloc_buf(0, data_buf_alloc_size, align_in_page, &giter->second.data);
     if (AIPU_STATUS_SUCCESS != ret)
     {
         goto finish;
     }
-    giter->second.data.pa = data_phys_base;
 
-    /* alloc va for every internal data buffer */
+    /* convert offsets into pa & va of every internal data buffer */
+    tbuf.stack.pa = giter->second.data.pa;
     tbuf.stack.va = giter->second.data.va;
-    for (uint32_t stensor_iter = 0; stensor_iter < pbuf_templ.static_sections.size(); stensor_iter++)
+    for (uint32_t stensor_iter = 0; stensor_iter < pbuf.static_buf.size(); stensor_iter++)
     {
-        offset = pbuf.static_buf[stensor_iter].pa - data_phys_base;
+        offset = pbuf.static_buf[stensor_iter].pa;
+        pbuf.static_buf[stensor_iter].pa = giter->second.data.pa + offset;
         pbuf.static_buf[stensor_iter].va = (void*)((unsigned long)giter->second.data.va + offset);
     }
-    for (uint32_t reuse_iter = 0; reuse_iter < tbuf_templ.reuse_sections.size(); reuse_iter++)
+    for (uint32_t reuse_iter = 0; reuse_iter < tbuf.reuse_buf.size(); reuse_iter++)
     {
-        offset = tbuf.reuse_buf[reuse_iter].pa - data_phys_base;
+        offset = tbuf.reuse_buf[reuse_iter].pa;
+        tbuf.reuse_buf[reuse_iter].pa = giter->second.data.pa + offset;
         tbuf.reuse_buf[reuse_iter].va = (void*)((unsigned long)giter->second.data.va + offset);
     }
 
+    if (pbuf.static_buf.size())
+    {
+        pbuf.static_group.pa = pbuf.static_buf[0].pa;
+        pbuf.static_group.va = pbuf.static_buf[0].va;
+        pbuf.static_group.size = pbuf.static_buf.back().pa + pbuf.static_buf.back().size
+            - pbuf.static_buf[0].pa;
+        pbuf.static_group.real_size = pbuf.static_group.size;
+        giter->second.static_data.va = (void*)pbuf.static_buf[0].va;
+        giter->second.static_data.size = pbuf.static_group.size;
+    }
+    else
+    {
+        pbuf.static_group.pa = 0;
+        pbuf.static_group.va = nullptr;
+        pbuf.static_group.size = 0;
+        pbuf.static_group.real_size = 0;
+    }
+
+    tbuf.reuse_group.pa = tbuf.reuse_buf[0].pa;
+    tbuf.reuse_group.va = tbuf.reuse_buf[0].va;
+    tbuf.reuse_group.size = tbuf.reuse_buf.back().pa + tbuf.reuse_buf.back().size
+        - tbuf.reuse_buf[0].pa;
+    tbuf.reuse_group.real_size = tbuf.reuse_group.size;
+
 finish:
     return ret;
 }
@@ -565,6 +685,7 @@ aipu_status_t AIRT::DeviceCtrl::simulation_set_io_info(uint32_t graph_id, const
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     std::map<uint32_t, simulation_res_t>::iterator giter = graphs.find(graph_id);
     output_file_desc_t output;
+    sim_cache_region_t input;
 
     if (graphs.end() == giter)
     {
@@ -572,6 +693,13 @@ aipu_status_t AIRT::DeviceCtrl::simulation_set_io_info(uint32_t graph_id, const
         goto finish;
     }
 
+    for (uint32_t i = 0; i < iobuf.inputs.number; i++)
+    {
+        input.va = iobuf.inputs.tensors[i].va;
+        input.size = iobuf.inputs.tensors[i].size;
+        giter->second.inputs.push_back(input);
+    }
+
     for (uint32_t i = 0; i < iobuf.outputs.number; i++)
     {
         output.id = iobuf.outputs.tensors[i].id;
@@ -619,6 +747,7 @@ aipu_status_t AIRT::DeviceCtrl::init()
 
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
     int kern_ret = 0;
+    uint32_t seq = 0;
     aipu_open_info_t info;
     kern_ret = dev_op_wrapper_open(info);
     if (kern_ret != 0)
@@ -639,9 +768,15 @@ aipu_status_t AIRT::DeviceCtrl::init()
             info.cap.tpc_feature);
     LOG(LOG_DEBUG, "AIPU hardware version: %d, config version number: %d",
             aipu_version, aipu_hw_config);
+
+    /* only the defragmentation requests issued from now on concern this process */
+    if (dev_op_wrapper_get_defrag_seq(fd, &seq) == 0)
+    {
+        defrag_seq.store(seq);
+    }
 #else
     has_additional_opt = false;
-    simulation_malloc_top = 0;
+    sim_addr.reset();
     goto finish;
 #endif
 
@@ -651,6 +786,10 @@ finish:
 
 aipu_status_t AIRT::DeviceCtrl::deinit()
 {
+#if (defined X86_LINUX) && (X86_LINUX==1)
+    sim_addr_stats_t stats;
+#endif
+
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
     if (fd > 0)
     {
@@ -661,7 +800,16 @@ aipu_status_t AIRT::DeviceCtrl::deinit()
 #else
     graphs.clear();
     simulation_cmd[0] = '\0';
-    simulation_malloc_top = 0;
+    sim_addr.get_stats(stats);
+    LOG(LOG_INFO, "Simulation address space: %u buffer(s) not freed, free 0x%lx, largest free 0x%lx, \
+        %u free range(s), fragmentation %u%%", stats.alloc_cnt, (unsigned long)stats.free_bytes,
+        (unsigned long)stats.max_free_bytes, stats.free_range_cnt, stats.frag_percent);
+    sim_addr.reset();
+    if (sim_cache.is_enabled())
+    {
+        LOG(LOG_INFO, "Simulation cache: %lu hit(s), %lu miss(es)",
+            (unsigned long)sim_cache.get_hit_cnt(), (unsigned long)sim_cache.get_miss_cnt());
+    }
 #endif
     return AIPU_STATUS_SUCCESS;
 }
@@ -679,11 +827,13 @@ uint64_t AIRT::DeviceCtrl::get_shm_offset() const
 }
 
 aipu_status_t AIRT::DeviceCtrl::malloc_buf(uint32_t dtype, uint32_t size, uint32_t align,
-        buffer_desc_t* buf, uint32_t region_id)
+        buffer_desc_t* buf, uint32_t region_id, uint32_t placement, uint32_t owner_tag)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
     int kern_ret = AIPU_ERRCODE_NO_ERROR;
+#else
+    uint64_t pa = 0;
 #endif
 
     if (nullptr == buf)
@@ -699,17 +849,23 @@ aipu_status_t AIRT::DeviceCtrl::malloc_buf(uint32_t dtype, uint32_t size, uint32
     }
 
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
-    kern_ret = dev_op_wrapper_malloc(fd, dtype, size, align, buf, region_id);
+    kern_ret = dev_op_wrapper_malloc(fd, dtype, size, align, buf, region_id, placement, owner_tag);
     if (AIPU_ERRCODE_NO_ERROR != kern_ret)
     {
         ret = AIPU_STATUS_ERROR_BUF_ALLOC_FAIL;
     }
 #else
-    buf->pa = simulation_malloc_top;
+    (void)placement;
+    (void)owner_tag;
+    ret = sim_addr.alloc(size, align, &pa);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+    buf->pa = pa;
     buf->va = new char[ALIGN_PAGE(size)];
     buf->size = ALIGN_PAGE(size);
     buf->real_size = size;
-    simulation_malloc_top += buf->size;
 #endif
 
 #if (defined DEBUG_ZALLOC_ALL_FLAG) && (DEBUG_ZALLOC_ALL_FLAG==1)
@@ -748,6 +904,11 @@ aipu_status_t AIRT::DeviceCtrl::free_buf(const buffer_desc_t* buf)
         goto finish;
     }
 #else
+    ret = sim_addr.free(buf->pa);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
     if (nullptr != buf->va)
     {
         delete[] (char*)buf->va;
@@ -760,10 +921,66 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::DeviceCtrl::migrate_buf(buffer_desc_t* buf, uint32_t align, bool& moved)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    int kern_ret = AIPU_ERRCODE_NO_ERROR;
+#endif
+
+    moved = false;
+    if (nullptr == buf)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    kern_ret = dev_op_wrapper_migrate(fd, buf, align, &moved);
+    if (kern_ret != 0)
+    {
+        LOG(LOG_ERR, "migrate buffer 0x%lx failed! (errno = %d)", (unsigned long)buf->pa, errno);
+        ret = AIPU_STATUS_ERROR_BUF_ALLOC_FAIL;
+    }
+#else
+    (void)align;
+    ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+    return ret;
+}
+
+bool AIRT::DeviceCtrl::is_defrag_requested()
+{
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    uint64_t now = Tracer::now_ns();
+    uint64_t last = defrag_poll_ns.load();
+    uint32_t seq = 0;
+    uint32_t prev = 0;
+
+    /* one ioctl per interval process wide */
+    if ((now - last < DEFRAG_POLL_INTERVAL_NS) || !defrag_poll_ns.compare_exchange_strong(last, now))
+    {
+        return false;
+    }
+
+    if (dev_op_wrapper_get_defrag_seq(fd, &seq) != 0)
+    {
+        return false;
+    }
+
+    prev = defrag_seq.exchange(seq);
+    return prev != seq;
+#else
+    return false;
+#endif
+}
+
 aipu_status_t AIRT::DeviceCtrl::alloc_text_buffer(uint32_t graph_id, const pbuf_alloc_templ_t& pbuf_templ,
     buffer_desc_t& ibuf_desc)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+#if (defined X86_LINUX) && (X86_LINUX==1)
+    uint64_t pa = 0;
+#endif
 
     if (0 == pbuf_templ.text_size)
     {
@@ -780,11 +997,15 @@ aipu_status_t AIRT::DeviceCtrl::alloc_text_buffer(uint32_t graph_id, const pbuf_
         goto finish;
     }
     /* reuse code section buffer in virtual space */
+    ret = sim_addr.alloc(pbuf_templ.text_size, 1, &pa);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
     ibuf_desc.va = (void*)pbuf_templ.text_src;
-    ibuf_desc.pa = simulation_malloc_top;
+    ibuf_desc.pa = pa;
     ibuf_desc.size = ALIGN_PAGE(pbuf_templ.text_size);
     ibuf_desc.real_size = pbuf_templ.text_size;
-    simulation_malloc_top += ibuf_desc.size;
 #endif
 
 finish:
@@ -805,6 +1026,7 @@ aipu_status_t AIRT::DeviceCtrl::load_text_buffer(uint32_t graph_id, const void*
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
 #if (defined X86_LINUX) && (X86_LINUX==1)
     simulation_res_t sim;
+    SimCacheKey text_key;
 #endif
 
     if ((nullptr == src) || (nullptr == ibuf_desc.va))
@@ -833,6 +1055,13 @@ aipu_status_t AIRT::DeviceCtrl::load_text_buffer(uint32_t graph_id, const void*
     }
 
     sim.graph_id = graph_id;
+    if (sim_cache.is_enabled())
+    {
+        text_key.update(src, size);
+        sim.text_digest = text_key.digest();
+    }
+    sim.static_data.va = nullptr;
+    sim.static_data.size = 0;
     graphs[graph_id] = sim;
 #else
     load_buffer(ibuf_desc.va, src, size);
@@ -847,6 +1076,12 @@ aipu_status_t AIRT::DeviceCtrl::free_text_buffer(buffer_desc_t& ibuf_desc)
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
     ret = free_buf(&ibuf_desc);
+#else
+    /* text va is borrowed from the graph binary; only the device range is owned */
+    if (0 != ibuf_desc.size)
+    {
+        ret = sim_addr.free(ibuf_desc.pa);
+    }
 #endif
     return ret;
 }
@@ -859,6 +1094,9 @@ aipu_status_t AIRT::DeviceCtrl::schedule_job_on_aipu(uint32_t graph_id, job_desc
     user_job job2kern;
 #else
     std::map<uint32_t, simulation_res_t>::iterator giter = graphs.end();
+    std::string cache_key;
+    std::vector<sim_cache_region_t> cache_regions;
+    uint64_t sim_start_ns = 0;
 #endif
 
     if(job == nullptr)
@@ -887,8 +1125,13 @@ aipu_status_t AIRT::DeviceCtrl::schedule_job_on_aipu(uint32_t graph_id, job_desc
     job2kern.desc.reuse_size = job->config.reuse_size;
     job2kern.desc.enable_prof = job->config.enable_prof;
     job2kern.desc.enable_asid = job->config.enable_asid;
+    job2kern.desc.dep_job_cnt = job->dep_cnt;
+    for (uint32_t i = 0; i < AIPU_JOB_MAX_DEPS; i++)
+    {
+        job2kern.desc.dep_job_id[i] = (i < job->dep_cnt) ? job->deps[i] : 0;
+    }
     job2kern.errcode = AIPU_ERRCODE_NO_ERROR;
-    kern_ret = ioctl(fd, IPUIOC_RUNJOB, &job2kern);
+    kern_ret = dev_op_wrapper_run_job(fd, &job2kern);
     if ((kern_ret != 0) || (job2kern.errcode != AIPU_ERRCODE_NO_ERROR))
     {
         LOG(LOG_ERR, "load aipu job descriptor to KMD failed! (errcode = %d)", job2kern.errcode);
@@ -898,6 +1141,8 @@ aipu_status_t AIRT::DeviceCtrl::schedule_job_on_aipu(uint32_t graph_id, job_desc
 #endif
 
 #if (defined X86_LINUX) && (X86_LINUX==1)
+    /* jobs are simulated one by one; waiting for the lock is the queuing time */
+    job->ts.submit_ns = Tracer::now_ns();
     pthread_mutex_lock(&glock);
     giter = graphs.find(graph_id);
     if (graphs.end() == giter)
@@ -906,6 +1151,21 @@ aipu_status_t AIRT::DeviceCtrl::schedule_job_on_aipu(uint32_t graph_id, job_desc
         goto unlock;
     }
 
+    if (sim_cache.is_enabled())
+    {
+        cache_key = get_sim_cache_key(giter->second, job->config);
+        get_sim_cache_regions(giter->second, cache_regions);
+        if (sim_cache.lookup(cache_key, cache_regions))
+        {
+            job->ts.start_ns = Tracer::now_ns();
+            job->ts.end_ns = job->ts.start_ns;
+            job->state = JOB_STATE_DONE;
+            ret = AIPU_STATUS_SUCCESS;
+            LOG(LOG_INFO, "Simulation end (cached result %s).", cache_key.c_str());
+            goto unlock;
+        }
+    }
+
     ret = update_simulation_rtcfg(graph_id, job->config);
     if (ret != AIPU_STATUS_SUCCESS)
     {
@@ -913,7 +1173,11 @@ aipu_status_t AIRT::DeviceCtrl::schedule_job_on_aipu(uint32_t graph_id, job_desc
     }
 
     LOG(LOG_DEFAULT, "[UMD SIMULATION] %s", simulation_cmd);
+    sim_start_ns = Tracer::now_ns();
     kern_ret = system(simulation_cmd);
+    job->ts.start_ns = sim_start_ns;
+    job->ts.end_ns = Tracer::now_ns();
+    Tracer::get_tracer().record("simulation", sim_start_ns, job->ts.end_ns, job->id);
     if (kern_ret == -1)
     {
         LOG(LOG_ERR, "Simulation execution failed!");
@@ -952,6 +1216,12 @@ aipu_status_t AIRT::DeviceCtrl::schedule_job_on_aipu(uint32_t graph_id, job_desc
         }
     }
 
+    if (sim_cache.is_enabled())
+    {
+        /* a failed cache write only costs a future re-simulation */
+        sim_cache.store(cache_key, cache_regions);
+    }
+
     job->state = JOB_STATE_DONE;
     ret = AIPU_STATUS_SUCCESS;
     LOG(LOG_INFO, "Simulation end.");
@@ -1033,7 +1303,7 @@ aipu_status_t AIRT::DeviceCtrl::kill_timeout_job(uint32_t job_id)
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
 
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
-    if(ioctl(fd, IPUIOC_KILL_TIMEOUT_JOB, &job_id))
+    if (dev_op_wrapper_kill_job(fd, job_id))
     {
         ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
     }
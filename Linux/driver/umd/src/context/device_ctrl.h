@@ -30,17 +30,23 @@
 #include <string>
 #include <pthread.h>
 #include <signal.h>
+#include <atomic>
 #include "standard_api.h"
 #include "device/dev_op_wrapper.h"
 #include "graph/graph_info.h"
 #include "graph/buffer_desc.h"
 #include "graph/job_desc.h"
 #include "arch/aipu_arch.h"
+#include "sim_cache.h"
+#include "sim_addr_allocator.h"
 
 #define FNAME_LEN 2048
 #define OPT_LEN   2148
 #define CMD_MEN   8000
 
+/* KMD defragmentation requests are polled at most once per interval */
+#define DEFRAG_POLL_INTERVAL_NS  100000000ULL
+
 namespace AIRT
 {
 #if (defined X86_LINUX) && (X86_LINUX==1)
@@ -71,6 +77,10 @@ typedef struct simulation {
     uint32_t odata_whole_pa;
     void*    odata_whole_va;
     uint32_t odata_whole_size;
+    /* job inputs hashed for the simulation result cache */
+    std::string text_digest;
+    sim_cache_region_t static_data;
+    std::vector<sim_cache_region_t> inputs;
 } simulation_res_t;
 #endif /* !X86_LINUX */
 
@@ -85,6 +95,8 @@ private:
     uint32_t aipu_arch;
     uint32_t aipu_version;
     uint32_t aipu_hw_config;
+    std::atomic<uint32_t> defrag_seq;
+    std::atomic<uint64_t> defrag_poll_ns;
 #endif /* !ARM_LINUX */
 
 #if (defined X86_LINUX) && (X86_LINUX==1)
@@ -94,12 +106,13 @@ private:
     std::string output_dir;
     std::string additional_opt;
     bool has_additional_opt;
-    uint32_t simulation_malloc_top;
+    SimAddrAllocator sim_addr;
     char simulation_cmd[CMD_MEN];
     std::map<uint32_t, simulation_res_t> graphs;
     std::map<uint32_t, aipu_arch_t> aipu_arch;
     pthread_mutex_t glock;
     int use_new_arch_sim;
+    SimCache sim_cache;
 
 private:
     aipu_status_t create_simulation_input_file(uint32_t graph_id, const buffer_desc_t& desc,
@@ -113,6 +126,9 @@ private:
         FILE *fp, char* cfg_fname);
     aipu_status_t update_simulation_rtcfg(uint32_t graph_id, const dev_config_t& config);
     void init_aipu_arch();
+    void init_sim_cache();
+    std::string get_sim_cache_key(const simulation_res_t& sim, const dev_config_t& config) const;
+    void get_sim_cache_regions(const simulation_res_t& sim, std::vector<sim_cache_region_t>& regions) const;
 
 public:
     aipu_status_t config_simulation(const aipu_simulation_config_t* config);
@@ -128,9 +144,11 @@ public:
     bool match_target_dev(uint32_t arch, uint32_t version, uint32_t hw_config) const;
     void unload_graph(uint32_t graph_id);
     aipu_status_t malloc_buf(uint32_t dtype, uint32_t size, uint32_t align, buffer_desc_t* buf,
-            uint32_t region_id = 0);
+            uint32_t region_id = 0, uint32_t placement = 0, uint32_t owner_tag = 0);
     void load_buffer(volatile void* dest, const void* src, uint32_t bytes);
     aipu_status_t free_buf(const buffer_desc_t* buf);
+    aipu_status_t migrate_buf(buffer_desc_t* buf, uint32_t align, bool& moved);
+    bool is_defrag_requested();
     aipu_status_t alloc_text_buffer(uint32_t graph_id, const pbuf_alloc_templ_t& pbuf_templ,
         buffer_desc_t& ibuf_desc);
     aipu_status_t alloc_rodata_buffer(uint32_t region_id, const tbuf_alloc_templ_t& pbuf_templ,
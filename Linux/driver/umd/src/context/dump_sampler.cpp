@@ -0,0 +1,179 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  dump_sampler.cpp
+ * @brief AIPU User Mode Driver (UMD) dump policy module implementation
+ */
+
+#include <unistd.h>
+#include <time.h>
+#include "dump_sampler.h"
+#include "utils/log.h"
+
+AIRT::DumpSampler::DumpSampler()
+{
+    enabled = false;
+    mode = AIPU_DUMP_SAMPLE_ALL;
+    every_n = 1;
+    fraction = 0;
+    rand_state = 1;
+    job_cnt = 0;
+    flag = 0;
+    has_selection = false;
+    pthread_mutex_init(&lock, NULL);
+}
+
+AIRT::DumpSampler::~DumpSampler()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+aipu_status_t AIRT::DumpSampler::set(const aipu_dump_policy_t* policy)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    uint32_t policy_flag = 0;
+    const char* policy_dir = ".";
+
+    if (nullptr == policy)
+    {
+        pthread_mutex_lock(&lock);
+        enabled = false;
+        pthread_mutex_unlock(&lock);
+        goto finish;
+    }
+
+    /* nothing is known before the job ends in error */
+    policy_flag = policy->option.flag;
+    if (AIPU_DUMP_SAMPLE_ON_ERROR == policy->mode)
+    {
+        policy_flag &= ~(AIPU_DUMP_BEFORE_RUN | AIPU_DUMP_MEM_MAP);
+    }
+
+    if ((policy->mode >= AIPU_DUMP_SAMPLE_MAX) ||
+        ((AIPU_DUMP_SAMPLE_EVERY_NTH == policy->mode) && (0 == policy->every_n)) ||
+        ((AIPU_DUMP_SAMPLE_RANDOM == policy->mode) &&
+         ((policy->fraction < 0) || (policy->fraction > 1))) ||
+        !Graph::is_dump_flag_valid(policy_flag))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    if ((nullptr != policy->selection) &&
+        (((nullptr != policy->selection->outputs) && (0 == policy->selection->output_cnt)) ||
+         ((nullptr != policy->selection->inter_dumps) && (0 == policy->selection->inter_dump_cnt))))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    if (nullptr != policy->option.dir)
+    {
+        policy_dir = policy->option.dir;
+    }
+    if (access(policy_dir, W_OK) != 0)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_PATH;
+        goto finish;
+    }
+
+    pthread_mutex_lock(&lock);
+    enabled = true;
+    mode = policy->mode;
+    every_n = policy->every_n;
+    fraction = policy->fraction;
+    rand_state = policy->seed ? policy->seed : (uint32_t)time(NULL) | 1;
+    job_cnt = 0;
+    flag = policy_flag;
+    fname_suffix = (nullptr != policy->option.fname_suffix) ? policy->option.fname_suffix : "Default";
+    dir = policy_dir;
+    has_selection = (nullptr != policy->selection);
+    outputs.clear();
+    inter_dumps.clear();
+    if (has_selection)
+    {
+        selection = *policy->selection;
+        if (nullptr != selection.outputs)
+        {
+            outputs.assign(selection.outputs, selection.outputs + selection.output_cnt);
+            selection.outputs = outputs.data();
+        }
+        if (nullptr != selection.inter_dumps)
+        {
+            inter_dumps.assign(selection.inter_dumps, selection.inter_dumps + selection.inter_dump_cnt);
+            selection.inter_dumps = inter_dumps.data();
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+finish:
+    return ret;
+}
+
+bool AIRT::DumpSampler::sample_inner()
+{
+    uint64_t cnt = job_cnt++;
+
+    if (AIPU_DUMP_SAMPLE_EVERY_NTH == mode)
+    {
+        return (0 == cnt % every_n);
+    }
+
+    if (AIPU_DUMP_SAMPLE_RANDOM == mode)
+    {
+        /* xorshift32 */
+        rand_state ^= rand_state << 13;
+        rand_state ^= rand_state >> 17;
+        rand_state ^= rand_state << 5;
+        return ((rand_state >> 8) * (1.0f / (1 << 24))) < fraction;
+    }
+
+    return true;
+}
+
+void AIRT::DumpSampler::apply(Graph* gobj, uint32_t job_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    aipu_dump_option_t option;
+
+    pthread_mutex_lock(&lock);
+    if (!enabled || !sample_inner())
+    {
+        goto unlock;
+    }
+
+    /* a selection not matching the graph leaves the job undumped */
+    if (has_selection)
+    {
+        ret = gobj->set_dump_selection(job_id, &selection);
+    }
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        option.flag = flag;
+        option.fname_suffix = fname_suffix.c_str();
+        option.dir = dir.c_str();
+        ret = gobj->set_dump_options(job_id, &option, AIPU_DUMP_SAMPLE_ON_ERROR == mode);
+    }
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        LOG(LOG_WARN, "dump policy not applied to job 0x%x (%d)", job_id, ret);
+    }
+
+unlock:
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,72 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  dump_sampler.h
+ * @brief AIPU User Mode Driver (UMD) dump policy module header
+ */
+
+#ifndef _DUMP_SAMPLER_H_
+#define _DUMP_SAMPLER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "standard_api.h"
+#include "graph/graph.h"
+
+namespace AIRT
+{
+/**
+ * @brief Dump policy of a context, see AIPU_set_dump_policy(). Every job created is
+ *        sampled and the sampled ones get the dump options/selection of the policy.
+ */
+class DumpSampler
+{
+private:
+    bool enabled;
+    uint32_t mode;
+    uint32_t every_n;
+    float fraction;
+    uint32_t rand_state;
+    uint64_t job_cnt;
+    uint32_t flag;
+    std::string fname_suffix;
+    std::string dir;
+    bool has_selection;
+    std::vector<uint32_t> outputs;
+    std::vector<uint32_t> inter_dumps;
+    aipu_dump_selection_t selection;
+    pthread_mutex_t lock;
+
+private:
+    bool sample_inner();
+
+public:
+    aipu_status_t set(const aipu_dump_policy_t* policy);
+    void apply(Graph* gobj, uint32_t job_id);
+
+public:
+    DumpSampler();
+    ~DumpSampler();
+    DumpSampler(const DumpSampler& sampler) = delete;
+    DumpSampler& operator=(const DumpSampler& sampler) = delete;
+};
+}
+
+#endif /* _DUMP_SAMPLER_H_ */
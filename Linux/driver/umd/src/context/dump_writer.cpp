@@ -0,0 +1,342 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  dump_writer.cpp
+ * @brief AIPU User Mode Driver (UMD) asynchronous dump writer module implementation
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/uio.h>
+#include "dump_writer.h"
+#include "utils/lz4.h"
+#include "utils/log.h"
+
+AIRT::DumpWriter::DumpWriter()
+{
+    pool_bytes = 0;
+    memset(&stats, 0, sizeof(stats));
+    started = false;
+    writing = false;
+    exit_flag = false;
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+AIRT::DumpWriter::~DumpWriter()
+{
+    /* the writer thread writes out the queued dumps before it exits */
+    if (started)
+    {
+        pthread_mutex_lock(&lock);
+        exit_flag = true;
+        pthread_cond_broadcast(&cond);
+        pthread_mutex_unlock(&lock);
+        pthread_join(tid, NULL);
+    }
+    for (uint32_t i = 0; i < pool.size(); i++)
+    {
+        delete pool[i];
+    }
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+std::vector<char>* AIRT::DumpWriter::get_chunk(uint32_t size)
+{
+    std::vector<char>* chunk = nullptr;
+    uint32_t best = 0;
+
+    /* the smallest idle chunk large enough */
+    for (uint32_t i = 0; i < pool.size(); i++)
+    {
+        if ((pool[i]->capacity() >= size) &&
+            ((nullptr == chunk) || (pool[i]->capacity() < chunk->capacity())))
+        {
+            chunk = pool[i];
+            best = i;
+        }
+    }
+
+    if (nullptr == chunk)
+    {
+        chunk = new std::vector<char>();
+    }
+    else
+    {
+        pool.erase(pool.begin() + best);
+        pool_bytes -= chunk->capacity();
+    }
+    chunk->resize(size);
+    return chunk;
+}
+
+void AIRT::DumpWriter::put_chunk(std::vector<char>* chunk)
+{
+    if (pool_bytes + chunk->capacity() > DUMP_POOL_CACHE_MAX)
+    {
+        delete chunk;
+        return;
+    }
+    pool_bytes += chunk->capacity();
+    pool.push_back(chunk);
+}
+
+aipu_status_t AIRT::DumpWriter::write_batch(dump_batch_t* batch,
+    std::vector< std::vector<char> >& packed, uint64_t& written)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    dump_file_header_t file_hdr;
+    std::vector<dump_record_header_t> rec_hdrs(batch->sections.size());
+    std::vector<struct iovec> iov;
+    struct iovec vec;
+    uint32_t packed_size = 0;
+    uint32_t iov_iter = 0;
+    ssize_t len = 0;
+    int fd = -1;
+
+    written = 0;
+    if (packed.size() < batch->sections.size())
+    {
+        packed.resize(batch->sections.size());
+    }
+
+    if (batch->truncate)
+    {
+        memset(&file_hdr, 0, sizeof(file_hdr));
+        memcpy(file_hdr.magic, DUMP_FILE_MAGIC, sizeof(file_hdr.magic));
+        file_hdr.version = DUMP_FILE_VERSION;
+        file_hdr.graph_id = batch->graph_id;
+        file_hdr.job_id = batch->job_id;
+        vec.iov_base = &file_hdr;
+        vec.iov_len = sizeof(file_hdr);
+        iov.push_back(vec);
+    }
+
+    for (uint32_t i = 0; i < batch->sections.size(); i++)
+    {
+        dump_record_header_t& hdr = rec_hdrs[i];
+        const dump_section_t& section = batch->sections[i];
+
+        memset(&hdr, 0, sizeof(hdr));
+        strncpy(hdr.name, section.name.c_str(), sizeof(hdr.name) - 1);
+        hdr.base = section.base;
+        hdr.size = section.size;
+        hdr.stored_size = section.size;
+        hdr.codec = DUMP_CODEC_NONE;
+        vec.iov_base = batch->chunks[i]->data();
+        vec.iov_len = section.size;
+
+        if (batch->compress && section.size)
+        {
+            packed[i].resize(umd_lz4_bound(section.size));
+            packed_size = umd_lz4_compress(batch->chunks[i]->data(), section.size,
+                packed[i].data(), packed[i].size());
+            /* incompressible sections are stored as they are */
+            if ((packed_size > 0) && (packed_size < section.size))
+            {
+                hdr.stored_size = packed_size;
+                hdr.codec = DUMP_CODEC_LZ4;
+                vec.iov_base = packed[i].data();
+                vec.iov_len = packed_size;
+            }
+        }
+
+        iov.push_back(iovec());
+        iov.back().iov_base = &hdr;
+        iov.back().iov_len = sizeof(hdr);
+        iov.push_back(vec);
+    }
+
+    fd = open(batch->fname.c_str(), O_CREAT | O_WRONLY | (batch->truncate ? O_TRUNC : O_APPEND),
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0)
+    {
+        LOG(LOG_ERR, "create dump file failed: %s! (errno = %d)\n", batch->fname.c_str(), errno);
+        ret = AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+        goto finish;
+    }
+
+    while (iov_iter < iov.size())
+    {
+        len = writev(fd, &iov[iov_iter], ((iov.size() - iov_iter) < IOV_MAX) ?
+            (iov.size() - iov_iter) : IOV_MAX);
+        if (len <= 0)
+        {
+            LOG(LOG_ERR, "write dump file %s failed! (errno = %d)\n", batch->fname.c_str(), errno);
+            ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+            goto finish;
+        }
+        written += len;
+
+        /* skip what is written, possibly a part of a vector */
+        while ((iov_iter < iov.size()) && ((size_t)len >= iov[iov_iter].iov_len))
+        {
+            len -= iov[iov_iter].iov_len;
+            iov_iter++;
+        }
+        if (len > 0)
+        {
+            iov[iov_iter].iov_base = (char*)iov[iov_iter].iov_base + len;
+            iov[iov_iter].iov_len -= len;
+        }
+    }
+
+finish:
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return ret;
+}
+
+void* AIRT::DumpWriter::writer_thread(void* arg)
+{
+    DumpWriter* writer = (DumpWriter*)arg;
+    dump_batch_t* batch = nullptr;
+    std::vector< std::vector<char> > packed;
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    uint64_t written = 0;
+
+    pthread_mutex_lock(&writer->lock);
+    while (true)
+    {
+        while (writer->queue.empty() && !writer->exit_flag)
+        {
+            pthread_cond_wait(&writer->cond, &writer->lock);
+        }
+        if (writer->queue.empty())
+        {
+            break;
+        }
+        batch = writer->queue.front();
+        writer->queue.pop_front();
+        writer->writing = true;
+        pthread_mutex_unlock(&writer->lock);
+
+        ret = writer->write_batch(batch, packed, written);
+
+        pthread_mutex_lock(&writer->lock);
+        for (uint32_t i = 0; i < batch->chunks.size(); i++)
+        {
+            writer->put_chunk(batch->chunks[i]);
+        }
+        writer->stats.staged_bytes -= batch->staged;
+        writer->stats.bytes_written += written;
+        if (AIPU_STATUS_SUCCESS == ret)
+        {
+            writer->stats.jobs_dumped++;
+            writer->stats.bytes_dumped += batch->staged;
+        }
+        else
+        {
+            writer->stats.write_errors++;
+        }
+        writer->writing = false;
+        pthread_cond_broadcast(&writer->cond);
+        delete batch;
+    }
+    pthread_mutex_unlock(&writer->lock);
+
+    return NULL;
+}
+
+aipu_status_t AIRT::DumpWriter::submit(const std::string& fname, bool truncate, bool compress,
+    uint32_t graph_id, uint32_t job_id, const std::vector<dump_section_t>& sections)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    dump_batch_t* batch = new dump_batch_t;
+    uint32_t depth = 0;
+
+    batch->fname = fname;
+    batch->truncate = truncate;
+    batch->compress = compress;
+    batch->graph_id = graph_id;
+    batch->job_id = job_id;
+    batch->sections = sections;
+    batch->staged = 0;
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        batch->staged += sections[i].size;
+    }
+
+    pthread_mutex_lock(&lock);
+    if (!started)
+    {
+        if (pthread_create(&tid, NULL, writer_thread, this) != 0)
+        {
+            pthread_mutex_unlock(&lock);
+            delete batch;
+            LOG(LOG_ERR, "create dump writer thread failed!\n");
+            return AIPU_STATUS_ERROR_INVALID_OP;
+        }
+        started = true;
+    }
+
+    /* back pressure: wait for the writer rather than dropping dumps */
+    while ((stats.staged_bytes > 0) && (stats.staged_bytes + batch->staged > DUMP_STAGING_MAX))
+    {
+        pthread_cond_wait(&cond, &lock);
+    }
+    stats.staged_bytes += batch->staged;
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        batch->chunks.push_back(get_chunk(sections[i].size));
+    }
+    pthread_mutex_unlock(&lock);
+
+    /* snapshot the sections; the writer may work on other jobs meanwhile */
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        memcpy(batch->chunks[i]->data(), (const void*)sections[i].va, sections[i].size);
+        batch->sections[i].va = nullptr;
+    }
+
+    pthread_mutex_lock(&lock);
+    queue.push_back(batch);
+    depth = queue.size() + (writing ? 1 : 0);
+    if (depth > stats.max_queue_depth)
+    {
+        stats.max_queue_depth = depth;
+    }
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+
+    return ret;
+}
+
+void AIRT::DumpWriter::sync()
+{
+    pthread_mutex_lock(&lock);
+    while (!queue.empty() || writing)
+    {
+        pthread_cond_wait(&cond, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::DumpWriter::get_stats(aipu_dump_stats_t* out)
+{
+    pthread_mutex_lock(&lock);
+    *out = stats;
+    out->queue_depth = queue.size() + (writing ? 1 : 0);
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,140 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  dump_writer.h
+ * @brief AIPU User Mode Driver (UMD) asynchronous dump writer module header
+ */
+
+#ifndef _DUMP_WRITER_H_
+#define _DUMP_WRITER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <pthread.h>
+#include "standard_api.h"
+
+/* queued dumps wait for the writer once their staging memory exceeds this */
+#define DUMP_STAGING_MAX    (256UL << 20)
+/* idle staging chunks kept for the next dumps */
+#define DUMP_POOL_CACHE_MAX (64UL << 20)
+
+#define DUMP_FILE_MAGIC     "AIPUDUMP"
+#define DUMP_FILE_VERSION   1
+
+namespace AIRT
+{
+typedef enum {
+    DUMP_CODEC_NONE = 0,
+    DUMP_CODEC_LZ4  = 1   /**< LZ4 block format, see utils/lz4.h */
+} dump_codec_t;
+
+/**
+ * Container file of the async dumps of a job: a file header followed by records, each a
+ * record header and <stored_size> bytes of section data. Dumps before and after running
+ * append their records to the same file. All fields are little endian.
+ */
+typedef struct dump_file_header {
+    char magic[8];          /**< DUMP_FILE_MAGIC */
+    uint32_t version;
+    uint32_t graph_id;
+    uint32_t job_id;
+    uint32_t reserved;
+} dump_file_header_t;
+
+typedef struct dump_record_header {
+    char name[64];          /**< e.g. "After_Run_OutTensor0", as in the sync dump file names */
+    uint64_t base;          /**< device address of the section */
+    uint32_t size;          /**< section size */
+    uint32_t stored_size;   /**< size of the data following this header */
+    uint32_t codec;         /**< dump_codec_t */
+    uint32_t reserved;
+} dump_record_header_t;
+
+/**
+ * section of a job to be dumped; va is only read while the job is dumped
+ */
+typedef struct dump_section {
+    std::string name;
+    uint64_t base;
+    const volatile void* va;
+    uint32_t size;
+} dump_section_t;
+
+/**
+ * @brief Process-wide writer of the async dumps (AIPU_DUMP_ASYNC). The sections of a job
+ *        are copied into pooled host staging chunks on the thread dumping the job, and a
+ *        writer thread writes (and compresses) them into the container file of the job with
+ *        one writev() per batch.
+ */
+class DumpWriter
+{
+private:
+    typedef struct dump_batch {
+        std::string fname;
+        bool truncate;
+        bool compress;
+        uint32_t graph_id;
+        uint32_t job_id;
+        std::vector<dump_section_t> sections;
+        std::vector<std::vector<char>*> chunks;
+        uint64_t staged;
+    } dump_batch_t;
+
+private:
+    std::deque<dump_batch_t*> queue;
+    std::vector<std::vector<char>*> pool;
+    uint64_t pool_bytes;
+    aipu_dump_stats_t stats;
+    bool started;
+    bool writing;
+    bool exit_flag;
+    pthread_t tid;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+private:
+    static void* writer_thread(void* arg);
+    std::vector<char>* get_chunk(uint32_t size);
+    void put_chunk(std::vector<char>* chunk);
+    aipu_status_t write_batch(dump_batch_t* batch, std::vector< std::vector<char> >& packed,
+        uint64_t& written);
+
+public:
+    static DumpWriter& get_writer()
+    {
+        static DumpWriter writer;
+        return writer;
+    }
+    aipu_status_t submit(const std::string& fname, bool truncate, bool compress, uint32_t graph_id,
+        uint32_t job_id, const std::vector<dump_section_t>& sections);
+    void sync();
+    void get_stats(aipu_dump_stats_t* out);
+
+public:
+    DumpWriter(const DumpWriter& writer) = delete;
+    DumpWriter& operator=(const DumpWriter& writer) = delete;
+    ~DumpWriter();
+
+private:
+    DumpWriter();
+};
+}
+
+#endif /* _DUMP_WRITER_H_ */
@@ -24,6 +24,7 @@
 #define _BUFFER_DESC_H_
 
 #include <vector>
+#include <map>
 #include "standard_api.h"
 #include "device/dev_op_wrapper.h"
 
@@ -56,6 +57,8 @@ typedef struct thread_buffer_info {
     buffer_desc_t descriptor;
     std::vector<buffer_desc_t> reuse_buf;
     buffer_desc_t reuse_group;
+    bool reuse_shared;  /**< reuse buffers are carved from a shared activation arena */
+    std::map<uint32_t, HOST_PA> input_alias; /**< input index -> output of a pipeline producer */
     iobuf_info_t iobuf;
 } tbuf_info_t;
 
@@ -27,6 +27,8 @@
 #include <sys/mman.h>
 #include <sys/time.h>
 #include "graph.h"
+#include "context/tracer.h"
+#include "printf/aipu_printf.h"
 #include "utils/helper.h"
 #include "utils/log.h"
 
@@ -38,6 +40,7 @@ AIRT::Graph::Graph(uint32_t _id, DeviceCtrl& _ctrl): ctrl(_ctrl)
     gbin_size = 0;
     entry = 0;
     asid_flag = 0;
+    sram_hint = AIPU_SRAM_HINT_AUTO;
     pthread_rwlock_init(&tbuf_lock, NULL);
     pthread_rwlock_init(&job_queue_lock, NULL);
 
@@ -349,9 +352,48 @@ bool AIRT::Graph::is_timeout(struct timeval sched_time, int32_t time_out) const
     }
 }
 
+void AIRT::Graph::add_dump_section(std::vector<dump_section_t>& sections, const char* name,
+    uint64_t base, const volatile void* va, uint32_t size) const
+{
+    dump_section_t section;
+
+    section.name = name;
+    section.base = base;
+    section.va = va;
+    section.size = size;
+    sections.push_back(section);
+}
+
+void AIRT::Graph::add_dump_tensor(std::vector<dump_section_t>& sections, const dump_select_t* sel,
+    const char* name, uint64_t base, const aipu_buffer_t& tensor) const
+{
+    uint32_t offset = 0;
+    uint32_t size = tensor.size;
+
+    /* byte range of the tensor selected, if any */
+    if (nullptr != sel)
+    {
+        if (sel->offset >= tensor.size)
+        {
+            return;
+        }
+        offset = sel->offset;
+        size = tensor.size - offset;
+        if ((sel->length > 0) && (sel->length < size))
+        {
+            size = sel->length;
+        }
+    }
+
+    add_dump_section(sections, name, base + offset, (const volatile char*)tensor.va + offset, size);
+}
+
 void AIRT::Graph::dump_job_buffers(const job_desc_t* job, const tbuf_info_t* tbuf, const char* interfix) const
 {
     char fname[4096];
+    char name[64];
+    std::vector<dump_section_t> sections;
+    bool truncate = false;
 
     if ((nullptr == job) || (nullptr == tbuf))
     {
@@ -361,37 +403,29 @@ void AIRT::Graph::dump_job_buffers(const job_desc_t* job, const tbuf_info_t* tbu
 
     if (job->dump_flag & AIPU_DUMP_TEXT)
     {
-        snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_Text_Section_Base0x%lx_Size0x%lx_%s.bin",
-            job->dump_dir.c_str(), gdesc.id, job->id, interfix,
-            pbuf.text.pa - ctrl.get_shm_offset(), pbuf.text.real_size, job->dump_fname_suffix.c_str());
-        umd_dump_file_helper(fname, (void*)pbuf.text.va, pbuf.text.real_size);
+        add_dump_section(sections, "Text_Section", pbuf.text.pa - ctrl.get_shm_offset(),
+            pbuf.text.va, pbuf.text.real_size);
     }
 
     if (job->dump_flag & AIPU_DUMP_RO)
     {
-        snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_Rodata_Section_Base0x%lx_Size0x%lx_%s.bin",
-            job->dump_dir.c_str(), gdesc.id, job->id, interfix,
-            tbuf->rodata.pa - ctrl.get_shm_offset(), tbuf->rodata.real_size, job->dump_fname_suffix.c_str());
-        umd_dump_file_helper(fname, (void*)tbuf->rodata.va, tbuf->rodata.real_size);
+        add_dump_section(sections, "Rodata_Section", tbuf->rodata.pa - ctrl.get_shm_offset(),
+            tbuf->rodata.va, tbuf->rodata.real_size);
     }
 
     if (job->dump_flag & AIPU_DUMP_STACK)
     {
-        snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_Stack_Section_Base0x%lx_Size0x%lx_%s.bin",
-            job->dump_dir.c_str(), gdesc.id, job->id, interfix,
-            tbuf->stack.pa - ctrl.get_shm_offset(), tbuf->stack.real_size, job->dump_fname_suffix.c_str());
-        umd_dump_file_helper(fname, (void*)tbuf->stack.va, tbuf->stack.real_size);
+        add_dump_section(sections, "Stack_Section", tbuf->stack.pa - ctrl.get_shm_offset(),
+            tbuf->stack.va, tbuf->stack.real_size);
     }
 
     if (job->dump_flag & AIPU_DUMP_STATIC_TENSOR)
     {
         for (uint32_t i = 0; i < pbuf.static_buf.size(); i++)
         {
-            snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_Static_Section%u_Base0x%lx_Size0x%lx_%s.bin",
-                job->dump_dir.c_str(), gdesc.id, job->id, interfix, i,
-                pbuf.static_buf[i].pa - ctrl.get_shm_offset(), pbuf.static_buf[i].real_size,
-                job->dump_fname_suffix.c_str());
-            umd_dump_file_helper(fname, (void*)pbuf.static_buf[i].va, pbuf.static_buf[i].real_size);
+            snprintf(name, sizeof(name), "Static_Section%u", i);
+            add_dump_section(sections, name, pbuf.static_buf[i].pa - ctrl.get_shm_offset(),
+                pbuf.static_buf[i].va, pbuf.static_buf[i].real_size);
         }
     }
 
@@ -399,12 +433,9 @@ void AIRT::Graph::dump_job_buffers(const job_desc_t* job, const tbuf_info_t* tbu
     {
         for (uint32_t i = 0; i < tbuf->reuse_buf.size(); i++)
         {
-            snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_Reuse_Section%u_Base0x%lx_Size0x%lx_%s.bin",
-                job->dump_dir.c_str(), gdesc.id, job->id, interfix, i,
-                tbuf->reuse_buf[i].pa - ctrl.get_shm_offset(),
-                tbuf->reuse_buf[i].real_size, job->dump_fname_suffix.c_str());
-            umd_dump_file_helper(fname, (void*)tbuf->reuse_buf[i].va,
-                tbuf->reuse_buf[i].real_size);
+            snprintf(name, sizeof(name), "Reuse_Section%u", i);
+            add_dump_section(sections, name, tbuf->reuse_buf[i].pa - ctrl.get_shm_offset(),
+                tbuf->reuse_buf[i].va, tbuf->reuse_buf[i].real_size);
         }
     }
 
@@ -413,12 +444,12 @@ void AIRT::Graph::dump_job_buffers(const job_desc_t* job, const tbuf_info_t* tbu
     {
         for (uint32_t i = 0; i < tbuf->iobuf.outputs.number; i++)
         {
-            snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_OutTensor%u_Base0x%lx_Size0x%x_%s.bin",
-                job->dump_dir.c_str(), gdesc.id, job->id, interfix, i,
-                tbuf->iobuf.outputs.pa[i] - ctrl.get_shm_offset(),
-                tbuf->iobuf.outputs.tensors[i].size, job->dump_fname_suffix.c_str());
-            umd_dump_file_helper(fname, (void*)tbuf->iobuf.outputs.tensors[i].va,
-                tbuf->iobuf.outputs.tensors[i].size);
+            if ((nullptr == job->dump_sel) || job->dump_sel->all_outputs || job->dump_sel->outputs[i])
+            {
+                snprintf(name, sizeof(name), "OutTensor%u", i);
+                add_dump_tensor(sections, job->dump_sel, name,
+                    tbuf->iobuf.outputs.pa[i] - ctrl.get_shm_offset(), tbuf->iobuf.outputs.tensors[i]);
+            }
         }
     }
 
@@ -426,14 +457,38 @@ void AIRT::Graph::dump_job_buffers(const job_desc_t* job, const tbuf_info_t* tbu
     {
         for (uint32_t i = 0; i < tbuf->iobuf.inter_dumps.number; i++)
         {
-            snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_InterTensor%u_Base0x%lx_Size0x%x_%s.bin",
-                job->dump_dir.c_str(), gdesc.id, job->id, interfix, i,
-                tbuf->iobuf.inter_dumps.pa[i] - ctrl.get_shm_offset(),
-                tbuf->iobuf.inter_dumps.tensors[i].size, job->dump_fname_suffix.c_str());
-            umd_dump_file_helper(fname, (void*)tbuf->iobuf.inter_dumps.tensors[i].va,
-                tbuf->iobuf.inter_dumps.tensors[i].size);
+            if ((nullptr == job->dump_sel) || job->dump_sel->all_inter_dumps ||
+                job->dump_sel->inter_dumps[i])
+            {
+                snprintf(name, sizeof(name), "InterTensor%u", i);
+                add_dump_tensor(sections, job->dump_sel, name,
+                    tbuf->iobuf.inter_dumps.pa[i] - ctrl.get_shm_offset(), tbuf->iobuf.inter_dumps.tensors[i]);
+            }
         }
     }
+
+    if (job->dump_flag & AIPU_DUMP_ASYNC)
+    {
+        /* one container per job: the first dump of the job creates it */
+        truncate = (interfix[0] == 'B') || !(job->dump_flag & AIPU_DUMP_BEFORE_RUN);
+        for (uint32_t i = 0; i < sections.size(); i++)
+        {
+            sections[i].name = std::string(interfix) + "_" + sections[i].name;
+        }
+        snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s.aipudump",
+            job->dump_dir.c_str(), gdesc.id, job->id, job->dump_fname_suffix.c_str());
+        DumpWriter::get_writer().submit(fname, truncate, job->dump_flag & AIPU_DUMP_LZ4,
+            gdesc.id, job->id, sections);
+        return;
+    }
+
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        snprintf(fname, sizeof(fname), "%s/Graph0x%x_Job0x%x_%s_%s_Base0x%lx_Size0x%x_%s.bin",
+            job->dump_dir.c_str(), gdesc.id, job->id, interfix, sections[i].name.c_str(),
+            (unsigned long)sections[i].base, sections[i].size, job->dump_fname_suffix.c_str());
+        umd_dump_file_helper(fname, (const void*)sections[i].va, sections[i].size);
+    }
 }
 
 void AIRT::Graph::dump_job_mem_map(const job_desc_t* job, const tbuf_info_t* tbuf) const
@@ -673,6 +728,44 @@ bool AIRT::Graph::is_unload_ok()
     return ret;
 }
 
+bool AIRT::Graph::has_thread_buffer()
+{
+    bool ret = false;
+    pthread_rwlock_rdlock(&tbuf_lock);
+    ret = !tbufs.empty();
+    pthread_rwlock_unlock(&tbuf_lock);
+    return ret;
+}
+
+uint32_t AIRT::Graph::get_reuse_size() const
+{
+    return get_group_size(tbuf_templ.reuse_sections);
+}
+
+uint32_t AIRT::Graph::get_reuse_align() const
+{
+    uint32_t align_in_page = 1;
+
+    if (tbuf_templ.reuse_sections.size())
+    {
+        align_in_page = tbuf_templ.reuse_sections[0].align_in_page;
+    }
+    return align_in_page;
+}
+
+void AIRT::Graph::set_sram_hint(aipu_sram_hint_t hint)
+{
+    sram_hint = hint;
+}
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+uint32_t AIRT::Graph::get_reuse_placement() const
+{
+    /* activations are read & written by every layer: the hottest data of a graph */
+    return (AIPU_SRAM_HINT_NONE == sram_hint) ? AIPU_MEM_PLACEMENT_DDR : AIPU_MEM_PLACEMENT_SRAM;
+}
+#endif
+
 void AIRT::Graph::get_graph_desc(aipu_graph_desc_t* gdesc_user) const
 {
     if (nullptr != gdesc_user)
@@ -724,8 +817,6 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
 #if (defined X86_LINUX) && (X86_LINUX==1)
     tbuf_info_t* tbuf = nullptr;
     uint32_t handle = create_buf_handle_inner();
-#else
-    buffer_desc_t buf;
 #endif
     /**
      * No lock in load because load operation will be done before any
@@ -744,6 +835,7 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
     entry = info.entry;
     asid_flag = info.asid_flag;
     linked_list_flag = info.linked_list_flag;
+    pbuf_templ = info.pbuf_templ;
     tbuf_templ = info.tbuf_templ;
     inputs = info.inputs;
     outputs = info.outputs;
@@ -754,6 +846,7 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
     dcr_map = info.dcr_map;
     create_graph_desc(info);
 
+#if (defined X86_LINUX) && (X86_LINUX==1)
     /* alloc and load text buffer */
     ret = ctrl.alloc_text_buffer(gdesc.id, info.pbuf_templ, pbuf.text);
     if (AIPU_STATUS_SUCCESS != ret)
@@ -766,8 +859,8 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
         goto finish;
     }
 
-#if (defined X86_LINUX) && (X86_LINUX==1)
     tbuf = new tbuf_info_t;
+    tbuf->reuse_shared = false;
     ret = ctrl.simulation_alloc_data_buffer(gdesc.id, info.pbuf_templ, pbuf, info.tbuf_templ, *tbuf);
     if (AIPU_STATUS_SUCCESS != ret)
     {
@@ -789,11 +882,57 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
     tbuf->handle = handle;
     tbuf->is_free = true;
     tbufs[handle] = tbuf;
+
+    for (uint32_t i = 0; i < info.pbuf_templ.static_sections.size(); i++)
+    {
+        ctrl.load_buffer(pbuf.static_buf[i].va, info.pbuf_templ.static_sections[i].load_src,
+            info.pbuf_templ.static_sections[i].size);
+    }
 #else
+    ret = alloc_pbuf();
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+#endif
+
+finish:
+    return ret;
+}
+
+uint64_t AIRT::Graph::get_pbuf_size(const pbuf_alloc_templ_t& templ)
+{
+    uint64_t size = ALIGN_PAGE((uint64_t)templ.text_size);
+
+    for (uint32_t i = 0; i < templ.static_sections.size(); i++)
+    {
+        size += ALIGN_PAGE((uint64_t)templ.static_sections[i].size);
+    }
+    return size;
+}
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+aipu_status_t AIRT::Graph::alloc_pbuf()
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    buffer_desc_t buf;
+
+    /* alloc and load text buffer */
+    ret = ctrl.alloc_text_buffer(gdesc.id, pbuf_templ, pbuf.text);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+    ret = ctrl.load_text_buffer(gdesc.id, pbuf_templ.text_src, pbuf_templ.text_size, pbuf.text);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+
     if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
     {
         /* a simple buffer offset computation method meets all size & alignment requirements */
-        ret = alloc_group_buffers(info.pbuf_templ.static_sections, AIPU_MM_DATA_TYPE_STATIC,
+        ret = alloc_group_buffers(pbuf_templ.static_sections, AIPU_MM_DATA_TYPE_STATIC,
             pbuf.static_buf, pbuf.static_group);
         if (AIPU_STATUS_SUCCESS != ret)
         {
@@ -802,10 +941,10 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
     }
     else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_SEPARATED)
     {
-        for (uint32_t i = 0; i < info.pbuf_templ.static_sections.size(); i++)
+        for (uint32_t i = 0; i < pbuf_templ.static_sections.size(); i++)
         {
-            ret = ctrl.malloc_buf(AIPU_MM_DATA_TYPE_STATIC, info.pbuf_templ.static_sections[i].size,
-                info.pbuf_templ.static_sections[i].align_in_page, &buf, 0);
+            ret = ctrl.malloc_buf(AIPU_MM_DATA_TYPE_STATIC, pbuf_templ.static_sections[i].size,
+                pbuf_templ.static_sections[i].align_in_page, &buf, 0);
             if (AIPU_STATUS_SUCCESS != ret)
             {
                 goto finish;
@@ -817,40 +956,194 @@ aipu_status_t AIRT::Graph::load(const graph_info_t& info, bool _map_flag)
         pbuf.static_group.size = 0;
         pbuf.static_group.real_size = 0;
     }
+
+    for (uint32_t i = 0; i < pbuf_templ.static_sections.size(); i++)
+    {
+        ctrl.load_buffer(pbuf.static_buf[i].va, pbuf_templ.static_sections[i].load_src,
+            pbuf_templ.static_sections[i].size);
+    }
+
+finish:
+    return ret;
+}
 #endif
 
-    for (uint32_t i = 0; i < info.pbuf_templ.static_sections.size(); i++)
+aipu_status_t AIRT::Graph::free_pbuf()
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    if (nullptr != pbuf.text.va)
     {
-        ctrl.load_buffer(pbuf.static_buf[i].va, info.pbuf_templ.static_sections[i].load_src,
-            info.pbuf_templ.static_sections[i].size);
+        ret = ctrl.free_text_buffer(pbuf.text);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            goto finish;
+        }
+        pbuf.text.pa = 0;
+        pbuf.text.va = nullptr;
+        pbuf.text.size = 0;
     }
 
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
+    {
+        if (nullptr != pbuf.static_group.va)
+        {
+            ret = ctrl.free_buf(&pbuf.static_group);
+            if (AIPU_STATUS_SUCCESS != ret)
+            {
+                goto finish;
+            }
+            buffer_desc_init(&pbuf.static_group);
+        }
+    }
+    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_SEPARATED)
+    {
+        for (uint32_t i = 0; i < pbuf.static_buf.size(); i++)
+        {
+            ret = ctrl.free_buf(&pbuf.static_buf[i]);
+            if (AIPU_STATUS_SUCCESS != ret)
+            {
+                goto finish;
+            }
+        }
+    }
+    pbuf.static_buf.clear();
+#endif
+
 finish:
     return ret;
 }
 
-aipu_status_t AIRT::Graph::alloc_group_buffers(const std::vector<section_desc_t>& sections,
-        uint32_t dtype, std::vector<buffer_desc_t>& buffers, buffer_desc_t& group)
+bool AIRT::Graph::is_evict_ok()
+{
+    bool ret = false;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    /**
+     * the text/static sources must outlive the load call (graph binary mapped by UMD),
+     * and no job may hold the buffer addresses patched into its rodata
+     */
+    pthread_rwlock_rdlock(&job_queue_lock);
+    ret = map_flag && (nullptr != gbin) && jobs.empty();
+    pthread_rwlock_unlock(&job_queue_lock);
+#endif
+    return ret;
+}
+
+aipu_status_t AIRT::Graph::evict()
 {
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    return free_pbuf();
+#else
+    return AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+}
+
+aipu_status_t AIRT::Graph::reload()
+{
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    aipu_status_t ret = free_pbuf();
+
+    /* buffers of a failed allocation are released for the caller to retry */
+    if (AIPU_STATUS_SUCCESS == ret)
+    {
+        ret = alloc_pbuf();
+    }
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        free_pbuf();
+    }
+    return ret;
+#else
+    return AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+}
+
+bool AIRT::Graph::is_migrate_ok()
+{
+    bool ret = false;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    /* jobs built before hold the current buffer addresses patched in their rodata */
+    pthread_rwlock_rdlock(&job_queue_lock);
+    ret = jobs.empty() && (nullptr != pbuf.text.va);
+    pthread_rwlock_unlock(&job_queue_lock);
+#endif
+    return ret;
+}
+
+aipu_status_t AIRT::Graph::migrate_pbuf(uint32_t& cnt, uint64_t& bytes)
+{
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
-    buffer_desc_t group_buf, child_buf;
-    uint32_t cnt = sections.size();
-    uint32_t* offsets = nullptr;
-    uint32_t tot_bytes = 0;
+    bool moved = false;
 
-    if (cnt)
+    /**
+     * buffers keep their virtual addresses; the device addresses are patched
+     * again by the next build_new_job
+     */
+    ret = ctrl.migrate_buf(&pbuf.text, 1, moved);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+    if (moved)
+    {
+        cnt++;
+        bytes += pbuf.text.size;
+    }
+
+    if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
     {
-        offsets = new uint32_t[cnt];
-        offsets[0] = 0;
-        for (uint32_t i = 1; i < cnt; i++)
+        if (0 == pbuf.static_group.size)
         {
-            offsets[i] = get_aligned_addr(offsets[i - 1] + sections[i - 1].size,
-               sections[i].align_in_page);
+            goto finish;
+        }
+        ret = ctrl.migrate_buf(&pbuf.static_group, pbuf_templ.static_sections[0].align_in_page, moved);
+        if ((AIPU_STATUS_SUCCESS == ret) && moved)
+        {
+            pbuf.static_buf.clear();
+            split_group_buffer(pbuf_templ.static_sections, pbuf.static_group, pbuf.static_buf);
+            cnt++;
+            bytes += pbuf.static_group.size;
+        }
+    }
+    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_SEPARATED)
+    {
+        for (uint32_t i = 0; i < pbuf.static_buf.size(); i++)
+        {
+            ret = ctrl.migrate_buf(&pbuf.static_buf[i], pbuf_templ.static_sections[i].align_in_page, moved);
+            if (AIPU_STATUS_SUCCESS != ret)
+            {
+                goto finish;
+            }
+            if (moved)
+            {
+                cnt++;
+                bytes += pbuf.static_buf[i].size;
+            }
         }
-        tot_bytes = offsets[cnt - 1] + sections[cnt - 1].size;
+    }
+
+finish:
+    return ret;
+#else
+    (void)cnt;
+    (void)bytes;
+    return AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+}
+
+aipu_status_t AIRT::Graph::alloc_group_buffers(const std::vector<section_desc_t>& sections,
+        uint32_t dtype, std::vector<buffer_desc_t>& buffers, buffer_desc_t& group,
+        uint32_t placement)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    buffer_desc_t group_buf;
 
-        ret = ctrl.malloc_buf(dtype, tot_bytes, sections[0].align_in_page,
-                &group_buf);
+    if (sections.size())
+    {
+        ret = ctrl.malloc_buf(dtype, get_group_size(sections), sections[0].align_in_page,
+                &group_buf, 0, placement, gdesc.id);
         if (AIPU_STATUS_SUCCESS != ret)
         {
             goto finish;
@@ -860,24 +1153,53 @@ aipu_status_t AIRT::Graph::alloc_group_buffers(const std::vector<section_desc_t>
         LOG(LOG_CLOSE, "group buffer pa = 0x%lx, size 0x%lx", group_buf.pa,
                 group_buf.size);
 
-        for (uint32_t i = 0; i < cnt; i++)
-        {
-            child_buf.pa = group_buf.pa + offsets[i];
-            child_buf.va = (void*)((unsigned long)group_buf.va + offsets[i]);
-            child_buf.size = sections[i].size;
-            child_buf.real_size = sections[i].size;
-            buffers.push_back(child_buf);
-        }
+        split_group_buffer(sections, group_buf, buffers);
     }
 
 finish:
     return ret;
 }
 
+uint32_t AIRT::Graph::get_group_size(const std::vector<section_desc_t>& sections)
+{
+    uint32_t offset = 0;
+
+    /* a simple buffer offset computation method meets all size & alignment requirements */
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        if (i)
+        {
+            offset = get_aligned_addr(offset, sections[i].align_in_page);
+        }
+        offset += sections[i].size;
+    }
+    return offset;
+}
+
+void AIRT::Graph::split_group_buffer(const std::vector<section_desc_t>& sections,
+        const buffer_desc_t& group, std::vector<buffer_desc_t>& buffers) const
+{
+    buffer_desc_t child_buf;
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        if (i)
+        {
+            offset = get_aligned_addr(offset + sections[i - 1].size, sections[i].align_in_page);
+        }
+        child_buf.pa = group.pa + offset;
+        child_buf.va = (void*)((unsigned long)group.va + offset);
+        child_buf.size = sections[i].size;
+        child_buf.real_size = sections[i].size;
+        child_buf.region_id = group.region_id;
+        buffers.push_back(child_buf);
+    }
+}
+
 aipu_status_t AIRT::Graph::unload()
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
-    std::map<uint32_t, tbuf_info_t*>::iterator tbuf_iter;
     std::map<uint32_t, job_desc_t*>::iterator job_iter;
 
     /**
@@ -893,6 +1215,8 @@ aipu_status_t AIRT::Graph::unload()
 
     for(job_iter = jobs.begin(); job_iter != jobs.end(); job_iter++)
     {
+        notify_job_done(job_iter->first, true);
+        delete job_iter->second->dump_sel;
         delete job_iter->second;
         job_iter->second = nullptr;
     }
@@ -904,47 +1228,16 @@ aipu_status_t AIRT::Graph::unload()
     inter_dumps.clear();
     plog_data.clear();
 
-    if (nullptr != pbuf.text.va)
-    {
-        ret = ctrl.free_text_buffer(pbuf.text);
-        if (AIPU_STATUS_SUCCESS != ret)
-        {
-            goto finish;
-        }
-        pbuf.text.pa = 0;
-        pbuf.text.va = nullptr;
-        pbuf.text.size = 0;
-    }
-
-#if (defined ARM_LINUX) && (ARM_LINUX==1)
-    if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
-    {
-        if (nullptr != pbuf.static_group.va)
-        {
-            ret = ctrl.free_buf(&pbuf.static_group);
-            if (AIPU_STATUS_SUCCESS != ret)
-            {
-                goto finish;
-            }
-        }
-    }
-    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_SEPARATED)
+    ret = free_pbuf();
+    if (AIPU_STATUS_SUCCESS != ret)
     {
-        for (uint32_t i = 0; i < pbuf.static_buf.size(); i++)
-        {
-            ret = ctrl.free_buf(&pbuf.static_buf[i]);
-            if (AIPU_STATUS_SUCCESS != ret)
-            {
-                goto finish;
-            }
-        }
+        goto finish;
     }
-    pbuf.static_buf.clear();
-#endif
 
-    for (tbuf_iter = tbufs.begin(); tbuf_iter != tbufs.end(); tbuf_iter++)
+    /* free_thread_buffer erases the tbuf from the map */
+    while (!tbufs.empty())
     {
-        ret = free_thread_buffer(tbuf_iter->first);
+        ret = free_thread_buffer(tbufs.begin()->first);
         if (AIPU_STATUS_SUCCESS != ret)
         {
             goto finish;
@@ -965,7 +1258,8 @@ finish:
     return ret;
 }
 
-aipu_status_t AIRT::Graph::alloc_thread_buffer(aipu_buffer_alloc_info_t* info)
+aipu_status_t AIRT::Graph::alloc_thread_buffer(aipu_buffer_alloc_info_t* info,
+    const buffer_desc_t* shared_reuse)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     uint32_t handle = 0;
@@ -997,10 +1291,11 @@ aipu_status_t AIRT::Graph::alloc_thread_buffer(aipu_buffer_alloc_info_t* info)
     }
 #else
     tbuf = new tbuf_info_t;
+    tbuf->reuse_shared = false;
     /* initialize tbuf */
-    /* stack */
+    /* stack: shares the ASID of text which KMD does not map to SRAM */
     ret = ctrl.malloc_buf(AIPU_MM_DATA_TYPE_RO_STACK, tbuf_templ.stack_size, tbuf_templ.stack_align_in_page,
-        &tbuf->stack, pbuf.text.region_id);
+        &tbuf->stack, pbuf.text.region_id, AIPU_MEM_PLACEMENT_DDR, gdesc.id);
     if (AIPU_STATUS_SUCCESS != ret)
     {
         goto delete_tbuf;
@@ -1013,11 +1308,18 @@ aipu_status_t AIRT::Graph::alloc_thread_buffer(aipu_buffer_alloc_info_t* info)
     }
 
     /* reuse buffers */
-    if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
+    if (nullptr != shared_reuse)
+    {
+        /* carved from a shared activation arena region which outlives this tbuf */
+        split_group_buffer(tbuf_templ.reuse_sections, *shared_reuse, tbuf->reuse_buf);
+        tbuf->reuse_group = *shared_reuse;
+        tbuf->reuse_shared = true;
+    }
+    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
     {
         /* a simple buffer offset computation method meets all size & alignment requirements */
         ret = alloc_group_buffers(tbuf_templ.reuse_sections, AIPU_MM_DATA_TYPE_REUSE,
-            tbuf->reuse_buf, tbuf->reuse_group);
+            tbuf->reuse_buf, tbuf->reuse_group, get_reuse_placement());
         if (AIPU_STATUS_SUCCESS != ret)
         {
             goto free_ro_reuse;
@@ -1028,7 +1330,7 @@ aipu_status_t AIRT::Graph::alloc_thread_buffer(aipu_buffer_alloc_info_t* info)
         for (uint32_t i = 0; i < tbuf_templ.reuse_sections.size(); i++)
         {
             ret = ctrl.malloc_buf(AIPU_MM_DATA_TYPE_REUSE, tbuf_templ.reuse_sections[i].size,
-                tbuf_templ.reuse_sections[i].align_in_page, &buf, 0);
+                tbuf_templ.reuse_sections[i].align_in_page, &buf, 0, get_reuse_placement(), gdesc.id);
             if (AIPU_STATUS_SUCCESS != ret)
             {
                 goto free_ro_reuse;
@@ -1134,52 +1436,209 @@ aipu_status_t AIRT::Graph::free_thread_buffer(uint32_t handle)
         goto finish;
     }
 
-    /* reuse buffers */
-    if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
+    /* reuse buffers; a shared activation arena region is freed by the arena */
+    if (tbuf->reuse_shared)
+    {
+        tbuf->reuse_buf.clear();
+    }
+    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_GROUP)
+    {
+        ret = ctrl.free_buf(&tbuf->reuse_group);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            goto finish;
+        }
+    }
+    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_SEPARATED)
+    {
+        for (uint32_t i = 0; i < tbuf->reuse_buf.size(); i++)
+        {
+            ret = ctrl.free_buf(&tbuf->reuse_buf[i]);
+            if (AIPU_STATUS_SUCCESS != ret)
+            {
+                goto finish;
+            }
+        }
+    }
+#else
+    ret = ctrl.simulation_free_data_buffer(gdesc.id);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto finish;
+    }
+#endif
+
+    /* free cpu heap buffers */
+    pthread_rwlock_wrlock(&tbuf_lock);
+    destroy_iobuf_info(tbuf->iobuf.inputs);
+    destroy_iobuf_info(tbuf->iobuf.outputs);
+    destroy_iobuf_info(tbuf->iobuf.inter_dumps);
+    destroy_iobuf_info(tbuf->iobuf.plog_data);
+    delete tbuf;
+    tbuf = nullptr;
+    tbufs.erase(handle);
+    pthread_rwlock_unlock(&tbuf_lock);
+
+finish:
+    return ret;
+}
+
+bool AIRT::Graph::is_asid_enabled() const
+{
+    return (hw_version == AIPU_HW_VERSION_ZHOUYI_V2) && IS_ASID_ENABLED(asid_flag);
+}
+
+bool AIRT::Graph::get_input_alias_pa(const tbuf_info_t* tbuf, uint32_t ref_iter, uint32_t sec_offset,
+    HOST_PA& pa) const
+{
+    std::map<uint32_t, HOST_PA>::const_iterator iter;
+
+    for (iter = tbuf->input_alias.begin(); iter != tbuf->input_alias.end(); iter++)
+    {
+        const io_tensor_desc_t& input = inputs[iter->first];
+        if ((input.ref_section_iter == ref_iter) && (sec_offset >= input.offset_in_section) &&
+            (sec_offset < input.offset_in_section + input.size))
+        {
+            pa = iter->second + sec_offset - input.offset_in_section;
+            return true;
+        }
+    }
+    return false;
+}
+
+aipu_status_t AIRT::Graph::get_output_buffer(uint32_t handle, uint32_t output_id, HOST_PA* pa,
+    uint32_t* size)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    tbuf_info_t* tbuf = get_tbuf_ptr(handle);
+
+    if ((nullptr == pa) || (nullptr == size))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == tbuf)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+        goto finish;
+    }
+
+    if (output_id >= tbuf->iobuf.outputs.number)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    *pa = tbuf->iobuf.outputs.pa[output_id];
+    *size = tbuf->iobuf.outputs.tensors[output_id].size;
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::Graph::get_printf_buffers(uint32_t handle, std::vector<aipu_buffer_t>& bufs)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    tbuf_info_t* tbuf = get_tbuf_ptr(handle);
+
+    if (nullptr == tbuf)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+        goto finish;
+    }
+
+    bufs.clear();
+    for (uint32_t i = 0; i < tbuf->iobuf.plog_data.number; i++)
+    {
+        if (tbuf->iobuf.plog_data.tensors[i].size > LOG_HEADER_SZ)
+        {
+            bufs.push_back(tbuf->iobuf.plog_data.tensors[i]);
+        }
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::Graph::set_input_alias(uint32_t handle, uint32_t input_id, HOST_PA pa, uint32_t size)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    tbuf_info_t* tbuf = get_tbuf_ptr(handle);
+
+    if (nullptr == tbuf)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+        goto finish;
+    }
+
+    if (input_id >= inputs.size())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+        goto finish;
+    }
+
+    /* with ASID enabled, rodata holds offsets within the reuse group of this graph */
+    if (is_asid_enabled())
+    {
+        ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+        goto finish;
+    }
+
+    if (!tbuf->is_free)
+    {
+        ret = AIPU_STATUS_ERROR_BUSY_HANDLE;
+        goto finish;
+    }
+
+    /* pa 0 removes the alias */
+    if (0 == pa)
     {
-        ret = ctrl.free_buf(&tbuf->reuse_group);
-        if (AIPU_STATUS_SUCCESS != ret)
-        {
-            goto finish;
-        }
+        tbuf->input_alias.erase(input_id);
     }
-    else if (CURRENT_AIPU_MALLOC_STRATEGY == AIPU_MALLOC_STRATEGY_SEPARATED)
+    else if (size < inputs[input_id].size)
     {
-        for (uint32_t i = 0; i < tbuf->reuse_buf.size(); i++)
-        {
-            ret = ctrl.free_buf(&tbuf->reuse_buf[i]);
-            if (AIPU_STATUS_SUCCESS != ret)
-            {
-                goto finish;
-            }
-        }
+        ret = AIPU_STATUS_ERROR_INVALID_SIZE;
     }
-#else
-    ret = ctrl.simulation_free_data_buffer(gdesc.id);
-    if (AIPU_STATUS_SUCCESS != ret)
+    else
     {
-        goto finish;
+        tbuf->input_alias[input_id] = pa;
     }
-#endif
-
-    /* free cpu heap buffers */
-    pthread_rwlock_wrlock(&tbuf_lock);
-    destroy_iobuf_info(tbuf->iobuf.inputs);
-    destroy_iobuf_info(tbuf->iobuf.outputs);
-    destroy_iobuf_info(tbuf->iobuf.inter_dumps);
-    destroy_iobuf_info(tbuf->iobuf.plog_data);
-    delete tbuf;
-    tbuf = nullptr;
-    tbufs.erase(handle);
-    pthread_rwlock_unlock(&tbuf_lock);
 
 finish:
     return ret;
 }
 
-bool AIRT::Graph::is_asid_enabled() const
+aipu_status_t AIRT::Graph::set_job_deps(uint32_t job_id, const uint32_t* deps, uint32_t cnt)
 {
-    return (hw_version == AIPU_HW_VERSION_ZHOUYI_V2) && IS_ASID_ENABLED(asid_flag);
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    job_desc_t* job = get_job_ptr(job_id);
+
+    if (nullptr == job)
+    {
+        return AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+    }
+
+    if ((cnt > AIPU_JOB_MAX_DEPS) || ((nullptr == deps) && (0 != cnt)))
+    {
+        return AIPU_STATUS_ERROR_INVALID_OPTIONS;
+    }
+
+    /* dependencies are passed to KMD on flush */
+    if (job->state != JOB_STATE_BUILT)
+    {
+        return AIPU_STATUS_ERROR_JOB_SCHED;
+    }
+
+    job->dep_cnt = cnt;
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        job->deps[i] = deps[i];
+    }
+    return AIPU_STATUS_SUCCESS;
+#else
+    return AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
 }
 
 aipu_status_t AIRT::Graph::build_new_job(uint32_t handle, uint32_t* job_id)
@@ -1224,6 +1683,7 @@ aipu_status_t AIRT::Graph::build_new_job(uint32_t handle, uint32_t* job_id)
         uint32_t ref_iter = param_map[i].ref_section_iter;
         uint32_t sec_offset = param_map[i].sub_section_offset;
         uint32_t sub_sec_pa = 0;
+        HOST_PA alias_pa = 0;
         if (param_map[i].offset_in_map >= tbuf->rodata.size)
         {
             ret = AIPU_STATUS_ERROR_INVALID_SIZE;
@@ -1237,7 +1697,12 @@ aipu_status_t AIRT::Graph::build_new_job(uint32_t handle, uint32_t* job_id)
                 ret = AIPU_STATUS_ERROR_INVALID_SIZE;
                 goto finish;
             }
-            sub_sec_pa = host2dev(tbuf->reuse_buf[ref_iter].pa + sec_offset);
+            if (tbuf->input_alias.empty() ||
+                !get_input_alias_pa(tbuf, ref_iter, sec_offset, alias_pa))
+            {
+                alias_pa = tbuf->reuse_buf[ref_iter].pa + sec_offset;
+            }
+            sub_sec_pa = host2dev(alias_pa);
         }
         else if (param_map[i].load_type == PARAM_MAP_LOAD_TYPE_STATIC)
         {
@@ -1280,6 +1745,8 @@ aipu_status_t AIRT::Graph::build_new_job(uint32_t handle, uint32_t* job_id)
     job->state = JOB_STATE_BUILT;
     job->buf_handle = handle;
     job->dump_flag = 0;
+    job->dump_sel = nullptr;
+    job->dump_on_error = false;
     job->config.arch = arch;
     job->config.hw_version = hw_version;
     job->config.hw_config = hw_config;
@@ -1364,6 +1831,67 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::Graph::set_job_done_cb(uint32_t job_id, aipu_job_done_cb_t cb, void* arg)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    job_desc_t* job = get_job_ptr(job_id);
+
+    if (nullptr == job)
+    {
+        return AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+    }
+
+    pthread_mutex_lock(&job->lock);
+    if ((nullptr != cb) && (job->state != JOB_STATE_BUILT))
+    {
+        ret = AIPU_STATUS_ERROR_JOB_SCHED;
+    }
+    else
+    {
+        job->done_cb = cb;
+        job->done_arg = arg;
+    }
+    pthread_mutex_unlock(&job->lock);
+    return ret;
+}
+
+void AIRT::Graph::notify_job_done(uint32_t job_id, bool cancel)
+{
+    job_desc_t* job = get_job_ptr(job_id);
+    aipu_job_done_cb_t cb = nullptr;
+    void* arg = nullptr;
+    aipu_job_status_t status = AIPU_JOB_STATUS_NO_STATUS;
+
+    if (nullptr == job)
+    {
+        return;
+    }
+
+    /**
+     * taken under the lock so that the callback is called only once; jobs timed out or
+     * cancelled before they end report no status
+     */
+    pthread_mutex_lock(&job->lock);
+    if ((nullptr != job->done_cb) && (cancel ||
+        (job->state == JOB_STATE_DONE) || (job->state == JOB_STATE_EXCEPTION) ||
+        (job->state == JOB_STATE_TIMEOUT)))
+    {
+        cb = job->done_cb;
+        arg = job->done_arg;
+        if ((job->state == JOB_STATE_DONE) || (job->state == JOB_STATE_EXCEPTION))
+        {
+            status = (aipu_job_status_t)job->state;
+        }
+        job->done_cb = nullptr;
+    }
+    pthread_mutex_unlock(&job->lock);
+
+    if (nullptr != cb)
+    {
+        cb(job_id, status, arg);
+    }
+}
+
 void AIRT::Graph::set_timespec(struct timespec* time, struct timeval* curr, uint32_t time_out) const
 {
     long nsec = 0;
@@ -1435,6 +1963,7 @@ aipu_status_t AIRT::Graph::wait_for_job_end_sleep(uint32_t job_id, int32_t time_
     {
         ctrl.kill_timeout_job(job_id);
         job->state = JOB_STATE_TIMEOUT;
+        notify_job_done(job_id);
         ret = AIPU_STATUS_ERROR_JOB_TIMEOUT;
         LOG(LOG_INFO, "return timeout");
     }
@@ -1444,7 +1973,7 @@ finish:
     return ret;
 }
 
-void AIRT::Graph::dump_end_job_buffers(uint32_t job_id)
+void AIRT::Graph::dump_end_job_buffers(uint32_t job_id, bool on_error)
 {
     char dump_dir[1024];
 #if (defined ARM_LINUX) && (ARM_LINUX==1)
@@ -1465,6 +1994,18 @@ void AIRT::Graph::dump_end_job_buffers(uint32_t job_id)
         return;
     }
 
+    /**
+     * a job sampled on error is dumped once it ends in exception, either here or on the
+     * error path of wait (exception/timeout); no other job is dumped on the error path
+     */
+    if (on_error != job->dump_on_error)
+    {
+        if (!job->dump_on_error || (job->state != JOB_STATE_EXCEPTION))
+        {
+            return;
+        }
+    }
+
     if (job->dump_flag & AIPU_DUMP_AFTER_RUN)
     {
         dump_job_buffers(job, tbuf, "After_Run");
@@ -1514,6 +2055,37 @@ void AIRT::Graph::dump_end_job_buffers(uint32_t job_id)
         snprintf(buffer, sizeof(buffer), "TOT CYCLE: 0x%016lx\n",
                 ((uint64_t)job->pdata.tot_cycle_msb << 32) + job->pdata.tot_cycle_lsb);
         of.write(buffer, strlen(buffer));
+        if (job->pdata.valid_mask & AIPU_PROFILING_VALID_DMA)
+        {
+            snprintf(buffer, sizeof(buffer), "DMA LATENCY TOT: 0x%016lx\n",
+                ((uint64_t)job->pdata.dma_latency_tot_msb << 32) + job->pdata.dma_latency_tot_lsb);
+            of.write(buffer, strlen(buffer));
+            snprintf(buffer, sizeof(buffer), "DMA RDATA TOT: 0x%016lx\n",
+                ((uint64_t)job->pdata.dma_rdata_tot_msb << 32) + job->pdata.dma_rdata_tot_lsb);
+            of.write(buffer, strlen(buffer));
+            snprintf(buffer, sizeof(buffer), "DMA AR HANDSHAKE: 0x%016lx\n",
+                ((uint64_t)job->pdata.dma_ar_handshake_msb << 32) + job->pdata.dma_ar_handshake_lsb);
+            of.write(buffer, strlen(buffer));
+        }
+        if (job->pdata.valid_mask & AIPU_PROFILING_VALID_OUTSTAND)
+        {
+            snprintf(buffer, sizeof(buffer), "MAX OUTSTANDING: 0x%x\n", job->pdata.max_outstanding);
+            of.write(buffer, strlen(buffer));
+        }
+        if (job->pdata.valid_mask & AIPU_PROFILING_VALID_ID_LAT)
+        {
+            snprintf(buffer, sizeof(buffer), "ID LATENCY MAX: 0x%016lx (single 0x%x)\n",
+                ((uint64_t)job->pdata.id_latency_max_msb << 32) + job->pdata.id_latency_max_lsb,
+                job->pdata.id_latency_single);
+            of.write(buffer, strlen(buffer));
+            for (uint32_t id = 0; id < AIPU_PROFILING_AXI_ID_MAX; id++)
+            {
+                snprintf(buffer, sizeof(buffer), "ID%-2u LATENCY TOT: 0x%016lx MAX: 0x%x\n", id,
+                    ((uint64_t)job->pdata.latency_tot_id_msb[id] << 32) +
+                    job->pdata.latency_tot_id_lsb[id], job->pdata.latency_max_id[id]);
+                of.write(buffer, strlen(buffer));
+            }
+        }
         umd_draw_line_helper(of, '-', 40);
         umd_draw_line_helper(of, '=', 40);
         of.close();
@@ -1521,6 +2093,25 @@ void AIRT::Graph::dump_end_job_buffers(uint32_t job_id)
 #endif
 }
 
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+void AIRT::Graph::trace_kmd_job_timeline(const job_status_desc* status) const
+{
+    Tracer& tracer = Tracer::get_tracer();
+    const struct job_timestamps& ts = status->ts;
+
+    if (!tracer.is_enabled() || (0 == ts.submit_ns))
+    {
+        return;
+    }
+
+    /* KMD timestamps use the same monotonic clock as UMD spans */
+    tracer.record("kmd_pending", ts.submit_ns, ts.trigger_ns, status->job_id, TRACE_EVENT_ASYNC);
+    tracer.record("aipu_execute", ts.trigger_ns, ts.irq_ns, status->job_id, TRACE_EVENT_ASYNC);
+    tracer.record("kmd_irq_to_bh", ts.irq_ns, ts.bh_ns, status->job_id, TRACE_EVENT_ASYNC);
+    tracer.record("kmd_bh_to_umd", ts.bh_ns, Tracer::now_ns(), status->job_id, TRACE_EVENT_ASYNC);
+}
+#endif
+
 aipu_status_t AIRT::Graph::update_job_status(job_status_desc* status, bool is_wake_up)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
@@ -1539,14 +2130,24 @@ aipu_status_t AIRT::Graph::update_job_status(job_status_desc* status, bool is_wa
         goto finish;
     }
 
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    trace_kmd_job_timeline(status);
+#endif
+
     pthread_mutex_lock(&job->lock);
     job->state = (job_state_t)status->state;
     job->pdata = status->pdata;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    job->ts.submit_ns = status->ts.submit_ns;
+    job->ts.start_ns = status->ts.trigger_ns;
+    job->ts.end_ns = status->ts.irq_ns;
+#endif
     if (is_wake_up)
     {
         pthread_cond_signal(&job->cond);
     }
     pthread_mutex_unlock(&job->lock);
+    notify_job_done(status->job_id);
 
 finish:
     return ret;
@@ -1567,6 +2168,7 @@ aipu_status_t AIRT::Graph::update_job_status(uint32_t job_id, job_state_t state)
     pthread_mutex_lock(&job->lock);
     job->state = state;
     pthread_mutex_unlock(&job->lock);
+    notify_job_done(job_id);
 
 finish:
     return ret;
@@ -1615,7 +2217,7 @@ finish:
     return ret;
 }
 
-aipu_status_t AIRT::Graph::clean_job(uint32_t job_id)
+aipu_status_t AIRT::Graph::clean_job(uint32_t job_id, bool discard_built)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     job_desc_t* job = get_job_ptr(job_id);
@@ -1626,7 +2228,8 @@ aipu_status_t AIRT::Graph::clean_job(uint32_t job_id)
         return AIPU_STATUS_ERROR_JOB_NOT_EXIST;
     }
 
-    if (job->state == JOB_STATE_BUILT)
+    /* built jobs are discarded only when a pipeline run is aborted */
+    if ((job->state == JOB_STATE_BUILT) && !discard_built)
     {
         ret = AIPU_STATUS_ERROR_JOB_NOT_SCHED;
         goto finish;
@@ -1638,7 +2241,9 @@ aipu_status_t AIRT::Graph::clean_job(uint32_t job_id)
         goto finish;
     }
 
-    /* state = done/exception/timeout */
+    /* state = done/exception/timeout, or built & discarded; a pending callback is cancelled */
+    notify_job_done(job_id, true);
+
     /* thread buf might be freed before clean_job */
     tbuf = get_tbuf_ptr(job->buf_handle);
     if (nullptr != tbuf)
@@ -1651,6 +2256,7 @@ aipu_status_t AIRT::Graph::clean_job(uint32_t job_id)
     jobs.erase(job->id);
     pthread_mutex_destroy(&job->lock);
     pthread_cond_destroy(&job->cond);
+    delete job->dump_sel;
     delete job;
     job = nullptr;
     pthread_rwlock_unlock(&job_queue_lock);
@@ -1659,7 +2265,26 @@ finish:
     return ret;
 }
 
-aipu_status_t AIRT::Graph::set_dump_options(uint32_t job_id, const aipu_dump_option_t* option)
+bool AIRT::Graph::is_dump_flag_valid(uint32_t flag)
+{
+    /**
+     * invalid options:
+     * 1. use config >= AIPU_DUMP_MAX;
+     * 2. do not set dump timing info;
+     * 3. set dump output before running;
+     * 4. do not set dump what type of data;
+     * 5. compress sync dumps;
+     */
+    return !((flag >= AIPU_DUMP_MAX) ||
+        (!(flag & (AIPU_DUMP_BEFORE_RUN | AIPU_DUMP_AFTER_RUN |
+            AIPU_DUMP_MEM_MAP | AIPU_DUMP_DRV_PROF_DATA))) ||
+        (flag == (AIPU_DUMP_BEFORE_RUN | AIPU_DUMP_OUT_TENSOR)) ||
+        (!(flag & (AIPU_DUMP_BEFORE_RUN - 1))) ||
+        ((flag & AIPU_DUMP_LZ4) && !(flag & AIPU_DUMP_ASYNC)));
+}
+
+aipu_status_t AIRT::Graph::set_dump_options(uint32_t job_id, const aipu_dump_option_t* option,
+    bool on_error)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     job_desc_t* job = get_job_ptr(job_id);
@@ -1683,18 +2308,7 @@ aipu_status_t AIRT::Graph::set_dump_options(uint32_t job_id, const aipu_dump_opt
         goto finish;
     }
 
-    /**
-     * invalid options:
-     * 1. use config >= AIPU_DUMP_MAX;
-     * 2. do not set dump timing info;
-     * 3. set dump output before running;
-     * 4. do not set dump what type of data;
-     */
-    if ((option->flag >= AIPU_DUMP_MAX) ||
-        (!(option->flag & (AIPU_DUMP_BEFORE_RUN | AIPU_DUMP_AFTER_RUN |
-            AIPU_DUMP_MEM_MAP | AIPU_DUMP_DRV_PROF_DATA))) ||
-        (option->flag == (AIPU_DUMP_BEFORE_RUN | AIPU_DUMP_OUT_TENSOR)) ||
-        (!(option->flag & (AIPU_DUMP_BEFORE_RUN - 1))))
+    if (!is_dump_flag_valid(option->flag))
     {
         ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
         goto finish;
@@ -1702,6 +2316,7 @@ aipu_status_t AIRT::Graph::set_dump_options(uint32_t job_id, const aipu_dump_opt
 
     /* success */
     job->dump_flag = option->flag;
+    job->dump_on_error = on_error;
     if (nullptr == option->fname_suffix)
     {
         job->dump_fname_suffix = "Default";
@@ -1730,6 +2345,66 @@ finish:
     return ret;
 }
 
+aipu_status_t AIRT::Graph::set_dump_selection(uint32_t job_id, const aipu_dump_selection_t* selection)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    job_desc_t* job = get_job_ptr(job_id);
+    dump_select_t* sel = nullptr;
+
+    if (nullptr == job)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+    if (job->state != JOB_STATE_BUILT)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_SCHED;
+        goto finish;
+    }
+
+    if (nullptr != selection)
+    {
+        sel = new dump_select_t;
+        sel->all_outputs = (nullptr == selection->outputs);
+        sel->all_inter_dumps = (nullptr == selection->inter_dumps);
+        sel->outputs.assign(outputs.size(), false);
+        sel->inter_dumps.assign(inter_dumps.size(), false);
+        sel->offset = selection->offset;
+        sel->length = selection->length;
+        for (uint32_t i = 0; !sel->all_outputs && (i < selection->output_cnt); i++)
+        {
+            if (selection->outputs[i] >= outputs.size())
+            {
+                ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+                break;
+            }
+            sel->outputs[selection->outputs[i]] = true;
+        }
+        for (uint32_t i = 0; !sel->all_inter_dumps && (i < selection->inter_dump_cnt); i++)
+        {
+            if (selection->inter_dumps[i] >= inter_dumps.size())
+            {
+                ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+                break;
+            }
+            sel->inter_dumps[selection->inter_dumps[i]] = true;
+        }
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            delete sel;
+            goto finish;
+        }
+    }
+
+    /* success */
+    delete job->dump_sel;
+    job->dump_sel = sel;
+
+finish:
+    return ret;
+}
+
 aipu_status_t AIRT::Graph::get_debug_info(uint32_t job_id, aipu_debug_info_t* info)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
@@ -1751,6 +2426,112 @@ aipu_status_t AIRT::Graph::get_debug_info(uint32_t job_id, aipu_debug_info_t* in
     info->start_pc_pa = dev2host(job->config.code.start_pc_pa);
     info->interrupt_pc_pa = dev2host(job->config.code.interrupt_pc_pa);
 
+finish:
+    return ret;
+}
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+static uint64_t get_prof_counter(uint32_t msb, uint32_t lsb)
+{
+    return ((uint64_t)msb << 32) + lsb;
+}
+
+static void convert_profiling_data(const struct profiling_data& pdata, aipu_job_profiling_data_t* data)
+{
+    memset(data, 0, sizeof(aipu_job_profiling_data_t));
+    data->version = pdata.version;
+    data->execution_time_ns = pdata.execution_time_ns;
+    data->rdata_tot = get_prof_counter(pdata.rdata_tot_msb, pdata.rdata_tot_lsb);
+    data->wdata_tot = get_prof_counter(pdata.wdata_tot_msb, pdata.wdata_tot_lsb);
+    data->tot_cycle = get_prof_counter(pdata.tot_cycle_msb, pdata.tot_cycle_lsb);
+    if (pdata.version < 2)
+    {
+        /* not captured (profiling disabled) */
+        return;
+    }
+
+    data->valid_mask = pdata.valid_mask;
+    data->id_latency_max = get_prof_counter(pdata.id_latency_max_msb, pdata.id_latency_max_lsb);
+    data->id_latency_single = pdata.id_latency_single;
+    data->max_outstanding = pdata.max_outstanding;
+    data->dma_latency_tot = get_prof_counter(pdata.dma_latency_tot_msb, pdata.dma_latency_tot_lsb);
+    data->dma_rdata_tot = get_prof_counter(pdata.dma_rdata_tot_msb, pdata.dma_rdata_tot_lsb);
+    data->dma_ar_handshake = get_prof_counter(pdata.dma_ar_handshake_msb, pdata.dma_ar_handshake_lsb);
+    for (uint32_t id = 0; id < AIPU_PROF_AXI_ID_MAX; id++)
+    {
+        data->latency_tot_id[id] = get_prof_counter(pdata.latency_tot_id_msb[id],
+            pdata.latency_tot_id_lsb[id]);
+        data->latency_max_id[id] = pdata.latency_max_id[id];
+    }
+}
+#endif
+
+aipu_status_t AIRT::Graph::get_job_profiling_data(uint32_t job_id, aipu_job_profiling_data_t* data)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    job_desc_t* job = get_job_ptr(job_id);
+
+    if (nullptr == data)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == job)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    pthread_mutex_lock(&job->lock);
+    if ((JOB_STATE_DONE != job->state) && (JOB_STATE_EXCEPTION != job->state))
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_END;
+    }
+    else
+    {
+        convert_profiling_data(job->pdata, data);
+    }
+    pthread_mutex_unlock(&job->lock);
+#else
+    ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIRT::Graph::get_job_timestamps(uint32_t job_id, aipu_job_timestamps_t* ts)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    job_desc_t* job = get_job_ptr(job_id);
+
+    if (nullptr == ts)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == job)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+        goto finish;
+    }
+
+    pthread_mutex_lock(&job->lock);
+    if ((JOB_STATE_DONE != job->state) && (JOB_STATE_EXCEPTION != job->state))
+    {
+        ret = AIPU_STATUS_ERROR_JOB_NOT_END;
+    }
+    else
+    {
+        ts->submit_ns = job->ts.submit_ns;
+        ts->start_ns = job->ts.start_ns;
+        ts->end_ns = job->ts.end_ns;
+    }
+    pthread_mutex_unlock(&job->lock);
+
 finish:
     return ret;
 }
\ No newline at end of file
@@ -28,6 +28,7 @@
 #include <pthread.h>
 #include "standard_api.h"
 #include "context/device_ctrl.h"
+#include "context/dump_writer.h"
 #include "graph_def.h"
 #include "graph_info.h"
 #include "graph_desc_inner.h"
@@ -56,12 +57,14 @@ private:
     uint32_t hw_config;
     uint32_t asid_flag;
     uint32_t linked_list_flag;
+    aipu_sram_hint_t sram_hint;
 
 private:
     /**
      * process shared graph descriptor, IO info., an internal DS
      */
     aipu_graph_desc_inner_t gdesc;
+    pbuf_alloc_templ_t pbuf_templ;
     tbuf_alloc_templ_t tbuf_templ;
     std::vector<io_tensor_desc_t> inputs;
     std::vector<io_tensor_desc_t> outputs;
@@ -103,6 +106,8 @@ private:
     bool is_job_end_inner(uint32_t job_id) const;
     bool is_all_jobs_end_inner() const;
     bool is_asid_enabled() const;
+    bool get_input_alias_pa(const tbuf_info_t* tbuf, uint32_t ref_iter, uint32_t sec_offset,
+        HOST_PA& pa) const;
 
 private:
     void create_iobuf_info(const tbuf_info_t* tbuf, const std::vector<io_tensor_desc_t>& io_tensor_desc,
@@ -115,37 +120,77 @@ private:
 
 private:
     bool is_timeout(struct timeval sched_time, int32_t time_out) const;
+    void add_dump_section(std::vector<dump_section_t>& sections, const char* name, uint64_t base,
+        const volatile void* va, uint32_t size) const;
+    void add_dump_tensor(std::vector<dump_section_t>& sections, const dump_select_t* sel,
+        const char* name, uint64_t base, const aipu_buffer_t& tensor) const;
     void dump_job_buffers(const job_desc_t* job, const tbuf_info_t* tbuf, const char* interfix) const;
     void dump_job_mem_map(const job_desc_t* job, const tbuf_info_t* tbuf) const;
     uint32_t create_buf_handle_inner() const;
     uint32_t create_job_id_inner() const;
     void set_timespec(struct timespec* time, struct timeval* curr, uint32_t time_out) const;
     aipu_status_t alloc_group_buffers(const std::vector<section_desc_t>& sections,
-            uint32_t dtype, std::vector<buffer_desc_t>& buffers, buffer_desc_t& group);
+            uint32_t dtype, std::vector<buffer_desc_t>& buffers, buffer_desc_t& group,
+            uint32_t placement = 0);
+    void split_group_buffer(const std::vector<section_desc_t>& sections, const buffer_desc_t& group,
+            std::vector<buffer_desc_t>& buffers) const;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    aipu_status_t alloc_pbuf();
+#endif
+    aipu_status_t free_pbuf();
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    void trace_kmd_job_timeline(const job_status_desc* status) const;
+#endif
 
 public:
     static uint32_t handle2graph_id(uint32_t buf_handle);
     static uint32_t job_id2graph_id(uint32_t job_id);
+    static uint64_t get_pbuf_size(const pbuf_alloc_templ_t& templ);
+    static uint32_t get_group_size(const std::vector<section_desc_t>& sections);
+    static bool is_dump_flag_valid(uint32_t flag);
 
 public:
     bool is_unload_ok();
+    bool has_thread_buffer();
+    uint32_t get_reuse_size() const;
+    uint32_t get_reuse_align() const;
+    void set_sram_hint(aipu_sram_hint_t hint);
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    uint32_t get_reuse_placement() const;
+#endif
     void get_graph_desc(aipu_graph_desc_t* gdesc_user) const;
     uint32_t get_sched_job_cnt() const;
-    void dump_end_job_buffers(uint32_t job_id);
+    void dump_end_job_buffers(uint32_t job_id, bool on_error = false);
     aipu_status_t is_job_sched(uint32_t job_id);
     bool is_job_end(uint32_t job_id);
 
 public:
     aipu_status_t load(const graph_info_t& info, bool _map_flag);
     aipu_status_t unload();
-    aipu_status_t alloc_thread_buffer(aipu_buffer_alloc_info_t* info);
+    bool is_evict_ok();
+    aipu_status_t evict();
+    aipu_status_t reload();
+    bool is_migrate_ok();
+    aipu_status_t migrate_pbuf(uint32_t& cnt, uint64_t& bytes);
+    aipu_status_t alloc_thread_buffer(aipu_buffer_alloc_info_t* info,
+        const buffer_desc_t* shared_reuse = nullptr);
     aipu_status_t free_thread_buffer(uint32_t handle);
+    aipu_status_t get_output_buffer(uint32_t handle, uint32_t output_id, HOST_PA* pa, uint32_t* size);
+    aipu_status_t get_printf_buffers(uint32_t handle, std::vector<aipu_buffer_t>& bufs);
+    aipu_status_t set_input_alias(uint32_t handle, uint32_t input_id, HOST_PA pa, uint32_t size);
+    aipu_status_t set_job_deps(uint32_t job_id, const uint32_t* deps, uint32_t cnt);
     aipu_status_t build_new_job(uint32_t handle, uint32_t* job_id);
     aipu_status_t flush_job(uint32_t job_id);
+    aipu_status_t set_job_done_cb(uint32_t job_id, aipu_job_done_cb_t cb, void* arg);
+    void notify_job_done(uint32_t job_id, bool cancel = false);
     aipu_status_t wait_for_job_end_sleep(uint32_t job_id, int32_t time_out, aipu_job_status_t* status);
-    aipu_status_t clean_job(uint32_t job_id);
-    aipu_status_t set_dump_options(uint32_t job_id, const aipu_dump_option_t* option);
+    aipu_status_t clean_job(uint32_t job_id, bool discard_built = false);
+    aipu_status_t set_dump_options(uint32_t job_id, const aipu_dump_option_t* option,
+        bool on_error = false);
+    aipu_status_t set_dump_selection(uint32_t job_id, const aipu_dump_selection_t* selection);
     aipu_status_t get_debug_info(uint32_t job_id, aipu_debug_info_t* info);
+    aipu_status_t get_job_profiling_data(uint32_t job_id, aipu_job_profiling_data_t* data);
+    aipu_status_t get_job_timestamps(uint32_t job_id, aipu_job_timestamps_t* ts);
     aipu_status_t update_job_status(job_status_desc* status, bool is_wake_up);
     aipu_status_t get_job_status(uint32_t job_id, aipu_job_status_t* status);
     aipu_status_t update_job_status(uint32_t job_id, job_state_t state);
@@ -24,6 +24,7 @@
 #define _JOB_DESC_H_
 
 #include <string>
+#include <vector>
 #include <pthread.h>
 #include "standard_api.h"
 #include "device/dev_op_wrapper.h"
@@ -62,6 +63,28 @@ typedef struct dev_config {
     uint32_t enable_asid;
 } dev_config_t;
 
+/**
+ * job timestamps in ns (CLOCK_MONOTONIC): from KMD on arm-linux,
+ * and around the simulator execution on x86-linux
+ */
+typedef struct job_time {
+    uint64_t submit_ns;
+    uint64_t start_ns;
+    uint64_t end_ns;
+} job_time_t;
+
+/**
+ * output/intermediate tensors dumped of a job, see aipu_dump_selection_t
+ */
+typedef struct dump_select {
+    bool all_outputs;
+    bool all_inter_dumps;
+    std::vector<bool> outputs;
+    std::vector<bool> inter_dumps;
+    uint32_t offset;
+    uint32_t length;
+} dump_select_t;
+
 typedef struct job_desc {
     uint32_t id;
     uint32_t buf_handle;
@@ -70,10 +93,21 @@ typedef struct job_desc {
     uint32_t dump_flag;
     std::string dump_fname_suffix;
     std::string dump_dir;
+    dump_select_t* dump_sel;   /**< nullptr: whole tensors, all of them */
+    bool dump_on_error;        /**< dumped after running only if ending in exception/timeout */
     struct profiling_data pdata;
+    job_time_t ts;
     struct timeval timeout_start;
     pthread_mutex_t lock;
     pthread_cond_t cond;
+    /* called once when the job ends, if the job is flushed by AIPU_flush_job_async */
+    aipu_job_done_cb_t done_cb;
+    void* done_arg;
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    /* prerequisite jobs tracked by KMD before this job is scheduled */
+    uint32_t dep_cnt;
+    uint32_t deps[AIPU_JOB_MAX_DEPS];
+#endif
 } job_desc_t;
 
 #endif /* _JOB_DESC_H_ */
\ No newline at end of file
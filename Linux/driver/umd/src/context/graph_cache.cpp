@@ -0,0 +1,368 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+
+/**
+ * @file  graph_cache.cpp
+ * @brief AIPU User Mode Driver (UMD) prepared graph cache module implementation
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "graph_cache.h"
+#include "sim_cache.h"
+#include "utils/log.h"
+
+#define GRAPH_CACHE_FNAME_SUFFIX ".gpc"
+#define GRAPH_CACHE_TBL_ALIGN    8
+
+static const uint32_t graph_cache_entry_size[AIRT::GRAPH_CACHE_TBL_MAX] = {
+    sizeof(AIRT::graph_cache_section_t),
+    sizeof(AIRT::graph_cache_section_t),
+    sizeof(AIRT::sub_section_desc_t),
+    sizeof(AIRT::param_map_load_desc_t),
+    sizeof(AIRT::dcr_map_load_desc_t),
+    sizeof(AIRT::io_tensor_desc_t),
+    sizeof(AIRT::io_tensor_desc_t),
+    sizeof(AIRT::io_tensor_desc_t),
+    sizeof(AIRT::io_tensor_desc_t),
+    sizeof(AIRT::io_tensor_desc_t),
+};
+
+template<typename entry_type>
+static const entry_type* get_tbl(const void* base, const AIRT::graph_cache_file_hdr_t* hdr, uint32_t tbl)
+{
+    return (const entry_type*)((unsigned long)base + hdr->tbl[tbl].offset);
+}
+
+template<typename entry_type>
+static void assign_tbl(std::vector<entry_type>& vec, const void* base,
+    const AIRT::graph_cache_file_hdr_t* hdr, uint32_t tbl)
+{
+    const entry_type* first = get_tbl<entry_type>(base, hdr, tbl);
+    vec.assign(first, first + hdr->tbl[tbl].cnt);
+}
+
+template<typename entry_type>
+static void append_tbl(std::vector<char>& file, AIRT::graph_cache_file_hdr_t& hdr, uint32_t tbl,
+    const entry_type* entries, uint32_t cnt)
+{
+    uint64_t offset = (file.size() + GRAPH_CACHE_TBL_ALIGN - 1) & (~(uint64_t)(GRAPH_CACHE_TBL_ALIGN - 1));
+
+    hdr.tbl[tbl].offset = offset;
+    hdr.tbl[tbl].cnt = cnt;
+    hdr.tbl[tbl].entry_size = sizeof(entry_type);
+    file.resize(offset + (uint64_t)cnt * sizeof(entry_type), 0);
+    if (cnt)
+    {
+        memcpy(&file[offset], entries, (uint64_t)cnt * sizeof(entry_type));
+    }
+}
+
+static void flatten_sections(const std::vector<AIRT::section_desc_t>& sections, const void* data_src,
+    std::vector<AIRT::graph_cache_section_t>& flat, std::vector<AIRT::sub_section_desc_t>& subs)
+{
+    AIRT::graph_cache_section_t sec;
+
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        sec.src_offset = (nullptr == sections[i].load_src) ? GRAPH_CACHE_NO_SRC :
+            (uint64_t)((unsigned long)sections[i].load_src - (unsigned long)data_src);
+        sec.size = sections[i].size;
+        sec.align_in_page = sections[i].align_in_page;
+        sec.sub_section_first = subs.size();
+        sec.sub_section_cnt = sections[i].sub_sections.size();
+        subs.insert(subs.end(), sections[i].sub_sections.begin(), sections[i].sub_sections.end());
+        flat.push_back(sec);
+    }
+}
+
+static bool unflatten_sections(const void* base, const AIRT::graph_cache_file_hdr_t* hdr, uint32_t tbl,
+    const void* data_src, std::vector<AIRT::section_desc_t>& sections)
+{
+    const AIRT::graph_cache_section_t* flat = get_tbl<AIRT::graph_cache_section_t>(base, hdr, tbl);
+    const AIRT::sub_section_desc_t* subs = get_tbl<AIRT::sub_section_desc_t>(base, hdr,
+        AIRT::GRAPH_CACHE_TBL_SUB_SEC);
+    uint32_t sub_cnt = hdr->tbl[AIRT::GRAPH_CACHE_TBL_SUB_SEC].cnt;
+
+    sections.resize(hdr->tbl[tbl].cnt);
+    for (uint32_t i = 0; i < sections.size(); i++)
+    {
+        if ((flat[i].sub_section_first > sub_cnt) ||
+            (flat[i].sub_section_cnt > sub_cnt - flat[i].sub_section_first))
+        {
+            return false;
+        }
+        sections[i].load_src = (GRAPH_CACHE_NO_SRC == flat[i].src_offset) ? nullptr :
+            (void*)((unsigned long)data_src + flat[i].src_offset);
+        sections[i].size = flat[i].size;
+        sections[i].align_in_page = flat[i].align_in_page;
+        sections[i].sub_sections.assign(subs + flat[i].sub_section_first,
+            subs + flat[i].sub_section_first + flat[i].sub_section_cnt);
+    }
+
+    return true;
+}
+
+AIRT::GraphCache::GraphCache()
+{
+    enabled = false;
+}
+
+std::string AIRT::GraphCache::get_entry_fname(const std::string& key) const
+{
+    return dir + "/" + key + GRAPH_CACHE_FNAME_SUFFIX;
+}
+
+std::string AIRT::GraphCache::get_key(const graph_info_t& info, uint32_t bss_size)
+{
+    SimCacheKey key;
+    unsigned long gbin_end = (unsigned long)info.gbin + info.gbin_size;
+    unsigned long bss_end = (unsigned long)info.bss_src + sizeof(bss_hdr_v3_t) + bss_size;
+
+    /**
+     * the parsed tables only depend on the header (section offsets, version & flags)
+     * and on the BSS descriptors; text/rodata/data contents are not part of the key
+     */
+    key.update((uint64_t)GRAPH_CACHE_VERSION);
+    key.update(info.gbin, BIN_HDR_SIZE);
+    key.update(info.bss_src, ((bss_end < gbin_end) ? bss_end : gbin_end) - (unsigned long)info.bss_src);
+    return key.digest();
+}
+
+aipu_status_t AIRT::GraphCache::init(const char* cache_dir)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    if (nullptr == cache_dir)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if ((mkdir(cache_dir, S_IRWXU | S_IRWXG | S_IRWXO) != 0) && (errno != EEXIST))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_PATH;
+        goto finish;
+    }
+
+    if (access(cache_dir, W_OK | R_OK) != 0)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_PATH;
+        goto finish;
+    }
+
+    dir = cache_dir;
+    enabled = true;
+    LOG(LOG_DEBUG, "prepared graph cache enabled: %s", dir.c_str());
+
+finish:
+    return ret;
+}
+
+bool AIRT::GraphCache::load_tables(const void* base, uint64_t size, const std::string& key,
+    graph_info_t& info) const
+{
+    const graph_cache_file_hdr_t* hdr = (const graph_cache_file_hdr_t*)base;
+
+    if ((size < sizeof(graph_cache_file_hdr_t)) ||
+        (hdr->magic != GRAPH_CACHE_MAGIC) ||
+        (hdr->version != GRAPH_CACHE_VERSION) ||
+        (hdr->file_size != size) ||
+        (strncmp(hdr->key, key.c_str(), sizeof(hdr->key)) != 0))
+    {
+        return false;
+    }
+
+    /* the entry sizes catch a file written by a UMD build with a different struct layout */
+    for (uint32_t i = 0; i < GRAPH_CACHE_TBL_MAX; i++)
+    {
+        if ((hdr->tbl[i].entry_size != graph_cache_entry_size[i]) ||
+            (hdr->tbl[i].offset % GRAPH_CACHE_TBL_ALIGN) ||
+            (hdr->tbl[i].offset > size) ||
+            ((uint64_t)hdr->tbl[i].cnt * hdr->tbl[i].entry_size > size - hdr->tbl[i].offset))
+        {
+            return false;
+        }
+    }
+
+    if (!unflatten_sections(base, hdr, GRAPH_CACHE_TBL_STATIC_SEC, info.pbuf_templ.data_src,
+            info.pbuf_templ.static_sections) ||
+        !unflatten_sections(base, hdr, GRAPH_CACHE_TBL_REUSE_SEC, info.pbuf_templ.data_src,
+            info.tbuf_templ.reuse_sections))
+    {
+        return false;
+    }
+
+    info.tbuf_templ.stack_size = hdr->stack_size;
+    info.tbuf_templ.stack_align_in_page = hdr->stack_align_in_page;
+    assign_tbl(info.param_map, base, hdr, GRAPH_CACHE_TBL_PARAM_MAP);
+    assign_tbl(info.dcr_map, base, hdr, GRAPH_CACHE_TBL_DCR_MAP);
+    assign_tbl(info.inputs, base, hdr, GRAPH_CACHE_TBL_INPUT);
+    assign_tbl(info.outputs, base, hdr, GRAPH_CACHE_TBL_OUTPUT);
+    assign_tbl(info.inter_dumps, base, hdr, GRAPH_CACHE_TBL_INTER_DUMP);
+    assign_tbl(info.pdata, base, hdr, GRAPH_CACHE_TBL_PROF_DATA);
+    assign_tbl(info.plog_data, base, hdr, GRAPH_CACHE_TBL_PLOG_DATA);
+    return true;
+}
+
+bool AIRT::GraphCache::lookup(const std::string& key, graph_info_t& info) const
+{
+    bool hit = false;
+    int fd = -1;
+    void* va = MAP_FAILED;
+    struct stat st;
+    std::string fname;
+
+    if (!enabled)
+    {
+        return false;
+    }
+
+    fname = get_entry_fname(key);
+    fd = open(fname.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        goto finish;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0))
+    {
+        goto stale;
+    }
+
+    va = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == va)
+    {
+        goto finish;
+    }
+
+    hit = load_tables(va, st.st_size, key, info);
+    munmap(va, st.st_size);
+    if (hit)
+    {
+        LOG(LOG_DEBUG, "prepared graph cache hit: %s", fname.c_str());
+        goto finish;
+    }
+
+stale:
+    /* the caller parses the graph and stores a new file */
+    LOG(LOG_DEBUG, "stale prepared graph cache file dropped: %s", fname.c_str());
+    unlink(fname.c_str());
+    info.pbuf_templ.static_sections.clear();
+    info.tbuf_templ.reuse_sections.clear();
+    info.param_map.clear();
+    info.dcr_map.clear();
+    info.inputs.clear();
+    info.outputs.clear();
+    info.inter_dumps.clear();
+    info.pdata.clear();
+    info.plog_data.clear();
+
+finish:
+    if (fd != -1)
+    {
+        close(fd);
+    }
+    return hit;
+}
+
+aipu_status_t AIRT::GraphCache::store(const std::string& key, const graph_info_t& info) const
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    int fd = -1;
+    graph_cache_file_hdr_t hdr;
+    std::vector<char> file(sizeof(hdr), 0);
+    std::vector<graph_cache_section_t> static_secs;
+    std::vector<graph_cache_section_t> reuse_secs;
+    std::vector<sub_section_desc_t> subs;
+    std::string fname;
+    std::string tmp_fname;
+    char suffix[32];
+
+    if (!enabled)
+    {
+        goto finish;
+    }
+
+    memset(&hdr, 0, sizeof(hdr));
+    flatten_sections(info.pbuf_templ.static_sections, info.pbuf_templ.data_src, static_secs, subs);
+    flatten_sections(info.tbuf_templ.reuse_sections, info.pbuf_templ.data_src, reuse_secs, subs);
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_STATIC_SEC, static_secs.data(), static_secs.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_REUSE_SEC, reuse_secs.data(), reuse_secs.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_SUB_SEC, subs.data(), subs.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_PARAM_MAP, info.param_map.data(), info.param_map.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_DCR_MAP, info.dcr_map.data(), info.dcr_map.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_INPUT, info.inputs.data(), info.inputs.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_OUTPUT, info.outputs.data(), info.outputs.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_INTER_DUMP, info.inter_dumps.data(), info.inter_dumps.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_PROF_DATA, info.pdata.data(), info.pdata.size());
+    append_tbl(file, hdr, GRAPH_CACHE_TBL_PLOG_DATA, info.plog_data.data(), info.plog_data.size());
+
+    hdr.magic = GRAPH_CACHE_MAGIC;
+    hdr.version = GRAPH_CACHE_VERSION;
+    strncpy(hdr.key, key.c_str(), sizeof(hdr.key) - 1);
+    hdr.stack_size = info.tbuf_templ.stack_size;
+    hdr.stack_align_in_page = info.tbuf_templ.stack_align_in_page;
+    hdr.file_size = file.size();
+    memcpy(&file[0], &hdr, sizeof(hdr));
+
+    /* write aside and rename so that concurrent loaders never map a partial file */
+    fname = get_entry_fname(key);
+    snprintf(suffix, sizeof(suffix), ".tmp%d", getpid());
+    tmp_fname = fname + suffix;
+    fd = open(tmp_fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1)
+    {
+        LOG(LOG_ERR, "create graph cache file failed: %s! (errno = %d)", tmp_fname.c_str(), errno);
+        ret = AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+        goto finish;
+    }
+
+    if (write(fd, &file[0], file.size()) != (ssize_t)file.size())
+    {
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+        goto finish;
+    }
+
+    close(fd);
+    fd = -1;
+    if (rename(tmp_fname.c_str(), fname.c_str()) != 0)
+    {
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+        goto finish;
+    }
+    LOG(LOG_DEBUG, "prepared graph cache file created: %s (0x%lx bytes)", fname.c_str(),
+        (unsigned long)file.size());
+
+finish:
+    if (fd != -1)
+    {
+        close(fd);
+    }
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        unlink(tmp_fname.c_str());
+    }
+    return ret;
+}
@@ -0,0 +1,114 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+
+/**
+ * @file  graph_cache.h
+ * @brief AIPU User Mode Driver (UMD) prepared graph cache module header
+ */
+
+#ifndef _GRAPH_CACHE_H_
+#define _GRAPH_CACHE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "standard_api.h"
+#include "graph/graph_def.h"
+#include "graph/graph_info.h"
+
+#define GRAPH_CACHE_MAGIC     0x43505047 /* "GPPC" */
+#define GRAPH_CACHE_VERSION   1
+#define GRAPH_CACHE_NO_SRC    0xFFFFFFFFFFFFFFFFULL
+
+namespace AIRT
+{
+typedef enum {
+    GRAPH_CACHE_TBL_STATIC_SEC = 0,
+    GRAPH_CACHE_TBL_REUSE_SEC,
+    GRAPH_CACHE_TBL_SUB_SEC,
+    GRAPH_CACHE_TBL_PARAM_MAP,
+    GRAPH_CACHE_TBL_DCR_MAP,
+    GRAPH_CACHE_TBL_INPUT,
+    GRAPH_CACHE_TBL_OUTPUT,
+    GRAPH_CACHE_TBL_INTER_DUMP,
+    GRAPH_CACHE_TBL_PROF_DATA,
+    GRAPH_CACHE_TBL_PLOG_DATA,
+    GRAPH_CACHE_TBL_MAX
+} graph_cache_tbl_t;
+
+/**
+ * @brief flat section record; sub-sections of all sections are stored in one table
+ */
+typedef struct graph_cache_section {
+    uint64_t src_offset;          /**< load_src offset from the data section or GRAPH_CACHE_NO_SRC */
+    uint32_t size;
+    uint32_t align_in_page;
+    uint32_t sub_section_first;   /**< index of the first sub-section in the sub-section table */
+    uint32_t sub_section_cnt;
+} graph_cache_section_t;
+
+typedef struct graph_cache_tbl_desc {
+    uint64_t offset;              /**< table offset in file, 8 bytes aligned */
+    uint32_t cnt;
+    uint32_t entry_size;          /**< sizeof entry when the file was created */
+} graph_cache_tbl_desc_t;
+
+typedef struct graph_cache_file_hdr {
+    uint32_t magic;
+    uint32_t version;
+    char     key[36];             /**< the key this file is created for (file name w/o suffix) */
+    uint32_t stack_size;
+    uint32_t stack_align_in_page;
+    uint64_t file_size;
+    graph_cache_tbl_desc_t tbl[GRAPH_CACHE_TBL_MAX];
+} graph_cache_file_hdr_t;
+
+/**
+ * @brief On-disk cache of the parsed BSS section of graph binaries (the graph_info_t tables),
+ *        stored as contiguous arrays and keyed by the hash of the graph header & BSS section.
+ *        A hit mmaps the file and copies the tables in bulk instead of walking the descriptors;
+ *        a stale or corrupted file is dropped and recreated by the next store.
+ */
+class GraphCache
+{
+private:
+    bool enabled;
+    std::string dir;
+
+private:
+    std::string get_entry_fname(const std::string& key) const;
+    bool load_tables(const void* base, uint64_t size, const std::string& key, graph_info_t& info) const;
+
+public:
+    aipu_status_t init(const char* cache_dir);
+    bool is_enabled() const
+    {
+        return enabled;
+    }
+    static std::string get_key(const graph_info_t& info, uint32_t bss_size);
+    bool lookup(const std::string& key, graph_info_t& info) const;
+    aipu_status_t store(const std::string& key, const graph_info_t& info) const;
+
+public:
+    GraphCache();
+    GraphCache(const GraphCache& cache) = delete;
+    GraphCache& operator=(const GraphCache& cache) = delete;
+};
+}
+
+#endif /* _GRAPH_CACHE_H_ */
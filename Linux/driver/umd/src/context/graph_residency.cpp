@@ -0,0 +1,319 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+
+/**
+ * @file  graph_residency.cpp
+ * @brief AIPU User Mode Driver (UMD) graph residency manager module implementation
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "graph_residency.h"
+#include "tracer.h"
+#include "utils/log.h"
+
+AIRT::GraphResidency::GraphResidency()
+{
+    char* budget_mb = getenv("AIPU_GRAPH_RESIDENT_MB");
+
+    budget_bytes = (nullptr != budget_mb) ? (strtoull(budget_mb, NULL, 0) << 20) : 0;
+    resident_bytes = 0;
+    memset(&stats, 0, sizeof(stats));
+    pthread_mutex_init(&lock, NULL);
+}
+
+AIRT::GraphResidency::~GraphResidency()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void AIRT::GraphResidency::touch_no_lock(residency_entry_t& entry)
+{
+    lru.splice(lru.begin(), lru, entry.lru_iter);
+    entry.lru_iter = lru.begin();
+}
+
+bool AIRT::GraphResidency::evict_lru_no_lock(uint32_t exclude_id)
+{
+    std::list<uint32_t>::reverse_iterator iter;
+    residency_entry_t* entry = nullptr;
+
+    for (iter = lru.rbegin(); iter != lru.rend(); iter++)
+    {
+        entry = &entries[*iter];
+        if ((*iter == exclude_id) || (!entry->resident) || entry->pinned || entry->users ||
+            (!entry->gobj->is_evict_ok()))
+        {
+            continue;
+        }
+
+        if (AIPU_STATUS_SUCCESS != entry->gobj->evict())
+        {
+            LOG(LOG_ERR, "evict graph 0x%x failed!", *iter);
+            continue;
+        }
+        entry->resident = false;
+        resident_bytes -= entry->bytes;
+        stats.eviction_cnt++;
+        LOG(LOG_DEBUG, "graph 0x%x evicted (0x%lx bytes)", *iter, (unsigned long)entry->bytes);
+        return true;
+    }
+
+    return false;
+}
+
+void AIRT::GraphResidency::make_room_no_lock(uint64_t bytes, uint32_t exclude_id)
+{
+    if (0 == budget_bytes)
+    {
+        return;
+    }
+
+    while ((resident_bytes + bytes > budget_bytes) && evict_lru_no_lock(exclude_id));
+}
+
+aipu_status_t AIRT::GraphResidency::reload_no_lock(uint32_t id, residency_entry_t& entry)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    uint64_t start_ns = Tracer::now_ns();
+    uint64_t reload_ns = 0;
+
+    make_room_no_lock(entry.bytes, id);
+    ret = entry.gobj->reload();
+    if ((AIPU_STATUS_ERROR_BUF_ALLOC_FAIL == ret) && compact_no_lock())
+    {
+        ret = entry.gobj->reload();
+    }
+    while ((AIPU_STATUS_ERROR_BUF_ALLOC_FAIL == ret) && evict_lru_no_lock(id))
+    {
+        ret = entry.gobj->reload();
+    }
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        LOG(LOG_ERR, "reload graph 0x%x failed!", id);
+        return ret;
+    }
+
+    reload_ns = Tracer::now_ns() - start_ns;
+    entry.resident = true;
+    resident_bytes += entry.bytes;
+    stats.reload_cnt++;
+    stats.reload_ns_tot += reload_ns;
+    if (reload_ns > stats.reload_ns_max)
+    {
+        stats.reload_ns_max = reload_ns;
+    }
+    LOG(LOG_DEBUG, "graph 0x%x reloaded in %lu ns", id, (unsigned long)reload_ns);
+    return ret;
+}
+
+uint32_t AIRT::GraphResidency::compact_no_lock()
+{
+    std::list<uint32_t>::reverse_iterator iter;
+    residency_entry_t* entry = nullptr;
+    uint32_t cnt = 0;
+    uint64_t bytes = 0;
+
+    /* graphs in use or with built jobs keep their buffers in place */
+    for (iter = lru.rbegin(); iter != lru.rend(); iter++)
+    {
+        entry = &entries[*iter];
+        if ((!entry->resident) || entry->users || (!entry->gobj->is_migrate_ok()))
+        {
+            continue;
+        }
+
+        if (AIPU_STATUS_SUCCESS != entry->gobj->migrate_pbuf(cnt, bytes))
+        {
+            LOG(LOG_WARN, "migrate buffers of graph 0x%x failed!", *iter);
+        }
+    }
+
+    stats.defrag_cnt++;
+    stats.migrate_cnt += cnt;
+    stats.migrate_bytes += bytes;
+    LOG(LOG_DEBUG, "compaction migrated %u buffers (0x%lx bytes)", cnt, (unsigned long)bytes);
+    return cnt;
+}
+
+bool AIRT::GraphResidency::compact()
+{
+    bool ret = false;
+
+    pthread_mutex_lock(&lock);
+    ret = (0 != compact_no_lock());
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::GraphResidency::reserve(uint64_t bytes)
+{
+    pthread_mutex_lock(&lock);
+    make_room_no_lock(bytes, 0);
+    pthread_mutex_unlock(&lock);
+}
+
+bool AIRT::GraphResidency::evict_lru()
+{
+    bool ret = false;
+
+    pthread_mutex_lock(&lock);
+    ret = evict_lru_no_lock(0);
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::GraphResidency::add(uint32_t id, Graph* gobj, uint64_t bytes)
+{
+    residency_entry_t entry;
+
+    pthread_mutex_lock(&lock);
+    lru.push_front(id);
+    entry.gobj = gobj;
+    entry.bytes = bytes;
+    entry.resident = true;
+    entry.pinned = false;
+    entry.users = 0;
+    entry.lru_iter = lru.begin();
+    entries[id] = entry;
+    resident_bytes += bytes;
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::GraphResidency::remove(uint32_t id)
+{
+    std::map<uint32_t, residency_entry_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = entries.find(id);
+    if (entries.end() != iter)
+    {
+        if (iter->second.resident)
+        {
+            resident_bytes -= iter->second.bytes;
+        }
+        lru.erase(iter->second.lru_iter);
+        entries.erase(iter);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::GraphResidency::clear()
+{
+    pthread_mutex_lock(&lock);
+    lru.clear();
+    entries.clear();
+    resident_bytes = 0;
+    pthread_mutex_unlock(&lock);
+}
+
+aipu_status_t AIRT::GraphResidency::acquire(uint32_t id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, residency_entry_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = entries.find(id);
+    if (entries.end() == iter)
+    {
+        ret = AIPU_STATUS_ERROR_GRAPH_NOT_EXIST;
+        goto unlock;
+    }
+
+    /* a graph in use is never chosen as an eviction victim */
+    iter->second.users++;
+    if (iter->second.resident)
+    {
+        stats.hit_cnt++;
+    }
+    else
+    {
+        stats.miss_cnt++;
+        ret = reload_no_lock(id, iter->second);
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            iter->second.users--;
+        }
+    }
+    touch_no_lock(iter->second);
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::GraphResidency::release(uint32_t id)
+{
+    std::map<uint32_t, residency_entry_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = entries.find(id);
+    if ((entries.end() != iter) && iter->second.users)
+    {
+        iter->second.users--;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+aipu_status_t AIRT::GraphResidency::set_pinned(uint32_t id, bool pinned)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, residency_entry_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = entries.find(id);
+    if (entries.end() == iter)
+    {
+        ret = AIPU_STATUS_ERROR_GRAPH_NOT_EXIST;
+        goto unlock;
+    }
+
+    /* a pinned graph is made resident at once so that no later job creation pays a reload */
+    if (pinned && (!iter->second.resident))
+    {
+        iter->second.users++;
+        ret = reload_no_lock(id, iter->second);
+        iter->second.users--;
+        if (AIPU_STATUS_SUCCESS != ret)
+        {
+            goto unlock;
+        }
+    }
+    iter->second.pinned = pinned;
+    touch_no_lock(iter->second);
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::GraphResidency::get_stats(aipu_residency_stats_t* out)
+{
+    std::map<uint32_t, residency_entry_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    *out = stats;
+    out->graph_cnt = entries.size();
+    out->resident_cnt = 0;
+    for (iter = entries.begin(); iter != entries.end(); iter++)
+    {
+        out->resident_cnt += iter->second.resident ? 1 : 0;
+    }
+    out->resident_bytes = resident_bytes;
+    pthread_mutex_unlock(&lock);
+}
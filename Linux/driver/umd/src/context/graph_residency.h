@@ -0,0 +1,91 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+
+/**
+ * @file  graph_residency.h
+ * @brief AIPU User Mode Driver (UMD) graph residency manager module header
+ */
+
+#ifndef _GRAPH_RESIDENCY_H_
+#define _GRAPH_RESIDENCY_H_
+
+#include <stdint.h>
+#include <map>
+#include <list>
+#include <pthread.h>
+#include "standard_api.h"
+#include "graph/graph.h"
+
+namespace AIRT
+{
+typedef struct residency_entry {
+    Graph*   gobj;
+    uint64_t bytes;               /**< text & static buffer size of this graph */
+    bool     resident;
+    bool     pinned;
+    uint32_t users;               /**< job creations in progress on this graph */
+    std::list<uint32_t>::iterator lru_iter;
+} residency_entry_t;
+
+/**
+ * @brief Keeps the text & static buffers of the most recently used graphs in device memory.
+ *        Cold graphs are evicted in LRU order (graph metadata stays loaded) when device memory
+ *        runs out or the resident size exceeds AIPU_GRAPH_RESIDENT_MB, and are reloaded from
+ *        their mapped graph binary by the next job creation.
+ *        The text & static buffers of idle resident graphs are also migrated to close the
+ *        holes of fragmented device memory (compact).
+ */
+class GraphResidency
+{
+private:
+    uint64_t budget_bytes;
+    uint64_t resident_bytes;
+    /* front is the most recently used graph */
+    std::list<uint32_t> lru;
+    std::map<uint32_t, residency_entry_t> entries;
+    aipu_residency_stats_t stats;
+    pthread_mutex_t lock;
+
+private:
+    void touch_no_lock(residency_entry_t& entry);
+    bool evict_lru_no_lock(uint32_t exclude_id);
+    void make_room_no_lock(uint64_t bytes, uint32_t exclude_id);
+    aipu_status_t reload_no_lock(uint32_t id, residency_entry_t& entry);
+    uint32_t compact_no_lock();
+
+public:
+    void reserve(uint64_t bytes);
+    bool evict_lru();
+    bool compact();
+    void add(uint32_t id, Graph* gobj, uint64_t bytes);
+    void remove(uint32_t id);
+    void clear();
+    aipu_status_t acquire(uint32_t id);
+    void release(uint32_t id);
+    aipu_status_t set_pinned(uint32_t id, bool pinned);
+    void get_stats(aipu_residency_stats_t* out);
+
+public:
+    GraphResidency();
+    ~GraphResidency();
+    GraphResidency(const GraphResidency& residency) = delete;
+    GraphResidency& operator=(const GraphResidency& residency) = delete;
+};
+}
+
+#endif /* _GRAPH_RESIDENCY_H_ */
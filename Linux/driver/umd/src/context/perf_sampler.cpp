@@ -0,0 +1,388 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  perf_sampler.cpp
+ * @brief AIPU User Mode Driver (UMD) KMD counter sampler consumer implementation (arm-linux)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <unistd.h>
+#include <atomic>
+#include <sys/mman.h>
+#include "perf_sampler.h"
+#include "utils/log.h"
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+AIRT::PerfSampler::PerfSampler()
+{
+    fd = -1;
+    map = nullptr;
+    map_size = 0;
+    hdr = nullptr;
+    tail = 0;
+    has_last = false;
+    memset(&last, 0, sizeof(last));
+    pthread_mutex_init(&lock, NULL);
+}
+
+AIRT::PerfSampler::~PerfSampler()
+{
+    unmap_ring();
+    pthread_mutex_destroy(&lock);
+}
+
+aipu_status_t AIRT::PerfSampler::find_dir()
+{
+    char* env = getenv("AIPU_SAMPLER_DIR");
+    glob_t result;
+
+    if (!dir.empty())
+    {
+        return AIPU_STATUS_SUCCESS;
+    }
+
+    if (nullptr != env)
+    {
+        dir = env;
+        return AIPU_STATUS_SUCCESS;
+    }
+
+    if ((0 != glob("/sys/kernel/debug/aipu-*", 0, NULL, &result)) || (0 == result.gl_pathc))
+    {
+        LOG(LOG_ERR, "AIPU debugfs not found; is debugfs mounted and KMD built with it?");
+        globfree(&result);
+        return AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+    }
+    dir = result.gl_pathv[0];
+    globfree(&result);
+    return AIPU_STATUS_SUCCESS;
+}
+
+aipu_status_t AIRT::PerfSampler::map_ring()
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::string fname;
+    struct aipu_sampler_header head;
+
+    if (nullptr != map)
+    {
+        return AIPU_STATUS_SUCCESS;
+    }
+
+    ret = find_dir();
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    fname = dir + "/sampler_ring";
+    fd = open(fname.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        LOG(LOG_ERR, "open %s failed!", fname.c_str());
+        return AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+    }
+
+    /* map the header first to learn the ring size */
+    map = mmap(NULL, sizeof(head), PROT_READ, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == map)
+    {
+        LOG(LOG_ERR, "map %s failed; is the sampler started?", fname.c_str());
+        ret = AIPU_STATUS_ERROR_MAP_FILE_FAIL;
+        goto error;
+    }
+    memcpy(&head, map, sizeof(head));
+    munmap(map, sizeof(head));
+    map = nullptr;
+
+    if ((AIPU_SAMPLER_MAGIC != head.magic) || (AIPU_SAMPLER_VERSION != head.version) ||
+        (sizeof(struct aipu_sample) != head.sample_size) || (0 == head.capacity) ||
+        (head.capacity & (head.capacity - 1)))
+    {
+        LOG(LOG_ERR, "sampler ring version mismatch with KMD!");
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+        goto error;
+    }
+
+    map_size = head.data_offset + (size_t)head.capacity * head.sample_size;
+    map = mmap(NULL, map_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == map)
+    {
+        LOG(LOG_ERR, "map %s failed!", fname.c_str());
+        map = nullptr;
+        ret = AIPU_STATUS_ERROR_MAP_FILE_FAIL;
+        goto error;
+    }
+    hdr = (const struct aipu_sampler_header*)map;
+    tail = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+    has_last = false;
+    return AIPU_STATUS_SUCCESS;
+
+error:
+    if (MAP_FAILED == map)
+    {
+        map = nullptr;
+    }
+    close(fd);
+    fd = -1;
+    return ret;
+}
+
+void AIRT::PerfSampler::unmap_ring()
+{
+    if (nullptr != map)
+    {
+        munmap(map, map_size);
+        map = nullptr;
+        hdr = nullptr;
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+        fd = -1;
+    }
+}
+
+uint64_t AIRT::PerfSampler::copy_samples(uint64_t from, std::vector<struct aipu_sample>& samples,
+    uint64_t& lost) const
+{
+    const struct aipu_sample* ring = (const struct aipu_sample*)((const char*)hdr + hdr->data_offset);
+    uint64_t cap = hdr->capacity;
+    uint64_t head = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+    uint64_t start = from;
+    uint64_t recheck = 0;
+    uint64_t overwritten = 0;
+
+    if (head < from)
+    {
+        /* ring re-created by a reloaded KMD */
+        start = 0;
+    }
+
+    if ((head > cap) && (start < head - cap))
+    {
+        lost += head - cap - start;
+        start = head - cap;
+    }
+
+    samples.clear();
+    for (uint64_t i = start; i < head; i++)
+    {
+        samples.push_back(ring[i & (cap - 1)]);
+    }
+
+    /* samples overwritten by KMD while being copied are dropped */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    recheck = __atomic_load_n(&hdr->head, __ATOMIC_RELAXED);
+    if (recheck + 1 > start + cap)
+    {
+        overwritten = recheck + 1 - cap - start;
+        if (overwritten > samples.size())
+        {
+            overwritten = samples.size();
+        }
+        samples.erase(samples.begin(), samples.begin() + overwritten);
+        lost += overwritten;
+    }
+
+    return head;
+}
+
+aipu_status_t AIRT::PerfSampler::config(uint32_t period_us)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::string fname;
+    FILE* fp = nullptr;
+
+    pthread_mutex_lock(&lock);
+    ret = find_dir();
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto unlock;
+    }
+
+    fname = dir + "/sampler";
+    fp = fopen(fname.c_str(), "w");
+    if (nullptr == fp)
+    {
+        LOG(LOG_ERR, "open %s failed!", fname.c_str());
+        ret = AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+        goto unlock;
+    }
+    fprintf(fp, "%u\n", period_us);
+    if ((0 != fflush(fp)) || ferror(fp))
+    {
+        LOG(LOG_ERR, "set sampling period %uus failed (min. period is 100us)!", period_us);
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+    }
+    fclose(fp);
+
+    if ((AIPU_STATUS_SUCCESS == ret) && period_us)
+    {
+        ret = map_ring();
+        if ((AIPU_STATUS_SUCCESS == ret) && (nullptr != hdr))
+        {
+            /* statistics start from now */
+            tail = __atomic_load_n(&hdr->head, __ATOMIC_ACQUIRE);
+            has_last = false;
+        }
+    }
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PerfSampler::get_stats(aipu_perf_sampling_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::vector<struct aipu_sample> samples;
+    const struct aipu_sample* prev = nullptr;
+    uint64_t busy_cnt = 0;
+    uint64_t sched_sum = 0;
+    uint64_t dt = 0;
+    uint64_t bw_dt = 0;
+    uint64_t first_ts = 0;
+    double rate = 0;
+
+    if (nullptr == stats)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    memset(stats, 0, sizeof(aipu_perf_sampling_stats_t));
+    pthread_mutex_lock(&lock);
+    ret = map_ring();
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto unlock;
+    }
+
+    tail = copy_samples(tail, samples, stats->lost_cnt);
+    if (samples.empty())
+    {
+        goto unlock;
+    }
+
+    prev = has_last ? &last : nullptr;
+    first_ts = has_last ? last.ts_ns : samples[0].ts_ns;
+    for (uint32_t i = 0; i < samples.size(); i++)
+    {
+        const struct aipu_sample& cur = samples[i];
+
+        stats->sample_cnt++;
+        busy_cnt += (cur.flags & AIPU_SAMPLE_FLAG_BUSY) ? 1 : 0;
+        sched_sum += cur.sched_num;
+        if ((cur.flags & AIPU_SAMPLE_FLAG_DMA_VALID) && (cur.max_outstanding > stats->max_outstanding))
+        {
+            stats->max_outstanding = cur.max_outstanding;
+        }
+
+        /**
+         * counters are cumulative; a pair is skipped if counters were not captured or
+         * restarted in between (e.g. by per-job profiling)
+         */
+        if ((nullptr != prev) && (prev->flags & cur.flags & AIPU_SAMPLE_FLAG_BW_VALID) &&
+            (cur.ts_ns > prev->ts_ns) && (cur.rdata_tot >= prev->rdata_tot) &&
+            (cur.wdata_tot >= prev->wdata_tot) && (cur.tot_cycle >= prev->tot_cycle))
+        {
+            dt = cur.ts_ns - prev->ts_ns;
+            bw_dt += dt;
+            stats->rdata_tot += cur.rdata_tot - prev->rdata_tot;
+            stats->wdata_tot += cur.wdata_tot - prev->wdata_tot;
+            stats->tot_cycle += cur.tot_cycle - prev->tot_cycle;
+            rate = (cur.rdata_tot - prev->rdata_tot) * 1e9 / dt;
+            stats->peak_rdata_per_sec = (rate > stats->peak_rdata_per_sec) ? rate : stats->peak_rdata_per_sec;
+            rate = (cur.wdata_tot - prev->wdata_tot) * 1e9 / dt;
+            stats->peak_wdata_per_sec = (rate > stats->peak_wdata_per_sec) ? rate : stats->peak_wdata_per_sec;
+        }
+        prev = &cur;
+    }
+
+    stats->window_ns = samples.back().ts_ns - first_ts;
+    stats->busy_ratio = (double)busy_cnt / stats->sample_cnt;
+    stats->avg_jobs_in_flight = (double)sched_sum / stats->sample_cnt;
+    if (bw_dt)
+    {
+        stats->rdata_per_sec = stats->rdata_tot * 1e9 / bw_dt;
+        stats->wdata_per_sec = stats->wdata_tot * 1e9 / bw_dt;
+    }
+    last = samples.back();
+    has_last = true;
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PerfSampler::dump(const char* fname)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::vector<struct aipu_sample> samples;
+    uint64_t lost = 0;
+    FILE* fp = nullptr;
+
+    if (nullptr == fname)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    pthread_mutex_lock(&lock);
+    ret = map_ring();
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        goto unlock;
+    }
+
+    fp = fopen(fname, "w");
+    if (nullptr == fp)
+    {
+        LOG(LOG_ERR, "open %s failed!", fname);
+        ret = AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+        goto unlock;
+    }
+
+    /* all samples still in the ring; the statistics read position is not changed */
+    copy_samples(0, samples, lost);
+    fprintf(fp, "ts_ns,flags,busy,sched_num,status_reg,rdata_tot,wdata_tot,tot_cycle,"
+        "dma_latency_tot,max_outstanding\n");
+    for (uint32_t i = 0; i < samples.size(); i++)
+    {
+        const struct aipu_sample& s = samples[i];
+        fprintf(fp, "%llu,0x%x,%u,%u,0x%x,%llu,%llu,%llu,%llu,%u\n",
+            (unsigned long long)s.ts_ns, s.flags, (s.flags & AIPU_SAMPLE_FLAG_BUSY) ? 1 : 0,
+            s.sched_num, s.status_reg, (unsigned long long)s.rdata_tot,
+            (unsigned long long)s.wdata_tot, (unsigned long long)s.tot_cycle,
+            (unsigned long long)s.dma_latency_tot, s.max_outstanding);
+    }
+    if (ferror(fp))
+    {
+        LOG(LOG_ERR, "write %s failed!", fname);
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+    }
+    fclose(fp);
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+#endif /* ARM_LINUX */
@@ -0,0 +1,84 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  perf_sampler.h
+ * @brief AIPU User Mode Driver (UMD) KMD counter sampler consumer header (arm-linux)
+ */
+
+#ifndef _PERF_SAMPLER_H_
+#define _PERF_SAMPLER_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include "standard_api.h"
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+#include "device/arm-linux/aipu_sampler.h"
+#endif
+
+namespace AIRT
+{
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+/**
+ * @brief Reader of the counter sampler ring exported by KMD via debugfs; the ring is
+ *        mmapped read-only and consumed without any syscall. The debugfs directory is
+ *        found by globbing /sys/kernel/debug/aipu-* unless AIPU_SAMPLER_DIR is set.
+ */
+class PerfSampler
+{
+private:
+    std::string dir;
+    int fd;
+    void* map;
+    size_t map_size;
+    const struct aipu_sampler_header* hdr;
+    uint64_t tail;
+    bool has_last;
+    struct aipu_sample last;
+    pthread_mutex_t lock;
+
+private:
+    aipu_status_t find_dir();
+    aipu_status_t map_ring();
+    void unmap_ring();
+    uint64_t copy_samples(uint64_t from, std::vector<struct aipu_sample>& samples,
+        uint64_t& lost) const;
+
+public:
+    static PerfSampler& get_sampler()
+    {
+        static PerfSampler sampler;
+        return sampler;
+    }
+    aipu_status_t config(uint32_t period_us);
+    aipu_status_t get_stats(aipu_perf_sampling_stats_t* stats);
+    aipu_status_t dump(const char* fname);
+
+public:
+    PerfSampler(const PerfSampler& sampler) = delete;
+    PerfSampler& operator=(const PerfSampler& sampler) = delete;
+    ~PerfSampler();
+
+private:
+    PerfSampler();
+};
+#endif /* ARM_LINUX */
+}
+
+#endif /* _PERF_SAMPLER_H_ */
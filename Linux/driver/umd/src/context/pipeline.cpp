@@ -0,0 +1,241 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+
+/**
+ * @file  pipeline.cpp
+ * @brief AIPU User Mode Driver (UMD) multi-graph pipeline module implementation
+ */
+
+#include "pipeline.h"
+
+AIRT::PipelineTable::PipelineTable()
+{
+    next_id = 1;
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+AIRT::PipelineTable::~PipelineTable()
+{
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+bool AIRT::PipelineTable::is_handle_used_no_lock(uint32_t handle) const
+{
+    std::map<uint32_t, pipeline_desc_t>::const_iterator iter;
+
+    for (iter = pipes.begin(); iter != pipes.end(); iter++)
+    {
+        for (uint32_t i = 0; i < iter->second.stages.size(); i++)
+        {
+            if (iter->second.stages[i].handle == handle)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool AIRT::PipelineTable::is_handle_used(uint32_t handle)
+{
+    bool ret = false;
+
+    pthread_mutex_lock(&lock);
+    ret = is_handle_used_no_lock(handle);
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+bool AIRT::PipelineTable::is_graph_used(uint32_t graph_id)
+{
+    bool ret = false;
+    std::map<uint32_t, pipeline_desc_t>::const_iterator iter;
+
+    pthread_mutex_lock(&lock);
+    for (iter = pipes.begin(); (iter != pipes.end()) && !ret; iter++)
+    {
+        for (uint32_t i = 0; i < iter->second.stages.size(); i++)
+        {
+            if (iter->second.stages[i].graph_id == graph_id)
+            {
+                ret = true;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PipelineTable::add(const pipeline_desc_t& desc, uint32_t* id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&lock);
+    for (uint32_t i = 0; i < desc.stages.size(); i++)
+    {
+        if (is_handle_used_no_lock(desc.stages[i].handle))
+        {
+            ret = AIPU_STATUS_ERROR_BUSY_HANDLE;
+            goto unlock;
+        }
+    }
+
+    while (pipes.count(next_id) || (0 == next_id))
+    {
+        next_id++;
+    }
+    *id = next_id++;
+    pipes[*id] = desc;
+    pipes[*id].jobs.clear();
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PipelineTable::remove(uint32_t id, pipeline_desc_t& desc)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, pipeline_desc_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = pipes.find(id);
+    if (iter == pipes.end())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+    }
+    else if (!iter->second.jobs.empty())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+    }
+    else
+    {
+        desc = iter->second;
+        pipes.erase(iter);
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PipelineTable::get(uint32_t id, pipeline_desc_t& desc)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, pipeline_desc_t>::const_iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = pipes.find(id);
+    if (iter == pipes.end())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+    }
+    else
+    {
+        desc = iter->second;
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PipelineTable::start(uint32_t id, const std::vector<uint32_t>& jobs, bool handoff)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, pipeline_desc_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = pipes.find(id);
+    if (iter == pipes.end())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_HANDLE;
+    }
+    else if (!iter->second.jobs.empty())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OP;
+    }
+    else
+    {
+        iter->second.jobs = jobs;
+        for (uint32_t i = 0; handoff && (i < jobs.size()); i++)
+        {
+            next_jobs[jobs[i]] = (i + 1 < jobs.size()) ? jobs[i + 1] : 0;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::PipelineTable::stop(uint32_t id)
+{
+    std::map<uint32_t, pipeline_desc_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = pipes.find(id);
+    if (iter != pipes.end())
+    {
+        for (uint32_t i = 0; i < iter->second.jobs.size(); i++)
+        {
+            next_jobs.erase(iter->second.jobs[i]);
+        }
+        iter->second.jobs.clear();
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+uint32_t AIRT::PipelineTable::take_next_job(uint32_t job_id)
+{
+    uint32_t next = 0;
+    std::map<uint32_t, uint32_t>::iterator iter;
+
+    /**
+     * the chain is taken once: by the poller or the waiter observing the job end first;
+     * the next job is handed off until end_handoff()
+     */
+    pthread_mutex_lock(&lock);
+    iter = next_jobs.find(job_id);
+    if (iter != next_jobs.end())
+    {
+        next = iter->second;
+        next_jobs.erase(iter);
+        if (0 != next)
+        {
+            handoffs.insert(next);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return next;
+}
+
+void AIRT::PipelineTable::end_handoff(uint32_t job_id)
+{
+    pthread_mutex_lock(&lock);
+    handoffs.erase(job_id);
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::PipelineTable::wait_handoff(uint32_t job_id)
+{
+    pthread_mutex_lock(&lock);
+    while (handoffs.count(job_id))
+    {
+        pthread_cond_wait(&cond, &lock);
+    }
+    pthread_mutex_unlock(&lock);
+}
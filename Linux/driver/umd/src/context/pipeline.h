@@ -0,0 +1,84 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+
+/**
+ * @file  pipeline.h
+ * @brief AIPU User Mode Driver (UMD) multi-graph pipeline module header
+ */
+
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <vector>
+#include <pthread.h>
+#include "standard_api.h"
+
+namespace AIRT
+{
+typedef struct pipeline_desc {
+    std::vector<aipu_pipeline_stage_t> stages;
+    std::vector<aipu_pipeline_link_t> links;
+    std::vector<uint32_t> jobs;   /**< jobs of the current run, one per stage; empty while idle */
+} pipeline_desc_t;
+
+/**
+ * @brief Pipelines of a context. The tensor buffer of a stage belongs to one pipeline only
+ *        and the consumer inputs alias the producer outputs, so one run of a pipeline exists
+ *        at a time. On arm-linux, all jobs of a run are flushed at once and KMD starts every
+ *        stage when the former one ends; otherwise, the job of every stage is chained to the
+ *        job of the next stage, which is flushed by whoever observes the end of the former one.
+ */
+class PipelineTable
+{
+private:
+    std::map<uint32_t, pipeline_desc_t> pipes;
+    /* key: job ID of a stage in flight; value: job ID of the next stage (0 for the last) */
+    std::map<uint32_t, uint32_t> next_jobs;
+    /* next jobs taken from the chain and not flushed yet */
+    std::set<uint32_t> handoffs;
+    uint32_t next_id;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+private:
+    bool is_handle_used_no_lock(uint32_t handle) const;
+
+public:
+    bool is_graph_used(uint32_t graph_id);
+    bool is_handle_used(uint32_t handle);
+    aipu_status_t add(const pipeline_desc_t& desc, uint32_t* id);
+    aipu_status_t remove(uint32_t id, pipeline_desc_t& desc);
+    aipu_status_t get(uint32_t id, pipeline_desc_t& desc);
+    aipu_status_t start(uint32_t id, const std::vector<uint32_t>& jobs, bool handoff);
+    void stop(uint32_t id);
+    uint32_t take_next_job(uint32_t job_id);
+    void end_handoff(uint32_t job_id);
+    void wait_handoff(uint32_t job_id);
+
+public:
+    PipelineTable();
+    ~PipelineTable();
+    PipelineTable(const PipelineTable& table) = delete;
+    PipelineTable& operator=(const PipelineTable& table) = delete;
+};
+}
+
+#endif /* _PIPELINE_H_ */
@@ -0,0 +1,196 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  sim_addr_allocator.cpp
+ * @brief AIPU User Mode Driver (UMD) simulation device address allocator implementation
+ */
+
+#include "sim_addr_allocator.h"
+#include "utils/log.h"
+#include "utils/helper.h"
+
+#if ((defined X86_LINUX) && (X86_LINUX==1)) || ((defined LOOPBACK_LINUX) && (LOOPBACK_LINUX==1))
+AIRT::SimAddrAllocator::SimAddrAllocator()
+{
+    pthread_mutex_init(&lock, NULL);
+    reset();
+}
+
+AIRT::SimAddrAllocator::~SimAddrAllocator()
+{
+    pthread_mutex_destroy(&lock);
+}
+
+void AIRT::SimAddrAllocator::reset(uint64_t space_base, uint64_t space_size)
+{
+    pthread_mutex_lock(&lock);
+    base = space_base;
+    size = space_size;
+    free_ranges.clear();
+    alloc_ranges.clear();
+    free_ranges[base] = size;
+    pthread_mutex_unlock(&lock);
+}
+
+aipu_status_t AIRT::SimAddrAllocator::alloc(uint64_t bytes, uint32_t align_in_page, uint64_t* pa)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    uint64_t align = (align_in_page ? align_in_page : 1) * 4096ULL;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint64_t range_start = 0;
+    uint64_t range_end = 0;
+    std::map<uint64_t, uint64_t>::iterator iter;
+    sim_addr_stats_t stats;
+
+    if (nullptr == pa)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    if (0 == bytes)
+    {
+        return AIPU_STATUS_ERROR_INVALID_SIZE;
+    }
+
+    bytes = ALIGN_PAGE(bytes);
+
+    pthread_mutex_lock(&lock);
+    for (iter = free_ranges.begin(); iter != free_ranges.end(); iter++)
+    {
+        range_start = iter->first;
+        range_end = iter->first + iter->second;
+        start = (range_start + align - 1) / align * align;
+        end = start + bytes;
+        if (end <= range_end)
+        {
+            break;
+        }
+    }
+
+    if (iter == free_ranges.end())
+    {
+        get_stats_inner(stats);
+        LOG(LOG_ERR, "simulation address space exhausted: request 0x%lx (align 0x%lx), free 0x%lx, \
+            largest free 0x%lx, fragmentation %u%%", (unsigned long)bytes, (unsigned long)align,
+            (unsigned long)stats.free_bytes, (unsigned long)stats.max_free_bytes, stats.frag_percent);
+        ret = AIPU_STATUS_ERROR_BUF_ALLOC_FAIL;
+        goto unlock;
+    }
+
+    /**
+     * split the chosen free range:
+     * |<-front (free)->|<-----allocated----->|<-back (free)->|
+     * range_start      start                 end             range_end
+     */
+    free_ranges.erase(iter);
+    if (start > range_start)
+    {
+        free_ranges[range_start] = start - range_start;
+    }
+    if (range_end > end)
+    {
+        free_ranges[end] = range_end - end;
+    }
+    alloc_ranges[start] = bytes;
+    *pa = start;
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::SimAddrAllocator::free(uint64_t pa)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    uint64_t start = pa;
+    uint64_t bytes = 0;
+    std::map<uint64_t, uint64_t>::iterator iter;
+    std::map<uint64_t, uint64_t>::iterator next;
+
+    pthread_mutex_lock(&lock);
+    iter = alloc_ranges.find(pa);
+    if (iter == alloc_ranges.end())
+    {
+        LOG(LOG_ERR, "simulation address 0x%lx to free is not allocated!", (unsigned long)pa);
+        ret = AIPU_STATUS_ERROR_BUF_FREE_FAIL;
+        goto unlock;
+    }
+    bytes = iter->second;
+    alloc_ranges.erase(iter);
+
+    /* merge with the free neighbours */
+    next = free_ranges.lower_bound(start);
+    if (next != free_ranges.begin())
+    {
+        iter = next;
+        iter--;
+        if (iter->first + iter->second == start)
+        {
+            start = iter->first;
+            bytes += iter->second;
+            free_ranges.erase(iter);
+        }
+    }
+    if ((next != free_ranges.end()) && (next->first == start + bytes))
+    {
+        bytes += next->second;
+        free_ranges.erase(next);
+    }
+    free_ranges[start] = bytes;
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::SimAddrAllocator::get_stats_inner(sim_addr_stats_t& stats) const
+{
+    std::map<uint64_t, uint64_t>::const_iterator iter;
+
+    stats.tot_bytes = size;
+    stats.free_bytes = 0;
+    stats.max_free_bytes = 0;
+    stats.free_range_cnt = free_ranges.size();
+    stats.alloc_cnt = alloc_ranges.size();
+    for (iter = free_ranges.begin(); iter != free_ranges.end(); iter++)
+    {
+        stats.free_bytes += iter->second;
+        if (iter->second > stats.max_free_bytes)
+        {
+            stats.max_free_bytes = iter->second;
+        }
+    }
+
+    if (stats.free_bytes)
+    {
+        stats.frag_percent = 100 - (uint32_t)(stats.max_free_bytes * 100 / stats.free_bytes);
+    }
+    else
+    {
+        stats.frag_percent = 0;
+    }
+}
+
+void AIRT::SimAddrAllocator::get_stats(sim_addr_stats_t& stats)
+{
+    pthread_mutex_lock(&lock);
+    get_stats_inner(stats);
+    pthread_mutex_unlock(&lock);
+}
+#endif /* !X86_LINUX && !LOOPBACK_LINUX */
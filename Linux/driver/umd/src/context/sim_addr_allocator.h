@@ -0,0 +1,79 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  sim_addr_allocator.h
+ * @brief AIPU User Mode Driver (UMD) simulation device address allocator header
+ */
+
+#ifndef _SIM_ADDR_ALLOCATOR_H_
+#define _SIM_ADDR_ALLOCATOR_H_
+
+#include <stdint.h>
+#include <map>
+#include <pthread.h>
+#include "standard_api.h"
+
+#define SIM_ADDR_SPACE_BASE  0x0ULL
+#define SIM_ADDR_SPACE_SIZE  0x100000000ULL
+
+namespace AIRT
+{
+/* also used as the device address space of the loopback device */
+#if ((defined X86_LINUX) && (X86_LINUX==1)) || ((defined LOOPBACK_LINUX) && (LOOPBACK_LINUX==1))
+typedef struct sim_addr_stats {
+    uint64_t tot_bytes;      /* size of the whole simulated address space */
+    uint64_t free_bytes;     /* sum of all free ranges */
+    uint64_t max_free_bytes; /* largest free range */
+    uint32_t free_range_cnt;
+    uint32_t alloc_cnt;
+    uint32_t frag_percent;   /* 100 * (1 - max_free_bytes / free_bytes) */
+} sim_addr_stats_t;
+
+/**
+ * @brief First-fit device address range allocator of the simulated AIPU address space;
+ *        freed ranges are merged with free neighbours and reused by later allocations.
+ */
+class SimAddrAllocator
+{
+private:
+    uint64_t base;
+    uint64_t size;
+    /* start address -> bytes */
+    std::map<uint64_t, uint64_t> free_ranges;
+    std::map<uint64_t, uint64_t> alloc_ranges;
+    pthread_mutex_t lock;
+
+private:
+    void get_stats_inner(sim_addr_stats_t& stats) const;
+
+public:
+    void reset(uint64_t space_base = SIM_ADDR_SPACE_BASE, uint64_t space_size = SIM_ADDR_SPACE_SIZE);
+    aipu_status_t alloc(uint64_t bytes, uint32_t align_in_page, uint64_t* pa);
+    aipu_status_t free(uint64_t pa);
+    void get_stats(sim_addr_stats_t& stats);
+
+public:
+    SimAddrAllocator();
+    ~SimAddrAllocator();
+    SimAddrAllocator(const SimAddrAllocator& allocator) = delete;
+    SimAddrAllocator& operator=(const SimAddrAllocator& allocator) = delete;
+};
+#endif /* !X86_LINUX && !LOOPBACK_LINUX */
+}
+
+#endif /* _SIM_ADDR_ALLOCATOR_H_ */
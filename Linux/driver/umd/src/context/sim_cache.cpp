@@ -0,0 +1,442 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  sim_cache.cpp
+ * @brief AIPU User Mode Driver (UMD) simulation result cache module implementation
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <utime.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <algorithm>
+#include "sim_cache.h"
+#include "utils/log.h"
+
+#define SIM_CACHE_KEY_LEN      32
+
+static inline uint64_t sim_cache_rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t sim_cache_fmix(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+AIRT::SimCacheKey::SimCacheKey()
+{
+    h0 = 0xcbf29ce484222325ULL;
+    h1 = 0x9e3779b97f4a7c15ULL;
+    len = 0;
+}
+
+void AIRT::SimCacheKey::update(uint64_t value)
+{
+    /* two independent lanes: word-wise FNV-1a and a multiply-rotate mix */
+    h0 = (h0 ^ value) * 0x100000001b3ULL;
+    h1 = sim_cache_rotl(h1 ^ (value * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+    len += sizeof(value);
+}
+
+void AIRT::SimCacheKey::update(const void* data, uint32_t size)
+{
+    const char* src = (const char*)data;
+    uint64_t word = 0;
+    uint32_t i = 0;
+
+    /* mix the size in first so that the section boundaries are part of the key */
+    update((uint64_t)size);
+    if (nullptr == data)
+    {
+        return;
+    }
+
+    for (i = 0; i + sizeof(word) <= size; i += sizeof(word))
+    {
+        memcpy(&word, src + i, sizeof(word));
+        update(word);
+    }
+    if (i < size)
+    {
+        word = 0;
+        memcpy(&word, src + i, size - i);
+        update(word);
+    }
+}
+
+void AIRT::SimCacheKey::update(const std::string& str)
+{
+    update(str.c_str(), str.size());
+}
+
+std::string AIRT::SimCacheKey::digest() const
+{
+    char str[SIM_CACHE_KEY_LEN + 1];
+    snprintf(str, sizeof(str), "%016lx%016lx",
+        (unsigned long)sim_cache_fmix(h0 ^ len), (unsigned long)sim_cache_fmix(h1 + len));
+    return std::string(str);
+}
+
+#if (defined X86_LINUX) && (X86_LINUX==1)
+#define SIM_CACHE_FNAME_SUFFIX ".simc"
+
+AIRT::SimCache::SimCache()
+{
+    enabled = false;
+    max_bytes = 0;
+    tot_bytes = 0;
+    hit_cnt = 0;
+    miss_cnt = 0;
+}
+
+AIRT::SimCache::~SimCache()
+{
+    deinit();
+}
+
+std::string AIRT::SimCache::get_entry_fname(const std::string& key) const
+{
+    return dir + "/" + key + SIM_CACHE_FNAME_SUFFIX;
+}
+
+void AIRT::SimCache::add_entry(const std::string& key, uint64_t bytes)
+{
+    sim_cache_entry_t entry;
+
+    if (entries.count(key) == 1)
+    {
+        remove_entry(key);
+    }
+    lru.push_front(key);
+    entry.bytes = bytes;
+    entry.lru_iter = lru.begin();
+    entries[key] = entry;
+    tot_bytes += bytes;
+}
+
+void AIRT::SimCache::remove_entry(const std::string& key)
+{
+    std::map<std::string, sim_cache_entry_t>::iterator iter = entries.find(key);
+
+    if (iter == entries.end())
+    {
+        return;
+    }
+    tot_bytes -= iter->second.bytes;
+    lru.erase(iter->second.lru_iter);
+    entries.erase(iter);
+}
+
+void AIRT::SimCache::touch(const std::string& key)
+{
+    std::map<std::string, sim_cache_entry_t>::iterator iter = entries.find(key);
+
+    if (iter == entries.end())
+    {
+        return;
+    }
+    lru.splice(lru.begin(), lru, iter->second.lru_iter);
+    iter->second.lru_iter = lru.begin();
+
+    /* mtime is the recency record shared with other processes using the same directory */
+    utime(get_entry_fname(key).c_str(), NULL);
+}
+
+void AIRT::SimCache::evict(uint64_t reserve)
+{
+    std::string key;
+
+    while ((tot_bytes + reserve > max_bytes) && (!lru.empty()))
+    {
+        key = lru.back();
+        unlink(get_entry_fname(key).c_str());
+        remove_entry(key);
+        LOG(LOG_DEBUG, "[UMD SIMULATION] cache entry evicted: %s", key.c_str());
+    }
+}
+
+void AIRT::SimCache::scan_dir()
+{
+    DIR* dp = NULL;
+    struct dirent* ent = NULL;
+    struct stat st;
+    std::string name;
+    std::vector<std::pair<time_t, std::pair<std::string, uint64_t> > > found;
+
+    dp = opendir(dir.c_str());
+    if (NULL == dp)
+    {
+        return;
+    }
+
+    while (NULL != (ent = readdir(dp)))
+    {
+        name = ent->d_name;
+        if ((name.size() != SIM_CACHE_KEY_LEN + strlen(SIM_CACHE_FNAME_SUFFIX)) ||
+            (name.compare(SIM_CACHE_KEY_LEN, std::string::npos, SIM_CACHE_FNAME_SUFFIX) != 0))
+        {
+            continue;
+        }
+        if ((stat((dir + "/" + name).c_str(), &st) != 0) || (!S_ISREG(st.st_mode)))
+        {
+            continue;
+        }
+        found.push_back(std::make_pair(st.st_mtime,
+            std::make_pair(name.substr(0, SIM_CACHE_KEY_LEN), (uint64_t)st.st_size)));
+    }
+    closedir(dp);
+
+    /* oldest first so that the newest entry ends up at the LRU front */
+    std::sort(found.begin(), found.end());
+    for (uint32_t i = 0; i < found.size(); i++)
+    {
+        add_entry(found[i].second.first, found[i].second.second);
+    }
+}
+
+aipu_status_t AIRT::SimCache::init(const char* cache_dir, uint64_t max_size)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    if (nullptr == cache_dir)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if ((mkdir(cache_dir, S_IRWXU | S_IRWXG | S_IRWXO) != 0) && (errno != EEXIST))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_PATH;
+        goto finish;
+    }
+
+    if (access(cache_dir, W_OK | R_OK) != 0)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_PATH;
+        goto finish;
+    }
+
+    deinit();
+    dir = cache_dir;
+    max_bytes = max_size;
+    scan_dir();
+    evict(0);
+    enabled = true;
+    LOG(LOG_DEBUG, "[UMD SIMULATION] cache enabled: %s (%lu entries, 0x%lx/0x%lx bytes)",
+        dir.c_str(), (unsigned long)entries.size(), (unsigned long)tot_bytes, (unsigned long)max_bytes);
+
+finish:
+    return ret;
+}
+
+void AIRT::SimCache::deinit()
+{
+    enabled = false;
+    lru.clear();
+    entries.clear();
+    tot_bytes = 0;
+}
+
+bool AIRT::SimCache::lookup(const std::string& key, const std::vector<sim_cache_region_t>& regions)
+{
+    bool hit = false;
+    bool corrupted = false;
+    int fd = -1;
+    struct stat st;
+    sim_cache_file_hdr_t hdr;
+    std::vector<uint32_t> sizes(regions.size());
+    std::string fname;
+
+    if (!enabled)
+    {
+        return false;
+    }
+
+    fname = get_entry_fname(key);
+    fd = open(fname.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        /* dropped by another process sharing this directory */
+        remove_entry(key);
+        goto finish;
+    }
+
+    corrupted = true;
+    if ((read(fd, &hdr, sizeof(hdr)) != sizeof(hdr)) ||
+        (hdr.magic != SIM_CACHE_MAGIC) ||
+        (hdr.version != SIM_CACHE_VERSION) ||
+        (hdr.region_cnt != regions.size()))
+    {
+        goto finish;
+    }
+
+    if (regions.size() &&
+        (read(fd, &sizes[0], sizes.size() * sizeof(uint32_t)) != (ssize_t)(sizes.size() * sizeof(uint32_t))))
+    {
+        goto finish;
+    }
+
+    for (uint32_t i = 0; i < regions.size(); i++)
+    {
+        if (sizes[i] != regions[i].size)
+        {
+            goto finish;
+        }
+    }
+
+    for (uint32_t i = 0; i < regions.size(); i++)
+    {
+        if (read(fd, regions[i].va, regions[i].size) != (ssize_t)regions[i].size)
+        {
+            goto finish;
+        }
+    }
+    corrupted = false;
+    hit = true;
+
+    if (entries.count(key) == 0)
+    {
+        /* created by another process sharing this directory */
+        if (fstat(fd, &st) == 0)
+        {
+            add_entry(key, st.st_size);
+        }
+    }
+    touch(key);
+
+finish:
+    if (fd != -1)
+    {
+        close(fd);
+    }
+    if (corrupted)
+    {
+        LOG(LOG_WARN, "[UMD SIMULATION] invalid cache entry dropped: %s", fname.c_str());
+        unlink(fname.c_str());
+        remove_entry(key);
+    }
+    if (hit)
+    {
+        hit_cnt++;
+    }
+    else
+    {
+        miss_cnt++;
+    }
+    return hit;
+}
+
+aipu_status_t AIRT::SimCache::store(const std::string& key, const std::vector<sim_cache_region_t>& regions)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    int fd = -1;
+    sim_cache_file_hdr_t hdr;
+    std::vector<uint32_t> sizes(regions.size());
+    uint64_t bytes = sizeof(hdr) + sizes.size() * sizeof(uint32_t);
+    std::string fname;
+    std::string tmp_fname;
+    char suffix[32];
+
+    if (!enabled)
+    {
+        goto finish;
+    }
+
+    for (uint32_t i = 0; i < regions.size(); i++)
+    {
+        sizes[i] = regions[i].size;
+        bytes += regions[i].size;
+    }
+
+    if (bytes > max_bytes)
+    {
+        LOG(LOG_DEBUG, "[UMD SIMULATION] result (0x%lx bytes) exceeds cache size and is not cached",
+            (unsigned long)bytes);
+        goto finish;
+    }
+    evict(bytes);
+
+    /* write aside and rename so that concurrent readers never see a partial entry */
+    fname = get_entry_fname(key);
+    snprintf(suffix, sizeof(suffix), ".tmp%d", getpid());
+    tmp_fname = fname + suffix;
+    fd = open(tmp_fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd == -1)
+    {
+        LOG(LOG_ERR, "create cache file failed: %s! (errno = %d)", tmp_fname.c_str(), errno);
+        ret = AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+        goto finish;
+    }
+
+    hdr.magic = SIM_CACHE_MAGIC;
+    hdr.version = SIM_CACHE_VERSION;
+    hdr.region_cnt = regions.size();
+    hdr.reserved = 0;
+    if (write(fd, &hdr, sizeof(hdr)) != sizeof(hdr))
+    {
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+        goto finish;
+    }
+    if (regions.size() &&
+        (write(fd, &sizes[0], sizes.size() * sizeof(uint32_t)) != (ssize_t)(sizes.size() * sizeof(uint32_t))))
+    {
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+        goto finish;
+    }
+    for (uint32_t i = 0; i < regions.size(); i++)
+    {
+        if (write(fd, regions[i].va, regions[i].size) != (ssize_t)regions[i].size)
+        {
+            ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+            goto finish;
+        }
+    }
+
+    close(fd);
+    fd = -1;
+    if (rename(tmp_fname.c_str(), fname.c_str()) != 0)
+    {
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+        goto finish;
+    }
+    add_entry(key, bytes);
+
+finish:
+    if (fd != -1)
+    {
+        close(fd);
+    }
+    if ((AIPU_STATUS_SUCCESS != ret) && (!tmp_fname.empty()))
+    {
+        LOG(LOG_WARN, "[UMD SIMULATION] write cache entry failed: %s", fname.c_str());
+        unlink(tmp_fname.c_str());
+    }
+    return ret;
+}
+#endif /* !X86_LINUX */
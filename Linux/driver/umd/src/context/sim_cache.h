@@ -0,0 +1,130 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  sim_cache.h
+ * @brief AIPU User Mode Driver (UMD) simulation result cache module header
+ */
+
+#ifndef _SIM_CACHE_H_
+#define _SIM_CACHE_H_
+
+#include <stdint.h>
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+#include "standard_api.h"
+
+#define SIM_CACHE_MAGIC       0x434D4953 /* "SIMC" */
+#define SIM_CACHE_VERSION     1
+#define SIM_CACHE_DEFAULT_MB  1024
+
+namespace AIRT
+{
+/**
+ * @brief A 128-bit content hash accumulated over all the simulation inputs of a job
+ *        (also used to key the prepared graph cache on all platforms)
+ */
+class SimCacheKey
+{
+private:
+    uint64_t h0;
+    uint64_t h1;
+    uint64_t len;
+
+public:
+    void update(const void* data, uint32_t size);
+    void update(uint64_t value);
+    void update(const std::string& str);
+    std::string digest() const;
+
+public:
+    SimCacheKey();
+};
+
+#if (defined X86_LINUX) && (X86_LINUX==1)
+typedef struct sim_cache_region {
+    void*    va;
+    uint32_t size;
+} sim_cache_region_t;
+
+typedef struct sim_cache_entry {
+    uint64_t bytes;
+    std::list<std::string>::iterator lru_iter;
+} sim_cache_entry_t;
+
+typedef struct sim_cache_file_hdr {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t region_cnt;
+    uint32_t reserved;
+} sim_cache_file_hdr_t;
+
+/**
+ * @brief On-disk cache of simulation output buffers, keyed by the hash of the job inputs;
+ *        entries are evicted in LRU order when the total size exceeds the bound.
+ */
+class SimCache
+{
+private:
+    bool enabled;
+    std::string dir;
+    uint64_t max_bytes;
+    uint64_t tot_bytes;
+    uint64_t hit_cnt;
+    uint64_t miss_cnt;
+    /* front is the most recently used entry */
+    std::list<std::string> lru;
+    std::map<std::string, sim_cache_entry_t> entries;
+
+private:
+    std::string get_entry_fname(const std::string& key) const;
+    void scan_dir();
+    void touch(const std::string& key);
+    void add_entry(const std::string& key, uint64_t bytes);
+    void remove_entry(const std::string& key);
+    void evict(uint64_t reserve);
+
+public:
+    aipu_status_t init(const char* cache_dir, uint64_t max_size);
+    void deinit();
+    bool is_enabled() const
+    {
+        return enabled;
+    }
+    bool lookup(const std::string& key, const std::vector<sim_cache_region_t>& regions);
+    aipu_status_t store(const std::string& key, const std::vector<sim_cache_region_t>& regions);
+    uint64_t get_hit_cnt() const
+    {
+        return hit_cnt;
+    }
+    uint64_t get_miss_cnt() const
+    {
+        return miss_cnt;
+    }
+
+public:
+    SimCache();
+    ~SimCache();
+    SimCache(const SimCache& cache) = delete;
+    SimCache& operator=(const SimCache& cache) = delete;
+};
+#endif /* !X86_LINUX */
+}
+
+#endif /* _SIM_CACHE_H_ */
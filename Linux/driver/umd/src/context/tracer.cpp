@@ -0,0 +1,266 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tracer.cpp
+ * @brief AIPU User Mode Driver (UMD) job timeline tracer module implementation
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "tracer.h"
+#include "utils/log.h"
+
+class TraceRingHolder
+{
+public:
+    AIRT::trace_ring_t* ring;
+
+public:
+    TraceRingHolder(): ring(nullptr) {}
+    ~TraceRingHolder()
+    {
+        if (nullptr != ring)
+        {
+            AIRT::Tracer::get_tracer().retire_ring(ring);
+        }
+    }
+};
+
+static thread_local TraceRingHolder ring_holder;
+
+AIRT::Tracer::Tracer()
+{
+    char* env = getenv("AIPU_TRACE");
+
+    pthread_mutex_init(&lock, NULL);
+    retired_cnt = 0;
+    enabled.store((nullptr != env) && (0 != atoi(env)));
+}
+
+AIRT::Tracer::~Tracer()
+{
+    std::list<trace_ring_t*>::iterator iter;
+
+    enabled.store(false);
+    pthread_mutex_lock(&lock);
+    for (iter = rings.begin(); iter != rings.end(); iter++)
+    {
+        delete *iter;
+    }
+    rings.clear();
+    pthread_mutex_unlock(&lock);
+    pthread_mutex_destroy(&lock);
+}
+
+uint64_t AIRT::Tracer::now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void AIRT::Tracer::enable(bool en)
+{
+    enabled.store(en);
+}
+
+AIRT::trace_ring_t* AIRT::Tracer::get_thread_ring()
+{
+    trace_ring_t* ring = ring_holder.ring;
+
+    if (nullptr != ring)
+    {
+        return ring;
+    }
+
+    ring = new trace_ring_t;
+    ring->tid = syscall(SYS_gettid);
+    ring->retired = false;
+    ring->head.store(0);
+    for (uint32_t i = 0; i < TRACE_RING_EVENTS; i++)
+    {
+        ring->seqs[i].store(0, std::memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&lock);
+    rings.push_back(ring);
+    pthread_mutex_unlock(&lock);
+
+    ring_holder.ring = ring;
+    return ring;
+}
+
+void AIRT::Tracer::retire_ring(trace_ring_t* ring)
+{
+    std::list<trace_ring_t*>::iterator iter;
+
+    /**
+     * events of exited threads are kept for dumping;
+     * only the oldest retired rings are dropped to bound the memory
+     */
+    pthread_mutex_lock(&lock);
+    ring->retired = true;
+    retired_cnt++;
+    iter = rings.begin();
+    while ((retired_cnt > TRACE_MAX_RETIRED_RINGS) && (iter != rings.end()))
+    {
+        if ((*iter)->retired)
+        {
+            delete *iter;
+            iter = rings.erase(iter);
+            retired_cnt--;
+        }
+        else
+        {
+            iter++;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void AIRT::Tracer::record(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t job_id,
+    uint32_t type)
+{
+    trace_ring_t* ring = nullptr;
+    trace_event_t* event = nullptr;
+    uint64_t head = 0;
+    uint32_t slot = 0;
+
+    if (!is_enabled() || (nullptr == name))
+    {
+        return;
+    }
+
+    ring = get_thread_ring();
+    head = ring->head.load(std::memory_order_relaxed);
+    slot = head & (TRACE_RING_EVENTS - 1);
+    event = &ring->events[slot];
+    ring->seqs[slot].store(2 * head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event->name = name;
+    event->start_ns = start_ns;
+    event->end_ns = (end_ns > start_ns) ? end_ns : start_ns;
+    event->job_id = job_id;
+    event->type = type;
+    ring->seqs[slot].store(2 * (head + 1), std::memory_order_release);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void AIRT::Tracer::write_ring_events(FILE* fp, const trace_ring_t* ring, uint32_t pid,
+    bool& is_first, uint64_t& dropped) const
+{
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t first = (head > TRACE_RING_EVENTS) ? (head - TRACE_RING_EVENTS) : 0;
+    uint32_t slot = 0;
+    uint64_t seq = 0;
+    trace_event_t copy;
+    const trace_event_t* event = &copy;
+
+    dropped += first;
+    for (uint64_t i = first; i < head; i++)
+    {
+        /* the owner may overwrite the slot meanwhile; drop the event if the stamp changes */
+        slot = i & (TRACE_RING_EVENTS - 1);
+        seq = ring->seqs[slot].load(std::memory_order_acquire);
+        memcpy(&copy, (const void*)&ring->events[slot], sizeof(copy));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq != 2 * (i + 1)) || (ring->seqs[slot].load(std::memory_order_relaxed) != seq))
+        {
+            dropped++;
+            continue;
+        }
+        if (TRACE_EVENT_ASYNC == event->type)
+        {
+            fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"job\",\"ph\":\"b\",\"id\":\"0x%x\","
+                "\"ts\":%.3f,\"pid\":%u,\"tid\":%u}", is_first ? "" : ",", event->name,
+                event->job_id, event->start_ns / 1000.0, pid, ring->tid);
+            fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"job\",\"ph\":\"e\",\"id\":\"0x%x\","
+                "\"ts\":%.3f,\"pid\":%u,\"tid\":%u}", event->name,
+                event->job_id, event->end_ns / 1000.0, pid, ring->tid);
+        }
+        else
+        {
+            fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"umd\",\"ph\":\"X\",\"ts\":%.3f,"
+                "\"dur\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"job_id\":\"0x%x\"}}",
+                is_first ? "" : ",", event->name, event->start_ns / 1000.0,
+                (event->end_ns - event->start_ns) / 1000.0, pid, ring->tid, event->job_id);
+        }
+        is_first = false;
+    }
+}
+
+aipu_status_t AIRT::Tracer::dump(const char* fname)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    FILE* fp = nullptr;
+    uint32_t pid = getpid();
+    uint64_t dropped = 0;
+    bool is_first = true;
+    std::list<trace_ring_t*>::iterator iter;
+
+    if (nullptr == fname)
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    fp = fopen(fname, "w");
+    if (nullptr == fp)
+    {
+        LOG(LOG_ERR, "open trace file %s failed!", fname);
+        return AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    /* rings are not released while dumping; events are written without stopping the owners */
+    pthread_mutex_lock(&lock);
+    for (iter = rings.begin(); iter != rings.end(); iter++)
+    {
+        write_ring_events(fp, *iter, pid, is_first, dropped);
+    }
+    pthread_mutex_unlock(&lock);
+    fprintf(fp, "\n],\"otherData\":{\"clock\":\"CLOCK_MONOTONIC\",\"dropped_events\":\"%lu\"}}\n",
+        (unsigned long)dropped);
+
+    if (ferror(fp))
+    {
+        LOG(LOG_ERR, "write trace file %s failed!", fname);
+        ret = AIPU_STATUS_ERROR_WRITE_FILE_FAIL;
+    }
+    fclose(fp);
+
+    return ret;
+}
+
+AIRT::TraceSpan::TraceSpan(const char* span_name, uint32_t id)
+{
+    name = span_name;
+    job_id = id;
+    start_ns = Tracer::get_tracer().is_enabled() ? Tracer::now_ns() : 0;
+}
+
+AIRT::TraceSpan::~TraceSpan()
+{
+    if (start_ns)
+    {
+        Tracer::get_tracer().record(name, start_ns, Tracer::now_ns(), job_id);
+    }
+}
@@ -0,0 +1,133 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tracer.h
+ * @brief AIPU User Mode Driver (UMD) job timeline tracer module header
+ */
+
+#ifndef _TRACER_H_
+#define _TRACER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+#include <list>
+#include <pthread.h>
+#include "standard_api.h"
+
+#define TRACE_RING_EVENTS        4096 /* must be a power of 2 */
+#define TRACE_MAX_RETIRED_RINGS  16
+
+namespace AIRT
+{
+typedef enum {
+    TRACE_EVENT_SPAN = 0, /**< span of the recording thread */
+    TRACE_EVENT_ASYNC     /**< span of a job which is not bound to any thread (e.g. in KMD/AIPU) */
+} trace_event_type_t;
+
+typedef struct trace_event {
+    const char* name;     /**< must be a string literal */
+    uint64_t start_ns;    /**< CLOCK_MONOTONIC, the same clock used by KMD timestamps */
+    uint64_t end_ns;
+    uint32_t job_id;
+    uint32_t type;
+} trace_event_t;
+
+/**
+ * @brief Per-thread event ring; only the owner thread writes it and the write index
+ *        is published after the event so that a dumping thread never reads a slot
+ *        not yet written. The oldest events are overwritten when the ring is full;
+ *        each slot is stamped (seqlock-style) so that a dumping thread can drop an
+ *        event overwritten while it is being copied.
+ */
+typedef struct trace_ring {
+    uint32_t tid;
+    bool retired;
+    std::atomic<uint64_t> head;
+    std::atomic<uint64_t> seqs[TRACE_RING_EVENTS]; /**< 2 * (index + 1) when event #index is written, odd while writing */
+    trace_event_t events[TRACE_RING_EVENTS];
+} trace_ring_t;
+
+/**
+ * @brief Process-wide tracer collecting API/simulation spans of UMD threads and
+ *        per-job KMD timestamps, and dumping them as Chrome/Perfetto trace JSON.
+ */
+class Tracer
+{
+private:
+    std::atomic<bool> enabled;
+    std::list<trace_ring_t*> rings;
+    uint32_t retired_cnt;
+    pthread_mutex_t lock;
+
+private:
+    trace_ring_t* get_thread_ring();
+    void write_ring_events(FILE* fp, const trace_ring_t* ring, uint32_t pid,
+        bool& is_first, uint64_t& dropped) const;
+
+public:
+    static Tracer& get_tracer()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+    static uint64_t now_ns();
+    void enable(bool en);
+    bool is_enabled() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns, uint32_t job_id = 0,
+        uint32_t type = TRACE_EVENT_SPAN);
+    void retire_ring(trace_ring_t* ring);
+    aipu_status_t dump(const char* fname);
+
+public:
+    Tracer(const Tracer& tracer) = delete;
+    Tracer& operator=(const Tracer& tracer) = delete;
+    ~Tracer();
+
+private:
+    Tracer();
+};
+
+/**
+ * @brief Scoped span recorded at destruction if tracing is enabled
+ */
+class TraceSpan
+{
+private:
+    const char* name;
+    uint64_t start_ns;
+    uint32_t job_id;
+
+public:
+    void set_job_id(uint32_t id)
+    {
+        job_id = id;
+    }
+
+public:
+    TraceSpan(const char* span_name, uint32_t id = 0);
+    ~TraceSpan();
+    TraceSpan(const TraceSpan& span) = delete;
+    TraceSpan& operator=(const TraceSpan& span) = delete;
+};
+}
+
+#endif /* _TRACER_H_ */
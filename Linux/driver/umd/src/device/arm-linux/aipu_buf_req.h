@@ -39,11 +39,17 @@ enum aipu_alloc_flag {
     AIPU_ALLOC_FLAG_COMPACT = 0x2,
 };
 
+enum aipu_mem_placement {
+    AIPU_MEM_PLACEMENT_DDR = 0x0,
+    AIPU_MEM_PLACEMENT_SRAM = 0x1,
+};
+
 struct buf_desc {
     __u64 pa;
     __u64 dev_offset; /* user space access this area via mapping this offset from the dev file start */
     __u64 bytes;
     __u32 region_id;
+    __u32 placement;  /* where the buffer is placed: enum aipu_mem_placement */
 };
 
 struct buf_request {
@@ -54,6 +60,8 @@ struct buf_request {
     __u32 alloc_flag;     /* Allocation flag: default, strict or compact */
     struct buf_desc desc; /* info of buffer successfully allocated */
     __u32 errcode;
+    __u32 placement;      /* preferred placement; SRAM falls back to DDR if configured */
+    __u32 owner_tag;      /* owner of the buffer shown in sysfs, e.g. UMD graph ID */
 };
 
 #endif /* _AIPU_BUF_REQ_H_ */
\ No newline at end of file
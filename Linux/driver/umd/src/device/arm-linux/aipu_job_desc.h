@@ -31,11 +31,15 @@
 #define AIPU_JOB_STATE_PENDING   1
 #define AIPU_JOB_STATE_SCHED     2
 #define AIPU_JOB_STATE_END       3
+#define AIPU_JOB_STATE_BLOCKED   4
 
 #define AIPU_JOB_FLAG_INVALID    0
 #define AIPU_JOB_FLAG_VALID      1
 #endif
 
+/* maximum number of prerequisite jobs of a job */
+#define AIPU_JOB_MAX_DEPS        4
+
 struct user_job_desc {
         __u64 start_pc_addr;
         __u64 intr_handler_addr;
@@ -51,6 +55,8 @@ struct user_job_desc {
         __u32 reuse_size;
         __u32 enable_prof;
         __u32 enable_asid;
+        __u32 dep_job_cnt;                   /* number of valid IDs in dep_job_id */
+        __u32 dep_job_id[AIPU_JOB_MAX_DEPS]; /* jobs of this session to end before this one starts */
 };
 
 struct user_job {
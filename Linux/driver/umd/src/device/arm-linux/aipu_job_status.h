@@ -29,11 +29,26 @@
 #define AIPU_JOB_STATE_DONE      0x1
 #define AIPU_JOB_STATE_EXCEPTION 0x2
 
+/**
+ * struct job_timestamps: per-job KMD timestamps (in ns, CLOCK_MONOTONIC)
+ * @submit_ns: job flushed and added into the pending queue
+ * @trigger_ns: job triggered to run on AIPU
+ * @irq_ns: done/exception interrupt handled in upper half
+ * @bh_ns: job end handled in bottom half and user thread woken up
+ */
+struct job_timestamps {
+        __u64 submit_ns;
+        __u64 trigger_ns;
+        __u64 irq_ns;
+        __u64 bh_ns;
+};
+
 struct job_status_desc {
         __u32 job_id;
         __u32 thread_id;
         __u32 state;
         struct profiling_data pdata;
+        struct job_timestamps ts;
 };
 
 struct job_status_query {
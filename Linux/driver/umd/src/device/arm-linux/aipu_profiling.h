@@ -25,6 +25,25 @@
 
 #include <linux/types.h>
 
+/**
+ * version 1: execution time & rdata/wdata/cycle totals
+ * version 2: appended DMA, per-AXI-ID latency and outstanding counters
+ */
+#define AIPU_PROFILING_DATA_VERSION    2
+#define AIPU_PROFILING_AXI_ID_MAX      16
+
+/* valid_mask bits: counter groups captured by the SoC/board */
+#define AIPU_PROFILING_VALID_BW        (1 << 0)  /* rdata/wdata/cycle totals */
+#define AIPU_PROFILING_VALID_DMA       (1 << 1)  /* DMA latency/rdata/AR handshake totals */
+#define AIPU_PROFILING_VALID_ID_LAT    (1 << 2)  /* per-AXI-ID latency totals & maxima */
+#define AIPU_PROFILING_VALID_OUTSTAND  (1 << 3)  /* max outstanding transactions */
+
+/**
+ * struct profiling_data - per-job profiling record
+ *
+ * Counters are raw SoC register values; 64-bit counters are split into msb/lsb.
+ * Fields of version 1 keep their offsets; new fields are only appended.
+ */
 struct profiling_data {
         __s64  execution_time_ns;
         __u32  rdata_tot_msb;
@@ -33,6 +52,22 @@ struct profiling_data {
         __u32  wdata_tot_lsb;
         __u32  tot_cycle_msb;
         __u32  tot_cycle_lsb;
+        /* version 2 */
+        __u32  version;
+        __u32  valid_mask;
+        __u32  id_latency_max_msb;
+        __u32  id_latency_max_lsb;
+        __u32  id_latency_single;
+        __u32  dma_latency_tot_msb;
+        __u32  dma_latency_tot_lsb;
+        __u32  dma_rdata_tot_msb;
+        __u32  dma_rdata_tot_lsb;
+        __u32  dma_ar_handshake_msb;
+        __u32  dma_ar_handshake_lsb;
+        __u32  max_outstanding;
+        __u32  latency_tot_id_msb[AIPU_PROFILING_AXI_ID_MAX];
+        __u32  latency_tot_id_lsb[AIPU_PROFILING_AXI_ID_MAX];
+        __u32  latency_max_id[AIPU_PROFILING_AXI_ID_MAX];
 };
 
 #endif /* _AIPU_PROFILING_H_ */
\ No newline at end of file
@@ -21,6 +21,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -28,6 +29,87 @@
 #include <sys/mman.h>
 #include <sys/poll.h>
 #include "device/dev_op_wrapper.h"
+#if (defined LOOPBACK_LINUX) && (LOOPBACK_LINUX==1)
+#include "device/loopback-linux/loopback_dev.h"
+#endif
+
+/**
+ * device file operations: /dev/aipu, or the userspace loopback device
+ * emulating it in loopback-linux builds
+ */
+#if (defined LOOPBACK_LINUX) && (LOOPBACK_LINUX==1)
+static int dev_open()
+{
+    return AIRT::LoopbackDevice::get_device().open();
+}
+
+static int dev_close(int fd)
+{
+    return AIRT::LoopbackDevice::get_device().close(fd);
+}
+
+static int dev_ioctl(int fd, unsigned long cmd, void* arg)
+{
+    return AIRT::LoopbackDevice::get_device().ioctl(fd, cmd, arg);
+}
+
+static void* dev_mmap(size_t length, int fd, off_t offset)
+{
+    return AIRT::LoopbackDevice::get_device().mmap(length, fd, offset);
+}
+
+static int dev_munmap(void* addr, size_t length)
+{
+    return AIRT::LoopbackDevice::get_device().munmap(addr, length);
+}
+
+static void* dev_remap(void* addr, size_t length, int fd, off_t offset)
+{
+    /* a migrated loopback buffer keeps its host memory */
+    (void)addr;
+    return AIRT::LoopbackDevice::get_device().mmap(length, fd, offset);
+}
+
+static int dev_poll(struct pollfd* fds, int time_out)
+{
+    return AIRT::LoopbackDevice::get_device().poll(fds, time_out);
+}
+#else
+static int dev_open()
+{
+    return open("/dev/aipu", O_RDWR | O_SYNC);
+}
+
+static int dev_close(int fd)
+{
+    return close(fd);
+}
+
+static int dev_ioctl(int fd, unsigned long cmd, void* arg)
+{
+    return ioctl(fd, cmd, arg);
+}
+
+static void* dev_mmap(size_t length, int fd, off_t offset)
+{
+    return mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+}
+
+static int dev_munmap(void* addr, size_t length)
+{
+    return munmap(addr, length);
+}
+
+static void* dev_remap(void* addr, size_t length, int fd, off_t offset)
+{
+    return mmap(addr, length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset);
+}
+
+static int dev_poll(struct pollfd* fds, int time_out)
+{
+    return poll(fds, 1, time_out);
+}
+#endif
 
 int dev_op_wrapper_open(aipu_open_info_t& info)
 {
@@ -36,17 +118,17 @@ int dev_op_wrapper_open(aipu_open_info_t& info)
     uint64_t host_aipu_shm_offset = 0;
     aipu_cap cap;
 
-    fd = open("/dev/aipu", O_RDWR | O_SYNC);
+    fd = dev_open();
     if (fd <= 0)
     {
         goto finish;
     }
-    ret = ioctl(fd, IPUIOC_REQSHMMAP, &host_aipu_shm_offset);
+    ret = dev_ioctl(fd, IPUIOC_REQSHMMAP, &host_aipu_shm_offset);
     if (ret != 0)
     {
         goto fail;
     }
-    ret = ioctl(fd, IPUIOC_QUERYCAP, &cap);
+    ret = dev_ioctl(fd, IPUIOC_QUERYCAP, &cap);
     if (ret != 0)
     {
         goto fail;
@@ -59,7 +141,7 @@ int dev_op_wrapper_open(aipu_open_info_t& info)
     goto finish;
 
 fail:
-    close(fd);
+    dev_close(fd);
 
 finish:
     return ret;
@@ -67,7 +149,7 @@ finish:
 
 int dev_op_wrapper_close(int handle)
 {
-    return close(handle);
+    return dev_close(handle);
 }
 
 int dev_op_wrapper_read32(uint32_t handle, uint32_t offset, uint32_t* value)
@@ -82,7 +164,7 @@ int dev_op_wrapper_read32(uint32_t handle, uint32_t offset, uint32_t* value)
 
     ioreq.rw = AIPU_IO_READ;
     ioreq.offset = offset;
-    ret = ioctl(handle, IPUIOC_REQIO, &ioreq);
+    ret = dev_ioctl(handle, IPUIOC_REQIO, &ioreq);
     if ((AIPU_ERRCODE_NO_ERROR != ret) || (AIPU_ERRCODE_NO_ERROR != ioreq.errcode))
     {
         goto finish;
@@ -103,7 +185,7 @@ int dev_op_wrapper_write32(uint32_t handle, uint32_t offset, uint32_t value)
     ioreq.rw = AIPU_IO_WRITE;
     ioreq.offset = offset;
     ioreq.value = value;
-    ret = ioctl(handle, IPUIOC_REQIO, &ioreq);
+    ret = dev_ioctl(handle, IPUIOC_REQIO, &ioreq);
     if ((AIPU_ERRCODE_NO_ERROR != ret) || (AIPU_ERRCODE_NO_ERROR != ioreq.errcode))
     {
         goto finish;
@@ -114,7 +196,8 @@ finish:
 }
 
 int dev_op_wrapper_malloc(uint32_t handle, uint32_t dtype, uint32_t size,
-        uint32_t align_in_page, buffer_desc_t* buf, uint32_t region_id)
+        uint32_t align_in_page, buffer_desc_t* buf, uint32_t region_id,
+        uint32_t placement, uint32_t owner_tag)
 {
     int ret = 0;
     buf_request buf_req;
@@ -124,6 +207,8 @@ int dev_op_wrapper_malloc(uint32_t handle, uint32_t dtype, uint32_t size,
     buf_req.region_id = region_id;
     buf_req.alloc_flag = AIPU_ALLOC_FLAG_DEFAULT;
     buf_req.errcode = AIPU_ERRCODE_NO_ERROR;
+    buf_req.placement = placement;
+    buf_req.owner_tag = owner_tag;
     void* ptr = nullptr;
 
     if (nullptr == buf)
@@ -138,15 +223,14 @@ int dev_op_wrapper_malloc(uint32_t handle, uint32_t dtype, uint32_t size,
         goto finish;
     }
 
-    ret = ioctl(handle, IPUIOC_REQBUF, &buf_req);
+    ret = dev_ioctl(handle, IPUIOC_REQBUF, &buf_req);
     if ((ret != 0) || (buf_req.errcode != AIPU_ERRCODE_NO_ERROR))
     {
         ret = buf_req.errcode;
         goto finish;
     }
 
-    ptr = mmap(NULL, buf_req.desc.bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
-        handle, buf_req.desc.dev_offset);
+    ptr = dev_mmap(buf_req.desc.bytes, handle, buf_req.desc.dev_offset);
     if (ptr == MAP_FAILED)
     {
         ret = -1;
@@ -177,13 +261,79 @@ int dev_op_wrapper_free(uint32_t handle, const buffer_desc_t* buf)
 
     desc.pa = buf->pa;
     desc.bytes = buf->size;
-    munmap((void*)buf->va, buf->size);
-    ret = ioctl(handle, IPUIOC_FREEBUF, &desc);
+    dev_munmap((void*)buf->va, buf->size);
+    ret = dev_ioctl(handle, IPUIOC_FREEBUF, &desc);
+
+finish:
+    return ret;
+}
+
+int dev_op_wrapper_migrate(uint32_t handle, buffer_desc_t* buf, uint32_t align_in_page, bool* moved)
+{
+    int ret = 0;
+    buf_request buf_req;
+    buf_desc desc;
+    void* ptr = nullptr;
+
+    if ((nullptr == buf) || (nullptr == moved))
+    {
+        ret = AIPU_ERRCODE_INTERNAL_NULLPTR;
+        goto finish;
+    }
+
+    *moved = false;
+    memset(&buf_req, 0, sizeof(buf_req));
+    buf_req.bytes = buf->real_size;
+    buf_req.align_in_page = align_in_page;
+    buf_req.desc.pa = buf->pa;
+    buf_req.desc.dev_offset = buf->pa;
+    buf_req.desc.bytes = buf->size;
+    buf_req.errcode = AIPU_ERRCODE_NO_ERROR;
+    ret = dev_ioctl(handle, IPUIOC_MIGRATEBUF, &buf_req);
+    if ((ret != 0) || (buf_req.errcode != AIPU_ERRCODE_NO_ERROR))
+    {
+        ret = buf_req.errcode;
+        goto finish;
+    }
+
+    /* no closer hole */
+    if (buf_req.desc.pa == buf->pa)
+    {
+        goto finish;
+    }
+
+    /* the copy replaces the source mapping so that pointers to the buffer stay valid */
+    ptr = dev_remap((void*)buf->va, buf_req.desc.bytes, handle, buf_req.desc.dev_offset);
+    if (ptr != buf->va)
+    {
+        desc.pa = buf_req.desc.pa;
+        desc.bytes = buf_req.desc.bytes;
+        dev_ioctl(handle, IPUIOC_FREEBUF, &desc);
+        ret = -1;
+        goto finish;
+    }
+
+    desc.pa = buf->pa;
+    desc.bytes = buf->size;
+    buf->pa = buf_req.desc.pa;
+    buf->region_id = buf_req.desc.region_id;
+    *moved = true;
+    ret = dev_ioctl(handle, IPUIOC_FREEBUF, &desc);
 
 finish:
     return ret;
 }
 
+int dev_op_wrapper_get_defrag_seq(uint32_t handle, uint32_t* seq)
+{
+    if (nullptr == seq)
+    {
+        return AIPU_ERRCODE_INTERNAL_NULLPTR;
+    }
+
+    return dev_ioctl(handle, IPUIOC_QUERYDEFRAG, seq);
+}
+
 int dev_op_wrapper_poll(uint32_t handle, std::vector<job_status_desc>& jobs_status,
     uint32_t max_cnt, uint32_t time_out, bool poll_single_job, uint32_t job_id)
 {
@@ -199,7 +349,7 @@ int dev_op_wrapper_poll(uint32_t handle, std::vector<job_status_desc>& jobs_stat
         return -2;
     }
 
-    ret = poll(&poll_list, 1, time_out);
+    ret = dev_poll(&poll_list, time_out);
     if (ret < 0)
     {
         printf("[UMD ERROR] poll failed!\n");
@@ -213,7 +363,7 @@ int dev_op_wrapper_poll(uint32_t handle, std::vector<job_status_desc>& jobs_stat
         status_query.max_cnt = max_cnt;
         status_query.status = new job_status_desc[max_cnt];
         status_query.errcode = AIPU_ERRCODE_NO_ERROR;
-        ret = ioctl(handle, IPUIOC_QUERYSTATUS, &status_query);
+        ret = dev_ioctl(handle, IPUIOC_QUERYSTATUS, &status_query);
         if ((0 != ret) || (status_query.errcode != AIPU_ERRCODE_NO_ERROR))
         {
             goto clean;
@@ -234,4 +384,19 @@ clean:
 
 finish:
     return ret;
-}
\ No newline at end of file
+}
+
+int dev_op_wrapper_run_job(uint32_t handle, user_job* job)
+{
+    if (nullptr == job)
+    {
+        return AIPU_ERRCODE_INTERNAL_NULLPTR;
+    }
+
+    return dev_ioctl(handle, IPUIOC_RUNJOB, job);
+}
+
+int dev_op_wrapper_kill_job(uint32_t handle, uint32_t job_id)
+{
+    return dev_ioctl(handle, IPUIOC_KILL_TIMEOUT_JOB, &job_id);
+}
@@ -97,11 +97,14 @@ int dev_op_wrapper_write32(uint32_t handle, uint32_t offset, uint32_t value);
  * @param buf           Pointer to a memory location allocated by application where UMD stores the
  *                      successfully allocated buffer info.
  * @region_id           ID of region where the requested buffer is expected to locate in
+ * @placement           Preferred placement (enum aipu_mem_placement)
+ * @owner_tag           Owner of the buffer shown in KMD sysfs (graph ID)
  *
  * @retval TBD
  */
 int dev_op_wrapper_malloc(uint32_t handle, uint32_t dtype, uint32_t size,
-        uint32_t align_in_page, buffer_desc_t* buf, uint32_t region_id = 0);
+        uint32_t align_in_page, buffer_desc_t* buf, uint32_t region_id = 0,
+        uint32_t placement = 0, uint32_t owner_tag = 0);
 /**
  * @brief This API is used to request to free a buffer allocated by AIPU_LL_malloc.
  *
@@ -111,6 +114,29 @@ int dev_op_wrapper_malloc(uint32_t handle, uint32_t dtype, uint32_t size,
  * @retval 0 if successful
  */
 int dev_op_wrapper_free(uint32_t handle, const buffer_desc_t* buf);
+/**
+ * @brief This API is used to migrate an idle buffer into a hole closer to the end of the
+ *        device memory region its type is packed at; the data is copied by KMD and the new
+ *        buffer is mapped at the same virtual address, then the source buffer is freed.
+ *
+ * @param handle        Device handle returned by AIPU_LL_open
+ * @param buf           Buffer descriptor pointer returned by AIPU_LL_malloc; pa is updated
+ * @param align_in_page Alignment requirement of the buffer (in page)
+ * @param moved         Set if the buffer is moved
+ *
+ * @retval 0 if successful
+ */
+int dev_op_wrapper_migrate(uint32_t handle, buffer_desc_t* buf, uint32_t align_in_page, bool* moved);
+/**
+ * @brief This API is used to get the number of defragmentation requests issued by KMD
+ *        (sysfs or allocation failures caused by fragmentation).
+ *
+ * @param handle Device handle returned by AIPU_LL_open
+ * @param seq    Request sequence number
+ *
+ * @retval 0 if successful
+ */
+int dev_op_wrapper_get_defrag_seq(uint32_t handle, uint32_t* seq);
 /**
  * @brief This API is used to query job status scheduled with the same handle.
  *
@@ -125,5 +151,25 @@ int dev_op_wrapper_free(uint32_t handle, const buffer_desc_t* buf);
  */
 int dev_op_wrapper_poll(uint32_t handle, std::vector<job_status_desc>& jobs_status,
     uint32_t max_cnt, uint32_t time_out, bool poll_single_job = 0, uint32_t job_id = 0);
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+/**
+ * @brief This API is used to schedule a job to run on AIPU.
+ *
+ * @param handle Device handle returned by AIPU_LL_open
+ * @param job    Pointer to the job descriptor; errcode is updated by driver
+ *
+ * @retval 0 if successful
+ */
+int dev_op_wrapper_run_job(uint32_t handle, user_job* job);
+/**
+ * @brief This API is used to kill a job which has timed out.
+ *
+ * @param handle Device handle returned by AIPU_LL_open
+ * @param job_id ID of the job to kill
+ *
+ * @retval 0 if successful
+ */
+int dev_op_wrapper_kill_job(uint32_t handle, uint32_t job_id);
+#endif
 
 #endif /* _DEV_OP_WRAPPER_H_ */
\ No newline at end of file
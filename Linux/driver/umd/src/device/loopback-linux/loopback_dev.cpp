@@ -0,0 +1,714 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  loopback_dev.cpp
+ * @brief AIPU User Mode Driver (UMD) loopback device module implementation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "loopback_dev.h"
+#include "utils/log.h"
+#include "utils/helper.h"
+
+#if (defined LOOPBACK_LINUX) && (LOOPBACK_LINUX==1)
+static uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+AIRT::LoopbackDevice::LoopbackDevice()
+{
+    char* exec_us = getenv("AIPU_LOOPBACK_EXEC_US");
+    char* cap_str = getenv("AIPU_LOOPBACK_CAP");
+    char* mem_mb = getenv("AIPU_LOOPBACK_MEM_MB");
+
+    exec_ns = (nullptr != exec_us) ? strtoull(exec_us, NULL, 0) * 1000 :
+        LOOPBACK_DEFAULT_EXEC_US * 1000ULL;
+    memset(&cap, 0, sizeof(cap));
+    if ((nullptr == cap_str) ||
+        (sscanf(cap_str, "%u:%u:%u", &cap.isa_version, &cap.aiff_feature, &cap.tpc_feature) != 3))
+    {
+        sscanf(LOOPBACK_DEFAULT_CAP, "%u:%u:%u", &cap.isa_version, &cap.aiff_feature,
+            &cap.tpc_feature);
+    }
+    cap.errcode = AIPU_ERRCODE_NO_ERROR;
+    mem_bytes = (nullptr != mem_mb) ? (strtoull(mem_mb, NULL, 0) << 20) : 0;
+    if ((0 == mem_bytes) || (mem_bytes > SIM_ADDR_SPACE_SIZE))
+    {
+        mem_bytes = SIM_ADDR_SPACE_SIZE;
+    }
+    defrag_seq = 0;
+
+    running = nullptr;
+    worker_running = false;
+    stop = false;
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&pending_cond, NULL);
+    pthread_cond_init(&end_cond, NULL);
+    LOG(LOG_INFO, "loopback device: fake execution time %lu ns", (unsigned long)exec_ns);
+}
+
+AIRT::LoopbackDevice::~LoopbackDevice()
+{
+    std::map<int, std::list<loopback_job_t*>>::iterator siter;
+    std::list<loopback_job_t*>::iterator jiter;
+    std::map<uint64_t, loopback_buf_t>::iterator biter;
+
+    pthread_mutex_lock(&lock);
+    stop = true;
+    pthread_cond_broadcast(&pending_cond);
+    pthread_mutex_unlock(&lock);
+    if (worker_running)
+    {
+        pthread_join(worker, NULL);
+    }
+
+    for (siter = sessions.begin(); siter != sessions.end(); siter++)
+    {
+        for (jiter = siter->second.begin(); jiter != siter->second.end(); jiter++)
+        {
+            delete *jiter;
+        }
+        ::close(siter->first);
+    }
+    sessions.clear();
+    pending.clear();
+
+    for (biter = bufs.begin(); biter != bufs.end(); biter++)
+    {
+        free(biter->second.va);
+    }
+    bufs.clear();
+
+    pthread_mutex_destroy(&lock);
+    pthread_cond_destroy(&pending_cond);
+    pthread_cond_destroy(&end_cond);
+}
+
+void* AIRT::LoopbackDevice::worker_thread(void* data)
+{
+    ((LoopbackDevice*)data)->run_pending_jobs();
+    return data;
+}
+
+void AIRT::LoopbackDevice::run_pending_jobs()
+{
+    loopback_job_t* job = nullptr;
+    struct timespec exec;
+    bool failed = false;
+
+    exec.tv_sec = exec_ns / 1000000000ULL;
+    exec.tv_nsec = exec_ns % 1000000000ULL;
+
+    pthread_mutex_lock(&lock);
+    while (1)
+    {
+        while (pending.empty() && !stop)
+        {
+            pthread_cond_wait(&pending_cond, &lock);
+        }
+        if (stop)
+        {
+            break;
+        }
+
+        /* a single emulated core: jobs run one by one in flush order */
+        job = pending.front();
+        pending.pop_front();
+        running = job;
+        job->ts.trigger_ns = now_ns();
+        failed = job->failed;
+        pthread_mutex_unlock(&lock);
+
+        if (exec_ns && !failed)
+        {
+            while (nanosleep(&exec, &exec) != 0);
+            exec.tv_sec = exec_ns / 1000000000ULL;
+            exec.tv_nsec = exec_ns % 1000000000ULL;
+        }
+
+        pthread_mutex_lock(&lock);
+        job->ts.irq_ns = now_ns();
+        job->ts.bh_ns = job->ts.irq_ns;
+        job->exec_ns = job->ts.irq_ns - job->ts.trigger_ns;
+        job->end = true;
+        running = nullptr;
+        if (job->fd < 0)
+        {
+            /* session closed or job killed while running */
+            delete job;
+        }
+        pthread_cond_broadcast(&end_cond);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+bool AIRT::LoopbackDevice::has_end_job_no_lock(int fd, int uthread_id)
+{
+    std::list<loopback_job_t*>& jobs = sessions[fd];
+    std::list<loopback_job_t*>::iterator iter;
+    bool thread_specific = false;
+
+    /* the same condition as KMD: thread-specific if this thread has flushed jobs */
+    for (iter = jobs.begin(); iter != jobs.end(); iter++)
+    {
+        if ((*iter)->uthread_id == uthread_id)
+        {
+            thread_specific = true;
+            break;
+        }
+    }
+
+    for (iter = jobs.begin(); iter != jobs.end(); iter++)
+    {
+        if ((*iter)->end && (!thread_specific || ((*iter)->uthread_id == uthread_id)))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int AIRT::LoopbackDevice::open()
+{
+    int fd = 0;
+
+    /* a real descriptor keeps the handle unique in the process */
+    fd = ::open("/dev/null", O_RDWR | O_CLOEXEC);
+    if (fd <= 0)
+    {
+        return fd;
+    }
+
+    pthread_mutex_lock(&lock);
+    if (!worker_running)
+    {
+        if (pthread_create(&worker, NULL, worker_thread, this) != 0)
+        {
+            pthread_mutex_unlock(&lock);
+            ::close(fd);
+            LOG(LOG_ERR, "create loopback device worker thread failed!");
+            return -1;
+        }
+        worker_running = true;
+        addr.reset(SIM_ADDR_SPACE_BASE, mem_bytes);
+    }
+    sessions[fd].clear();
+    pthread_mutex_unlock(&lock);
+
+    return fd;
+}
+
+int AIRT::LoopbackDevice::close(int fd)
+{
+    std::map<int, std::list<loopback_job_t*>>::iterator siter;
+    std::list<loopback_job_t*>::iterator jiter;
+    std::deque<loopback_job_t*>::iterator piter;
+    std::map<uint64_t, loopback_buf_t>::iterator biter;
+
+    pthread_mutex_lock(&lock);
+    siter = sessions.find(fd);
+    if (sessions.end() == siter)
+    {
+        pthread_mutex_unlock(&lock);
+        errno = EBADF;
+        return -1;
+    }
+
+    for (piter = pending.begin(); piter != pending.end();)
+    {
+        piter = ((*piter)->fd == fd) ? pending.erase(piter) : (piter + 1);
+    }
+
+    for (jiter = siter->second.begin(); jiter != siter->second.end(); jiter++)
+    {
+        if (*jiter == running)
+        {
+            running->fd = -1;
+        }
+        else
+        {
+            delete *jiter;
+        }
+    }
+    sessions.erase(siter);
+
+    /* buffers not freed are released with the session like KMD does */
+    for (biter = bufs.begin(); biter != bufs.end();)
+    {
+        if (biter->second.fd == fd)
+        {
+            free(biter->second.va);
+            addr.free(biter->first);
+            biter = bufs.erase(biter);
+        }
+        else
+        {
+            biter++;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    return ::close(fd);
+}
+
+int AIRT::LoopbackDevice::req_buf(int fd, struct buf_request* req)
+{
+    loopback_buf_t buf;
+    uint64_t pa = 0;
+    sim_addr_stats_t stats;
+
+    buf.bytes = ALIGN_PAGE(req->bytes);
+    buf.fd = fd;
+    buf.va = nullptr;
+    if ((0 == req->bytes) || (addr.alloc(buf.bytes, req->align_in_page, &pa) != AIPU_STATUS_SUCCESS))
+    {
+        /* like KMD: enough free bytes but no hole large enough */
+        addr.get_stats(stats);
+        if (req->bytes && (stats.free_bytes >= buf.bytes))
+        {
+            defrag_seq++;
+        }
+        req->errcode = AIPU_ERRCODE_NO_MEMORY;
+        errno = ENOMEM;
+        return -1;
+    }
+
+    if (posix_memalign(&buf.va, 4096, buf.bytes) != 0)
+    {
+        addr.free(pa);
+        req->errcode = AIPU_ERRCODE_NO_MEMORY;
+        errno = ENOMEM;
+        return -1;
+    }
+    memset(buf.va, 0, buf.bytes);
+    bufs[pa] = buf;
+
+    req->desc.pa = pa;
+    req->desc.dev_offset = pa;
+    req->desc.bytes = buf.bytes;
+    req->desc.placement = AIPU_MEM_PLACEMENT_DDR;
+    req->desc.region_id = 0;
+    req->errcode = AIPU_ERRCODE_NO_ERROR;
+    return 0;
+}
+
+int AIRT::LoopbackDevice::free_buf(const struct buf_desc* desc)
+{
+    std::map<uint64_t, loopback_buf_t>::iterator iter = bufs.find(desc->pa);
+
+    if (bufs.end() == iter)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    free(iter->second.va);
+    addr.free(iter->first);
+    bufs.erase(iter);
+    return 0;
+}
+
+int AIRT::LoopbackDevice::migrate_buf(int fd, struct buf_request* req)
+{
+    std::map<uint64_t, loopback_buf_t>::iterator iter = bufs.find(req->desc.pa);
+    loopback_buf_t buf;
+    uint64_t pa = 0;
+
+    if ((bufs.end() == iter) || (iter->second.fd != fd) || (iter->second.bytes != req->desc.bytes) ||
+        (nullptr == iter->second.va))
+    {
+        req->errcode = AIPU_ERRCODE_ITEM_NOT_FOUND;
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* buffers are allocated first-fit: moved only into a lower hole */
+    req->errcode = AIPU_ERRCODE_NO_ERROR;
+    if (addr.alloc(req->desc.bytes, req->align_in_page, &pa) != AIPU_STATUS_SUCCESS)
+    {
+        return 0;
+    }
+    if (pa > req->desc.pa)
+    {
+        addr.free(pa);
+        return 0;
+    }
+
+    /* the host memory is handed over to the new buffer; the source one is freed by UMD */
+    buf = iter->second;
+    iter->second.va = nullptr;
+    bufs[pa] = buf;
+    req->desc.pa = pa;
+    req->desc.dev_offset = pa;
+    return 0;
+}
+
+bool AIRT::LoopbackDevice::is_job_failed_no_lock(int fd, uint32_t job_id)
+{
+    std::list<loopback_job_t*>& jobs = sessions[fd];
+    std::list<loopback_job_t*>::iterator iter;
+
+    /* like KMD: a job not found has ended and been collected */
+    for (iter = jobs.begin(); iter != jobs.end(); iter++)
+    {
+        if ((*iter)->desc.job_id == job_id)
+        {
+            return (*iter)->failed;
+        }
+    }
+    return false;
+}
+
+void AIRT::LoopbackDevice::fail_dependents_no_lock(int fd, uint32_t job_id)
+{
+    std::list<loopback_job_t*>& jobs = sessions[fd];
+    std::list<loopback_job_t*>::iterator iter;
+    std::vector<uint32_t> failed_ids(1, job_id);
+    loopback_job_t* job = nullptr;
+
+    /* jobs are listed in flush order, so the failure propagates along chains in one pass */
+    for (iter = jobs.begin(); iter != jobs.end(); iter++)
+    {
+        job = *iter;
+        if (job->end || job->failed || (job == running))
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < job->desc.dep_job_cnt; i++)
+        {
+            if (std::find(failed_ids.begin(), failed_ids.end(), job->desc.dep_job_id[i]) !=
+                failed_ids.end())
+            {
+                job->failed = true;
+                failed_ids.push_back(job->desc.job_id);
+                break;
+            }
+        }
+    }
+}
+
+int AIRT::LoopbackDevice::run_job(int fd, struct user_job* job)
+{
+    loopback_job_t* kern_job = nullptr;
+
+    if (job->desc.dep_job_cnt > AIPU_JOB_MAX_DEPS)
+    {
+        job->errcode = AIPU_ERRCODE_INVALID_ARGS;
+        errno = EINVAL;
+        return -1;
+    }
+
+    kern_job = new loopback_job_t;
+    memset(kern_job, 0, sizeof(loopback_job_t));
+    kern_job->desc = job->desc;
+    for (uint32_t i = 0; i < job->desc.dep_job_cnt; i++)
+    {
+        if (is_job_failed_no_lock(fd, job->desc.dep_job_id[i]))
+        {
+            kern_job->failed = true;
+            break;
+        }
+    }
+    kern_job->fd = fd;
+    kern_job->uthread_id = syscall(SYS_gettid);
+    kern_job->ts.submit_ns = now_ns();
+    sessions[fd].push_back(kern_job);
+    pending.push_back(kern_job);
+    pthread_cond_signal(&pending_cond);
+
+    job->errcode = AIPU_ERRCODE_NO_ERROR;
+    return 0;
+}
+
+int AIRT::LoopbackDevice::query_status(int fd, struct job_status_query* query)
+{
+    std::list<loopback_job_t*>& jobs = sessions[fd];
+    std::list<loopback_job_t*>::iterator iter;
+    struct job_status_desc* status = nullptr;
+    loopback_job_t* job = nullptr;
+
+    if ((query->max_cnt < 1) || (nullptr == query->status))
+    {
+        query->errcode = AIPU_ERRCODE_INVALID_ARGS;
+        errno = EINVAL;
+        return -1;
+    }
+
+    query->poll_cnt = 0;
+    for (iter = jobs.begin(); (iter != jobs.end()) && (query->poll_cnt < query->max_cnt);)
+    {
+        job = *iter;
+        if (!job->end || (query->get_single_job && (job->desc.job_id != query->job_id)))
+        {
+            iter++;
+            continue;
+        }
+
+        status = &query->status[query->poll_cnt++];
+        memset(status, 0, sizeof(*status));
+        status->job_id = job->desc.job_id;
+        status->thread_id = getpid();
+        status->state = job->failed ? AIPU_JOB_STATE_EXCEPTION : AIPU_JOB_STATE_DONE;
+        status->ts = job->ts;
+        if (job->desc.enable_prof)
+        {
+            status->pdata.execution_time_ns = job->exec_ns;
+            status->pdata.version = AIPU_PROFILING_DATA_VERSION;
+        }
+        iter = jobs.erase(iter);
+        delete job;
+
+        if (query->get_single_job)
+        {
+            break;
+        }
+    }
+
+    if (0 == query->poll_cnt)
+    {
+        query->errcode = AIPU_ERRCODE_ITEM_NOT_FOUND;
+        errno = EINVAL;
+        return -1;
+    }
+
+    query->errcode = AIPU_ERRCODE_NO_ERROR;
+    return 0;
+}
+
+int AIRT::LoopbackDevice::kill_job(int fd, uint32_t job_id)
+{
+    std::list<loopback_job_t*>& jobs = sessions[fd];
+    std::list<loopback_job_t*>::iterator iter;
+    std::deque<loopback_job_t*>::iterator piter;
+    loopback_job_t* job = nullptr;
+
+    for (iter = jobs.begin(); iter != jobs.end(); iter++)
+    {
+        if ((*iter)->desc.job_id == job_id)
+        {
+            job = *iter;
+            jobs.erase(iter);
+            break;
+        }
+    }
+
+    if (nullptr == job)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    fail_dependents_no_lock(fd, job_id);
+    if (job == running)
+    {
+        job->fd = -1;
+        return 0;
+    }
+
+    for (piter = pending.begin(); piter != pending.end(); piter++)
+    {
+        if (*piter == job)
+        {
+            pending.erase(piter);
+            break;
+        }
+    }
+    delete job;
+    return 0;
+}
+
+int AIRT::LoopbackDevice::req_io(struct aipu_io_req* req)
+{
+    if (AIPU_IO_READ == req->rw)
+    {
+        req->value = regs[req->offset];
+    }
+    else
+    {
+        regs[req->offset] = req->value;
+    }
+    req->errcode = AIPU_ERRCODE_NO_ERROR;
+    return 0;
+}
+
+int AIRT::LoopbackDevice::ioctl(int fd, unsigned long cmd, void* arg)
+{
+    int ret = 0;
+
+    if (nullptr == arg)
+    {
+        errno = EFAULT;
+        return -1;
+    }
+
+    pthread_mutex_lock(&lock);
+    if (sessions.end() == sessions.find(fd))
+    {
+        pthread_mutex_unlock(&lock);
+        errno = EBADF;
+        return -1;
+    }
+
+    switch (cmd)
+    {
+    case IPUIOC_QUERYCAP:
+        *(struct aipu_cap*)arg = cap;
+        break;
+
+    case IPUIOC_REQSHMMAP:
+        *(__u64*)arg = 0;
+        break;
+
+    case IPUIOC_REQBUF:
+        ret = req_buf(fd, (struct buf_request*)arg);
+        break;
+
+    case IPUIOC_FREEBUF:
+        ret = free_buf((const struct buf_desc*)arg);
+        break;
+
+    case IPUIOC_RUNJOB:
+        ret = run_job(fd, (struct user_job*)arg);
+        break;
+
+    case IPUIOC_MIGRATEBUF:
+        ret = migrate_buf(fd, (struct buf_request*)arg);
+        break;
+
+    case IPUIOC_QUERYDEFRAG:
+        *(__u32*)arg = defrag_seq;
+        break;
+
+    case IPUIOC_QUERYSTATUS:
+        ret = query_status(fd, (struct job_status_query*)arg);
+        break;
+
+    case IPUIOC_KILL_TIMEOUT_JOB:
+        ret = kill_job(fd, *(__u32*)arg);
+        break;
+
+    case IPUIOC_REQIO:
+        ret = req_io((struct aipu_io_req*)arg);
+        break;
+
+    default:
+        errno = ENOTTY;
+        ret = -1;
+        break;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return ret;
+}
+
+void* AIRT::LoopbackDevice::mmap(size_t length, int fd, off_t offset)
+{
+    void* va = MAP_FAILED;
+    std::map<uint64_t, loopback_buf_t>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = bufs.find(offset);
+    if ((bufs.end() != iter) && (iter->second.fd == fd) && (length <= iter->second.bytes))
+    {
+        va = iter->second.va;
+    }
+    else
+    {
+        errno = EINVAL;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return va;
+}
+
+int AIRT::LoopbackDevice::munmap(void* addr, size_t length)
+{
+    /* host memory is released by FREEBUF */
+    return 0;
+}
+
+int AIRT::LoopbackDevice::poll(struct pollfd* fds, int time_out)
+{
+    int ret = 0;
+    int uthread_id = syscall(SYS_gettid);
+    struct timespec deadline;
+    uint64_t deadline_ns = 0;
+
+    if (time_out > 0)
+    {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline_ns = (uint64_t)deadline.tv_sec * 1000000000ULL + deadline.tv_nsec +
+            (uint64_t)time_out * 1000000ULL;
+        deadline.tv_sec = deadline_ns / 1000000000ULL;
+        deadline.tv_nsec = deadline_ns % 1000000000ULL;
+    }
+
+    fds->revents = 0;
+    pthread_mutex_lock(&lock);
+    if (sessions.end() == sessions.find(fds->fd))
+    {
+        fds->revents = POLLNVAL;
+        pthread_mutex_unlock(&lock);
+        return 1;
+    }
+
+    while (!has_end_job_no_lock(fds->fd, uthread_id))
+    {
+        if (0 == time_out)
+        {
+            break;
+        }
+        else if (time_out < 0)
+        {
+            pthread_cond_wait(&end_cond, &lock);
+        }
+        else if (pthread_cond_timedwait(&end_cond, &lock, &deadline) == ETIMEDOUT)
+        {
+            break;
+        }
+
+        if (sessions.end() == sessions.find(fds->fd))
+        {
+            break;
+        }
+    }
+
+    if ((sessions.end() != sessions.find(fds->fd)) && has_end_job_no_lock(fds->fd, uthread_id))
+    {
+        fds->revents = fds->events & (POLLIN | POLLPRI);
+        ret = 1;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return ret;
+}
+#endif /* LOOPBACK_LINUX */
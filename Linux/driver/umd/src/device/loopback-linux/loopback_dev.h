@@ -0,0 +1,130 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  loopback_dev.h
+ * @brief AIPU User Mode Driver (UMD) loopback device module header
+ */
+
+#ifndef _LOOPBACK_DEV_H_
+#define _LOOPBACK_DEV_H_
+
+#include <stdint.h>
+#include <map>
+#include <list>
+#include <deque>
+#include <vector>
+#include <pthread.h>
+#include <poll.h>
+#include "aipu.h"
+#include "context/sim_addr_allocator.h"
+
+#define LOOPBACK_DEFAULT_EXEC_US  100
+#define LOOPBACK_DEFAULT_CAP      "0:3:4" /* <isa_version>:<aiff_feature>:<tpc_feature> (Z1 0904) */
+
+namespace AIRT
+{
+#if (defined LOOPBACK_LINUX) && (LOOPBACK_LINUX==1)
+typedef struct loopback_buf {
+    void* va;
+    uint64_t bytes;
+    int fd;
+} loopback_buf_t;
+
+typedef struct loopback_job {
+    struct user_job_desc desc;
+    int fd;
+    int uthread_id;
+    bool end;
+    bool failed;    /**< a prerequisite job was killed; ended without running */
+    struct job_timestamps ts;
+    int64_t exec_ns;
+} loopback_job_t;
+
+/**
+ * @brief Userspace emulation of the KMD ioctl/mmap/poll interface of /dev/aipu with host
+ *        memory; jobs are executed one by one by a worker thread which sleeps for a fake
+ *        execution time and then ends them like the KMD bottom half does. As jobs run in
+ *        flush order, job dependencies are satisfied naturally; only the failure of the
+ *        dependents of a killed job is emulated.
+ *
+ *        Environment variables:
+ *        AIPU_LOOPBACK_EXEC_US: fake execution time per job in us (100 by default)
+ *        AIPU_LOOPBACK_CAP:     <isa_version>:<aiff_feature>:<tpc_feature> reported by QUERYCAP
+ *        AIPU_LOOPBACK_MEM_MB:  size of the emulated device memory in MB (4GB by default)
+ */
+class LoopbackDevice
+{
+private:
+    uint64_t exec_ns;
+    uint64_t mem_bytes;
+    uint32_t defrag_seq;
+    struct aipu_cap cap;
+    SimAddrAllocator addr;
+    /* pa -> buffer */
+    std::map<uint64_t, loopback_buf_t> bufs;
+    /* fd -> jobs flushed via this fd, in flush order */
+    std::map<int, std::list<loopback_job_t*>> sessions;
+    std::deque<loopback_job_t*> pending;
+    std::map<uint32_t, uint32_t> regs;
+    loopback_job_t* running;
+    pthread_t worker;
+    bool worker_running;
+    bool stop;
+    pthread_mutex_t lock;
+    pthread_cond_t pending_cond;
+    pthread_cond_t end_cond;
+
+private:
+    static void* worker_thread(void* data);
+    void run_pending_jobs();
+    bool has_end_job_no_lock(int fd, int uthread_id);
+    bool is_job_failed_no_lock(int fd, uint32_t job_id);
+    void fail_dependents_no_lock(int fd, uint32_t job_id);
+    int req_buf(int fd, struct buf_request* req);
+    int free_buf(const struct buf_desc* desc);
+    int migrate_buf(int fd, struct buf_request* req);
+    int run_job(int fd, struct user_job* job);
+    int query_status(int fd, struct job_status_query* query);
+    int kill_job(int fd, uint32_t job_id);
+    int req_io(struct aipu_io_req* req);
+
+public:
+    static LoopbackDevice& get_device()
+    {
+        static LoopbackDevice device;
+        return device;
+    }
+    int open();
+    int close(int fd);
+    int ioctl(int fd, unsigned long cmd, void* arg);
+    void* mmap(size_t length, int fd, off_t offset);
+    int munmap(void* addr, size_t length);
+    int poll(struct pollfd* fds, int time_out);
+
+public:
+    LoopbackDevice(const LoopbackDevice& device) = delete;
+    LoopbackDevice& operator=(const LoopbackDevice& device) = delete;
+    ~LoopbackDevice();
+
+private:
+    LoopbackDevice();
+};
+#endif /* LOOPBACK_LINUX */
+}
+
+#endif /* _LOOPBACK_DEV_H_ */
@@ -25,17 +25,171 @@
 #define _HIGH_LEVEL_API_H_
 
 #include <vector>
+#include <string>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <pthread.h>
+#include <stddef.h>
 #include "standard_api.h"
 
+#ifndef SWIG
+/**
+ * @brief Bytes of an element of a tensor data type; 0 if the type carries no element size
+ */
+inline uint32_t GetTensorTypeBytes(aipu_data_type_t type)
+{
+    if ((TENSOR_DATA_TYPE_U8 == type) || (TENSOR_DATA_TYPE_S8 == type))
+    {
+        return 1;
+    }
+    if ((TENSOR_DATA_TYPE_U16 == type) || (TENSOR_DATA_TYPE_S16 == type))
+    {
+        return 2;
+    }
+    return 0;
+}
+
+/**
+ * @brief Non-owning typed view over a tensor buffer mapped by UMD
+ *
+ * A view is valid as long as the tensor set it comes from. It is empty if T does not
+ * match the element size of the tensor; byte views of any tensor are allowed.
+ */
+template <typename T>
+class TensorView
+{
+private:
+    T* ptr;
+    size_t cnt;
+    const aipu_tensor_desc_t* tdesc;
+
+public:
+    T* data() const { return ptr; }
+    size_t size() const { return cnt; }
+    size_t bytes() const { return cnt * sizeof(T); }
+    bool empty() const { return 0 == cnt; }
+    T& operator[](size_t i) const { return ptr[i]; }
+    T* begin() const { return ptr; }
+    T* end() const { return ptr + cnt; }
+    const aipu_tensor_desc_t* desc() const { return tdesc; }
+    const aipu_tensor_shape_t& shape() const { return tdesc->fmt.shape; }
+    aipu_tensor_layout_t layout() const { return tdesc->fmt.layout; }
+    aipu_data_type_t dtype() const { return tdesc->fmt.data_type; }
+
+public:
+    TensorView(): ptr(nullptr), cnt(0), tdesc(nullptr) {}
+    TensorView(const aipu_buffer_t& buf, const aipu_tensor_desc_t& desc):
+        ptr(nullptr), cnt(0), tdesc(&desc)
+    {
+        uint32_t type_bytes = GetTensorTypeBytes(desc.fmt.data_type);
+
+        if (((1 == sizeof(T)) || (0 == type_bytes) || (sizeof(T) == type_bytes)) &&
+            (0 == desc.size % sizeof(T)) && (buf.size >= desc.size))
+        {
+            ptr = (T*)buf.va;
+            cnt = desc.size / sizeof(T);
+        }
+    }
+};
+
+/**
+ * @brief Move-only set of tensor buffers of a graph, freed on destruction
+ */
+class TensorSet
+{
+private:
+    aipu_ctx_handle_t* ctx;
+    const aipu_graph_desc_t* gdesc;
+    aipu_buffer_alloc_info_t info;
+
+public:
+    bool valid() const { return nullptr != ctx; }
+    uint32_t handle() const { return info.handle; }
+    const aipu_buffer_alloc_info_t& buffers() const { return info; }
+    void Release();
+
+public:
+    template <typename T>
+    TensorView<T> GetInputView(int i) const
+    {
+        if (!valid() || ((uint32_t)i >= info.inputs.number))
+        {
+            return TensorView<T>();
+        }
+        return TensorView<T>(info.inputs.tensors[i], gdesc->inputs.desc[i]);
+    }
+    template <typename T>
+    TensorView<const T> GetOutputView(int i) const
+    {
+        if (!valid() || ((uint32_t)i >= info.outputs.number))
+        {
+            return TensorView<const T>();
+        }
+        return TensorView<const T>(info.outputs.tensors[i], gdesc->outputs.desc[i]);
+    }
+
+public:
+    TensorSet(): ctx(nullptr), gdesc(nullptr), info() {}
+    TensorSet(aipu_ctx_handle_t* _ctx, const aipu_graph_desc_t* _gdesc,
+        const aipu_buffer_alloc_info_t& _info): ctx(_ctx), gdesc(_gdesc), info(_info) {}
+    TensorSet(TensorSet&& set);
+    TensorSet& operator=(TensorSet&& set);
+    TensorSet(const TensorSet& set) = delete;
+    TensorSet& operator=(const TensorSet& set) = delete;
+    ~TensorSet() { Release(); }
+};
+
+/**
+ * @brief Move-only job scheduled on a tensor set, cleaned on destruction
+ *
+ * A job runs once; its tensor set must outlive it.
+ */
+class Job
+{
+private:
+    aipu_ctx_handle_t* ctx;
+    uint32_t job_id;
+
+public:
+    bool valid() const { return nullptr != ctx; }
+    uint32_t id() const { return job_id; }
+    int Flush();
+    int Wait(int32_t time_out = -1);
+    int Run(int32_t time_out = -1);
+    /**
+     * flush the job; done is called once with its result from the completion path of the
+     * context (see JobPoller), or with AIPU_STATUS_ERROR_JOB_NOT_END if the job times out in
+     * Wait() or is released before it ends. The job must not be released while it runs.
+     */
+    int Submit(const std::function<void(int ret)>& done);
+    std::future<int> Submit();
+    void Release();
+
+public:
+    Job(): ctx(nullptr), job_id(0) {}
+    Job(aipu_ctx_handle_t* _ctx, uint32_t _job_id): ctx(_ctx), job_id(_job_id) {}
+    Job(Job&& job);
+    Job& operator=(Job&& job);
+    Job(const Job& job) = delete;
+    Job& operator=(const Job& job) = delete;
+    ~Job() { Release(); }
+};
+#endif
+
 class Graph
 {
 private:
     aipu_ctx_handle_t* ctx;
     const char* status_msg;
     aipu_graph_desc_t gdesc;
-    aipu_buffer_alloc_info_t info;
-    uint32_t job_id;
-    bool is_buf_alloc;
+#ifndef SWIG
+    TensorSet tensors;
+    Job job;
+
+private:
+    int AllocTensors();
+#endif
 
 public:
     int UnloadGraph();
@@ -52,15 +206,104 @@ public:
     std::vector< std::vector<int> > Run(std::vector< std::vector<int> >& inputs);
     std::vector<int> GetOutputTensor(int i);
 
+#ifndef SWIG
+public:
+    /* hot path: no allocation once the graph tensors and caller storage are set up */
+    int Run(const std::vector<const void*>& inputs, const std::vector<void*>& outputs);
+    int Run(const std::vector< std::vector<int> >& inputs, std::vector< std::vector<int> >& outputs);
+    int GetOutputTensor(int i, std::vector<int>& data);
+    template <typename T>
+    TensorView<T> GetInputView(int i)
+    {
+        return (0 == AllocTensors()) ? tensors.GetInputView<T>(i) : TensorView<T>();
+    }
+    template <typename T>
+    TensorView<const T> GetOutputView(int i)
+    {
+        return (0 == AllocTensors()) ? tensors.GetOutputView<T>(i) : TensorView<const T>();
+    }
+
+public:
+    /* tensor sets & jobs of the application, e.g. for several jobs in flight */
+    TensorSet CreateTensorSet();
+    Job CreateJob(const TensorSet& set);
+    aipu_ctx_handle_t* GetContext() const { return ctx; }
+#endif
+
 public:
     Graph(aipu_ctx_handle_t* _ctx, aipu_graph_desc_t _gdesc)
     {
         ctx = _ctx;
         gdesc = _gdesc;
-        is_buf_alloc = false;
     }
 };
 
+#ifndef SWIG
+/**
+ * @brief Completion thread of the jobs submitted by Job::Submit() in a context
+ *
+ * The thread calls AIPU_poll_jobs_status, which ends the jobs and calls their callbacks, so
+ * the context should have poll_opt enabled. Nothing is polled on the simulator, where jobs
+ * end while they are flushed.
+ */
+class JobPoller
+{
+private:
+    aipu_ctx_handle_t* ctx;
+    std::atomic<bool> running;
+    bool started;
+    pthread_t tid;
+
+private:
+    static void* PollThread(void* arg);
+
+public:
+    JobPoller(aipu_ctx_handle_t* _ctx);
+    JobPoller(const JobPoller& poller) = delete;
+    JobPoller& operator=(const JobPoller& poller) = delete;
+    ~JobPoller();
+};
+
+/**
+ * @brief Streaming runner keeping <depth> frames of a graph in flight
+ *
+ * The inputs of the next frames are filled on the thread calling Run() while earlier
+ * frames run; every tensor set has a companion thread which waits for its job and
+ * delivers the outputs, either in frame order or in order of completion.
+ */
+class StreamRunner
+{
+public:
+    /**
+     * fills the inputs of a frame in the tensor set; returns false at the end of the stream
+     */
+    typedef std::function<bool(uint64_t frame, const TensorSet& set)> Producer;
+    /**
+     * consumes the outputs of a frame; ret is non-zero if the job failed. Calls are serialized.
+     */
+    typedef std::function<void(uint64_t frame, const TensorSet& set, int ret)> Consumer;
+
+private:
+    Graph& graph;
+    bool in_order;
+    std::vector<TensorSet> sets;
+
+public:
+    uint32_t GetDepth() const { return sets.size(); }
+    /**
+     * @brief Run the stream until the producer ends it
+     *
+     * @retval 0 or the first error of the frames
+     */
+    int Run(const Producer& produce, const Consumer& consume, int32_t time_out = -1);
+
+public:
+    StreamRunner(Graph& _graph, uint32_t depth = 2, bool _in_order = true);
+    StreamRunner(const StreamRunner& runner) = delete;
+    StreamRunner& operator=(const StreamRunner& runner) = delete;
+};
+#endif
+
 class Aipu
 {
 private:
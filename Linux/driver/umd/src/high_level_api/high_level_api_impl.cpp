@@ -22,11 +22,20 @@
 
 #include <string>
 #include <cstring>
+#include <memory>
 #include <unistd.h>
 #include <sys/mman.h>
 #include "../high_level_api.h"
 #include "utils/helper.h"
 
+static void report_error(const char* api, aipu_status_t ret)
+{
+    const char* status_msg = nullptr;
+
+    AIPU_get_status_msg(ret, &status_msg);
+    fprintf(stderr, "[UMD ERROR] %s: %s\n", api, status_msg);
+}
+
 Aipu& OpenDevice()
 {
     return Aipu::get_aipu();
@@ -91,9 +100,243 @@ int Graph::GetOutputTensorNumber()
     return gdesc.outputs.number;
 }
 
-int Graph::LoadInputTensor(int i, const void* data)
+TensorSet::TensorSet(TensorSet&& set): ctx(set.ctx), gdesc(set.gdesc), info(set.info)
+{
+    set.ctx = nullptr;
+}
+
+TensorSet& TensorSet::operator=(TensorSet&& set)
+{
+    if (this != &set)
+    {
+        Release();
+        ctx = set.ctx;
+        gdesc = set.gdesc;
+        info = set.info;
+        set.ctx = nullptr;
+    }
+    return *this;
+}
+
+void TensorSet::Release()
+{
+    if (ctx)
+    {
+        AIPU_free_tensor_buffers(ctx, info.handle);
+        ctx = nullptr;
+    }
+}
+
+Job::Job(Job&& job): ctx(job.ctx), job_id(job.job_id)
+{
+    job.ctx = nullptr;
+    job.job_id = 0;
+}
+
+Job& Job::operator=(Job&& job)
+{
+    if (this != &job)
+    {
+        Release();
+        ctx = job.ctx;
+        job_id = job.job_id;
+        job.ctx = nullptr;
+        job.job_id = 0;
+    }
+    return *this;
+}
+
+void Job::Release()
+{
+    if (ctx)
+    {
+        AIPU_clean_job(ctx, job_id);
+        ctx = nullptr;
+        job_id = 0;
+    }
+}
+
+int Job::Flush()
+{
+    aipu_status_t ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+
+    if (ctx)
+    {
+        ret = AIPU_flush_job(ctx, job_id);
+    }
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        report_error("AIPU_flush_job", ret);
+    }
+    return ret;
+}
+
+int Job::Wait(int32_t time_out)
+{
+    aipu_status_t ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+    aipu_job_status_t status = AIPU_JOB_STATUS_NO_STATUS;
+
+    if (ctx)
+    {
+        ret = AIPU_get_job_status(ctx, job_id, time_out, &status);
+    }
+    if ((ret == AIPU_STATUS_SUCCESS) && (status != AIPU_JOB_STATUS_DONE))
+    {
+        ret = AIPU_STATUS_ERROR_JOB_EXCEPTION;
+    }
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        report_error("AIPU_get_job_status", ret);
+    }
+    return ret;
+}
+
+int Job::Run(int32_t time_out)
+{
+    aipu_status_t ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+
+    if (ctx)
+    {
+        ret = AIPU_finish_job(ctx, job_id, time_out);
+    }
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        report_error("AIPU_finish_job", ret);
+    }
+    return ret;
+}
+
+static void job_done_callback(uint32_t job_id, aipu_job_status_t status, void* arg)
+{
+    std::function<void(int)>* done = (std::function<void(int)>*)arg;
+
+    int ret = 0;
+
+    if (AIPU_JOB_STATUS_EXCEPTION == status)
+    {
+        ret = AIPU_STATUS_ERROR_JOB_EXCEPTION;
+    }
+    else if (AIPU_JOB_STATUS_DONE != status)
+    {
+        /* timed out, or cleaned before it ended */
+        ret = AIPU_STATUS_ERROR_JOB_NOT_END;
+    }
+    (*done)(ret);
+    delete done;
+}
+
+int Job::Submit(const std::function<void(int ret)>& done)
+{
+    aipu_status_t ret = AIPU_STATUS_ERROR_JOB_NOT_EXIST;
+    std::function<void(int)>* cb = nullptr;
+
+    if (ctx)
+    {
+        cb = new std::function<void(int)>(done);
+        ret = AIPU_flush_job_async(ctx, job_id, job_done_callback, cb);
+        if (ret != AIPU_STATUS_SUCCESS)
+        {
+            delete cb;
+        }
+    }
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        report_error("AIPU_flush_job_async", ret);
+    }
+    return ret;
+}
+
+std::future<int> Job::Submit()
+{
+    std::shared_ptr< std::promise<int> > promise = std::make_shared< std::promise<int> >();
+    std::future<int> future = promise->get_future();
+    int ret = 0;
+
+    ret = Submit([promise](int result) { promise->set_value(result); });
+    if (ret)
+    {
+        promise->set_value(ret);
+    }
+    return future;
+}
+
+JobPoller::JobPoller(aipu_ctx_handle_t* _ctx): ctx(_ctx), running(true), started(false)
+{
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    started = (pthread_create(&tid, NULL, PollThread, this) == 0);
+    if (!started)
+    {
+        fprintf(stderr, "[UMD ERROR] Create job poller thread failed!\n");
+    }
+#endif
+}
+
+JobPoller::~JobPoller()
+{
+    running = false;
+    if (started)
+    {
+        pthread_join(tid, NULL);
+    }
+}
+
+void* JobPoller::PollThread(void* arg)
+{
+    JobPoller* poller = (JobPoller*)arg;
+    uint32_t job_cnt = 0;
+
+    /* a bounded timeout so that the poller quits soon after destruction */
+    while (poller->running)
+    {
+        AIPU_poll_jobs_status(poller->ctx, &job_cnt, 100);
+    }
+    return NULL;
+}
+
+TensorSet Graph::CreateTensorSet()
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    aipu_buffer_alloc_info_t buffers;
+
+    ret = AIPU_alloc_tensor_buffers(ctx, &gdesc, &buffers);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        report_error("AIPU_alloc_tensor_buffers", ret);
+        return TensorSet();
+    }
+    return TensorSet(ctx, &gdesc, buffers);
+}
+
+Job Graph::CreateJob(const TensorSet& set)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    uint32_t id = 0;
+
+    ret = AIPU_create_job(ctx, &gdesc, set.handle(), &id);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        report_error("AIPU_create_job", ret);
+        return Job();
+    }
+    return Job(ctx, id);
+}
+
+int Graph::AllocTensors()
+{
+    if (!tensors.valid())
+    {
+        tensors = CreateTensorSet();
+        if (!tensors.valid())
+        {
+            return AIPU_STATUS_ERROR_BUF_ALLOC_FAIL;
+        }
+    }
+    return 0;
+}
+
+int Graph::LoadInputTensor(int i, const void* data)
+{
+    int ret = 0;
 
     if ((uint32_t)i >= gdesc.inputs.number) {
         fprintf(stderr, "[UMD ERROR] Invalid input tensor ID too large!\n");
@@ -106,19 +349,13 @@ int Graph::LoadInputTensor(int i, const void* data)
         return -3;
     }
 
-    if (!is_buf_alloc)
+    ret = AllocTensors();
+    if (ret)
     {
-        ret = AIPU_alloc_tensor_buffers(ctx, &gdesc, &info);
-        if (ret != AIPU_STATUS_SUCCESS)
-        {
-            AIPU_get_status_msg(ret, &status_msg);
-            fprintf(stderr, "[UMD ERROR] AIPU_alloc_tensor_buffers: %s\n", status_msg);
-            return ret;
-        }
-        is_buf_alloc = true;
+        return ret;
     }
 
-    memcpy(info.inputs.tensors[i].va, data, gdesc.inputs.desc[i].size);
+    memcpy(tensors.buffers().inputs.tensors[i].va, data, gdesc.inputs.desc[i].size);
     return 0;
 }
 
@@ -142,37 +379,29 @@ int Graph::LoadInputTensor(int i, const char* filename)
 
 int Graph::Run()
 {
-    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    int ret = AllocTensors();
 
-    if (job_id)
-    {
-        AIPU_clean_job(ctx, job_id);
-        job_id = 0;
-    }
-
-    ret = AIPU_create_job(ctx, &gdesc, info.handle, &job_id);
-    if (ret != AIPU_STATUS_SUCCESS)
+    if (ret)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[UMD ERROR] AIPU_create_job: %s\n", status_msg);
         return ret;
     }
 
-    ret = AIPU_finish_job(ctx, job_id, -1);
-    if (ret != AIPU_STATUS_SUCCESS)
+    /* the tensor buffers are held by the job of the last run until it is cleaned */
+    job.Release();
+    job = CreateJob(tensors);
+    if (!job.valid())
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[UMD ERROR] AIPU_finish_job: %s\n", status_msg);
+        return AIPU_STATUS_ERROR_INVALID_HANDLE;
     }
 
-    return ret;
+    return job.Run(-1);
 }
 
 std::vector< std::vector<int> > Graph::Run(std::vector<std::string>& input_files)
 {
     std::vector< std::vector<int> > results;
 
-    for (uint32_t i = 0; (i < info.inputs.number) &&
+    for (uint32_t i = 0; (i < gdesc.inputs.number) &&
             (i < (uint32_t)input_files.size()); i++)
     {
         LoadInputTensor(i, input_files[i].c_str());
@@ -180,9 +409,10 @@ std::vector< std::vector<int> > Graph::Run(std::vector<std::string>& input_files
 
     Run();
 
-    for (uint32_t i = 0; i < info.outputs.number; i++)
+    results.resize(gdesc.outputs.number);
+    for (uint32_t i = 0; i < gdesc.outputs.number; i++)
     {
-        results.push_back(GetOutputTensor(i));
+        GetOutputTensor(i, results[i]);
     }
     return results;
 }
@@ -191,47 +421,115 @@ std::vector< std::vector<int> > Graph::Run(std::vector< std::vector<int> >& inpu
 {
     std::vector< std::vector<int> > results;
 
-    for (uint32_t i = 0; i < (i < info.inputs.number) &&
-            (i < (uint32_t)inputs.size()); i++)
+    Run(inputs, results);
+    return results;
+}
+
+int Graph::Run(const std::vector<const void*>& inputs, const std::vector<void*>& outputs)
+{
+    int ret = 0;
+
+    if ((inputs.size() != gdesc.inputs.number) || (outputs.size() > gdesc.outputs.number))
     {
-        LoadInputTensor(i, &inputs[i][0]);
+        fprintf(stderr, "[UMD ERROR] Invalid input/output tensor number!\n");
+        return -2;
     }
 
-    Run();
+    for (uint32_t i = 0; i < inputs.size(); i++)
+    {
+        ret = LoadInputTensor(i, inputs[i]);
+        if (ret)
+        {
+            return ret;
+        }
+    }
 
-    for (uint32_t i = 0; i < info.outputs.number; i++)
+    ret = Run();
+    if (ret)
     {
-        results.push_back(GetOutputTensor(i));
+        return ret;
     }
-    return results;
+
+    /* a null output is left in the tensor buffer, to be read through the views */
+    for (uint32_t i = 0; i < outputs.size(); i++)
+    {
+        if (outputs[i])
+        {
+            memcpy(outputs[i], tensors.buffers().outputs.tensors[i].va, gdesc.outputs.desc[i].size);
+        }
+    }
+    return 0;
 }
 
-std::vector<int> Graph::GetOutputTensor(int i)
+int Graph::Run(const std::vector< std::vector<int> >& inputs, std::vector< std::vector<int> >& outputs)
 {
-    std::vector<int> data;
+    int ret = AllocTensors();
 
-    if ((uint32_t)i >= info.outputs.number)
+    if (ret)
     {
-        fprintf(stderr, "[UMD ERROR] Invalid output tensor ID too large!\n");
-        return data;
+        return ret;
+    }
+
+    /* every int carries a byte of the tensor, as returned by GetOutputTensor */
+    for (uint32_t i = 0; (i < gdesc.inputs.number) && (i < (uint32_t)inputs.size()); i++)
+    {
+        uint32_t size = gdesc.inputs.desc[i].size;
+        char* va = (char*)tensors.buffers().inputs.tensors[i].va;
+
+        if (inputs[i].size() < size)
+        {
+            fprintf(stderr, "[UMD ERROR] Invalid input tensor %u size!\n", i);
+            return -3;
+        }
+        for (uint32_t ch = 0; ch < size; ch++)
+        {
+            va[ch] = (char)inputs[i][ch];
+        }
+    }
+
+    ret = Run();
+    if (ret)
+    {
+        return ret;
     }
 
-    for (uint32_t ch = 0; ch < gdesc.outputs.desc[i].size; ch++)
+    /* storage of the caller is reused if it is large enough already */
+    outputs.resize(gdesc.outputs.number);
+    for (uint32_t i = 0; i < gdesc.outputs.number; i++)
     {
-        data.push_back(*(char*)((unsigned long)info.outputs.tensors[i].va + ch));
+        GetOutputTensor(i, outputs[i]);
     }
+    return 0;
+}
 
+std::vector<int> Graph::GetOutputTensor(int i)
+{
+    std::vector<int> data;
+
+    GetOutputTensor(i, data);
     return data;
 }
 
-int Graph::UnloadGraph()
+int Graph::GetOutputTensor(int i, std::vector<int>& data)
 {
-    if (job_id)
+    const char* va = nullptr;
+
+    if (!tensors.valid() || ((uint32_t)i >= gdesc.outputs.number))
     {
-        AIPU_clean_job(ctx, job_id);
-        AIPU_free_tensor_buffers(ctx, info.handle);
-        job_id = 0;
+        fprintf(stderr, "[UMD ERROR] Invalid output tensor ID too large!\n");
+        data.clear();
+        return -2;
     }
 
+    /* a single sequential pass over the device buffer, which may be uncached */
+    va = (const char*)tensors.buffers().outputs.tensors[i].va;
+    data.assign(va, va + gdesc.outputs.desc[i].size);
+    return 0;
+}
+
+int Graph::UnloadGraph()
+{
+    job.Release();
+    tensors.Release();
     return AIPU_unload_graph(ctx, &gdesc);
 }
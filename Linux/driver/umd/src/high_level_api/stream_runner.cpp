@@ -0,0 +1,221 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  stream_runner.cpp
+ * @brief AIPU User Mode Driver (UMD) High Level (HL) API streaming runner implementation
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+#include "../high_level_api.h"
+
+struct stream_ctx;
+
+typedef struct stream_slot {
+    struct stream_ctx* stream;
+    const TensorSet* set;
+    Job job;
+    uint64_t frame;
+    int ret;               /**< error of job creation or flush, if any */
+    bool busy;             /**< a frame is in flight on this tensor set */
+    bool started;
+    pthread_t tid;
+} stream_slot_t;
+
+typedef struct stream_ctx {
+    const StreamRunner::Consumer* consume;
+    int32_t time_out;
+    bool in_order;
+    bool stop;
+    uint64_t next_frame;   /**< next frame to be delivered in frame order */
+    int ret;               /**< first error of the frames */
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    pthread_mutex_t deliver_lock;
+    std::vector<stream_slot_t> slots;
+} stream_ctx_t;
+
+static void* slot_thread(void* arg)
+{
+    stream_slot_t* slot = (stream_slot_t*)arg;
+    stream_ctx_t* stream = slot->stream;
+    int ret = 0;
+
+    pthread_mutex_lock(&stream->lock);
+    while (true)
+    {
+        while (!slot->busy && !stream->stop)
+        {
+            pthread_cond_wait(&stream->cond, &stream->lock);
+        }
+        if (!slot->busy)
+        {
+            break;
+        }
+        pthread_mutex_unlock(&stream->lock);
+
+        ret = slot->ret;
+        if (0 == ret)
+        {
+            ret = slot->job.Wait(stream->time_out);
+        }
+
+        pthread_mutex_lock(&stream->lock);
+        while (stream->in_order && (slot->frame != stream->next_frame))
+        {
+            pthread_cond_wait(&stream->cond, &stream->lock);
+        }
+        pthread_mutex_unlock(&stream->lock);
+
+        pthread_mutex_lock(&stream->deliver_lock);
+        (*stream->consume)(slot->frame, *slot->set, ret);
+        pthread_mutex_unlock(&stream->deliver_lock);
+        slot->job.Release();
+
+        pthread_mutex_lock(&stream->lock);
+        if (ret && !stream->ret)
+        {
+            stream->ret = ret;
+        }
+        stream->next_frame++;
+        slot->busy = false;
+        pthread_cond_broadcast(&stream->cond);
+    }
+    pthread_mutex_unlock(&stream->lock);
+
+    return NULL;
+}
+
+StreamRunner::StreamRunner(Graph& _graph, uint32_t depth, bool _in_order):
+    graph(_graph), in_order(_in_order)
+{
+    if (0 == depth)
+    {
+        depth = 1;
+    }
+
+    for (uint32_t i = 0; i < depth; i++)
+    {
+        sets.push_back(graph.CreateTensorSet());
+    }
+}
+
+int StreamRunner::Run(const Producer& produce, const Consumer& consume, int32_t time_out)
+{
+    stream_ctx_t stream;
+    stream_slot_t* slot = nullptr;
+    int ret = 0;
+
+    for (uint32_t i = 0; i < sets.size(); i++)
+    {
+        if (!sets[i].valid())
+        {
+            return AIPU_STATUS_ERROR_BUF_ALLOC_FAIL;
+        }
+    }
+
+    stream.consume = &consume;
+    stream.time_out = time_out;
+    stream.in_order = in_order;
+    stream.stop = false;
+    stream.next_frame = 0;
+    stream.ret = 0;
+    pthread_mutex_init(&stream.lock, NULL);
+    pthread_cond_init(&stream.cond, NULL);
+    pthread_mutex_init(&stream.deliver_lock, NULL);
+
+    /* slots are not moved any more once their threads run */
+    stream.slots.resize(sets.size());
+    for (uint32_t i = 0; i < stream.slots.size(); i++)
+    {
+        stream.slots[i].stream = &stream;
+        stream.slots[i].set = &sets[i];
+        stream.slots[i].frame = 0;
+        stream.slots[i].ret = 0;
+        stream.slots[i].busy = false;
+        stream.slots[i].started = false;
+    }
+    for (uint32_t i = 0; i < stream.slots.size(); i++)
+    {
+        stream.slots[i].started = (pthread_create(&stream.slots[i].tid, NULL, slot_thread,
+            &stream.slots[i]) == 0);
+        if (!stream.slots[i].started)
+        {
+            fprintf(stderr, "[UMD ERROR] Create stream runner thread failed!\n");
+            stream.ret = AIPU_STATUS_ERROR_INVALID_OP;
+            break;
+        }
+    }
+
+    /* producer: fill the next frame into a free tensor set while the others run */
+    for (uint64_t frame = 0; ; frame++)
+    {
+        slot = nullptr;
+        pthread_mutex_lock(&stream.lock);
+        while ((nullptr == slot) && (0 == stream.ret))
+        {
+            for (uint32_t i = 0; i < stream.slots.size(); i++)
+            {
+                if (!stream.slots[i].busy)
+                {
+                    slot = &stream.slots[i];
+                    break;
+                }
+            }
+            if (nullptr == slot)
+            {
+                pthread_cond_wait(&stream.cond, &stream.lock);
+            }
+        }
+        pthread_mutex_unlock(&stream.lock);
+
+        /* no more frames are produced after an error */
+        if ((nullptr == slot) || !produce(frame, *slot->set))
+        {
+            break;
+        }
+
+        slot->job = graph.CreateJob(*slot->set);
+        slot->ret = slot->job.valid() ? slot->job.Flush() : AIPU_STATUS_ERROR_INVALID_HANDLE;
+        slot->frame = frame;
+
+        pthread_mutex_lock(&stream.lock);
+        slot->busy = true;
+        pthread_cond_broadcast(&stream.cond);
+        pthread_mutex_unlock(&stream.lock);
+    }
+
+    pthread_mutex_lock(&stream.lock);
+    stream.stop = true;
+    pthread_cond_broadcast(&stream.cond);
+    pthread_mutex_unlock(&stream.lock);
+
+    for (uint32_t i = 0; i < stream.slots.size(); i++)
+    {
+        if (stream.slots[i].started)
+        {
+            pthread_join(stream.slots[i].tid, NULL);
+        }
+    }
+
+    ret = stream.ret;
+    pthread_mutex_destroy(&stream.deliver_lock);
+    pthread_cond_destroy(&stream.cond);
+    pthread_mutex_destroy(&stream.lock);
+    return ret;
+}
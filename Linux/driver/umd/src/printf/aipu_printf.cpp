@@ -36,7 +36,7 @@ int aipu_printf(char *log_buffer_base, char *redirect_file)
     if (redirect_file == NULL) {
         redirect_flag = EM_REDIRECT_TERMINAL;
     } else {
-        redirect_fd = open(redirect_file, O_CREAT|O_RDWR, 0755);
+        redirect_fd = open(redirect_file, O_CREAT|O_WRONLY|O_APPEND, 0644);
         if (redirect_fd < 0) {
             printf(LOG_PRIFX "open %s, ret=%d [fail]\n", redirect_file, redirect_fd);
             goto out;
@@ -0,0 +1,395 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  printf_drain.cpp
+ * @brief AIPU Debug Log background drain implementation
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <time.h>
+#include "printf_drain.h"
+#include "aipu_printf.h"
+#include "context/graph/graph.h"
+
+/* the batch is written once it exceeds this size, or when no new log comes in a poll */
+#define DRAIN_BATCH_SZ (64 * 1024)
+#define DRAIN_POLL_US  1000
+
+AIRT::PrintfDrain::PrintfDrain(uint32_t _handle, const std::vector<aipu_buffer_t>& bufs, int _fd)
+{
+    drain_ring_t ring;
+
+    handle = _handle;
+    fd = _fd;
+    stop_flag = false;
+    stats.drained_bytes = 0;
+    stats.dropped_bytes = 0;
+    stats.writes = 0;
+    for (uint32_t i = 0; i < bufs.size(); i++)
+    {
+        ring.base = (volatile char*)bufs[i].va;
+        ring.size = ((bufs[i].size < BUFFER_LEN) ? bufs[i].size : BUFFER_LEN) - LOG_HEADER_SZ;
+        ring.pos = 0;
+        rings.push_back(ring);
+    }
+    batch.reserve(DRAIN_BATCH_SZ);
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&cond, NULL);
+}
+
+AIRT::PrintfDrain::~PrintfDrain()
+{
+    if ((fd >= 0) && (STDOUT_FILENO != fd))
+    {
+        close(fd);
+    }
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&lock);
+}
+
+uint32_t AIRT::PrintfDrain::drain_ring(drain_ring_t& ring)
+{
+    volatile aipu_log_buffer_header_t* header = (volatile aipu_log_buffer_header_t*)ring.base;
+    int overwrite_flag = header->overwrite_flag;
+    int write_offset = header->write_offset;
+    uint64_t total = 0;
+    uint64_t lap = 0;
+    uint64_t dropped = 0;
+    uint32_t start = 0;
+    uint32_t len = 0;
+    uint32_t cnt = 0;
+
+    if ((write_offset < 0) || ((uint32_t)write_offset >= ring.size))
+    {
+        return 0;
+    }
+
+    /**
+     * the header only tells the offset in the ring: the total written bytes are the first
+     * ones beyond the drained position, at least one lap once AIPU has wrapped around
+     */
+    if (0 == overwrite_flag)
+    {
+        total = write_offset;
+        if (total < ring.pos)
+        {
+            /* header cleared for a new log */
+            ring.pos = 0;
+        }
+    }
+    else
+    {
+        lap = ring.pos / ring.size;
+        total = ((lap > 0) ? lap : 1) * ring.size + write_offset;
+        if (total < ring.pos)
+        {
+            total += ring.size;
+        }
+    }
+
+    if (total - ring.pos > ring.size)
+    {
+        dropped = total - ring.pos - ring.size;
+        ring.pos = total - ring.size;
+    }
+
+    while (ring.pos < total)
+    {
+        start = ring.pos % ring.size;
+        len = ring.size - start;
+        if (total - ring.pos < len)
+        {
+            len = total - ring.pos;
+        }
+        batch.insert(batch.end(), (const char*)ring.base + LOG_HEADER_SZ + start,
+            (const char*)ring.base + LOG_HEADER_SZ + start + len);
+        ring.pos += len;
+        cnt += len;
+        if (batch.size() >= DRAIN_BATCH_SZ)
+        {
+            flush_batch();
+        }
+    }
+
+    if (dropped)
+    {
+        pthread_mutex_lock(&lock);
+        stats.dropped_bytes += dropped;
+        pthread_mutex_unlock(&lock);
+    }
+    return cnt;
+}
+
+void AIRT::PrintfDrain::flush_batch()
+{
+    size_t done = 0;
+    ssize_t len = 0;
+    uint64_t writes = 0;
+
+    if (batch.empty())
+    {
+        return;
+    }
+
+    if (STDOUT_FILENO == fd)
+    {
+        fflush(stdout);
+    }
+    while (done < batch.size())
+    {
+        len = write(fd, &batch[done], batch.size() - done);
+        if (len <= 0)
+        {
+            break;
+        }
+        done += len;
+        writes++;
+    }
+
+    pthread_mutex_lock(&lock);
+    stats.drained_bytes += done;
+    stats.dropped_bytes += batch.size() - done;
+    stats.writes += writes;
+    pthread_mutex_unlock(&lock);
+    batch.clear();
+}
+
+void* AIRT::PrintfDrain::drain_thread(void* arg)
+{
+    PrintfDrain* drain = (PrintfDrain*)arg;
+    struct timespec time;
+    uint32_t cnt = 0;
+    bool stop = false;
+
+    pthread_mutex_lock(&drain->lock);
+    while (true)
+    {
+        stop = drain->stop_flag;
+        pthread_mutex_unlock(&drain->lock);
+
+        cnt = 0;
+        for (uint32_t i = 0; i < drain->rings.size(); i++)
+        {
+            cnt += drain->drain_ring(drain->rings[i]);
+        }
+        /* last pass after the stop request, or AIPU is idle: write out the batch */
+        if (stop || (0 == cnt))
+        {
+            drain->flush_batch();
+        }
+
+        pthread_mutex_lock(&drain->lock);
+        if (stop)
+        {
+            break;
+        }
+        if (!drain->stop_flag)
+        {
+            clock_gettime(CLOCK_REALTIME, &time);
+            time.tv_nsec += DRAIN_POLL_US * 1000;
+            time.tv_sec += time.tv_nsec / 1000000000;
+            time.tv_nsec %= 1000000000;
+            pthread_cond_timedwait(&drain->cond, &drain->lock, &time);
+        }
+    }
+    pthread_mutex_unlock(&drain->lock);
+
+    return NULL;
+}
+
+aipu_status_t AIRT::PrintfDrain::start()
+{
+    if (pthread_create(&tid, NULL, drain_thread, this) != 0)
+    {
+        return AIPU_STATUS_ERROR_INVALID_OP;
+    }
+    return AIPU_STATUS_SUCCESS;
+}
+
+void AIRT::PrintfDrain::stop()
+{
+    pthread_mutex_lock(&lock);
+    stop_flag = true;
+    pthread_cond_signal(&cond);
+    pthread_mutex_unlock(&lock);
+    pthread_join(tid, NULL);
+}
+
+void AIRT::PrintfDrain::get_stats(aipu_printf_drain_stats_t* out)
+{
+    pthread_mutex_lock(&lock);
+    *out = stats;
+    pthread_mutex_unlock(&lock);
+}
+
+AIRT::PrintfDrainTable::PrintfDrainTable()
+{
+    next_id = 1;
+    pthread_mutex_init(&lock, NULL);
+}
+
+AIRT::PrintfDrainTable::~PrintfDrainTable()
+{
+    clear();
+    pthread_mutex_destroy(&lock);
+}
+
+bool AIRT::PrintfDrainTable::is_handle_used(uint32_t handle)
+{
+    bool ret = false;
+    std::map<uint32_t, PrintfDrain*>::const_iterator iter;
+
+    pthread_mutex_lock(&lock);
+    for (iter = drains.begin(); iter != drains.end(); iter++)
+    {
+        if (iter->second->get_handle() == handle)
+        {
+            ret = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+bool AIRT::PrintfDrainTable::is_graph_used(uint32_t graph_id)
+{
+    bool ret = false;
+    std::map<uint32_t, PrintfDrain*>::const_iterator iter;
+
+    pthread_mutex_lock(&lock);
+    for (iter = drains.begin(); iter != drains.end(); iter++)
+    {
+        if (Graph::handle2graph_id(iter->second->get_handle()) == graph_id)
+        {
+            ret = true;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PrintfDrainTable::add(uint32_t handle, const std::vector<aipu_buffer_t>& bufs,
+    const char* redirect_file, uint32_t* id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, PrintfDrain*>::const_iterator iter;
+    PrintfDrain* drain = nullptr;
+    int fd = STDOUT_FILENO;
+
+    pthread_mutex_lock(&lock);
+    for (iter = drains.begin(); iter != drains.end(); iter++)
+    {
+        if (iter->second->get_handle() == handle)
+        {
+            ret = AIPU_STATUS_ERROR_BUSY_HANDLE;
+            goto unlock;
+        }
+    }
+
+    if (nullptr != redirect_file)
+    {
+        fd = open(redirect_file, O_CREAT|O_WRONLY|O_APPEND, 0644);
+        if (fd < 0)
+        {
+            ret = AIPU_STATUS_ERROR_OPEN_FILE_FAIL;
+            goto unlock;
+        }
+    }
+
+    drain = new PrintfDrain(handle, bufs, fd);
+    ret = drain->start();
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        delete drain;
+        goto unlock;
+    }
+
+    while (drains.count(next_id) || (0 == next_id))
+    {
+        next_id++;
+    }
+    *id = next_id++;
+    drains[*id] = drain;
+
+unlock:
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PrintfDrainTable::remove(uint32_t id, aipu_printf_drain_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, PrintfDrain*>::iterator iter;
+
+    /* the tensor buffer stays busy until the final drain is done */
+    pthread_mutex_lock(&lock);
+    iter = drains.find(id);
+    if (iter == drains.end())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+    }
+    else
+    {
+        iter->second->stop();
+        if (nullptr != stats)
+        {
+            iter->second->get_stats(stats);
+        }
+        delete iter->second;
+        drains.erase(iter);
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+aipu_status_t AIRT::PrintfDrainTable::get_stats(uint32_t id, aipu_printf_drain_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::map<uint32_t, PrintfDrain*>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    iter = drains.find(id);
+    if (iter == drains.end())
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_OPTIONS;
+    }
+    else
+    {
+        iter->second->get_stats(stats);
+    }
+    pthread_mutex_unlock(&lock);
+    return ret;
+}
+
+void AIRT::PrintfDrainTable::clear()
+{
+    std::map<uint32_t, PrintfDrain*>::iterator iter;
+
+    pthread_mutex_lock(&lock);
+    for (iter = drains.begin(); iter != drains.end(); iter++)
+    {
+        iter->second->stop();
+        delete iter->second;
+    }
+    drains.clear();
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,106 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  printf_drain.h
+ * @brief AIPU Debug Log background drain header
+ */
+
+#ifndef _PRINTF_DRAIN_H_
+#define _PRINTF_DRAIN_H_
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+#include <pthread.h>
+#include "standard_api.h"
+
+namespace AIRT
+{
+/**
+ * log ring buffer followed by a drain; pos counts the bytes ever written by AIPU up to
+ * the drained ones, so that its offset in the ring is pos % size
+ */
+typedef struct drain_ring {
+    volatile char* base;    /**< log buffer base, i.e. the header */
+    uint32_t size;          /**< size of the log data following the header */
+    uint64_t pos;
+} drain_ring_t;
+
+/**
+ * @brief Drain thread of the printf log buffers of a tensor buffer. The log is batched and
+ *        written to an append-mode fd, either when the batch is full or once AIPU is idle.
+ */
+class PrintfDrain
+{
+private:
+    uint32_t handle;
+    std::vector<drain_ring_t> rings;
+    int fd;
+    std::vector<char> batch;
+    aipu_printf_drain_stats_t stats;
+    bool stop_flag;
+    pthread_t tid;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+private:
+    static void* drain_thread(void* arg);
+    uint32_t drain_ring(drain_ring_t& ring);
+    void flush_batch();
+
+public:
+    uint32_t get_handle() const { return handle; }
+    aipu_status_t start();
+    void stop();
+    void get_stats(aipu_printf_drain_stats_t* out);
+
+public:
+    PrintfDrain(uint32_t _handle, const std::vector<aipu_buffer_t>& bufs, int _fd);
+    ~PrintfDrain();
+    PrintfDrain(const PrintfDrain& drain) = delete;
+    PrintfDrain& operator=(const PrintfDrain& drain) = delete;
+};
+
+/**
+ * @brief Printf log drains of a context; a tensor buffer is drained by one drain at a time
+ */
+class PrintfDrainTable
+{
+private:
+    std::map<uint32_t, PrintfDrain*> drains;
+    uint32_t next_id;
+    pthread_mutex_t lock;
+
+public:
+    bool is_handle_used(uint32_t handle);
+    bool is_graph_used(uint32_t graph_id);
+    aipu_status_t add(uint32_t handle, const std::vector<aipu_buffer_t>& bufs,
+        const char* redirect_file, uint32_t* id);
+    aipu_status_t remove(uint32_t id, aipu_printf_drain_stats_t* stats);
+    aipu_status_t get_stats(uint32_t id, aipu_printf_drain_stats_t* stats);
+    void clear();
+
+public:
+    PrintfDrainTable();
+    ~PrintfDrainTable();
+    PrintfDrainTable(const PrintfDrainTable& table) = delete;
+    PrintfDrainTable& operator=(const PrintfDrainTable& table) = delete;
+};
+}
+
+#endif /* _PRINTF_DRAIN_H_ */
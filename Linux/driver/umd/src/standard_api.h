@@ -76,6 +76,32 @@ typedef struct buffer {
     uint32_t size;
 } aipu_buffer_t;
 
+/**
+ * @brief Application side tensor converted to/from the device tensor format
+ *        data:      host memory of the tensor, densely packed
+ *        data_type: F32 (or U8 for images loaded into input tensors)
+ *        layout:    NHWC/NCHW transposed to/from a 4-D device tensor of the other layout;
+ *                   the device tensor layout (or TENSOR_LAYOUT_NONE) for no transpose
+ */
+typedef enum {
+    AIPU_HOST_DATA_TYPE_F32 = 0x0,
+    AIPU_HOST_DATA_TYPE_U8  = 0x1,
+} aipu_host_data_type_t;
+
+typedef struct aipu_host_tensor {
+    void* data;
+    aipu_host_data_type_t data_type;
+    aipu_tensor_layout_t layout;
+} aipu_host_tensor_t;
+
+/**
+ * @brief Affine quantization of a tensor: real = scale * (quantized - zero_point)
+ */
+typedef struct aipu_quant_param {
+    float scale;
+    int32_t zero_point;
+} aipu_quant_param_t;
+
 /**
  * @brief AIPU tensor descriptions struct of specific types: input/output/dump
  *        tensor_info:   basic format info.
@@ -134,6 +160,36 @@ typedef struct runtime_config {
     bool bypass_version_check; /**< flag used to bypass version checking between binary and hardware; by default disabled */
 } aipu_runtime_config_t;
 
+/**
+ * @brief SRAM placement hint of a graph; set by AIPU_set_graph_sram_hint().
+ *        Buffers preferring SRAM fall back to DDR when SRAM is exhausted or its ASID
+ *        does not accept the data type (KMD configuration).
+ */
+typedef enum {
+    AIPU_SRAM_HINT_AUTO = 0,  /**< reuse (activation) buffers prefer SRAM; the default */
+    AIPU_SRAM_HINT_ALL,       /**< same as AIPU_SRAM_HINT_AUTO: only reuse buffers have an SRAM ASID */
+    AIPU_SRAM_HINT_NONE       /**< DDR only */
+} aipu_sram_hint_t;
+
+/**
+ * @brief Stage of a multi-graph pipeline: a loaded graph with one of its tensor buffers
+ */
+typedef struct aipu_pipeline_stage {
+    uint32_t graph_id;    /**< graph ID returned by AIPU_load_graph */
+    uint32_t handle;      /**< tensor buffer handle returned by AIPU_alloc_tensor_buffers */
+} aipu_pipeline_stage_t;
+
+/**
+ * @brief Zero-copy link of a pipeline: the consumer input tensor aliases the producer
+ *        output tensor in device memory
+ */
+typedef struct aipu_pipeline_link {
+    uint32_t src_stage;   /**< producer stage index */
+    uint32_t src_output;  /**< output tensor index of the producer graph */
+    uint32_t dst_stage;   /**< consumer stage index; should be larger than src_stage */
+    uint32_t dst_input;   /**< input tensor index of the consumer graph */
+} aipu_pipeline_link_t;
+
 /**
  * @brief AIPU job status; returned by status querying API AIPU_get_job_end_status().
  */
@@ -143,6 +199,11 @@ typedef enum {
     AIPU_JOB_STATUS_EXCEPTION  /**< job execution failed, encountering exception */
 } aipu_job_status_t;
 
+/**
+ * @brief Job end callback registered by AIPU_flush_job_async
+ */
+typedef void (*aipu_job_done_cb_t)(uint32_t job_id, aipu_job_status_t status, void* arg);
+
 /**
  * @brief AIPU debug info struct; returned by UMD API for AIPU debugger to use
  */
@@ -152,6 +213,86 @@ typedef struct aipu_debug_info {
     uint64_t interrupt_pc_pa;     /**< interrupt handler base address (physical) */
 } aipu_debug_info_t;
 
+#define AIPU_PROF_AXI_ID_MAX         16
+#define AIPU_PROF_VALID_BW           (1 << 0) /**< rdata/wdata/cycle totals are valid */
+#define AIPU_PROF_VALID_DMA          (1 << 1) /**< DMA latency/rdata/AR handshake totals are valid */
+#define AIPU_PROF_VALID_ID_LAT       (1 << 2) /**< per-AXI-ID latency totals & maxima are valid */
+#define AIPU_PROF_VALID_OUTSTAND     (1 << 3) /**< max outstanding is valid */
+
+/**
+ * @brief AIPU job profiling data collected by kernel driver from SoC bandwidth/latency
+ *        counters; returned by AIPU_get_job_profiling_data(). Counter units are those of
+ *        the SoC registers (bytes/cycles). Only groups flagged in valid_mask are captured
+ *        by the board.
+ */
+typedef struct aipu_job_profiling_data {
+    uint32_t version;                 /**< KMD profiling record version; 0 if not captured */
+    uint32_t valid_mask;              /**< AIPU_PROF_VALID_* flags */
+    int64_t  execution_time_ns;       /**< job execution time */
+    uint64_t rdata_tot;               /**< total read data */
+    uint64_t wdata_tot;               /**< total write data */
+    uint64_t tot_cycle;               /**< total cycles */
+    uint64_t id_latency_max;          /**< maximum latency of all AXI IDs */
+    uint32_t id_latency_single;       /**< single transaction latency of the ID latency counter */
+    uint32_t max_outstanding;         /**< maximum outstanding transactions */
+    uint64_t dma_latency_tot;         /**< DMA total latency */
+    uint64_t dma_rdata_tot;           /**< DMA total read data */
+    uint64_t dma_ar_handshake;        /**< DMA AR channel handshake count */
+    uint64_t latency_tot_id[AIPU_PROF_AXI_ID_MAX]; /**< total latency of each AXI ID */
+    uint32_t latency_max_id[AIPU_PROF_AXI_ID_MAX]; /**< maximum latency of each AXI ID */
+} aipu_job_profiling_data_t;
+
+/**
+ * @brief Timestamps of an end job in ns (CLOCK_MONOTONIC); returned by
+ *        AIPU_get_job_timestamps(). On arm-linux they are taken by kernel driver;
+ *        on x86-linux they are taken around the simulator execution.
+ */
+typedef struct aipu_job_timestamps {
+    uint64_t submit_ns;           /**< job submitted to KMD/simulator */
+    uint64_t start_ns;            /**< job triggered to run on AIPU/simulator */
+    uint64_t end_ns;              /**< job done/exception interrupt or simulation end */
+} aipu_job_timestamps_t;
+
+/**
+ * @brief Aggregation of the AIPU/SoC counter samples taken periodically by kernel driver;
+ *        returned by AIPU_get_perf_sampling_stats(). Data/cycle values are in SoC counter
+ *        units and cover only sample pairs between which the counters ran continuously.
+ */
+typedef struct aipu_perf_sampling_stats {
+    uint64_t window_ns;           /**< time covered by the samples aggregated */
+    uint64_t sample_cnt;          /**< number of samples aggregated */
+    uint64_t lost_cnt;            /**< samples overwritten before being read (read more often) */
+    double   busy_ratio;          /**< AIPU busy duty cycle (0.0 ~ 1.0) */
+    double   avg_jobs_in_flight;  /**< average number of jobs scheduled on AIPU */
+    uint64_t rdata_tot;           /**< read data increment */
+    uint64_t wdata_tot;           /**< write data increment */
+    uint64_t tot_cycle;           /**< cycle counter increment */
+    double   rdata_per_sec;       /**< average read bandwidth */
+    double   wdata_per_sec;       /**< average write bandwidth */
+    double   peak_rdata_per_sec;  /**< maximum read bandwidth of a sampling period */
+    double   peak_wdata_per_sec;  /**< maximum write bandwidth of a sampling period */
+    uint32_t max_outstanding;     /**< maximum outstanding transactions seen */
+} aipu_perf_sampling_stats_t;
+
+/**
+ * @brief Graph residency counters of a context; returned by AIPU_get_residency_stats().
+ *        Hit rate of job creations is hit_cnt / (hit_cnt + miss_cnt).
+ */
+typedef struct aipu_residency_stats {
+    uint32_t graph_cnt;           /**< number of loaded graphs */
+    uint32_t resident_cnt;        /**< graphs with text/static buffers in device memory */
+    uint64_t resident_bytes;      /**< device memory held by text/static buffers of those graphs */
+    uint64_t hit_cnt;             /**< jobs created on a resident graph */
+    uint64_t miss_cnt;            /**< jobs created on an evicted graph (reloaded first) */
+    uint64_t eviction_cnt;        /**< evictions of text/static buffers */
+    uint64_t reload_cnt;          /**< reloads of text/static buffers */
+    uint64_t reload_ns_tot;       /**< total reload time */
+    uint64_t reload_ns_max;       /**< maximum reload time */
+    uint64_t defrag_cnt;          /**< compaction passes over idle graphs (see KMD sysfs "defrag") */
+    uint64_t migrate_cnt;         /**< text/static buffers migrated to close device memory holes */
+    uint64_t migrate_bytes;       /**< bytes of the migrated buffers */
+} aipu_residency_stats_t;
+
 /**
  * @brief AIPU memory dump flag; set by UMD application via API AIPU_set_dump_options()
  */
@@ -167,7 +308,10 @@ typedef enum {
     AIPU_DUMP_DRV_PROF_DATA = 1 << 8, /**< dump profiling data collected by kernel driver */
     AIPU_DUMP_BEFORE_RUN = 1 << 9,    /**< dump after loading & before job execution */
     AIPU_DUMP_AFTER_RUN = 1 << 10,    /**< dump after AIPU job execution done */
-    AIPU_DUMP_MAX = 1 << 11           /**< dump flag max. value, invalid */
+    AIPU_DUMP_ASYNC = 1 << 11,        /**< snapshot the sections and write them on a writer thread into
+                                           one container file per job (see AIPU_sync_dumps) */
+    AIPU_DUMP_LZ4 = 1 << 12,          /**< LZ4-compress the sections of an async dump */
+    AIPU_DUMP_MAX = 1 << 13           /**< dump flag max. value, invalid */
 } aipu_dump_flag_t;
 
 typedef struct dump_option {
@@ -176,6 +320,64 @@ typedef struct dump_option {
     const char* dir;                  /**< dump file path; set to be NULL if unused */
 } aipu_dump_option_t;
 
+/**
+ * @brief Tensors dumped by AIPU_DUMP_OUT_TENSOR/AIPU_DUMP_INTER_TENSOR; set per job by
+ *        AIPU_set_dump_selection() or per context by AIPU_set_dump_policy()
+ */
+typedef struct aipu_dump_selection {
+    const uint32_t* outputs;          /**< IDs of the output tensors dumped; NULL for all */
+    uint32_t output_cnt;
+    const uint32_t* inter_dumps;      /**< IDs of the intermediate tensors dumped; NULL for all */
+    uint32_t inter_dump_cnt;
+    uint32_t offset;                  /**< start of the byte range dumped of every such tensor */
+    uint32_t length;                  /**< length of the byte range; 0 till the end of the tensor */
+} aipu_dump_selection_t;
+
+/**
+ * @brief Jobs sampled by the dump policy of a context
+ */
+typedef enum {
+    AIPU_DUMP_SAMPLE_ALL = 0,         /**< every job */
+    AIPU_DUMP_SAMPLE_EVERY_NTH,       /**< one job out of every_n, starting from the first one */
+    AIPU_DUMP_SAMPLE_RANDOM,          /**< every job with probability fraction */
+    AIPU_DUMP_SAMPLE_ON_ERROR,        /**< jobs ending in exception or timeout, dumped after running only */
+    AIPU_DUMP_SAMPLE_MAX
+} aipu_dump_sample_mode_t;
+
+/**
+ * @brief Dump policy of a context; set by AIPU_set_dump_policy()
+ */
+typedef struct aipu_dump_policy {
+    aipu_dump_option_t option;        /**< dump options of the sampled jobs, as of AIPU_set_dump_options */
+    const aipu_dump_selection_t* selection; /**< tensors dumped of the sampled jobs; NULL for all */
+    uint32_t mode;                    /**< aipu_dump_sample_mode_t */
+    uint32_t every_n;                 /**< for AIPU_DUMP_SAMPLE_EVERY_NTH, >= 1 */
+    float fraction;                   /**< for AIPU_DUMP_SAMPLE_RANDOM, 0.0 ~ 1.0 */
+    uint32_t seed;                    /**< for AIPU_DUMP_SAMPLE_RANDOM; 0 for a time-based seed */
+} aipu_dump_policy_t;
+
+/**
+ * @brief Statistics of the async dump writer of the process; returned by AIPU_get_dump_stats()
+ */
+typedef struct aipu_dump_stats {
+    uint32_t queue_depth;             /**< job dumps staged and not yet written */
+    uint32_t max_queue_depth;         /**< maximum of queue_depth */
+    uint64_t staged_bytes;            /**< host staging memory held by those dumps */
+    uint64_t jobs_dumped;             /**< job dumps written (before & after running count twice) */
+    uint64_t bytes_dumped;            /**< section bytes of the job dumps written, uncompressed */
+    uint64_t bytes_written;           /**< bytes written to the container files */
+    uint64_t write_errors;            /**< job dumps failed to be written */
+} aipu_dump_stats_t;
+
+/**
+ * @brief Statistics of a printf log drain; see AIPU_start_printf_drain()
+ */
+typedef struct aipu_printf_drain_stats {
+    uint64_t drained_bytes;           /**< log bytes written to the redirect file/terminal */
+    uint64_t dropped_bytes;           /**< log bytes overwritten by AIPU before they were drained */
+    uint64_t writes;                  /**< write() calls issued for the drained bytes */
+} aipu_printf_drain_stats_t;
+
 /**
  * @brief This aipu_status_t enumeration captures the result of any API function
  *        that has been executed. Success is represented by AIPU_STATUS_SUCCESS
@@ -390,6 +592,30 @@ aipu_status_t AIPU_create_job(const aipu_ctx_handle_t* ctx, const aipu_graph_des
  *       additional operations.
  */
 aipu_status_t AIPU_flush_job(const aipu_ctx_handle_t* ctx, uint32_t id);
+/**
+ * @brief This API is used to flush a new computation job onto AIPU, with a callback called once
+ *        when the job ends
+ *
+ * @param[in] ctx Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] id  Job ID returned by AIPU_create_job
+ * @param[in] cb  Callback called with the job end status
+ * @param[in] arg Argument passed to the callback
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_JOB_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_JOB_SCHED
+ *
+ * @note the callback is called in the thread which finds the job end: the AIPU_poll_jobs_status
+ *       thread (poll_opt enabled), a thread waiting for this job, or the flushing thread on the
+ *       simulator. It should return quickly and must not clean the job; the callback is not called
+ *       if this API fails.
+ * @note a job which times out, or is cleaned or unloaded before it ends, calls the callback with
+ *       AIPU_JOB_STATUS_NO_STATUS (from the waiting or cleaning thread), so it is always called once.
+ */
+aipu_status_t AIPU_flush_job_async(const aipu_ctx_handle_t* ctx, uint32_t id, aipu_job_done_cb_t cb,
+    void* arg);
 /**
  * @brief This API is used to flush a new computation job onto AIPU
  *
@@ -467,6 +693,67 @@ aipu_status_t AIPU_clean_job(const aipu_ctx_handle_t* ctx, uint32_t id);
  */
 aipu_status_t AIPU_set_dump_options(const aipu_ctx_handle_t* ctx,
     uint32_t job_id, const aipu_dump_option_t* option);
+/**
+ * @brief This API selects the output/intermediate tensors, and the byte range of them,
+ *        dumped for a job; by default whole tensors are dumped.
+ *
+ * @param[in] ctx       Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] job_id    Job ID returned by AIPU_create_job
+ * @param[in] selection Tensors to be dumped; NULL to dump all of them again
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_JOB_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_JOB_SCHED
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS (tensor ID out of range)
+ */
+aipu_status_t AIPU_set_dump_selection(const aipu_ctx_handle_t* ctx, uint32_t job_id,
+    const aipu_dump_selection_t* selection);
+/**
+ * @brief This API sets the dump policy of a context: the jobs created by AIPU_create_job
+ *        afterwards are sampled and the sampled ones get the dump options and selection
+ *        of the policy, as if AIPU_set_dump_options()/AIPU_set_dump_selection() were called.
+ *        Those APIs still override the policy for a job. With AIPU_DUMP_SAMPLE_ON_ERROR,
+ *        AIPU_DUMP_BEFORE_RUN/AIPU_DUMP_MEM_MAP are ignored and a job is dumped after it ends
+ *        in exception or timeout only. Combined with AIPU_DUMP_ASYNC, this keeps a lightweight
+ *        capture enabled in production.
+ *
+ * @param[in] ctx    Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] policy Dump policy; NULL to disable it
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS
+ * @retval AIPU_STATUS_ERROR_INVALID_PATH
+ */
+aipu_status_t AIPU_set_dump_policy(const aipu_ctx_handle_t* ctx, const aipu_dump_policy_t* policy);
+/**
+ * @brief This API waits until the async dumps (AIPU_DUMP_ASYNC) queued so far are written.
+ *        Async dumps are snapshotted when the job is flushed/ends and written by a writer
+ *        thread of the process into <dir>/Graph0x<graph>_Job0x<job>_<suffix>.aipudump;
+ *        see context/dump_writer.h for the container format.
+ *
+ * @param[in] ctx Pointer to a context handle struct returned by AIPU_init_ctx
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ */
+aipu_status_t AIPU_sync_dumps(const aipu_ctx_handle_t* ctx);
+/**
+ * @brief This API gets the statistics of the async dump writer
+ *
+ * @param[in]  ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[out] stats Pointer to a memory location allocated by application where UMD stores
+ *                   the statistics
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ */
+aipu_status_t AIPU_get_dump_stats(const aipu_ctx_handle_t* ctx, aipu_dump_stats_t* stats);
 /**
  * @brief This API returns physical addresses of corresponding memory sections for debugger to use;
  *        Note that those physical addresses are for host CPU to use, rather than device.
@@ -483,6 +770,200 @@ aipu_status_t AIPU_set_dump_options(const aipu_ctx_handle_t* ctx,
  */
 aipu_status_t AIPU_get_debug_info(const aipu_ctx_handle_t* ctx,
     uint32_t job_id, aipu_debug_info_t* info);
+/**
+ * @brief This API returns the profiling data of an end job collected by kernel driver;
+ *        profiling is enabled per job by setting AIPU_DUMP_DRV_PROF_DATA via
+ *        AIPU_set_dump_options() before flushing it.
+ *
+ * @param[in]  ctx    Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in]  job_id Job ID returned by AIPU_create_job
+ * @param[out] data   Pointer to a memory location allocated by application where UMD stores
+ *                    the profiling data
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_JOB_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_JOB_NOT_END
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note works only for arm-linux platform
+ */
+aipu_status_t AIPU_get_job_profiling_data(const aipu_ctx_handle_t* ctx,
+    uint32_t job_id, aipu_job_profiling_data_t* data);
+/**
+ * @brief This API returns the submit/start/end timestamps of an end job, which split
+ *        the job latency into queuing and execution parts.
+ *
+ * @param[in]  ctx    Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in]  job_id Job ID returned by AIPU_create_job
+ * @param[out] ts     Pointer to a memory location allocated by application where UMD stores
+ *                    the timestamps
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_JOB_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_JOB_NOT_END
+ *
+ * @note all timestamps are 0 if the kernel driver does not provide them
+ */
+aipu_status_t AIPU_get_job_timestamps(const aipu_ctx_handle_t* ctx,
+    uint32_t job_id, aipu_job_timestamps_t* ts);
+/**
+ * @brief This API pins a graph in device memory or unpins it. The text/static buffers of
+ *        unpinned graphs loaded by AIPU_load_graph_helper may be evicted when device memory
+ *        runs out (or exceeds AIPU_GRAPH_RESIDENT_MB) while they have no job, and are reloaded
+ *        by the next AIPU_create_job; pinning an evicted graph reloads it at once.
+ *
+ * @param[in] ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] gdesc Pointer to a graph descriptor returned by AIPU_load_graph
+ * @param[in] pin   Pin (true) or unpin (false)
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_GRAPH_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_BUF_ALLOC_FAIL
+ *
+ * @note graphs loaded by AIPU_load_graph are never evicted because UMD does not own the
+ *       graph binary buffer to reload from; eviction works only for arm-linux platform
+ */
+aipu_status_t AIPU_pin_graph(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc, bool pin);
+/**
+ * @brief This API returns the graph residency counters of a context
+ *
+ * @param[in]  ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[out] stats Pointer to a memory location allocated by application where UMD stores
+ *                   the counters
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ */
+aipu_status_t AIPU_get_residency_stats(const aipu_ctx_handle_t* ctx, aipu_residency_stats_t* stats);
+/**
+ * @brief This API puts a graph into a shared activation arena or takes it out. The reuse
+ *        (input/output/intermediate) buffers of all tensor buffers of graphs in the same arena
+ *        are carved from one region sized for the largest member, instead of a private region
+ *        per tensor buffer allocation. Only one job of the member graphs may exist at a time:
+ *        AIPU_create_job fails with AIPU_STATUS_ERROR_BUSY_HANDLE until the previous job of
+ *        the arena is cleaned by AIPU_clean_job.
+ *
+ * @param[in] ctx      Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] gdesc    Pointer to a graph descriptor returned by AIPU_load_graph
+ * @param[in] arena_id Application chosen non-zero arena ID; 0 takes the graph out of its arena
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_GRAPH_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_INVALID_OP
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note this API should be called before any AIPU_alloc_tensor_buffers on the graph; the
+ *       IO tensors of arena members alias each other, so outputs must be consumed before
+ *       the inputs of the next member job are filled; works only for arm-linux platform
+ */
+aipu_status_t AIPU_set_graph_arena(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc,
+    uint32_t arena_id);
+/**
+ * @brief This API sets the SRAM placement hint of a graph. It applies to the tensor buffers
+ *        allocated afterwards; the SRAM occupancy and the buffers placed in SRAM (tagged
+ *        with graph ID) are shown in the "sram" sysfs node of the AIPU device.
+ *
+ * @param[in] ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] gdesc Pointer to a graph descriptor returned by AIPU_load_graph
+ * @param[in] hint  SRAM placement hint
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_GRAPH_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note works only for arm-linux platform
+ */
+aipu_status_t AIPU_set_graph_sram_hint(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc,
+    aipu_sram_hint_t hint);
+/**
+ * @brief This API creates a pipeline of graphs run back to back. Linked input tensors of a
+ *        stage are not copied: the job of the stage reads the output tensors of the producer
+ *        stage in place, so the application need not fill them.
+ *
+ * @param[in]  ctx       Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in]  stages    Pointer to the stage array, in execution order
+ * @param[in]  stage_cnt Stage number
+ * @param[in]  links     Pointer to the link array (can be NULL if link_cnt is 0)
+ * @param[in]  link_cnt  Link number
+ * @param[out] pipe_id   Pointer to a memory location allocated by application where UMD stores
+ *                       the pipeline ID
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_GRAPH_NOT_EXIST
+ * @retval AIPU_STATUS_ERROR_INVALID_HANDLE
+ * @retval AIPU_STATUS_ERROR_BUSY_HANDLE
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS
+ * @retval AIPU_STATUS_ERROR_INVALID_SIZE
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note a tensor buffer belongs to one pipeline only, and it cannot be freed before the
+ *       pipeline is destroyed; links are not supported for graphs with ASID enabled
+ */
+aipu_status_t AIPU_create_pipeline(const aipu_ctx_handle_t* ctx, const aipu_pipeline_stage_t* stages,
+    uint32_t stage_cnt, const aipu_pipeline_link_t* links, uint32_t link_cnt, uint32_t* pipe_id);
+/**
+ * @brief This API builds the jobs of all stages of a pipeline and flushes the first one.
+ *        Every other stage is flushed as soon as the end of the previous stage is observed
+ *        by AIPU_finish_pipeline or AIPU_poll_jobs_status.
+ *
+ * @param[in] ctx     Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] pipe_id Pipeline ID returned by AIPU_create_pipeline
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_HANDLE
+ * @retval AIPU_STATUS_ERROR_INVALID_OP
+ * @retval Other values returned by AIPU_create_job/AIPU_flush_job
+ */
+aipu_status_t AIPU_run_pipeline(const aipu_ctx_handle_t* ctx, uint32_t pipe_id);
+/**
+ * @brief This API waits for the end of a pipeline run and cleans the jobs of all stages;
+ *        the output tensors of the stages are kept in their tensor buffers.
+ *
+ * @param[in] ctx      Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] pipe_id  Pipeline ID returned by AIPU_create_pipeline
+ * @param[in] time_out Time out (in millisecond) of each stage
+ *                     (A timeout of value <= 0 means an infinite timeout.)
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_HANDLE
+ * @retval AIPU_STATUS_ERROR_INVALID_OP
+ * @retval AIPU_STATUS_ERROR_JOB_EXCEPTION
+ * @retval AIPU_STATUS_ERROR_JOB_TIMEOUT
+ *
+ * @note stages after a failed one are not run
+ */
+aipu_status_t AIPU_finish_pipeline(const aipu_ctx_handle_t* ctx, uint32_t pipe_id, int32_t time_out);
+/**
+ * @brief This API destroys a pipeline and removes the links of its stages
+ *
+ * @param[in] ctx     Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] pipe_id Pipeline ID returned by AIPU_create_pipeline
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_HANDLE
+ * @retval AIPU_STATUS_ERROR_INVALID_OP
+ */
+aipu_status_t AIPU_destroy_pipeline(const aipu_ctx_handle_t* ctx, uint32_t pipe_id);
 /**
  * @brief this API returns the current value in AIPU status register
  *
@@ -498,6 +979,90 @@ aipu_status_t AIPU_get_debug_info(const aipu_ctx_handle_t* ctx,
  * @note works only for arm-linux platform
  */
 aipu_status_t AIPU_get_dev_status(const aipu_ctx_handle_t* ctx, uint32_t* value);
+/**
+ * @brief This API enables/disables job timeline tracing; tracing can also be enabled at
+ *        startup by setting environment variable AIPU_TRACE=1
+ *
+ * @param[in] ctx    Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] enable Enable (true) or disable (false) tracing
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ *
+ * @note the tracing state and the traced events are shared by all contexts of a process
+ */
+aipu_status_t AIPU_enable_trace(const aipu_ctx_handle_t* ctx, bool enable);
+/**
+ * @brief This API starts/stops the periodic sampling of AIPU/SoC counters in kernel driver;
+ *        samples are kept in a ring shared with UMD via debugfs (debugfs should be mounted;
+ *        set AIPU_SAMPLER_DIR if the driver debugfs directory is not /sys/kernel/debug/aipu-*)
+ *
+ * @param[in] ctx       Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] period_us Sampling period in microsecond (>= 100); 0 to stop sampling
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_OPEN_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_WRITE_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_MAP_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note works only for arm-linux platform; sampling is device-wide
+ */
+aipu_status_t AIPU_config_perf_sampling(const aipu_ctx_handle_t* ctx, uint32_t period_us);
+/**
+ * @brief This API aggregates the counter samples taken since the last call (or since
+ *        sampling was started)
+ *
+ * @param[in]  ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[out] stats Pointer to a memory location allocated by application where UMD stores
+ *                   the statistics
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_OPEN_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_MAP_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note works only for arm-linux platform
+ */
+aipu_status_t AIPU_get_perf_sampling_stats(const aipu_ctx_handle_t* ctx,
+    aipu_perf_sampling_stats_t* stats);
+/**
+ * @brief This API writes all counter samples kept in the sampling ring into a CSV file
+ *        (raw cumulative counter values, one sample per line) for plotting
+ *
+ * @param[in] ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] fname CSV file name
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_OPEN_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_MAP_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_WRITE_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ *
+ * @note works only for arm-linux platform
+ */
+aipu_status_t AIPU_dump_perf_samples(const aipu_ctx_handle_t* ctx, const char* fname);
+/**
+ * @brief This API dumps the traced UMD API spans and KMD job timestamps into a file
+ *        in Chrome/Perfetto trace JSON format
+ *
+ * @param[in] ctx   Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in] fname Trace file path
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_OPEN_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_WRITE_FILE_FAIL
+ */
+aipu_status_t AIPU_dump_trace(const aipu_ctx_handle_t* ctx, const char* fname);
 /**
  * @brief this API print AIPU execution log information after corresponding job ends
  *
@@ -509,5 +1074,97 @@ aipu_status_t AIPU_get_dev_status(const aipu_ctx_handle_t* ctx, uint32_t* value)
  *
  */
 aipu_status_t AIPU_printf(aipu_tensor_buffer_t* printf_dumps, char* redirect_file);
+/**
+ * @brief This API starts to drain the printf log buffers of a tensor buffer in the background
+ *        while its jobs run. A drain thread follows the write offset of the log ring buffers
+ *        and appends the new log to the redirect file in batches, so that the log is neither
+ *        lost to wraparound of the ring buffers nor written at job end.
+ *        Log overwritten before it is drained is counted as dropped; a ring buffer lapped
+ *        more than once within a poll period (~1ms) cannot be detected.
+ *        AIPU_printf() should not be called for a drained tensor buffer.
+ *
+ * @param[in]  ctx           Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in]  handle        Buffer handle returned by AIPU_alloc_tensor_buffers
+ * @param[in]  redirect_file Log file opened in append mode; set to be NULL for the terminal
+ * @param[out] drain_id      Pointer to a memory location allocated by application where UMD stores
+ *                           the ID of the drain
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_HANDLE
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS (no printf buffer in the tensor buffer)
+ * @retval AIPU_STATUS_ERROR_BUSY_HANDLE (the tensor buffer is drained already)
+ * @retval AIPU_STATUS_ERROR_OPEN_FILE_FAIL
+ * @retval AIPU_STATUS_ERROR_INVALID_OP (drain thread creation failed)
+ *
+ * @note The tensor buffer cannot be freed, nor its graph unloaded, until the drain stops.
+ */
+aipu_status_t AIPU_start_printf_drain(const aipu_ctx_handle_t* ctx, uint32_t handle,
+    const char* redirect_file, uint32_t* drain_id);
+/**
+ * @brief This API drains the rest of the log and stops a printf log drain
+ *
+ * @param[in]  ctx      Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in]  drain_id Drain ID returned by AIPU_start_printf_drain
+ * @param[out] stats    Final statistics of the drain; set to be NULL if unused
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS (no such drain)
+ */
+aipu_status_t AIPU_stop_printf_drain(const aipu_ctx_handle_t* ctx, uint32_t drain_id,
+    aipu_printf_drain_stats_t* stats);
+/**
+ * @brief This API gets the statistics of a running printf log drain
+ *
+ * @param[in]  ctx      Pointer to a context handle struct returned by AIPU_init_ctx
+ * @param[in]  drain_id Drain ID returned by AIPU_start_printf_drain
+ * @param[out] stats    Pointer to a memory location allocated by application where UMD stores
+ *                      the statistics
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_CTX
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS (no such drain)
+ */
+aipu_status_t AIPU_get_printf_drain_stats(const aipu_ctx_handle_t* ctx, uint32_t drain_id,
+    aipu_printf_drain_stats_t* stats);
+/**
+ * @brief This API quantizes a host tensor into a device tensor buffer (usually an input) in
+ *        a single pass, transposing it into the layout of the device tensor if necessary.
+ *        SIMD kernels (AVX2/SSE2/NEON) are selected at runtime.
+ *
+ * @param[in] desc  Descriptor of the device tensor, e.g. from gdesc.inputs.desc
+ * @param[in] buf   Device tensor buffer, e.g. from the buffer alloc info of AIPU_alloc_tensor_buffers
+ * @param[in] src   Host tensor (F32 or U8)
+ * @param[in] quant Quantization parameters of the device tensor; scale must be positive
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_SIZE
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS
+ *
+ * @note quantized = clamp(rint(real / scale + zero_point)) with ties rounded to even
+ */
+aipu_status_t AIPU_convert_to_tensor(const aipu_tensor_desc_t* desc, const aipu_buffer_t* buf,
+    const aipu_host_tensor_t* src, const aipu_quant_param_t* quant);
+/**
+ * @brief This API dequantizes a device tensor buffer (usually an output) into a host F32
+ *        tensor in a single pass, transposing it into the host layout if necessary.
+ *
+ * @param[in] desc  Descriptor of the device tensor, e.g. from gdesc.outputs.desc
+ * @param[in] buf   Device tensor buffer
+ * @param[in] dst   Host tensor (F32) to be filled
+ * @param[in] quant Quantization parameters of the device tensor
+ *
+ * @retval AIPU_STATUS_SUCCESS
+ * @retval AIPU_STATUS_ERROR_NULL_PTR
+ * @retval AIPU_STATUS_ERROR_INVALID_SIZE
+ * @retval AIPU_STATUS_ERROR_INVALID_OPTIONS
+ * @retval AIPU_STATUS_ERROR_OP_NOT_SUPPORTED
+ */
+aipu_status_t AIPU_convert_from_tensor(const aipu_tensor_desc_t* desc, const aipu_buffer_t* buf,
+    const aipu_host_tensor_t* dst, const aipu_quant_param_t* quant);
 
 #endif /* _STANDARD_API_H_ */
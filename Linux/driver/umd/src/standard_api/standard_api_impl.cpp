@@ -23,9 +23,13 @@
 #include <stdlib.h>
 #include "standard_api.h"
 #include "context/ctx_ref_map.h"
+#include "context/tracer.h"
+#include "context/perf_sampler.h"
+#include "context/dump_writer.h"
 #include "utils/helper.h"
 #include "utils/log.h"
 #include "printf/aipu_printf.h"
+#include "tensor_convert/tensor_convert.h"
 
 aipu_status_t AIPU_get_status_msg(aipu_status_t status, const char** msg)
 {
@@ -170,6 +174,7 @@ aipu_status_t AIPU_load_graph(const aipu_ctx_handle_t* ctx, const void* graph,
     uint32_t size, aipu_graph_desc_t* gdesc)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_load_graph");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -197,6 +202,7 @@ aipu_status_t AIPU_load_graph_helper(const aipu_ctx_handle_t* ctx, const char* g
     aipu_graph_desc_t* gdesc)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_load_graph_helper");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
     void* graph = nullptr;
@@ -230,6 +236,7 @@ finish:
 aipu_status_t AIPU_unload_graph(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_unload_graph");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -257,6 +264,7 @@ aipu_status_t AIPU_alloc_tensor_buffers(const aipu_ctx_handle_t* ctx, const aipu
     aipu_buffer_alloc_info_t* info)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_alloc_tensor_buffers");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -283,6 +291,7 @@ finish:
 aipu_status_t AIPU_free_tensor_buffers(const aipu_ctx_handle_t* ctx, uint32_t handle)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_free_tensor_buffers");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -310,6 +319,7 @@ aipu_status_t AIPU_create_job(const aipu_ctx_handle_t* ctx, const aipu_graph_des
     uint32_t buf_handle, uint32_t* job_id)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_create_job");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -327,6 +337,10 @@ aipu_status_t AIPU_create_job(const aipu_ctx_handle_t* ctx, const aipu_graph_des
     else
     {
         ret = p_ctx->create_new_job(gdesc, buf_handle, job_id);
+        if (AIPU_STATUS_SUCCESS == ret)
+        {
+            span.set_job_id(*job_id);
+        }
     }
 
 finish:
@@ -336,6 +350,7 @@ finish:
 aipu_status_t AIPU_flush_job(const aipu_ctx_handle_t* ctx, uint32_t id)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_flush_job", id);
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -359,10 +374,39 @@ finish:
     return ret;
 }
 
+aipu_status_t AIPU_flush_job_async(const aipu_ctx_handle_t* ctx, uint32_t id, aipu_job_done_cb_t cb,
+    void* arg)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_flush_job_async", id);
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == cb))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->flush_job_async(id, cb, arg);
+    }
+
+finish:
+    return ret;
+}
+
 aipu_status_t AIPU_get_job_status(const aipu_ctx_handle_t* ctx, uint32_t id, int32_t time_out,
     aipu_job_status_t* status)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_get_job_status", id);
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -389,6 +433,7 @@ finish:
 aipu_status_t AIPU_finish_job(const aipu_ctx_handle_t* ctx, uint32_t id, int32_t time_out)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_finish_job", id);
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
     aipu_job_status_t status;
@@ -425,6 +470,7 @@ finish:
 aipu_status_t AIPU_poll_jobs_status(const aipu_ctx_handle_t* ctx, uint32_t* job_cnt, int32_t time_out)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_poll_jobs_status");
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -455,6 +501,7 @@ finish:
 aipu_status_t AIPU_clean_job(const aipu_ctx_handle_t* ctx, uint32_t id)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::TraceSpan span("AIPU_clean_job", id);
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
@@ -505,6 +552,107 @@ finish:
     return ret;
 }
 
+aipu_status_t AIPU_set_dump_selection(const aipu_ctx_handle_t* ctx, uint32_t job_id,
+    const aipu_dump_selection_t* selection)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->set_dump_selection(job_id, selection);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_set_dump_policy(const aipu_ctx_handle_t* ctx, const aipu_dump_policy_t* policy)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->set_dump_policy(policy);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_sync_dumps(const aipu_ctx_handle_t* ctx)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        AIRT::DumpWriter::get_writer().sync();
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_get_dump_stats(const aipu_ctx_handle_t* ctx, aipu_dump_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if ((nullptr == ctx) || (nullptr == stats))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        AIRT::DumpWriter::get_writer().get_stats(stats);
+    }
+
+finish:
+    return ret;
+}
+
 aipu_status_t AIPU_get_debug_info(const aipu_ctx_handle_t* ctx, uint32_t job_id,
     aipu_debug_info_t* info)
 {
@@ -532,13 +680,14 @@ finish:
     return ret;
 }
 
-aipu_status_t AIPU_get_dev_status(const aipu_ctx_handle_t* ctx, uint32_t* value)
+aipu_status_t AIPU_get_job_profiling_data(const aipu_ctx_handle_t* ctx, uint32_t job_id,
+    aipu_job_profiling_data_t* data)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
     AIRT::MainContext* p_ctx = nullptr;
 
-    if ((nullptr == ctx) || (nullptr == value))
+    if ((nullptr == ctx) || (nullptr == data))
     {
         ret = AIPU_STATUS_ERROR_NULL_PTR;
         goto finish;
@@ -551,36 +700,561 @@ aipu_status_t AIPU_get_dev_status(const aipu_ctx_handle_t* ctx, uint32_t* value)
     }
     else
     {
-        ret = p_ctx->get_dev_status(value);
+        ret = p_ctx->get_job_profiling_data(job_id, data);
     }
 
 finish:
     return ret;
 }
 
-aipu_status_t AIPU_printf(aipu_tensor_buffer_t *printf_dumps, char *redirect_file)
+aipu_status_t AIPU_get_job_timestamps(const aipu_ctx_handle_t* ctx, uint32_t job_id,
+    aipu_job_timestamps_t* ts)
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
 
-    if (nullptr == printf_dumps)
+    if ((nullptr == ctx) || (nullptr == ts))
     {
         ret = AIPU_STATUS_ERROR_NULL_PTR;
         goto finish;
     }
 
-    for (uint32_t i = 0; i < printf_dumps->number; i++)
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
     {
-        if (nullptr != printf_dumps->tensors[i].va)
-        {
-            aipu_printf((char*)printf_dumps->tensors[i].va, redirect_file);
-        }
-        else
-        {
-            ret = AIPU_STATUS_ERROR_NULL_PTR;
-            goto finish;
-        }
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->get_job_timestamps(job_id, ts);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_pin_graph(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc, bool pin)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == gdesc))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->pin_graph(gdesc, pin);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_get_residency_stats(const aipu_ctx_handle_t* ctx, aipu_residency_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == stats))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->get_residency_stats(stats);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_set_graph_arena(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc,
+    uint32_t arena_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == gdesc))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->set_graph_arena(gdesc, arena_id);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_set_graph_sram_hint(const aipu_ctx_handle_t* ctx, const aipu_graph_desc_t* gdesc,
+    aipu_sram_hint_t hint)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == gdesc))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->set_graph_sram_hint(gdesc, hint);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_create_pipeline(const aipu_ctx_handle_t* ctx, const aipu_pipeline_stage_t* stages,
+    uint32_t stage_cnt, const aipu_pipeline_link_t* links, uint32_t link_cnt, uint32_t* pipe_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == stages) || (nullptr == pipe_id) ||
+        ((nullptr == links) && (0 != link_cnt)))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->create_pipeline(stages, stage_cnt, links, link_cnt, pipe_id);
     }
 
 finish:
     return ret;
 }
+
+aipu_status_t AIPU_run_pipeline(const aipu_ctx_handle_t* ctx, uint32_t pipe_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->run_pipeline(pipe_id);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_finish_pipeline(const aipu_ctx_handle_t* ctx, uint32_t pipe_id, int32_t time_out)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->finish_pipeline(pipe_id, time_out);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_destroy_pipeline(const aipu_ctx_handle_t* ctx, uint32_t pipe_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->destroy_pipeline(pipe_id);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_get_dev_status(const aipu_ctx_handle_t* ctx, uint32_t* value)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if ((nullptr == ctx) || (nullptr == value))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->get_dev_status(value);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_enable_trace(const aipu_ctx_handle_t* ctx, bool enable)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        AIRT::Tracer::get_tracer().enable(enable);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_dump_trace(const aipu_ctx_handle_t* ctx, const char* fname)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if ((nullptr == ctx) || (nullptr == fname))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = AIRT::Tracer::get_tracer().dump(fname);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_config_perf_sampling(const aipu_ctx_handle_t* ctx, uint32_t period_us)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+        ret = AIRT::PerfSampler::get_sampler().config(period_us);
+#else
+        ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_get_perf_sampling_stats(const aipu_ctx_handle_t* ctx,
+    aipu_perf_sampling_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if ((nullptr == ctx) || (nullptr == stats))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+        ret = AIRT::PerfSampler::get_sampler().get_stats(stats);
+#else
+        ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_dump_perf_samples(const aipu_ctx_handle_t* ctx, const char* fname)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+
+    if ((nullptr == ctx) || (nullptr == fname))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (nullptr == ctx_map.get_ctx_ref(ctx->handle))
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+        ret = AIRT::PerfSampler::get_sampler().dump(fname);
+#else
+        ret = AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+#endif
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_printf(aipu_tensor_buffer_t *printf_dumps, char *redirect_file)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    if (nullptr == printf_dumps)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    for (uint32_t i = 0; i < printf_dumps->number; i++)
+    {
+        if (nullptr != printf_dumps->tensors[i].va)
+        {
+            aipu_printf((char*)printf_dumps->tensors[i].va, redirect_file);
+        }
+        else
+        {
+            ret = AIPU_STATUS_ERROR_NULL_PTR;
+            goto finish;
+        }
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_start_printf_drain(const aipu_ctx_handle_t* ctx, uint32_t handle,
+    const char* redirect_file, uint32_t* drain_id)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->start_printf_drain(handle, redirect_file, drain_id);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_stop_printf_drain(const aipu_ctx_handle_t* ctx, uint32_t drain_id,
+    aipu_printf_drain_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->stop_printf_drain(drain_id, stats);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_get_printf_drain_stats(const aipu_ctx_handle_t* ctx, uint32_t drain_id,
+    aipu_printf_drain_stats_t* stats)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    AIRT::CtxRefMap& ctx_map = AIRT::CtxRefMap::get_ctx_map();
+    AIRT::MainContext* p_ctx = nullptr;
+
+    if (nullptr == ctx)
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    p_ctx = ctx_map.get_ctx_ref(ctx->handle);
+    if (nullptr == p_ctx)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_CTX;
+    }
+    else
+    {
+        ret = p_ctx->get_printf_drain_stats(drain_id, stats);
+    }
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_convert_to_tensor(const aipu_tensor_desc_t* desc, const aipu_buffer_t* buf,
+    const aipu_host_tensor_t* src, const aipu_quant_param_t* quant)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    if ((nullptr == desc) || (nullptr == buf) || (nullptr == src) || (nullptr == quant))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (buf->size < desc->size)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_SIZE;
+        goto finish;
+    }
+
+    ret = AIRT::convert_to_device_tensor(*desc, buf->va, *src, *quant);
+
+finish:
+    return ret;
+}
+
+aipu_status_t AIPU_convert_from_tensor(const aipu_tensor_desc_t* desc, const aipu_buffer_t* buf,
+    const aipu_host_tensor_t* dst, const aipu_quant_param_t* quant)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+
+    if ((nullptr == desc) || (nullptr == buf) || (nullptr == dst) || (nullptr == quant))
+    {
+        ret = AIPU_STATUS_ERROR_NULL_PTR;
+        goto finish;
+    }
+
+    if (buf->size < desc->size)
+    {
+        ret = AIPU_STATUS_ERROR_INVALID_SIZE;
+        goto finish;
+    }
+
+    ret = AIRT::convert_from_device_tensor(*desc, buf->va, *dst, *quant);
+
+finish:
+    return ret;
+}
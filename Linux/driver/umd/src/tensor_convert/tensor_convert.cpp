@@ -0,0 +1,309 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_convert.cpp
+ * @brief AIPU User Mode Driver (UMD) host <-> device tensor conversion module implementation
+ */
+
+#include <string.h>
+#include <vector>
+#include "tensor_convert.h"
+
+typedef struct convert_plan {
+    uint32_t type_bytes;   /**< bytes of a device tensor element */
+    uint32_t host_bytes;   /**< bytes of a host tensor element */
+    uint32_t elems;
+    bool transpose;
+    bool dev_nhwc;         /**< device NHWC & host NCHW if transpose, or the reverse */
+    uint32_t N;
+    uint32_t HW;
+    uint32_t C;
+    uint32_t tile;         /**< pixels per tile */
+    float scale;
+    float zero_point;
+} convert_plan_t;
+
+static bool is_4d_layout(aipu_tensor_layout_t layout)
+{
+    return (TENSOR_LAYOUT_NHWC == layout) || (TENSOR_LAYOUT_NCHW == layout);
+}
+
+static aipu_status_t get_convert_plan(const aipu_tensor_desc_t& desc, const aipu_host_tensor_t& host,
+    const aipu_quant_param_t& quant, convert_plan_t& plan)
+{
+    const aipu_tensor_shape_t& shape = desc.fmt.shape;
+
+    plan.type_bytes = AIRT::get_tensor_type_bytes(desc.fmt.data_type);
+    plan.host_bytes = (AIPU_HOST_DATA_TYPE_F32 == host.data_type) ? sizeof(float) : sizeof(uint8_t);
+    if ((0 == plan.type_bytes) || (!(quant.scale > 0)) ||
+        ((AIPU_HOST_DATA_TYPE_F32 != host.data_type) && (AIPU_HOST_DATA_TYPE_U8 != host.data_type)))
+    {
+        return AIPU_STATUS_ERROR_INVALID_OPTIONS;
+    }
+    plan.elems = desc.size / plan.type_bytes;
+    plan.scale = quant.scale;
+    plan.zero_point = (float)quant.zero_point;
+    plan.transpose = false;
+
+    if ((host.layout == desc.fmt.layout) || (TENSOR_LAYOUT_NONE == host.layout))
+    {
+        return AIPU_STATUS_SUCCESS;
+    }
+
+    if (!is_4d_layout(host.layout) || !is_4d_layout(desc.fmt.layout))
+    {
+        return AIPU_STATUS_ERROR_INVALID_OPTIONS;
+    }
+
+    if ((uint64_t)shape.N * shape.H * shape.W * shape.C != plan.elems)
+    {
+        return AIPU_STATUS_ERROR_INVALID_SIZE;
+    }
+
+    plan.N = shape.N;
+    plan.HW = shape.H * shape.W;
+    plan.C = shape.C;
+    plan.dev_nhwc = (TENSOR_LAYOUT_NHWC == desc.fmt.layout);
+    /* a single channel or pixel is the same in both layouts */
+    plan.transpose = (plan.C > 1) && (plan.HW > 1);
+    plan.tile = TENSOR_CONVERT_TILE_BYTES / (plan.C * sizeof(float));
+    plan.tile = (plan.tile < 16) ? 16 : (plan.tile & ~15U);
+    return AIPU_STATUS_SUCCESS;
+}
+
+/* out[p * C + c] = planes[c * stride + p] */
+template <typename E>
+static void interleave(const void* planes, uint32_t stride, void* out, uint32_t cnt, uint32_t C)
+{
+    const E* in = (const E*)planes;
+    E* o = (E*)out;
+
+    for (uint32_t p = 0; p < cnt; p++)
+    {
+        for (uint32_t c = 0; c < C; c++)
+        {
+            o[p * C + c] = in[(uint64_t)c * stride + p];
+        }
+    }
+}
+
+/* planes[c * stride + p] = in[p * C + c] */
+template <typename E>
+static void deinterleave(const void* in, void* planes, uint32_t stride, uint32_t cnt, uint32_t C)
+{
+    const E* i = (const E*)in;
+    E* o = (E*)planes;
+
+    for (uint32_t p = 0; p < cnt; p++)
+    {
+        for (uint32_t c = 0; c < C; c++)
+        {
+            o[(uint64_t)c * stride + p] = i[p * C + c];
+        }
+    }
+}
+
+static void interleave_elems(uint32_t bytes, const void* planes, uint32_t stride, void* out,
+    uint32_t cnt, uint32_t C)
+{
+    if (1 == bytes)
+    {
+        interleave<uint8_t>(planes, stride, out, cnt, C);
+    }
+    else if (2 == bytes)
+    {
+        interleave<uint16_t>(planes, stride, out, cnt, C);
+    }
+    else
+    {
+        interleave<uint32_t>(planes, stride, out, cnt, C);
+    }
+}
+
+static void deinterleave_elems(uint32_t bytes, const void* in, void* planes, uint32_t stride,
+    uint32_t cnt, uint32_t C)
+{
+    if (1 == bytes)
+    {
+        deinterleave<uint8_t>(in, planes, stride, cnt, C);
+    }
+    else if (2 == bytes)
+    {
+        deinterleave<uint16_t>(in, planes, stride, cnt, C);
+    }
+    else
+    {
+        deinterleave<uint32_t>(in, planes, stride, cnt, C);
+    }
+}
+
+static void quantize(const AIRT::tensor_kernels_t* kernels, aipu_data_type_t type,
+    const aipu_host_tensor_t& host, const void* src, void* dst, uint32_t cnt, const convert_plan_t& plan)
+{
+    if (AIPU_HOST_DATA_TYPE_F32 == host.data_type)
+    {
+        kernels->quantize_f32[type]((const float*)src, dst, cnt, 1.0f / plan.scale, plan.zero_point);
+    }
+    else
+    {
+        kernels->quantize_u8[type]((const uint8_t*)src, dst, cnt, 1.0f / plan.scale, plan.zero_point);
+    }
+}
+
+aipu_status_t AIRT::convert_to_device_tensor(const aipu_tensor_desc_t& desc, void* dev,
+    const aipu_host_tensor_t& host, const aipu_quant_param_t& quant, const tensor_kernels_t* kernels)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    aipu_data_type_t type = desc.fmt.data_type;
+    convert_plan_t plan;
+    std::vector<uint8_t> planes;
+    std::vector<uint8_t> tile;
+    const uint8_t* src = (const uint8_t*)host.data;
+    uint8_t* dst = (uint8_t*)dev;
+    uint32_t cnt = 0;
+    uint64_t frame = 0;
+
+    if ((nullptr == dev) || (nullptr == host.data))
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    ret = get_convert_plan(desc, host, quant, plan);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    if (nullptr == kernels)
+    {
+        kernels = get_best_tensor_kernels();
+    }
+
+    if (!plan.transpose)
+    {
+        quantize(kernels, type, host, src, dst, plan.elems, plan);
+        return ret;
+    }
+
+    planes.resize((uint64_t)plan.tile * plan.C * sizeof(float));
+    tile.resize((uint64_t)plan.tile * plan.C * plan.type_bytes);
+    for (uint32_t n = 0; n < plan.N; n++)
+    {
+        frame = (uint64_t)n * plan.HW * plan.C;
+        for (uint32_t p0 = 0; p0 < plan.HW; p0 += cnt)
+        {
+            cnt = (plan.HW - p0 < plan.tile) ? (plan.HW - p0) : plan.tile;
+            if (plan.dev_nhwc)
+            {
+                /* quantize channel plane segments, interleave in cache, then write pixels out */
+                for (uint32_t c = 0; c < plan.C; c++)
+                {
+                    quantize(kernels, type, host, src + (frame + (uint64_t)c * plan.HW + p0) * plan.host_bytes,
+                        &planes[(uint64_t)c * plan.tile * plan.type_bytes], cnt, plan);
+                }
+                interleave_elems(plan.type_bytes, &planes[0], plan.tile, &tile[0], cnt, plan.C);
+                memcpy(dst + (frame + (uint64_t)p0 * plan.C) * plan.type_bytes, &tile[0],
+                    (uint64_t)cnt * plan.C * plan.type_bytes);
+            }
+            else
+            {
+                /* split host pixels into channel planes in cache, then quantize into device planes */
+                deinterleave_elems(plan.host_bytes, src + (frame + (uint64_t)p0 * plan.C) * plan.host_bytes,
+                    &planes[0], plan.tile, cnt, plan.C);
+                for (uint32_t c = 0; c < plan.C; c++)
+                {
+                    quantize(kernels, type, host, &planes[(uint64_t)c * plan.tile * plan.host_bytes],
+                        dst + (frame + (uint64_t)c * plan.HW + p0) * plan.type_bytes, cnt, plan);
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+aipu_status_t AIRT::convert_from_device_tensor(const aipu_tensor_desc_t& desc, const void* dev,
+    const aipu_host_tensor_t& host, const aipu_quant_param_t& quant, const tensor_kernels_t* kernels)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    dequantize_fn_t dequantize = nullptr;
+    convert_plan_t plan;
+    std::vector<float> planes;
+    const uint8_t* src = (const uint8_t*)dev;
+    float* dst = (float*)host.data;
+    uint32_t cnt = 0;
+    uint64_t frame = 0;
+
+    if ((nullptr == dev) || (nullptr == host.data))
+    {
+        return AIPU_STATUS_ERROR_NULL_PTR;
+    }
+
+    if (AIPU_HOST_DATA_TYPE_F32 != host.data_type)
+    {
+        return AIPU_STATUS_ERROR_OP_NOT_SUPPORTED;
+    }
+
+    ret = get_convert_plan(desc, host, quant, plan);
+    if (AIPU_STATUS_SUCCESS != ret)
+    {
+        return ret;
+    }
+
+    if (nullptr == kernels)
+    {
+        kernels = get_best_tensor_kernels();
+    }
+    dequantize = kernels->dequantize[desc.fmt.data_type];
+
+    if (!plan.transpose)
+    {
+        dequantize(src, dst, plan.elems, plan.scale, plan.zero_point);
+        return ret;
+    }
+
+    planes.resize((uint64_t)plan.tile * plan.C);
+    for (uint32_t n = 0; n < plan.N; n++)
+    {
+        frame = (uint64_t)n * plan.HW * plan.C;
+        for (uint32_t p0 = 0; p0 < plan.HW; p0 += cnt)
+        {
+            cnt = (plan.HW - p0 < plan.tile) ? (plan.HW - p0) : plan.tile;
+            if (plan.dev_nhwc)
+            {
+                /* read pixels sequentially, then split them into the host planes */
+                dequantize(src + (frame + (uint64_t)p0 * plan.C) * plan.type_bytes, &planes[0],
+                    cnt * plan.C, plan.scale, plan.zero_point);
+                deinterleave_elems(sizeof(float), &planes[0], dst + frame + p0, plan.HW, cnt, plan.C);
+            }
+            else
+            {
+                /* read channel plane segments sequentially, then interleave into host pixels */
+                for (uint32_t c = 0; c < plan.C; c++)
+                {
+                    dequantize(src + (frame + (uint64_t)c * plan.HW + p0) * plan.type_bytes,
+                        &planes[(uint64_t)c * plan.tile], cnt, plan.scale, plan.zero_point);
+                }
+                interleave_elems(sizeof(float), &planes[0], plan.tile, dst + frame + (uint64_t)p0 * plan.C,
+                    cnt, plan.C);
+            }
+        }
+    }
+
+    return ret;
+}
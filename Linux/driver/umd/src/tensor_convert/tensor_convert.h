@@ -0,0 +1,55 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_convert.h
+ * @brief AIPU User Mode Driver (UMD) host <-> device tensor conversion module header
+ */
+
+#ifndef _TENSOR_CONVERT_H_
+#define _TENSOR_CONVERT_H_
+
+#include "standard_api.h"
+#include "tensor_kernels.h"
+
+/**
+ * transposes go through tiles of this size in cache, so that device memory is
+ * always accessed sequentially
+ */
+#define TENSOR_CONVERT_TILE_BYTES (16 * 1024)
+
+namespace AIRT
+{
+/**
+ * @brief Quantize a host tensor into a device tensor buffer
+ *
+ * @param kernels Kernels to be used; the fastest ones supported if nullptr
+ */
+aipu_status_t convert_to_device_tensor(const aipu_tensor_desc_t& desc, void* dev,
+    const aipu_host_tensor_t& host, const aipu_quant_param_t& quant,
+    const tensor_kernels_t* kernels = nullptr);
+/**
+ * @brief Dequantize a device tensor buffer into a host tensor
+ *
+ * @param kernels Kernels to be used; the fastest ones supported if nullptr
+ */
+aipu_status_t convert_from_device_tensor(const aipu_tensor_desc_t& desc, const void* dev,
+    const aipu_host_tensor_t& host, const aipu_quant_param_t& quant,
+    const tensor_kernels_t* kernels = nullptr);
+}
+
+#endif /* _TENSOR_CONVERT_H_ */
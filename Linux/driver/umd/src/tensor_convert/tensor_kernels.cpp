@@ -0,0 +1,117 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_kernels.cpp
+ * @brief AIPU User Mode Driver (UMD) tensor quantization kernels: scalar reference & dispatch
+ */
+
+#include "tensor_kernels.h"
+
+template <typename T>
+static void quantize_f32(const float* src, void* dst, uint32_t cnt, float inv_scale, float zero_point)
+{
+    AIRT::quantize_elems(src, (T*)dst, cnt, inv_scale, zero_point);
+}
+
+template <typename T>
+static void quantize_u8(const uint8_t* src, void* dst, uint32_t cnt, float inv_scale, float zero_point)
+{
+    AIRT::quantize_elems(src, (T*)dst, cnt, inv_scale, zero_point);
+}
+
+template <typename T>
+static void dequantize(const void* src, float* dst, uint32_t cnt, float scale, float zero_point)
+{
+    AIRT::dequantize_elems((const T*)src, dst, cnt, scale, zero_point);
+}
+
+static const AIRT::tensor_kernels_t scalar_kernels = {
+    "scalar",
+    { nullptr, quantize_f32<uint8_t>, quantize_f32<int8_t>, quantize_f32<uint16_t>, quantize_f32<int16_t> },
+    { nullptr, quantize_u8<uint8_t>, quantize_u8<int8_t>, quantize_u8<uint16_t>, quantize_u8<int16_t> },
+    { nullptr, dequantize<uint8_t>, dequantize<int8_t>, dequantize<uint16_t>, dequantize<int16_t> },
+};
+
+const AIRT::tensor_kernels_t* AIRT::get_scalar_tensor_kernels()
+{
+    return &scalar_kernels;
+}
+
+const AIRT::tensor_kernels_t* AIRT::get_tensor_kernels(tensor_isa_t isa)
+{
+    const tensor_kernels_t* kernels = nullptr;
+
+    switch (isa)
+    {
+        case TENSOR_ISA_SCALAR:
+            kernels = get_scalar_tensor_kernels();
+            break;
+        case TENSOR_ISA_SSE2:
+            kernels = get_sse2_tensor_kernels();
+            break;
+        case TENSOR_ISA_AVX2:
+#if defined(__x86_64__) || defined(__i386__)
+            if (__builtin_cpu_supports("avx2"))
+            {
+                kernels = get_avx2_tensor_kernels();
+            }
+#endif
+            break;
+        case TENSOR_ISA_NEON:
+            kernels = get_neon_tensor_kernels();
+            break;
+        default:
+            break;
+    }
+
+    return kernels;
+}
+
+static const AIRT::tensor_kernels_t* select_best_tensor_kernels()
+{
+    const AIRT::tensor_kernels_t* kernels = nullptr;
+
+    for (int isa = AIRT::TENSOR_ISA_MAX - 1; isa >= AIRT::TENSOR_ISA_SCALAR; isa--)
+    {
+        kernels = AIRT::get_tensor_kernels((AIRT::tensor_isa_t)isa);
+        if (nullptr != kernels)
+        {
+            break;
+        }
+    }
+    return kernels;
+}
+
+const AIRT::tensor_kernels_t* AIRT::get_best_tensor_kernels()
+{
+    static const tensor_kernels_t* best = select_best_tensor_kernels();
+    return best;
+}
+
+uint32_t AIRT::get_tensor_type_bytes(aipu_data_type_t type)
+{
+    if ((TENSOR_DATA_TYPE_U8 == type) || (TENSOR_DATA_TYPE_S8 == type))
+    {
+        return 1;
+    }
+    else if ((TENSOR_DATA_TYPE_U16 == type) || (TENSOR_DATA_TYPE_S16 == type))
+    {
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,109 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_kernels.h
+ * @brief AIPU User Mode Driver (UMD) tensor quantization kernels header
+ *
+ * Kernels work on contiguous elements; layout conversion is done by the caller in tiles.
+ * All implementations compute the same results bit by bit:
+ *     quantize:   q = clamp(rint(x * inv_scale + zero_point), type min, type max)
+ *     dequantize: x = ((float)q - zero_point) * scale
+ * with rint() rounding half to even.
+ */
+
+#ifndef _TENSOR_KERNELS_H_
+#define _TENSOR_KERNELS_H_
+
+#include <stdint.h>
+#include <math.h>
+#include <limits>
+#include "standard_api.h"
+
+namespace AIRT
+{
+typedef enum {
+    TENSOR_ISA_SCALAR = 0,
+    TENSOR_ISA_SSE2,
+    TENSOR_ISA_AVX2,
+    TENSOR_ISA_NEON,
+    TENSOR_ISA_MAX
+} tensor_isa_t;
+
+/* kernel tables are indexed by aipu_data_type_t of the quantized side */
+#define TENSOR_KERNEL_TYPE_CNT (TENSOR_DATA_TYPE_S16 + 1)
+
+typedef void (*quantize_f32_fn_t)(const float* src, void* dst, uint32_t cnt, float inv_scale,
+    float zero_point);
+typedef void (*quantize_u8_fn_t)(const uint8_t* src, void* dst, uint32_t cnt, float inv_scale,
+    float zero_point);
+typedef void (*dequantize_fn_t)(const void* src, float* dst, uint32_t cnt, float scale,
+    float zero_point);
+
+typedef struct tensor_kernels {
+    const char* name;
+    quantize_f32_fn_t quantize_f32[TENSOR_KERNEL_TYPE_CNT];
+    quantize_u8_fn_t quantize_u8[TENSOR_KERNEL_TYPE_CNT];
+    dequantize_fn_t dequantize[TENSOR_KERNEL_TYPE_CNT];
+} tensor_kernels_t;
+
+/**
+ * @brief Get the kernels of an instruction set
+ *
+ * @retval nullptr if the instruction set is not built in or not supported by this CPU
+ */
+const tensor_kernels_t* get_tensor_kernels(tensor_isa_t isa);
+/**
+ * @brief Get the fastest kernels supported by this CPU (selected once)
+ */
+const tensor_kernels_t* get_best_tensor_kernels();
+uint32_t get_tensor_type_bytes(aipu_data_type_t type);
+
+/* reference element conversion, also used for the tails of SIMD kernels */
+template <typename S, typename T>
+inline void quantize_elems(const S* src, T* dst, uint32_t cnt, float inv_scale, float zero_point)
+{
+    const float lo = (float)std::numeric_limits<T>::min();
+    const float hi = (float)std::numeric_limits<T>::max();
+    float v = 0;
+
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        v = (float)src[i] * inv_scale + zero_point;
+        v = (v > lo) ? v : lo;
+        v = (v < hi) ? v : hi;
+        dst[i] = (T)nearbyintf(v);
+    }
+}
+
+template <typename T>
+inline void dequantize_elems(const T* src, float* dst, uint32_t cnt, float scale, float zero_point)
+{
+    for (uint32_t i = 0; i < cnt; i++)
+    {
+        dst[i] = ((float)src[i] - zero_point) * scale;
+    }
+}
+
+/* per-ISA kernel tables; nullptr if not built for this architecture */
+const tensor_kernels_t* get_scalar_tensor_kernels();
+const tensor_kernels_t* get_sse2_tensor_kernels();
+const tensor_kernels_t* get_avx2_tensor_kernels();
+const tensor_kernels_t* get_neon_tensor_kernels();
+}
+
+#endif /* _TENSOR_KERNELS_H_ */
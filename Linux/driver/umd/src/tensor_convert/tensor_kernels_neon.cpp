@@ -0,0 +1,190 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_kernels_neon.cpp
+ * @brief AIPU User Mode Driver (UMD) tensor quantization kernels: AArch64 NEON
+ *
+ * Values are clamped in float before the conversion, which rounds half to even (FCVTNS)
+ * like rint, so the saturating narrows never saturate.
+ */
+
+#include "tensor_kernels.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+
+/* widen 16 elements to 4 int32 vectors */
+static inline void neon_widen16(const uint8_t* src, int32x4_t* q)
+{
+    uint8x16_t b = vld1q_u8(src);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(b));
+    uint16x8_t hi = vmovl_u8(vget_high_u8(b));
+
+    q[0] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo)));
+    q[1] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo)));
+    q[2] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi)));
+    q[3] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi)));
+}
+
+static inline void neon_widen16(const int8_t* src, int32x4_t* q)
+{
+    int8x16_t b = vld1q_s8(src);
+    int16x8_t lo = vmovl_s8(vget_low_s8(b));
+    int16x8_t hi = vmovl_s8(vget_high_s8(b));
+
+    q[0] = vmovl_s16(vget_low_s16(lo));
+    q[1] = vmovl_s16(vget_high_s16(lo));
+    q[2] = vmovl_s16(vget_low_s16(hi));
+    q[3] = vmovl_s16(vget_high_s16(hi));
+}
+
+static inline void neon_widen16(const uint16_t* src, int32x4_t* q)
+{
+    uint16x8_t w0 = vld1q_u16(src);
+    uint16x8_t w1 = vld1q_u16(src + 8);
+
+    q[0] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(w0)));
+    q[1] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(w0)));
+    q[2] = vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(w1)));
+    q[3] = vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(w1)));
+}
+
+static inline void neon_widen16(const int16_t* src, int32x4_t* q)
+{
+    int16x8_t w0 = vld1q_s16(src);
+    int16x8_t w1 = vld1q_s16(src + 8);
+
+    q[0] = vmovl_s16(vget_low_s16(w0));
+    q[1] = vmovl_s16(vget_high_s16(w0));
+    q[2] = vmovl_s16(vget_low_s16(w1));
+    q[3] = vmovl_s16(vget_high_s16(w1));
+}
+
+static inline void neon_load16(const float* src, float32x4_t* v)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        v[k] = vld1q_f32(src + 4 * k);
+    }
+}
+
+static inline void neon_load16(const uint8_t* src, float32x4_t* v)
+{
+    int32x4_t q[4];
+
+    neon_widen16(src, q);
+    for (int k = 0; k < 4; k++)
+    {
+        v[k] = vcvtq_f32_s32(q[k]);
+    }
+}
+
+/* narrow 4 int32 vectors in the range of the type and store 16 elements */
+static inline void neon_store16(uint8_t* dst, const int32x4_t* q)
+{
+    int16x8_t lo = vcombine_s16(vqmovn_s32(q[0]), vqmovn_s32(q[1]));
+    int16x8_t hi = vcombine_s16(vqmovn_s32(q[2]), vqmovn_s32(q[3]));
+
+    vst1q_u8(dst, vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)));
+}
+
+static inline void neon_store16(int8_t* dst, const int32x4_t* q)
+{
+    int16x8_t lo = vcombine_s16(vqmovn_s32(q[0]), vqmovn_s32(q[1]));
+    int16x8_t hi = vcombine_s16(vqmovn_s32(q[2]), vqmovn_s32(q[3]));
+
+    vst1q_s8(dst, vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi)));
+}
+
+static inline void neon_store16(uint16_t* dst, const int32x4_t* q)
+{
+    vst1q_u16(dst, vcombine_u16(vqmovun_s32(q[0]), vqmovun_s32(q[1])));
+    vst1q_u16(dst + 8, vcombine_u16(vqmovun_s32(q[2]), vqmovun_s32(q[3])));
+}
+
+static inline void neon_store16(int16_t* dst, const int32x4_t* q)
+{
+    vst1q_s16(dst, vcombine_s16(vqmovn_s32(q[0]), vqmovn_s32(q[1])));
+    vst1q_s16(dst + 8, vcombine_s16(vqmovn_s32(q[2]), vqmovn_s32(q[3])));
+}
+
+template <typename S, typename T>
+static void neon_quantize(const S* src, void* dst, uint32_t cnt, float inv_scale, float zero_point)
+{
+    T* out = (T*)dst;
+    const float32x4_t inv = vdupq_n_f32(inv_scale);
+    const float32x4_t zp = vdupq_n_f32(zero_point);
+    const float32x4_t lo = vdupq_n_f32((float)std::numeric_limits<T>::min());
+    const float32x4_t hi = vdupq_n_f32((float)std::numeric_limits<T>::max());
+    float32x4_t v[4];
+    int32x4_t q[4];
+    uint32_t i = 0;
+
+    for (; i + 16 <= cnt; i += 16)
+    {
+        neon_load16(src + i, v);
+        for (int k = 0; k < 4; k++)
+        {
+            /* separate multiply & add: no fused rounding, same results as the reference */
+            q[k] = vcvtnq_s32_f32(vminq_f32(vmaxq_f32(vaddq_f32(vmulq_f32(v[k], inv), zp), lo), hi));
+        }
+        neon_store16(out + i, q);
+    }
+    AIRT::quantize_elems(src + i, out + i, cnt - i, inv_scale, zero_point);
+}
+
+template <typename T>
+static void neon_dequantize(const void* src, float* dst, uint32_t cnt, float scale, float zero_point)
+{
+    const T* in = (const T*)src;
+    const float32x4_t sc = vdupq_n_f32(scale);
+    const float32x4_t zp = vdupq_n_f32(zero_point);
+    int32x4_t q[4];
+    uint32_t i = 0;
+
+    for (; i + 16 <= cnt; i += 16)
+    {
+        neon_widen16(in + i, q);
+        for (int k = 0; k < 4; k++)
+        {
+            vst1q_f32(dst + i + 4 * k, vmulq_f32(vsubq_f32(vcvtq_f32_s32(q[k]), zp), sc));
+        }
+    }
+    AIRT::dequantize_elems(in + i, dst + i, cnt - i, scale, zero_point);
+}
+
+static const AIRT::tensor_kernels_t neon_kernels = {
+    "neon",
+    { nullptr, neon_quantize<float, uint8_t>, neon_quantize<float, int8_t>,
+      neon_quantize<float, uint16_t>, neon_quantize<float, int16_t> },
+    { nullptr, neon_quantize<uint8_t, uint8_t>, neon_quantize<uint8_t, int8_t>,
+      neon_quantize<uint8_t, uint16_t>, neon_quantize<uint8_t, int16_t> },
+    { nullptr, neon_dequantize<uint8_t>, neon_dequantize<int8_t>,
+      neon_dequantize<uint16_t>, neon_dequantize<int16_t> },
+};
+
+const AIRT::tensor_kernels_t* AIRT::get_neon_tensor_kernels()
+{
+    return &neon_kernels;
+}
+#else
+const AIRT::tensor_kernels_t* AIRT::get_neon_tensor_kernels()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,355 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_kernels_x86.cpp
+ * @brief AIPU User Mode Driver (UMD) tensor quantization kernels: SSE2 & AVX2
+ *
+ * SSE2 is the x86-64 baseline; AVX2 kernels are compiled for the AVX2 target only and
+ * selected at runtime. Values are clamped in float before the conversion (which rounds
+ * half to even like rint), so the saturating packs never saturate.
+ */
+
+#include "tensor_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+/********************************** SSE2 **********************************/
+/* widen 16 elements to 4 int32 vectors */
+static inline void sse2_widen16(const uint8_t* src, __m128i* q)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i b = _mm_loadu_si128((const __m128i*)src);
+    __m128i lo = _mm_unpacklo_epi8(b, zero);
+    __m128i hi = _mm_unpackhi_epi8(b, zero);
+
+    q[0] = _mm_unpacklo_epi16(lo, zero);
+    q[1] = _mm_unpackhi_epi16(lo, zero);
+    q[2] = _mm_unpacklo_epi16(hi, zero);
+    q[3] = _mm_unpackhi_epi16(hi, zero);
+}
+
+static inline void sse2_widen16(const int8_t* src, __m128i* q)
+{
+    __m128i b = _mm_loadu_si128((const __m128i*)src);
+    __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+    __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8);
+
+    q[0] = _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16);
+    q[1] = _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16);
+    q[2] = _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16);
+    q[3] = _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16);
+}
+
+static inline void sse2_widen16(const uint16_t* src, __m128i* q)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i w0 = _mm_loadu_si128((const __m128i*)src);
+    __m128i w1 = _mm_loadu_si128((const __m128i*)(src + 8));
+
+    q[0] = _mm_unpacklo_epi16(w0, zero);
+    q[1] = _mm_unpackhi_epi16(w0, zero);
+    q[2] = _mm_unpacklo_epi16(w1, zero);
+    q[3] = _mm_unpackhi_epi16(w1, zero);
+}
+
+static inline void sse2_widen16(const int16_t* src, __m128i* q)
+{
+    __m128i w0 = _mm_loadu_si128((const __m128i*)src);
+    __m128i w1 = _mm_loadu_si128((const __m128i*)(src + 8));
+
+    q[0] = _mm_srai_epi32(_mm_unpacklo_epi16(w0, w0), 16);
+    q[1] = _mm_srai_epi32(_mm_unpackhi_epi16(w0, w0), 16);
+    q[2] = _mm_srai_epi32(_mm_unpacklo_epi16(w1, w1), 16);
+    q[3] = _mm_srai_epi32(_mm_unpackhi_epi16(w1, w1), 16);
+}
+
+static inline void sse2_load16(const float* src, __m128* v)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        v[k] = _mm_loadu_ps(src + 4 * k);
+    }
+}
+
+static inline void sse2_load16(const uint8_t* src, __m128* v)
+{
+    __m128i q[4];
+
+    sse2_widen16(src, q);
+    for (int k = 0; k < 4; k++)
+    {
+        v[k] = _mm_cvtepi32_ps(q[k]);
+    }
+}
+
+/* narrow 4 int32 vectors in the range of the type and store 16 elements */
+static inline void sse2_store16(uint8_t* dst, const __m128i* q)
+{
+    _mm_storeu_si128((__m128i*)dst, _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]),
+        _mm_packs_epi32(q[2], q[3])));
+}
+
+static inline void sse2_store16(int8_t* dst, const __m128i* q)
+{
+    _mm_storeu_si128((__m128i*)dst, _mm_packs_epi16(_mm_packs_epi32(q[0], q[1]),
+        _mm_packs_epi32(q[2], q[3])));
+}
+
+static inline void sse2_store16(uint16_t* dst, const __m128i* q)
+{
+    /* no unsigned 32->16 pack in SSE2: pack with a bias of 32768 */
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i flip = _mm_set1_epi16((short)0x8000);
+
+    _mm_storeu_si128((__m128i*)dst, _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(q[0], bias),
+        _mm_sub_epi32(q[1], bias)), flip));
+    _mm_storeu_si128((__m128i*)(dst + 8), _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(q[2], bias),
+        _mm_sub_epi32(q[3], bias)), flip));
+}
+
+static inline void sse2_store16(int16_t* dst, const __m128i* q)
+{
+    _mm_storeu_si128((__m128i*)dst, _mm_packs_epi32(q[0], q[1]));
+    _mm_storeu_si128((__m128i*)(dst + 8), _mm_packs_epi32(q[2], q[3]));
+}
+
+template <typename S, typename T>
+static void sse2_quantize(const S* src, void* dst, uint32_t cnt, float inv_scale, float zero_point)
+{
+    T* out = (T*)dst;
+    const __m128 inv = _mm_set1_ps(inv_scale);
+    const __m128 zp = _mm_set1_ps(zero_point);
+    const __m128 lo = _mm_set1_ps((float)std::numeric_limits<T>::min());
+    const __m128 hi = _mm_set1_ps((float)std::numeric_limits<T>::max());
+    __m128 v[4];
+    __m128i q[4];
+    uint32_t i = 0;
+
+    for (; i + 16 <= cnt; i += 16)
+    {
+        sse2_load16(src + i, v);
+        for (int k = 0; k < 4; k++)
+        {
+            q[k] = _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(v[k], inv), zp), lo), hi));
+        }
+        sse2_store16(out + i, q);
+    }
+    AIRT::quantize_elems(src + i, out + i, cnt - i, inv_scale, zero_point);
+}
+
+template <typename T>
+static void sse2_dequantize(const void* src, float* dst, uint32_t cnt, float scale, float zero_point)
+{
+    const T* in = (const T*)src;
+    const __m128 sc = _mm_set1_ps(scale);
+    const __m128 zp = _mm_set1_ps(zero_point);
+    __m128i q[4];
+    uint32_t i = 0;
+
+    for (; i + 16 <= cnt; i += 16)
+    {
+        sse2_widen16(in + i, q);
+        for (int k = 0; k < 4; k++)
+        {
+            _mm_storeu_ps(dst + i + 4 * k, _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(q[k]), zp), sc));
+        }
+    }
+    AIRT::dequantize_elems(in + i, dst + i, cnt - i, scale, zero_point);
+}
+
+static const AIRT::tensor_kernels_t sse2_kernels = {
+    "sse2",
+    { nullptr, sse2_quantize<float, uint8_t>, sse2_quantize<float, int8_t>,
+      sse2_quantize<float, uint16_t>, sse2_quantize<float, int16_t> },
+    { nullptr, sse2_quantize<uint8_t, uint8_t>, sse2_quantize<uint8_t, int8_t>,
+      sse2_quantize<uint8_t, uint16_t>, sse2_quantize<uint8_t, int16_t> },
+    { nullptr, sse2_dequantize<uint8_t>, sse2_dequantize<int8_t>,
+      sse2_dequantize<uint16_t>, sse2_dequantize<int16_t> },
+};
+
+/********************************** AVX2 **********************************/
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+/* widen 32 elements to 4 int32 vectors */
+static inline void avx2_widen32(const uint8_t* src, __m256i* q)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        q[k] = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * k)));
+    }
+}
+
+static inline void avx2_widen32(const int8_t* src, __m256i* q)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        q[k] = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(src + 8 * k)));
+    }
+}
+
+static inline void avx2_widen32(const uint16_t* src, __m256i* q)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        q[k] = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + 8 * k)));
+    }
+}
+
+static inline void avx2_widen32(const int16_t* src, __m256i* q)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        q[k] = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(src + 8 * k)));
+    }
+}
+
+static inline void avx2_load32(const float* src, __m256* v)
+{
+    for (int k = 0; k < 4; k++)
+    {
+        v[k] = _mm256_loadu_ps(src + 8 * k);
+    }
+}
+
+static inline void avx2_load32(const uint8_t* src, __m256* v)
+{
+    __m256i q[4];
+
+    avx2_widen32(src, q);
+    for (int k = 0; k < 4; k++)
+    {
+        v[k] = _mm256_cvtepi32_ps(q[k]);
+    }
+}
+
+/**
+ * the packs work within 128-bit lanes: 8-bit results come out as dwords of
+ * q0 q1 q2 q3 (low halves) then q0 q1 q2 q3 (high halves), 16-bit ones as qwords
+ */
+static inline void avx2_store32(uint8_t* dst, const __m256i* q)
+{
+    __m256i r = _mm256_packus_epi16(_mm256_packs_epi32(q[0], q[1]), _mm256_packs_epi32(q[2], q[3]));
+
+    r = _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256((__m256i*)dst, r);
+}
+
+static inline void avx2_store32(int8_t* dst, const __m256i* q)
+{
+    __m256i r = _mm256_packs_epi16(_mm256_packs_epi32(q[0], q[1]), _mm256_packs_epi32(q[2], q[3]));
+
+    r = _mm256_permutevar8x32_epi32(r, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    _mm256_storeu_si256((__m256i*)dst, r);
+}
+
+static inline void avx2_store32(uint16_t* dst, const __m256i* q)
+{
+    _mm256_storeu_si256((__m256i*)dst,
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(q[0], q[1]), 0xD8));
+    _mm256_storeu_si256((__m256i*)(dst + 16),
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(q[2], q[3]), 0xD8));
+}
+
+static inline void avx2_store32(int16_t* dst, const __m256i* q)
+{
+    _mm256_storeu_si256((__m256i*)dst,
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(q[0], q[1]), 0xD8));
+    _mm256_storeu_si256((__m256i*)(dst + 16),
+        _mm256_permute4x64_epi64(_mm256_packs_epi32(q[2], q[3]), 0xD8));
+}
+
+template <typename S, typename T>
+static void avx2_quantize(const S* src, void* dst, uint32_t cnt, float inv_scale, float zero_point)
+{
+    T* out = (T*)dst;
+    const __m256 inv = _mm256_set1_ps(inv_scale);
+    const __m256 zp = _mm256_set1_ps(zero_point);
+    const __m256 lo = _mm256_set1_ps((float)std::numeric_limits<T>::min());
+    const __m256 hi = _mm256_set1_ps((float)std::numeric_limits<T>::max());
+    __m256 v[4];
+    __m256i q[4];
+    uint32_t i = 0;
+
+    for (; i + 32 <= cnt; i += 32)
+    {
+        avx2_load32(src + i, v);
+        for (int k = 0; k < 4; k++)
+        {
+            q[k] = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(
+                _mm256_add_ps(_mm256_mul_ps(v[k], inv), zp), lo), hi));
+        }
+        avx2_store32(out + i, q);
+    }
+    AIRT::quantize_elems(src + i, out + i, cnt - i, inv_scale, zero_point);
+}
+
+template <typename T>
+static void avx2_dequantize(const void* src, float* dst, uint32_t cnt, float scale, float zero_point)
+{
+    const T* in = (const T*)src;
+    const __m256 sc = _mm256_set1_ps(scale);
+    const __m256 zp = _mm256_set1_ps(zero_point);
+    __m256i q[4];
+    uint32_t i = 0;
+
+    for (; i + 32 <= cnt; i += 32)
+    {
+        avx2_widen32(in + i, q);
+        for (int k = 0; k < 4; k++)
+        {
+            _mm256_storeu_ps(dst + i + 8 * k,
+                _mm256_mul_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(q[k]), zp), sc));
+        }
+    }
+    AIRT::dequantize_elems(in + i, dst + i, cnt - i, scale, zero_point);
+}
+
+static const AIRT::tensor_kernels_t avx2_kernels = {
+    "avx2",
+    { nullptr, avx2_quantize<float, uint8_t>, avx2_quantize<float, int8_t>,
+      avx2_quantize<float, uint16_t>, avx2_quantize<float, int16_t> },
+    { nullptr, avx2_quantize<uint8_t, uint8_t>, avx2_quantize<uint8_t, int8_t>,
+      avx2_quantize<uint8_t, uint16_t>, avx2_quantize<uint8_t, int16_t> },
+    { nullptr, avx2_dequantize<uint8_t>, avx2_dequantize<int8_t>,
+      avx2_dequantize<uint16_t>, avx2_dequantize<int16_t> },
+};
+
+#pragma GCC pop_options
+
+const AIRT::tensor_kernels_t* AIRT::get_sse2_tensor_kernels()
+{
+    return &sse2_kernels;
+}
+
+const AIRT::tensor_kernels_t* AIRT::get_avx2_tensor_kernels()
+{
+    return &avx2_kernels;
+}
+#else
+const AIRT::tensor_kernels_t* AIRT::get_sse2_tensor_kernels()
+{
+    return nullptr;
+}
+
+const AIRT::tensor_kernels_t* AIRT::get_avx2_tensor_kernels()
+{
+    return nullptr;
+}
+#endif
@@ -0,0 +1,236 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  lz4.cpp
+ * @brief UMD LZ4 block format codec implementation
+ */
+
+#include <string.h>
+#include <vector>
+#include "lz4.h"
+
+#define LZ4_MIN_MATCH     4
+#define LZ4_LAST_LITERALS 5   /* the last 5 bytes are always literals */
+#define LZ4_MF_LIMIT      12  /* the last match starts at least 12 bytes before the end */
+#define LZ4_MAX_DISTANCE  65535
+#define LZ4_HASH_BITS     12
+
+static inline uint32_t read32(const uint8_t* p)
+{
+    uint32_t v = 0;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t hash32(uint32_t v)
+{
+    return (v * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+/* length of a literal run/match beyond the 4 bits of the token */
+static inline bool write_len(uint8_t*& op, const uint8_t* oend, uint32_t len)
+{
+    for (; len >= 255; len -= 255)
+    {
+        if (op >= oend)
+        {
+            return false;
+        }
+        *op++ = 255;
+    }
+    if (op >= oend)
+    {
+        return false;
+    }
+    *op++ = (uint8_t)len;
+    return true;
+}
+
+static bool write_sequence(uint8_t*& op, const uint8_t* oend, const uint8_t* literal,
+    uint32_t lit_len, uint32_t offset, uint32_t match_len, bool last)
+{
+    uint8_t* token = op++;
+
+    if (token >= oend)
+    {
+        return false;
+    }
+    *token = (uint8_t)(((lit_len < 15) ? lit_len : 15) << 4);
+    if ((lit_len >= 15) && !write_len(op, oend, lit_len - 15))
+    {
+        return false;
+    }
+    if (lit_len > (uint32_t)(oend - op))
+    {
+        return false;
+    }
+    memcpy(op, literal, lit_len);
+    op += lit_len;
+    if (last)
+    {
+        return true;
+    }
+
+    if (oend - op < 2)
+    {
+        return false;
+    }
+    *op++ = (uint8_t)offset;
+    *op++ = (uint8_t)(offset >> 8);
+    match_len -= LZ4_MIN_MATCH;
+    *token |= (uint8_t)((match_len < 15) ? match_len : 15);
+    if ((match_len >= 15) && !write_len(op, oend, match_len - 15))
+    {
+        return false;
+    }
+    return true;
+}
+
+uint32_t umd_lz4_compress(const void* src, uint32_t size, void* dst, uint32_t cap)
+{
+    const uint8_t* in = (const uint8_t*)src;
+    const uint8_t* ip = in;
+    const uint8_t* anchor = in;
+    const uint8_t* ref = nullptr;
+    const uint8_t* mp = nullptr;
+    uint8_t* op = (uint8_t*)dst;
+    const uint8_t* oend = op + cap;
+    uint32_t misses = 0;
+    uint32_t h = 0;
+    std::vector<uint32_t> table(1 << LZ4_HASH_BITS, 0);
+
+    if (size > LZ4_MF_LIMIT)
+    {
+        const uint8_t* mflimit = in + size - LZ4_MF_LIMIT;
+        const uint8_t* matchlimit = in + size - LZ4_LAST_LITERALS;
+
+        while (ip < mflimit)
+        {
+            h = hash32(read32(ip));
+            ref = in + table[h];
+            table[h] = ip - in;
+            if ((ref < ip) && (ip - ref <= LZ4_MAX_DISTANCE) && (read32(ref) == read32(ip)))
+            {
+                mp = ip + LZ4_MIN_MATCH;
+                ref += LZ4_MIN_MATCH;
+                while ((mp < matchlimit) && (*mp == *ref))
+                {
+                    mp++;
+                    ref++;
+                }
+                if (!write_sequence(op, oend, anchor, ip - anchor, mp - ref, mp - ip, false))
+                {
+                    return 0;
+                }
+                ip = mp;
+                anchor = ip;
+                misses = 0;
+            }
+            else
+            {
+                /* skip faster over incompressible data */
+                ip += 1 + (misses++ >> 6);
+            }
+        }
+    }
+
+    if (!write_sequence(op, oend, anchor, in + size - anchor, 0, 0, true))
+    {
+        return 0;
+    }
+    return op - (uint8_t*)dst;
+}
+
+int64_t umd_lz4_decompress(const void* src, uint32_t size, void* dst, uint32_t cap)
+{
+    const uint8_t* ip = (const uint8_t*)src;
+    const uint8_t* iend = ip + size;
+    uint8_t* out = (uint8_t*)dst;
+    uint8_t* op = out;
+    uint8_t* oend = out + cap;
+    uint32_t len = 0;
+    uint32_t offset = 0;
+    uint8_t token = 0;
+    uint8_t b = 0;
+
+    while (ip < iend)
+    {
+        token = *ip++;
+
+        len = token >> 4;
+        if (15 == len)
+        {
+            do
+            {
+                if (ip >= iend)
+                {
+                    return -1;
+                }
+                b = *ip++;
+                len += b;
+            } while (255 == b);
+        }
+        if ((len > (uint32_t)(iend - ip)) || (len > (uint32_t)(oend - op)))
+        {
+            return -1;
+        }
+        memcpy(op, ip, len);
+        ip += len;
+        op += len;
+        if (ip == iend)
+        {
+            break;
+        }
+
+        if (iend - ip < 2)
+        {
+            return -1;
+        }
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if ((0 == offset) || (offset > (uint32_t)(op - out)))
+        {
+            return -1;
+        }
+        len = token & 15;
+        if (15 == len)
+        {
+            do
+            {
+                if (ip >= iend)
+                {
+                    return -1;
+                }
+                b = *ip++;
+                len += b;
+            } while (255 == b);
+        }
+        len += LZ4_MIN_MATCH;
+        if (len > (uint32_t)(oend - op))
+        {
+            return -1;
+        }
+        /* the match may overlap the bytes being written */
+        for (uint32_t i = 0; i < len; i++, op++)
+        {
+            *op = *(op - offset);
+        }
+    }
+
+    return op - out;
+}
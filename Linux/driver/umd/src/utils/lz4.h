@@ -0,0 +1,63 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  lz4.h
+ * @brief UMD LZ4 block format codec header
+ *
+ * A compact implementation of the LZ4 block format (no frame), compatible with
+ * LZ4_decompress_safe() of the reference library.
+ */
+
+#ifndef _LZ4_H_
+#define _LZ4_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Worst case size of a compressed block
+ */
+inline uint32_t umd_lz4_bound(uint32_t size)
+{
+    return size + size / 255 + 16;
+}
+
+/**
+ * @brief Compress a block
+ *
+ * @param[in]  src  Source data
+ * @param[in]  size Source data size
+ * @param[out] dst  Destination buffer
+ * @param[in]  cap  Destination buffer size; umd_lz4_bound(size) always fits
+ *
+ * @retval compressed size, or 0 if dst is too small
+ */
+uint32_t umd_lz4_compress(const void* src, uint32_t size, void* dst, uint32_t cap);
+
+/**
+ * @brief Decompress a block
+ *
+ * @param[in]  src  Compressed block
+ * @param[in]  size Compressed block size
+ * @param[out] dst  Destination buffer
+ * @param[in]  cap  Destination buffer size
+ *
+ * @retval decompressed size, or -1 if the block is malformed or dst is too small
+ */
+int64_t umd_lz4_decompress(const void* src, uint32_t size, void* dst, uint32_t cap);
+
+#endif /* _LZ4_H_ */
@@ -34,10 +34,13 @@ build_help() {
     echo "                      pipeline_test"
     echo "                      profiling_test"
     echo "                      dump_test"
+    echo "                      async_job_test"
     echo "                      debugger_test"
     echo "                      multithread_test"
     echo "                      multithread_share_graph_test"
     echo "                      multithread_non_pipeline_test"
+    echo "                      tensor_convert_test"
+    echo "                      tensor_cmp"
     echo "-l, --lib         link lib type:"
     echo "                      standard_api (by default)"
     echo "                      low_level_api"
@@ -94,6 +94,7 @@ cd ../driver
 cd -
 
 ./build.sh -p $PLATFORM $DBG_ARGS -t $TDIR -c dump_test
+./build.sh -p $PLATFORM $DBG_ARGS -t $TDIR -c tensor_cmp
 if [ "$PLATFORM"x = "x86-linux"x ]; then
     ./build.sh -p $PLATFORM $DBG_ARGS -t $TDIR -c simulation_test
 else
@@ -126,6 +127,7 @@ mkdir -p $RELEASE_DIR
 
 #copy common files for all target platforms
 cp -rf ./build/$PLATFORM/dump_test/ $RELEASE_DIR
+cp -rf ./build/$PLATFORM/tensor_cmp/ $RELEASE_DIR
 
 #copy for specific platform
 if [ "$PLATFORM"x = "x86-linux"x ]; then
@@ -0,0 +1,247 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  main.cpp
+ * @brief AIPU UMD test implementation file: asynchronous job test
+ *
+ * A job flushed by AIPU_flush_job_async() calls its callback exactly once: when it ends, or with
+ * no status when it times out. The callback fulfils a promise as Job::Submit() of the high level
+ * API does, and the test checks that the future always becomes ready.
+ *
+ * To have the second job time out on loopback-linux, run it with a long emulated job,
+ * e.g. AIPU_LOOPBACK_EXEC_US=200000.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include "standard_api.h"
+#include "common/common.h"
+
+using namespace std;
+const char* test_case = "async job";
+
+/* time to wait for the second job: too short for the job to end */
+#define SHORT_TIME_OUT_MS 1
+/* a callback not called within this time is taken as lost */
+#define CALLBACK_TIME_OUT_S 10
+
+typedef struct async_job {
+    promise<aipu_job_status_t> done;
+    atomic<uint32_t> calls;
+} async_job_t;
+
+static void job_done(uint32_t job_id, aipu_job_status_t status, void* arg)
+{
+    async_job_t* job = (async_job_t*)arg;
+
+    if (0 == job->calls++)
+    {
+        job->done.set_value(status);
+    }
+    fprintf(stdout, "[TEST INFO] Job #0x%x callback, status %d.\n", job_id, status);
+}
+
+/**
+ * run a job asynchronously and wait for it for <time_out> ms;
+ * returns 0 if its callback is called once, with the status matching the wait result
+ */
+static int run_async_job(aipu_ctx_handle_t* ctx, graph_test_info_t& info, int32_t time_out,
+    bool check)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    aipu_job_status_t status = AIPU_JOB_STATUS_NO_STATUS;
+    const char* status_msg = nullptr;
+    async_job_t job;
+    future<aipu_job_status_t> done = job.done.get_future();
+    int pass = 0;
+
+    job.calls = 0;
+    ret = AIPU_create_job(ctx, &info.gdesc, info.jobs[0].buffer.handle, &info.jobs[0].id);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        return -1;
+    }
+
+    ret = AIPU_flush_job_async(ctx, info.jobs[0].id, job_done, &job);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        pass = -1;
+        goto clean_job;
+    }
+
+    ret = AIPU_get_job_status(ctx, info.jobs[0].id, time_out, &status);
+    fprintf(stdout, "[TEST INFO] Job #0x%x waited for %dms: %s.\n", info.jobs[0].id, time_out,
+        (AIPU_STATUS_ERROR_JOB_TIMEOUT == ret) ? "timeout" : "end");
+
+    if (done.wait_for(chrono::seconds(CALLBACK_TIME_OUT_S)) != future_status::ready)
+    {
+        fprintf(stderr, "[TEST ERROR] Job #0x%x callback is not called!\n", info.jobs[0].id);
+        pass = -1;
+        goto clean_job;
+    }
+    if ((AIPU_STATUS_ERROR_JOB_TIMEOUT == ret) && (done.get() != AIPU_JOB_STATUS_NO_STATUS))
+    {
+        fprintf(stderr, "[TEST ERROR] Job #0x%x timed out but has an end status!\n", info.jobs[0].id);
+        pass = -1;
+    }
+    else if ((AIPU_STATUS_SUCCESS == ret) && (done.get() != status))
+    {
+        fprintf(stderr, "[TEST ERROR] Job #0x%x callback status mismatched!\n", info.jobs[0].id);
+        pass = -1;
+    }
+    else if ((AIPU_STATUS_SUCCESS == ret) && check)
+    {
+        pass = check_result_pass(info, info.jobs[0].id);
+    }
+    else if ((AIPU_STATUS_SUCCESS != ret) && (AIPU_STATUS_ERROR_JOB_TIMEOUT != ret))
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        pass = -1;
+    }
+
+clean_job:
+    ret = AIPU_clean_job(ctx, info.jobs[0].id);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+    }
+    /* cleaning calls a callback still pending */
+    if (job.calls != 1)
+    {
+        fprintf(stderr, "[TEST ERROR] Job callback is called %u times!\n", (uint32_t)job.calls);
+        pass = -1;
+    }
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    int pass = 0;
+    uint32_t graph_cnt = 1;
+    uint32_t pipe_cnt = 1;
+    graph_test_info_t* test_info = nullptr;
+
+    aipu_ctx_handle_t* ctx;
+    const char* status_msg = nullptr;
+#ifdef X86_LINUX
+    aipu_simulation_config_t config;
+#endif
+
+    if (argc < 3)
+    {
+        fprintf(stderr, "[TEST ERROR] need more options (use -h to find available options)!\n");
+        pass = -1;
+        goto finish;
+    }
+
+    test_info = create_gtest_info(argc, argv, test_case, graph_cnt, pipe_cnt);
+    if (nullptr == test_info)
+    {
+        fprintf(stderr, "[TEST ERROR] create test info failed!\n");
+        pass = -1;
+        goto finish;
+    }
+
+    ret = AIPU_init_ctx(&ctx);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        pass = -1;
+        goto finish;
+    }
+
+#ifdef X86_LINUX
+    config.simulator = test_info[0].opt.simulator;
+    config.cfg_file_dir = test_info[0].opt.cfg_file_dir;
+    config.output_dir = test_info[0].opt.dump_dir;
+    config.simulator_opt = NULL;
+    ret = AIPU_config_simulation(ctx, &config);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        pass = -1;
+        goto deinit_ctx;
+    }
+#endif
+
+    ret = AIPU_load_graph_helper(ctx, test_info[0].bench.graph_fname.c_str(), &test_info[0].gdesc);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        pass = -1;
+        goto deinit_ctx;
+    }
+    fprintf(stdout, "[TEST INFO] AIPU load graph successfully.\n");
+
+    ret = AIPU_alloc_tensor_buffers(ctx, &test_info[0].gdesc, &test_info[0].jobs[0].buffer);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+        pass = -1;
+        goto clean_graph;
+    }
+    load_inputs(test_info[0], 0);
+
+    /* a job waited for until it ends */
+    if (run_async_job(ctx, test_info[0], -1, true))
+    {
+        pass = -1;
+    }
+    /* a job waited for too short (or ended already, e.g. on the simulator) */
+    if (run_async_job(ctx, test_info[0], SHORT_TIME_OUT_MS, false))
+    {
+        pass = -1;
+    }
+
+    ret = AIPU_free_tensor_buffers(ctx, test_info[0].jobs[0].buffer.handle);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+    }
+
+clean_graph:
+    ret = AIPU_unload_graph(ctx, &test_info[0].gdesc);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] %s\n", status_msg);
+    }
+
+deinit_ctx:
+    AIPU_deinit_ctx(ctx);
+
+finish:
+    destroy_gtest_info(test_info, graph_cnt);
+    fprintf(stdout, "[TEST INFO] %s test %s!\n", test_case, pass ? "FAILED" : "PASS");
+    return pass;
+}
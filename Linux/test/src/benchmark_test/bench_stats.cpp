@@ -0,0 +1,154 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  bench_stats.cpp
+ * @brief AIPU UMD test implementation file: benchmark latency statistics & report
+ */
+
+#include <algorithm>
+#include "bench_stats.h"
+
+static const char* phase_name[BENCH_PHASE_MAX] = {
+    "submit",
+    "queue",
+    "exec",
+    "complete",
+    "total",
+};
+
+const char* bench_phase_name(uint32_t phase)
+{
+    return (phase < BENCH_PHASE_MAX) ? phase_name[phase] : "unknown";
+}
+
+static uint64_t get_percentile(const std::vector<uint64_t>& sorted, uint32_t percent)
+{
+    /* nearest-rank percentile */
+    uint64_t rank = ((uint64_t)sorted.size() * percent + 99) / 100;
+
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    return sorted[(rank > 0) ? (rank - 1) : 0];
+}
+
+void bench_summarize(std::vector<bench_sample_t>& samples, bench_summary_t* summary)
+{
+    std::vector<uint64_t> values(samples.size());
+    uint64_t sum = 0;
+
+    for (uint32_t phase = 0; phase < BENCH_PHASE_MAX; phase++)
+    {
+        sum = 0;
+        for (uint32_t i = 0; i < samples.size(); i++)
+        {
+            values[i] = samples[i].ns[phase];
+            sum += values[i];
+        }
+        std::sort(values.begin(), values.end());
+
+        summary[phase].mean_ns = values.empty() ? 0 : (sum / values.size());
+        summary[phase].p50_ns = get_percentile(values, 50);
+        summary[phase].p90_ns = get_percentile(values, 90);
+        summary[phase].p99_ns = get_percentile(values, 99);
+        summary[phase].max_ns = values.empty() ? 0 : values.back();
+    }
+}
+
+static double get_throughput(const bench_report_t& report)
+{
+    return report.duration_ns ? (report.inferences * 1e9 / report.duration_ns) : 0;
+}
+
+static double get_cpu_us_per_inf(const bench_report_t& report, uint64_t cpu_ns)
+{
+    return report.inferences ? (cpu_ns / 1e3 / report.inferences) : 0;
+}
+
+void bench_print_report(FILE* fp, const bench_opt_t& opt, const bench_report_t& report)
+{
+    fprintf(fp, "[TEST INFO] %s-loop, %u thread(s), %u graph(s), depth %u: "
+        "%u inferences (%u errors) in %.3f s, %.2f inf/s\n",
+        (opt.rate > 0) ? "open" : "closed", opt.threads, opt.graphs, opt.depth,
+        report.inferences, report.errors, report.duration_ns / 1e9, get_throughput(report));
+    fprintf(fp, "[TEST INFO] %-10s%12s%12s%12s%12s%12s\n", "latency", "mean(us)", "p50(us)",
+        "p90(us)", "p99(us)", "max(us)");
+    for (uint32_t phase = 0; phase < BENCH_PHASE_MAX; phase++)
+    {
+        if (!report.device_ts && ((BENCH_PHASE_QUEUE == phase) || (BENCH_PHASE_EXEC == phase)))
+        {
+            continue;
+        }
+        fprintf(fp, "[TEST INFO] %-10s%12.1f%12.1f%12.1f%12.1f%12.1f\n", phase_name[phase],
+            report.phase[phase].mean_ns / 1e3, report.phase[phase].p50_ns / 1e3,
+            report.phase[phase].p90_ns / 1e3, report.phase[phase].p99_ns / 1e3,
+            report.phase[phase].max_ns / 1e3);
+    }
+    fprintf(fp, "[TEST INFO] CPU per inference: %.1f us (process), %.1f us (children)\n",
+        get_cpu_us_per_inf(report, report.cpu_self_ns),
+        get_cpu_us_per_inf(report, report.cpu_child_ns));
+}
+
+int bench_write_json(const char* fname, const bench_opt_t& opt, const bench_report_t& report)
+{
+    FILE* fp = nullptr;
+    int ret = 0;
+
+    fp = fopen(fname, "w");
+    if (nullptr == fp)
+    {
+        fprintf(stderr, "[TEST ERROR] open JSON report file %s failed!\n", fname);
+        return -1;
+    }
+
+    fprintf(fp, "{\n  \"test\": \"benchmark\",\n  \"platform\": \"%s\",\n  \"graph\": \"%s\",\n",
+        report.platform, report.graph_fname);
+    fprintf(fp, "  \"config\": {\"mode\": \"%s\", \"rate\": %.3f, \"warmup\": %u, "
+        "\"iterations\": %u, \"depth\": %u, \"threads\": %u, \"graphs\": %u},\n",
+        (opt.rate > 0) ? "open" : "closed", opt.rate, opt.warmup, opt.iterations, opt.depth,
+        opt.threads, opt.graphs);
+    fprintf(fp, "  \"inferences\": %u,\n  \"errors\": %u,\n  \"check_pass\": %s,\n",
+        report.inferences, report.errors, report.check_pass ? "true" : "false");
+    fprintf(fp, "  \"duration_s\": %.6f,\n  \"throughput_ips\": %.3f,\n",
+        report.duration_ns / 1e9, get_throughput(report));
+    fprintf(fp, "  \"cpu_us_per_inference\": {\"process\": %.3f, \"children\": %.3f},\n",
+        get_cpu_us_per_inf(report, report.cpu_self_ns),
+        get_cpu_us_per_inf(report, report.cpu_child_ns));
+    fprintf(fp, "  \"device_timestamps\": %s,\n  \"latency_us\": {",
+        report.device_ts ? "true" : "false");
+    for (uint32_t phase = 0; phase < BENCH_PHASE_MAX; phase++)
+    {
+        fprintf(fp, "%s\n    \"%s\": {\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, "
+            "\"p99\": %.3f, \"max\": %.3f}", phase ? "," : "", phase_name[phase],
+            report.phase[phase].mean_ns / 1e3, report.phase[phase].p50_ns / 1e3,
+            report.phase[phase].p90_ns / 1e3, report.phase[phase].p99_ns / 1e3,
+            report.phase[phase].max_ns / 1e3);
+    }
+    fprintf(fp, "\n  }\n}\n");
+
+    if (ferror(fp))
+    {
+        fprintf(stderr, "[TEST ERROR] write JSON report file %s failed!\n", fname);
+        ret = -1;
+    }
+    fclose(fp);
+
+    return ret;
+}
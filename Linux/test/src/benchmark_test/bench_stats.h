@@ -0,0 +1,80 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  bench_stats.h
+ * @brief AIPU UMD test header file: benchmark latency statistics & report
+ */
+
+#ifndef _BENCH_STATS_H_
+#define _BENCH_STATS_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+typedef enum {
+    BENCH_PHASE_SUBMIT = 0, /* arrival -> job handed to KMD/simulator (incl. waiting for a free tbuf) */
+    BENCH_PHASE_QUEUE,      /* handed to KMD/simulator -> started on AIPU/simulator */
+    BENCH_PHASE_EXEC,       /* started -> done interrupt/simulation end */
+    BENCH_PHASE_COMPLETE,   /* done -> end status returned to application */
+    BENCH_PHASE_TOTAL,      /* arrival -> end status returned to application */
+    BENCH_PHASE_MAX
+} bench_phase_t;
+
+typedef struct bench_sample {
+    uint64_t ns[BENCH_PHASE_MAX];
+} bench_sample_t;
+
+typedef struct bench_summary {
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} bench_summary_t;
+
+typedef struct bench_opt {
+    uint32_t warmup;        /* warmup inferences per thread, excluded from statistics */
+    uint32_t iterations;    /* measured inferences per thread */
+    uint32_t depth;         /* tbufs (jobs) in flight per thread */
+    uint32_t threads;       /* scheduling threads */
+    uint32_t graphs;        /* graph instances loaded; threads are assigned round-robin */
+    double rate;            /* open-loop total arrival rate in inferences/s; 0 for closed-loop */
+    char json_file[255];    /* JSON report file; no report if empty */
+} bench_opt_t;
+
+typedef struct bench_report {
+    const char* platform;
+    const char* graph_fname;
+    uint32_t inferences;
+    uint32_t errors;
+    bool device_ts;         /* queue/exec split taken from KMD/simulator timestamps */
+    bool check_pass;
+    uint64_t duration_ns;
+    uint64_t cpu_self_ns;   /* user+sys CPU time of this process during measurement */
+    uint64_t cpu_child_ns;  /* user+sys CPU time of child processes (e.g. simulator) */
+    bench_summary_t phase[BENCH_PHASE_MAX];
+} bench_report_t;
+
+const char* bench_phase_name(uint32_t phase);
+/* samples are sorted in place, phase by phase */
+void bench_summarize(std::vector<bench_sample_t>& samples, bench_summary_t* summary);
+void bench_print_report(FILE* fp, const bench_opt_t& opt, const bench_report_t& report);
+int bench_write_json(const char* fname, const bench_opt_t& opt, const bench_report_t& report);
+
+#endif /* _BENCH_STATS_H_ */
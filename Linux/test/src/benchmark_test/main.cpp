@@ -18,46 +18,449 @@
 /**
  * @file  main.cpp
  * @brief AIPU UMD test implementation file: benchmark test
+ *
+ * Throughput & latency benchmark of a graph on AIPU (arm-linux) or simulator (x86-linux).
+ * Every scheduling thread keeps up to <depth> jobs in flight, each on its own tbuf; jobs are
+ * submitted by the thread and completed by a companion thread in submission order. In
+ * closed-loop mode a new job arrives as soon as a tbuf is free; in open-loop mode jobs
+ * arrive at a fixed total rate whether or not a tbuf is free, and the wait counts as latency.
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
-#include <sys/stat.h>
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <iostream>
 #include <string.h>
-#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <deque>
 #include <vector>
 #include "standard_api.h"
 #include "common/common.h"
+#include "bench_stats.h"
 
 using namespace std;
 const char* test_case = "benchmark";
 
+typedef struct inflight_job {
+    uint32_t slot;
+    uint32_t job_id;
+    uint64_t arrival_ns;
+    uint64_t flushed_ns;
+} inflight_job_t;
+
+typedef struct bench_worker {
+    uint32_t id;
+    graph_test_info_t* info;  /* test info of the graph scheduled by this worker */
+    uint32_t slot_base;       /* index of the first tbuf of this worker in info->jobs */
+    uint32_t alloc_cnt;
+    pthread_t tid;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    std::deque<inflight_job_t> inflight;
+    std::vector<uint32_t> free_slots;
+    bool submit_done;
+    bool record;
+    bool checked;
+    bool check_pass;
+    bool device_ts;
+    uint32_t errors;
+    std::vector<bench_sample_t> samples;
+} bench_worker_t;
+
+static aipu_ctx_handle_t* ctx = nullptr;
+static bench_opt_t bench_opt;
+static pthread_barrier_t barrier;
+static uint64_t measure_start_ns = 0;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t get_interval(uint64_t start, uint64_t end)
+{
+    return (end > start) ? (end - start) : 0;
+}
+
+static uint64_t get_cpu_time(int who)
+{
+    struct rusage usage;
+
+    getrusage(who, &usage);
+    return ((uint64_t)usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000000ULL +
+        ((uint64_t)usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1000ULL;
+}
+
+static bool get_opt_value(const char* arg, const char* name, const char** value)
+{
+    size_t len = strlen(name);
+
+    if ((strncmp(arg, name, len) == 0) && (arg[len] == '='))
+    {
+        *value = arg + len + 1;
+        return true;
+    }
+    return false;
+}
+
+static void show_bench_help_msg()
+{
+    fprintf(stdout, "Benchmark options:\n");
+    fprintf(stdout, "--warmup=<n>\t\twarmup inferences per thread, excluded from statistics (default 1)\n");
+    fprintf(stdout, "--iters=<n>\t\tmeasured inferences per thread (default 10)\n");
+    fprintf(stdout, "--depth=<n>\t\ttbufs (jobs) in flight per thread (default 1)\n");
+    fprintf(stdout, "--threads=<n>\t\tscheduling threads (default 1)\n");
+    fprintf(stdout, "--graphs=<n>\t\tgraph instances loaded, shared by threads round-robin (default 1)\n");
+    fprintf(stdout, "--rate=<inf/s>\t\topen-loop total arrival rate; 0 for closed-loop (default 0)\n");
+    fprintf(stdout, "--json=<file>\t\twrite the report in JSON for regression tracking\n");
+}
+
+/**
+ * benchmark options are consumed here and the others are left to the common parser;
+ * returns 1 if help is requested
+ */
+static int parsing_bench_opts(int argc, char* argv[], bench_opt_t* opt, std::vector<char*>& rest)
+{
+    const char* value = nullptr;
+    int ret = 0;
+
+    opt->warmup = 1;
+    opt->iterations = 10;
+    opt->depth = 1;
+    opt->threads = 1;
+    opt->graphs = 1;
+    opt->rate = 0;
+    opt->json_file[0] = '\0';
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (get_opt_value(argv[i], "--warmup", &value))
+        {
+            opt->warmup = strtoul(value, NULL, 0);
+        }
+        else if (get_opt_value(argv[i], "--iters", &value))
+        {
+            opt->iterations = strtoul(value, NULL, 0);
+        }
+        else if (get_opt_value(argv[i], "--depth", &value))
+        {
+            opt->depth = strtoul(value, NULL, 0);
+        }
+        else if (get_opt_value(argv[i], "--threads", &value))
+        {
+            opt->threads = strtoul(value, NULL, 0);
+        }
+        else if (get_opt_value(argv[i], "--graphs", &value))
+        {
+            opt->graphs = strtoul(value, NULL, 0);
+        }
+        else if (get_opt_value(argv[i], "--rate", &value))
+        {
+            opt->rate = strtod(value, NULL);
+        }
+        else if (get_opt_value(argv[i], "--json", &value))
+        {
+            strncpy(opt->json_file, value, sizeof(opt->json_file) - 1);
+            opt->json_file[sizeof(opt->json_file) - 1] = '\0';
+        }
+        else
+        {
+            if ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0))
+            {
+                show_bench_help_msg();
+                ret = 1;
+            }
+            rest.push_back(argv[i]);
+        }
+    }
+
+    if ((0 == opt->iterations) || (0 == opt->depth) || (0 == opt->threads) ||
+        (0 == opt->graphs) || (opt->rate < 0))
+    {
+        fprintf(stderr, "[TEST ERROR] invalid benchmark options!\n");
+        return -1;
+    }
+
+    if (opt->graphs > opt->threads)
+    {
+        fprintf(stdout, "[TEST INFO] thread number is raised to graph number %u.\n", opt->graphs);
+        opt->threads = opt->graphs;
+    }
+
+    return ret;
+}
+
+static void record_sample(bench_worker_t* worker, const inflight_job_t& job, uint64_t done_ns)
+{
+    aipu_job_timestamps_t ts;
+    bench_sample_t sample;
+
+    if ((AIPU_get_job_timestamps(ctx, job.job_id, &ts) != AIPU_STATUS_SUCCESS) ||
+        (0 == ts.submit_ns))
+    {
+        /* no device timestamps: queue & exec are left in complete */
+        worker->device_ts = false;
+        sample.ns[BENCH_PHASE_SUBMIT] = get_interval(job.arrival_ns, job.flushed_ns);
+        sample.ns[BENCH_PHASE_QUEUE] = 0;
+        sample.ns[BENCH_PHASE_EXEC] = 0;
+        sample.ns[BENCH_PHASE_COMPLETE] = get_interval(job.flushed_ns, done_ns);
+    }
+    else
+    {
+        sample.ns[BENCH_PHASE_SUBMIT] = get_interval(job.arrival_ns, ts.submit_ns);
+        sample.ns[BENCH_PHASE_QUEUE] = get_interval(ts.submit_ns, ts.start_ns);
+        sample.ns[BENCH_PHASE_EXEC] = get_interval(ts.start_ns, ts.end_ns);
+        sample.ns[BENCH_PHASE_COMPLETE] = get_interval(ts.end_ns, done_ns);
+    }
+    sample.ns[BENCH_PHASE_TOTAL] = get_interval(job.arrival_ns, done_ns);
+    worker->samples.push_back(sample);
+}
+
+static void complete_job(bench_worker_t* worker, const inflight_job_t& job)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    aipu_job_status_t status;
+    const char* status_msg = nullptr;
+    uint64_t done_ns = 0;
+
+    ret = AIPU_get_job_status(ctx, job.job_id, -1, &status);
+    done_ns = now_ns();
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] AIPU_get_job_status: %s\n", status_msg);
+        worker->errors++;
+        goto clean;
+    }
+
+    /* output of the first job of every thread is checked out of the measurement */
+    if (!worker->checked)
+    {
+        worker->checked = true;
+        worker->check_pass = (check_result_pass(*worker->info, job.job_id) == 0);
+    }
+
+    if (worker->record)
+    {
+        record_sample(worker, job, done_ns);
+    }
+
+clean:
+    ret = AIPU_clean_job(ctx, job.job_id);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] AIPU_clean_job: %s\n", status_msg);
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    worker->free_slots.push_back(job.slot);
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+static void* job_complete_thread(void* data)
+{
+    bench_worker_t* worker = (bench_worker_t*)data;
+    inflight_job_t job;
+
+    while (1)
+    {
+        pthread_mutex_lock(&worker->lock);
+        while (worker->inflight.empty() && !worker->submit_done)
+        {
+            pthread_cond_wait(&worker->cond, &worker->lock);
+        }
+        if (worker->inflight.empty())
+        {
+            pthread_mutex_unlock(&worker->lock);
+            break;
+        }
+        job = worker->inflight.front();
+        worker->inflight.pop_front();
+        pthread_mutex_unlock(&worker->lock);
+
+        complete_job(worker, job);
+    }
+
+    return data;
+}
+
+static int run_phase(bench_worker_t* worker, uint32_t count, bool record, uint64_t interval_ns,
+    uint64_t start_ns)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    const char* status_msg = nullptr;
+    pthread_t complete_tid;
+    inflight_job_t job;
+    struct timespec arrival;
+    test_job_desc_t* desc = nullptr;
+
+    worker->record = record;
+    worker->submit_done = false;
+    if (pthread_create(&complete_tid, NULL, job_complete_thread, worker) != 0)
+    {
+        fprintf(stderr, "[TEST ERROR] create job completion thread failed!\n");
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (interval_ns)
+        {
+            job.arrival_ns = start_ns + i * interval_ns;
+            arrival.tv_sec = job.arrival_ns / 1000000000ULL;
+            arrival.tv_nsec = job.arrival_ns % 1000000000ULL;
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &arrival, NULL) != 0);
+        }
+
+        pthread_mutex_lock(&worker->lock);
+        while (worker->free_slots.empty())
+        {
+            pthread_cond_wait(&worker->cond, &worker->lock);
+        }
+        job.slot = worker->free_slots.back();
+        worker->free_slots.pop_back();
+        pthread_mutex_unlock(&worker->lock);
+
+        if (0 == interval_ns)
+        {
+            job.arrival_ns = now_ns();
+        }
+
+        desc = &worker->info->jobs[job.slot];
+        ret = AIPU_create_job(ctx, &worker->info->gdesc, desc->buffer.handle, &desc->id);
+        if (ret != AIPU_STATUS_SUCCESS)
+        {
+            AIPU_get_status_msg(ret, &status_msg);
+            fprintf(stderr, "[TEST ERROR] AIPU_create_job: %s\n", status_msg);
+            worker->errors++;
+            break;
+        }
+        job.job_id = desc->id;
+
+        ret = AIPU_flush_job(ctx, job.job_id);
+        job.flushed_ns = now_ns();
+        if (ret != AIPU_STATUS_SUCCESS)
+        {
+            AIPU_get_status_msg(ret, &status_msg);
+            fprintf(stderr, "[TEST ERROR] AIPU_flush_job: %s\n", status_msg);
+            worker->errors++;
+            AIPU_clean_job(ctx, job.job_id);
+            break;
+        }
+
+        pthread_mutex_lock(&worker->lock);
+        worker->inflight.push_back(job);
+        pthread_cond_broadcast(&worker->cond);
+        pthread_mutex_unlock(&worker->lock);
+    }
+
+    pthread_mutex_lock(&worker->lock);
+    worker->submit_done = true;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->lock);
+    pthread_join(complete_tid, NULL);
+
+    return (ret == AIPU_STATUS_SUCCESS) ? 0 : -1;
+}
+
+static void* scheduling_thread(void* data)
+{
+    bench_worker_t* worker = (bench_worker_t*)data;
+    uint64_t interval_ns = 0;
+    uint64_t start_ns = 0;
+
+    run_phase(worker, bench_opt.warmup, false, 0, 0);
+
+    /* the main thread takes the measurement start between the two barriers */
+    pthread_barrier_wait(&barrier);
+    pthread_barrier_wait(&barrier);
+
+    if (bench_opt.rate > 0)
+    {
+        /* arrivals of threads are interleaved to keep the total rate even */
+        interval_ns = (uint64_t)(bench_opt.threads * 1e9 / bench_opt.rate);
+        start_ns = measure_start_ns + worker->id * interval_ns / bench_opt.threads;
+    }
+    run_phase(worker, bench_opt.iterations, true, interval_ns, start_ns);
+
+    return data;
+}
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+static void* job_status_poll_thread(void* data)
+{
+    aipu_status_t ret = AIPU_STATUS_SUCCESS;
+    std::atomic<bool>* stop = (std::atomic<bool>*)data;
+    uint32_t job_cnt = 0;
+    const char* status_msg = nullptr;
+
+    while (!stop->load())
+    {
+        ret = AIPU_poll_jobs_status(ctx, &job_cnt, 100);
+        if (ret != AIPU_STATUS_SUCCESS)
+        {
+            AIPU_get_status_msg(ret, &status_msg);
+            fprintf(stderr, "[TEST ERROR] AIPU_poll_jobs_status: %s\n", status_msg);
+            break;
+        }
+    }
+
+    return data;
+}
+#endif
+
 int main(int argc, char* argv[])
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
     int pass = 0;
-    uint32_t graph_cnt = 1;
-    uint32_t pipe_cnt = 1;
+    int help = 0;
+    std::vector<char*> args;
     graph_test_info_t* test_info = nullptr;
-
-    aipu_ctx_handle_t* ctx;
+    std::vector<bench_worker_t> workers;
+    std::vector<bench_sample_t> samples;
+    bench_report_t report;
+    uint32_t loaded_cnt = 0;
+    uint32_t started_cnt = 0;
+    uint64_t cpu_self_ns = 0;
+    uint64_t cpu_child_ns = 0;
     const char* status_msg = nullptr;
-
     aipu_runtime_config_t rt_config;
+#if (defined X86_LINUX) && (X86_LINUX==1)
+    aipu_simulation_config_t sim_config;
+#else
+    std::atomic<bool> poll_stop(false);
+    pthread_t poll_tid;
+#endif
+
+    help = parsing_bench_opts(argc, argv, &bench_opt, args);
+    if (help < 0)
+    {
+        pass = -1;
+        goto finish;
+    }
 
-    if (argc < 3)
+    /* help message of common options is shown by the common parser */
+    if ((args.size() < 3) && !help)
     {
         fprintf(stderr, "[TEST ERROR] need more options (use -h to find available options)!\n");
+        pass = -1;
         goto finish;
     }
 
-    test_info = create_gtest_info(argc, argv, test_case, graph_cnt, pipe_cnt);
+    /* graph instances are shared by threads round-robin, each thread with <depth> tbufs */
+    test_info = create_gtest_info(args.size(), args.data(), test_case, bench_opt.graphs,
+        bench_opt.depth * ((bench_opt.threads + bench_opt.graphs - 1) / bench_opt.graphs));
     if (nullptr == test_info)
     {
         fprintf(stderr, "[TEST ERROR] create test info failed!\n");
+        pass = -1;
         goto finish;
     }
 
@@ -66,98 +469,205 @@ int main(int argc, char* argv[])
     {
         AIPU_get_status_msg(ret, &status_msg);
         fprintf(stderr, "[TEST ERROR] AIPU_init_ctx: %s\n", status_msg);
+        pass = -1;
         goto finish;
     }
 
-    rt_config.poll_opt = 0;
+#if (defined X86_LINUX) && (X86_LINUX==1)
+    sim_config.simulator = test_info[0].opt.simulator;
+    sim_config.cfg_file_dir = test_info[0].opt.cfg_file_dir;
+    sim_config.output_dir = test_info[0].opt.dump_dir;
+    sim_config.simulator_opt = NULL;
+    ret = AIPU_config_simulation(ctx, &sim_config);
+    if (ret != AIPU_STATUS_SUCCESS)
+    {
+        AIPU_get_status_msg(ret, &status_msg);
+        fprintf(stderr, "[TEST ERROR] AIPU_config_simulation: %s\n", status_msg);
+        pass = -1;
+        goto deinit_ctx;
+    }
+#endif
+
+    /* jobs are submitted and waited in different threads */
+    rt_config.poll_opt = 1;
     rt_config.bypass_version_check = 0;
     ret = AIPU_set_runtime_config(ctx, &rt_config);
     if (ret != AIPU_STATUS_SUCCESS)
     {
         AIPU_get_status_msg(ret, &status_msg);
         fprintf(stderr, "[TEST ERROR] AIPU_set_runtime_config: %s\n", status_msg);
-        goto finish;
+        pass = -1;
+        goto deinit_ctx;
     }
 
-    ret = AIPU_load_graph_helper(ctx, test_info[0].bench.graph_fname.c_str(), &test_info[0].gdesc);
-    if (ret != AIPU_STATUS_SUCCESS)
+    for (loaded_cnt = 0; loaded_cnt < bench_opt.graphs; loaded_cnt++)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_load_graph_helper: %s\n", status_msg);
-        goto finish;
+        ret = AIPU_load_graph_helper(ctx, test_info[loaded_cnt].bench.graph_fname.c_str(),
+            &test_info[loaded_cnt].gdesc);
+        if (ret != AIPU_STATUS_SUCCESS)
+        {
+            AIPU_get_status_msg(ret, &status_msg);
+            fprintf(stderr, "[TEST ERROR] AIPU_load_graph_helper: %s\n", status_msg);
+            pass = -1;
+            goto clean_graph;
+        }
     }
-    fprintf(stdout, "[TEST INFO] AIPU load graph successfully.\n");
+    fprintf(stdout, "[TEST INFO] AIPU load %u graph(s) successfully.\n", loaded_cnt);
 
-    ret = AIPU_alloc_tensor_buffers(ctx, &test_info[0].gdesc, &test_info[0].jobs[0].buffer);
-    if (ret != AIPU_STATUS_SUCCESS)
+    workers.resize(bench_opt.threads);
+    for (uint32_t i = 0; i < bench_opt.threads; i++)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_alloc_tensor_buffers: %s\n", status_msg);
-        goto clean_graph;
+        bench_worker_t& worker = workers[i];
+
+        worker.id = i;
+        worker.info = &test_info[i % bench_opt.graphs];
+        worker.slot_base = (i / bench_opt.graphs) * bench_opt.depth;
+        worker.alloc_cnt = 0;
+        worker.submit_done = false;
+        worker.record = false;
+        worker.checked = false;
+        worker.check_pass = false;
+        worker.device_ts = true;
+        worker.errors = 0;
+        pthread_mutex_init(&worker.lock, NULL);
+        pthread_cond_init(&worker.cond, NULL);
+        worker.samples.reserve(bench_opt.iterations);
     }
 
-    load_inputs(test_info[0], 0);
-    ret = AIPU_create_job(ctx, &test_info[0].gdesc, test_info[0].jobs[0].buffer.handle,
-        &test_info[0].jobs[0].id);
-    if (ret != AIPU_STATUS_SUCCESS)
+    for (uint32_t i = 0; i < bench_opt.threads; i++)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_create_job: %s\n", status_msg);
-        goto clean_buffer;
+        bench_worker_t& worker = workers[i];
+
+        for (uint32_t j = 0; j < bench_opt.depth; j++)
+        {
+            ret = AIPU_alloc_tensor_buffers(ctx, &worker.info->gdesc,
+                &worker.info->jobs[worker.slot_base + j].buffer);
+            if (ret != AIPU_STATUS_SUCCESS)
+            {
+                AIPU_get_status_msg(ret, &status_msg);
+                fprintf(stderr, "[TEST ERROR] AIPU_alloc_tensor_buffers: %s\n", status_msg);
+                pass = -1;
+                goto clean_buffer;
+            }
+            worker.alloc_cnt++;
+            /* inputs are loaded once per tbuf; input copy is not part of the measurement */
+            load_inputs(*worker.info, worker.slot_base + j);
+            worker.free_slots.push_back(worker.slot_base + j);
+        }
     }
 
-    ret = AIPU_finish_job(ctx, test_info[0].jobs[0].id, -1);
-    if (ret != AIPU_STATUS_SUCCESS)
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    if (pthread_create(&poll_tid, NULL, job_status_poll_thread, &poll_stop) != 0)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_finish_job: %s\n", status_msg);
+        fprintf(stderr, "[TEST ERROR] create poll thread failed!\n");
         pass = -1;
-        goto clean_job;
+        goto clean_buffer;
     }
+#endif
 
-    pass = check_result_pass(test_info[0], test_info[0].jobs[0].id);
+    pthread_barrier_init(&barrier, NULL, bench_opt.threads + 1);
+    for (started_cnt = 0; started_cnt < bench_opt.threads; started_cnt++)
+    {
+        if (pthread_create(&workers[started_cnt].tid, NULL, scheduling_thread,
+            &workers[started_cnt]) != 0)
+        {
+            /* cannot proceed with a partial barrier */
+            fprintf(stderr, "[TEST ERROR] create sched thread failed!\n");
+            exit(-1);
+        }
+    }
 
-clean_job:
-    ret = AIPU_clean_job(ctx, test_info[0].jobs[0].id);
-    if (ret != AIPU_STATUS_SUCCESS)
+    pthread_barrier_wait(&barrier);
+    fprintf(stdout, "[TEST INFO] warmup done (%u inference(s) per thread).\n", bench_opt.warmup);
+    cpu_self_ns = get_cpu_time(RUSAGE_SELF);
+    cpu_child_ns = get_cpu_time(RUSAGE_CHILDREN);
+    measure_start_ns = now_ns();
+    pthread_barrier_wait(&barrier);
+
+    for (uint32_t i = 0; i < started_cnt; i++)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_clean_job: %s\n", status_msg);
-        goto finish;
+        pthread_join(workers[i].tid, NULL);
+    }
+
+    memset(&report, 0, sizeof(report));
+    report.duration_ns = get_interval(measure_start_ns, now_ns());
+    report.cpu_self_ns = get_interval(cpu_self_ns, get_cpu_time(RUSAGE_SELF));
+    report.cpu_child_ns = get_interval(cpu_child_ns, get_cpu_time(RUSAGE_CHILDREN));
+    pthread_barrier_destroy(&barrier);
+
+#if (defined ARM_LINUX) && (ARM_LINUX==1)
+    poll_stop.store(true);
+    pthread_join(poll_tid, NULL);
+    report.platform = "arm-linux";
+#else
+    report.platform = "x86-linux";
+#endif
+
+    report.graph_fname = test_info[0].bench.graph_fname.c_str();
+    report.device_ts = true;
+    report.check_pass = true;
+    for (uint32_t i = 0; i < workers.size(); i++)
+    {
+        samples.insert(samples.end(), workers[i].samples.begin(), workers[i].samples.end());
+        report.errors += workers[i].errors;
+        report.device_ts = report.device_ts && workers[i].device_ts;
+        report.check_pass = report.check_pass && workers[i].check_pass;
+    }
+    report.inferences = samples.size();
+    bench_summarize(samples, report.phase);
+    bench_print_report(stdout, bench_opt, report);
+
+    if ((bench_opt.json_file[0] != '\0') &&
+        (bench_write_json(bench_opt.json_file, bench_opt, report) != 0))
+    {
+        pass = -1;
+    }
+
+    if ((report.errors != 0) || !report.check_pass)
+    {
+        pass = -1;
     }
-    fprintf(stdout, "[TEST INFO] job cleaned.\n");
 
 clean_buffer:
-    ret = AIPU_free_tensor_buffers(ctx, test_info[0].jobs[0].buffer.handle);
-    if (ret != AIPU_STATUS_SUCCESS)
+    for (uint32_t i = 0; i < workers.size(); i++)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_free_tensor_buffers: %s\n", status_msg);
-        goto finish;
+        for (uint32_t j = 0; j < workers[i].alloc_cnt; j++)
+        {
+            ret = AIPU_free_tensor_buffers(ctx,
+                workers[i].info->jobs[workers[i].slot_base + j].buffer.handle);
+            if (ret != AIPU_STATUS_SUCCESS)
+            {
+                AIPU_get_status_msg(ret, &status_msg);
+                fprintf(stderr, "[TEST ERROR] AIPU_free_tensor_buffers: %s\n", status_msg);
+                pass = -1;
+            }
+        }
+        pthread_mutex_destroy(&workers[i].lock);
+        pthread_cond_destroy(&workers[i].cond);
     }
 
 clean_graph:
-    ret = AIPU_unload_graph(ctx, &test_info[0].gdesc);
-    if (ret != AIPU_STATUS_SUCCESS)
+    for (uint32_t i = 0; i < loaded_cnt; i++)
     {
-        AIPU_get_status_msg(ret, &status_msg);
-        fprintf(stderr, "[TEST ERROR] AIPU_unload_graph: %s\n", status_msg);
-        goto finish;
+        ret = AIPU_unload_graph(ctx, &test_info[i].gdesc);
+        if (ret != AIPU_STATUS_SUCCESS)
+        {
+            AIPU_get_status_msg(ret, &status_msg);
+            fprintf(stderr, "[TEST ERROR] AIPU_unload_graph: %s\n", status_msg);
+            pass = -1;
+        }
     }
 
+deinit_ctx:
     ret = AIPU_deinit_ctx(ctx);
     if (ret != AIPU_STATUS_SUCCESS)
     {
         AIPU_get_status_msg(ret, &status_msg);
         fprintf(stderr, "[TEST ERROR] AIPU_deinit_ctx: %s\n", status_msg);
-        goto finish;
+        pass = -1;
     }
 
 finish:
-    destroy_gtest_info(test_info, graph_cnt);
-    if (AIPU_STATUS_SUCCESS != ret)
-    {
-        pass = -1;
-    }
+    destroy_gtest_info(test_info, bench_opt.graphs);
     return pass;
-}
\ No newline at end of file
+}
@@ -27,5 +27,6 @@
 #include "graph_test_info.h"
 #include "cmd_line_parsing.h"
 #include "test_bench.h"
+#include "tensor_cmp.h"
 
 #endif /* _COMMON_H_ */
\ No newline at end of file
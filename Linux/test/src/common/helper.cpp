@@ -23,17 +23,11 @@
 #include <string.h>
 #include <errno.h>
 #include "helper.h"
+#include "tensor_cmp.h"
 
 bool is_output_correct(volatile char* src1, char* src2, uint32_t cnt)
 {
-    for (uint32_t out_chr = 0; out_chr < cnt; out_chr++)
-    {
-        if (src1[out_chr] != src2[out_chr])
-        {
-            return false;
-        }
-    }
-    return true;
+    return is_buffer_equal(src1, src2, cnt);
 }
 
 int dump_file_helper(const char* fname, void* src, unsigned int size)
@@ -0,0 +1,670 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_cmp.cpp
+ * @brief AIPU UMD test implementation file: tensor comparison
+ *
+ * Elements are widened to float (exact for 8/16-bit data) and compared 8 at a time with
+ * SSE2 on x86 or NEON on AArch64; other targets and the tails use the scalar code.
+ */
+
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "tensor_cmp.h"
+
+#if (defined __SSE2__)
+#include <emmintrin.h>
+#define CMP_SIMD_SSE2 1
+#elif (defined __aarch64__) && (defined __ARM_NEON)
+#include <arm_neon.h>
+#define CMP_SIMD_NEON 1
+#endif
+
+typedef struct cmp_acc {
+    uint64_t mismatches;
+    int64_t first;
+    float max_diff;
+    double sum_diff;
+    double dot;
+    double ref_sq;
+    double out_sq;
+} cmp_acc_t;
+
+typedef struct cmp_pool {
+    std::vector<cmp_task_t>* tasks;
+    const cmp_option_t* opt;
+    uint32_t next;
+    pthread_mutex_t lock;
+} cmp_pool_t;
+
+static uint32_t get_dtype_bytes(aipu_data_type_t dtype)
+{
+    if ((TENSOR_DATA_TYPE_U16 == dtype) || (TENSOR_DATA_TYPE_S16 == dtype))
+    {
+        return 2;
+    }
+    return 1;
+}
+
+bool is_buffer_equal(const volatile void* out, const void* ref, uint32_t size)
+{
+    /* output buffers are mapped as normal memory, so wide loads are fine */
+    const uint8_t* src0 = (const uint8_t*)out;
+    const uint8_t* src1 = (const uint8_t*)ref;
+    uint32_t i = 0;
+
+#if (defined CMP_SIMD_SSE2)
+    for (; i + 64 <= size; i += 64)
+    {
+        __m128i eq = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(src0 + i)),
+            _mm_loadu_si128((const __m128i*)(src1 + i)));
+        eq = _mm_and_si128(eq, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(src0 + i + 16)),
+            _mm_loadu_si128((const __m128i*)(src1 + i + 16))));
+        eq = _mm_and_si128(eq, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(src0 + i + 32)),
+            _mm_loadu_si128((const __m128i*)(src1 + i + 32))));
+        eq = _mm_and_si128(eq, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(src0 + i + 48)),
+            _mm_loadu_si128((const __m128i*)(src1 + i + 48))));
+        if (_mm_movemask_epi8(eq) != 0xFFFF)
+        {
+            return false;
+        }
+    }
+    for (; i + 16 <= size; i += 16)
+    {
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(src0 + i)),
+            _mm_loadu_si128((const __m128i*)(src1 + i)))) != 0xFFFF)
+        {
+            return false;
+        }
+    }
+#elif (defined CMP_SIMD_NEON)
+    for (; i + 64 <= size; i += 64)
+    {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(src0 + i), vld1q_u8(src1 + i));
+        eq = vandq_u8(eq, vceqq_u8(vld1q_u8(src0 + i + 16), vld1q_u8(src1 + i + 16)));
+        eq = vandq_u8(eq, vceqq_u8(vld1q_u8(src0 + i + 32), vld1q_u8(src1 + i + 32)));
+        eq = vandq_u8(eq, vceqq_u8(vld1q_u8(src0 + i + 48), vld1q_u8(src1 + i + 48)));
+        if (vminvq_u8(eq) != 0xFF)
+        {
+            return false;
+        }
+    }
+    for (; i + 16 <= size; i += 16)
+    {
+        if (vminvq_u8(vceqq_u8(vld1q_u8(src0 + i), vld1q_u8(src1 + i))) != 0xFF)
+        {
+            return false;
+        }
+    }
+#endif
+    for (; i < size; i++)
+    {
+        if (src0[i] != src1[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if (defined CMP_SIMD_SSE2)
+typedef __m128 cmp_vf_t;
+
+typedef struct cmp_vstate {
+    __m128 max_diff;
+    __m128d sum_diff;
+    __m128d dot;
+    __m128d ref_sq;
+    __m128d out_sq;
+} cmp_vstate_t;
+
+static inline void cmp_load8(const uint8_t* src, __m128& lo, __m128& hi)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src), zero);
+    lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+    hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+}
+
+static inline void cmp_load8(const int8_t* src, __m128& lo, __m128& hi)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_srai_epi16(_mm_unpacklo_epi8(zero, _mm_loadl_epi64((const __m128i*)src)), 8);
+    lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(zero, v), 16));
+    hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(zero, v), 16));
+}
+
+static inline void cmp_load8(const uint16_t* src, __m128& lo, __m128& hi)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_loadu_si128((const __m128i*)src);
+    lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+    hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero));
+}
+
+static inline void cmp_load8(const int16_t* src, __m128& lo, __m128& hi)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_loadu_si128((const __m128i*)src);
+    lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(zero, v), 16));
+    hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(zero, v), 16));
+}
+
+static inline void cmp_vinit(cmp_vstate_t& vs)
+{
+    vs.max_diff = _mm_setzero_ps();
+    vs.sum_diff = _mm_setzero_pd();
+    vs.dot = _mm_setzero_pd();
+    vs.ref_sq = _mm_setzero_pd();
+    vs.out_sq = _mm_setzero_pd();
+}
+
+template <bool COS>
+static inline void cmp_vstep(cmp_vstate_t& vs, __m128 ref, __m128 out, __m128 abs_tol,
+    __m128 rel_tol, uint64_t idx, cmp_acc_t* acc)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 diff = _mm_andnot_ps(sign, _mm_sub_ps(out, ref));
+    __m128 thr = _mm_add_ps(abs_tol, _mm_mul_ps(rel_tol, _mm_andnot_ps(sign, ref)));
+    int mask = _mm_movemask_ps(_mm_cmpgt_ps(diff, thr));
+
+    if (mask)
+    {
+        acc->mismatches += __builtin_popcount(mask);
+        if (acc->first < 0)
+        {
+            acc->first = idx + __builtin_ctz(mask);
+        }
+    }
+    vs.max_diff = _mm_max_ps(vs.max_diff, diff);
+    vs.sum_diff = _mm_add_pd(vs.sum_diff,
+        _mm_add_pd(_mm_cvtps_pd(diff), _mm_cvtps_pd(_mm_movehl_ps(diff, diff))));
+    if (COS)
+    {
+        __m128d ref_lo = _mm_cvtps_pd(ref);
+        __m128d ref_hi = _mm_cvtps_pd(_mm_movehl_ps(ref, ref));
+        __m128d out_lo = _mm_cvtps_pd(out);
+        __m128d out_hi = _mm_cvtps_pd(_mm_movehl_ps(out, out));
+        vs.dot = _mm_add_pd(vs.dot, _mm_add_pd(_mm_mul_pd(ref_lo, out_lo), _mm_mul_pd(ref_hi, out_hi)));
+        vs.ref_sq = _mm_add_pd(vs.ref_sq, _mm_add_pd(_mm_mul_pd(ref_lo, ref_lo), _mm_mul_pd(ref_hi, ref_hi)));
+        vs.out_sq = _mm_add_pd(vs.out_sq, _mm_add_pd(_mm_mul_pd(out_lo, out_lo), _mm_mul_pd(out_hi, out_hi)));
+    }
+}
+
+static inline void cmp_vreduce(const cmp_vstate_t& vs, cmp_acc_t* acc)
+{
+    float max_diff[4];
+    double sum[2];
+
+    _mm_storeu_ps(max_diff, vs.max_diff);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        acc->max_diff = (max_diff[i] > acc->max_diff) ? max_diff[i] : acc->max_diff;
+    }
+    _mm_storeu_pd(sum, vs.sum_diff);
+    acc->sum_diff += sum[0] + sum[1];
+    _mm_storeu_pd(sum, vs.dot);
+    acc->dot += sum[0] + sum[1];
+    _mm_storeu_pd(sum, vs.ref_sq);
+    acc->ref_sq += sum[0] + sum[1];
+    _mm_storeu_pd(sum, vs.out_sq);
+    acc->out_sq += sum[0] + sum[1];
+}
+
+static inline __m128 cmp_vdup(float val)
+{
+    return _mm_set1_ps(val);
+}
+#elif (defined CMP_SIMD_NEON)
+typedef float32x4_t cmp_vf_t;
+
+typedef struct cmp_vstate {
+    float32x4_t max_diff;
+    float64x2_t sum_diff;
+    float64x2_t dot;
+    float64x2_t ref_sq;
+    float64x2_t out_sq;
+} cmp_vstate_t;
+
+static inline void cmp_load8(const uint8_t* src, float32x4_t& lo, float32x4_t& hi)
+{
+    uint16x8_t v = vmovl_u8(vld1_u8(src));
+    lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v)));
+    hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v)));
+}
+
+static inline void cmp_load8(const int8_t* src, float32x4_t& lo, float32x4_t& hi)
+{
+    int16x8_t v = vmovl_s8(vld1_s8(src));
+    lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+    hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+}
+
+static inline void cmp_load8(const uint16_t* src, float32x4_t& lo, float32x4_t& hi)
+{
+    uint16x8_t v = vld1q_u16(src);
+    lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(v)));
+    hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(v)));
+}
+
+static inline void cmp_load8(const int16_t* src, float32x4_t& lo, float32x4_t& hi)
+{
+    int16x8_t v = vld1q_s16(src);
+    lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+    hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+}
+
+static inline void cmp_vinit(cmp_vstate_t& vs)
+{
+    vs.max_diff = vdupq_n_f32(0);
+    vs.sum_diff = vdupq_n_f64(0);
+    vs.dot = vdupq_n_f64(0);
+    vs.ref_sq = vdupq_n_f64(0);
+    vs.out_sq = vdupq_n_f64(0);
+}
+
+template <bool COS>
+static inline void cmp_vstep(cmp_vstate_t& vs, float32x4_t ref, float32x4_t out,
+    float32x4_t abs_tol, float32x4_t rel_tol, uint64_t idx, cmp_acc_t* acc)
+{
+    float32x4_t diff = vabdq_f32(out, ref);
+    float32x4_t thr = vaddq_f32(abs_tol, vmulq_f32(rel_tol, vabsq_f32(ref)));
+    uint32x4_t mask = vcgtq_f32(diff, thr);
+    uint32_t lanes[4];
+
+    if (vmaxvq_u32(mask))
+    {
+        vst1q_u32(lanes, mask);
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            if (lanes[i])
+            {
+                acc->mismatches++;
+                if (acc->first < 0)
+                {
+                    acc->first = idx + i;
+                }
+            }
+        }
+    }
+    vs.max_diff = vmaxq_f32(vs.max_diff, diff);
+    vs.sum_diff = vaddq_f64(vs.sum_diff,
+        vaddq_f64(vcvt_f64_f32(vget_low_f32(diff)), vcvt_high_f64_f32(diff)));
+    if (COS)
+    {
+        float64x2_t ref_lo = vcvt_f64_f32(vget_low_f32(ref));
+        float64x2_t ref_hi = vcvt_high_f64_f32(ref);
+        float64x2_t out_lo = vcvt_f64_f32(vget_low_f32(out));
+        float64x2_t out_hi = vcvt_high_f64_f32(out);
+        vs.dot = vaddq_f64(vs.dot, vaddq_f64(vmulq_f64(ref_lo, out_lo), vmulq_f64(ref_hi, out_hi)));
+        vs.ref_sq = vaddq_f64(vs.ref_sq, vaddq_f64(vmulq_f64(ref_lo, ref_lo), vmulq_f64(ref_hi, ref_hi)));
+        vs.out_sq = vaddq_f64(vs.out_sq, vaddq_f64(vmulq_f64(out_lo, out_lo), vmulq_f64(out_hi, out_hi)));
+    }
+}
+
+static inline void cmp_vreduce(const cmp_vstate_t& vs, cmp_acc_t* acc)
+{
+    float max_diff = vmaxvq_f32(vs.max_diff);
+
+    acc->max_diff = (max_diff > acc->max_diff) ? max_diff : acc->max_diff;
+    acc->sum_diff += vaddvq_f64(vs.sum_diff);
+    acc->dot += vaddvq_f64(vs.dot);
+    acc->ref_sq += vaddvq_f64(vs.ref_sq);
+    acc->out_sq += vaddvq_f64(vs.out_sq);
+}
+
+static inline float32x4_t cmp_vdup(float val)
+{
+    return vdupq_n_f32(val);
+}
+#endif
+
+template <typename T, bool COS>
+static void cmp_kernel(const T* ref, const T* out, uint64_t cnt, float abs_tol, float rel_tol,
+    cmp_acc_t* acc)
+{
+    uint64_t i = 0;
+
+#if (defined CMP_SIMD_SSE2) || (defined CMP_SIMD_NEON)
+    cmp_vstate_t vs;
+    cmp_vf_t vabs_tol = cmp_vdup(abs_tol);
+    cmp_vf_t vrel_tol = cmp_vdup(rel_tol);
+    cmp_vf_t ref_lo, ref_hi, out_lo, out_hi;
+
+    cmp_vinit(vs);
+    for (; i + 8 <= cnt; i += 8)
+    {
+        cmp_load8(ref + i, ref_lo, ref_hi);
+        cmp_load8(out + i, out_lo, out_hi);
+        cmp_vstep<COS>(vs, ref_lo, out_lo, vabs_tol, vrel_tol, i, acc);
+        cmp_vstep<COS>(vs, ref_hi, out_hi, vabs_tol, vrel_tol, i + 4, acc);
+    }
+    cmp_vreduce(vs, acc);
+#endif
+
+    for (; i < cnt; i++)
+    {
+        float r = (float)ref[i];
+        float o = (float)out[i];
+        float diff = fabsf(o - r);
+
+        if (diff > abs_tol + rel_tol * fabsf(r))
+        {
+            acc->mismatches++;
+            if (acc->first < 0)
+            {
+                acc->first = i;
+            }
+        }
+        acc->max_diff = (diff > acc->max_diff) ? diff : acc->max_diff;
+        acc->sum_diff += diff;
+        if (COS)
+        {
+            acc->dot += (double)r * o;
+            acc->ref_sq += (double)r * r;
+            acc->out_sq += (double)o * o;
+        }
+    }
+}
+
+template <typename T>
+static void cmp_dispatch(const void* ref, const void* out, uint64_t cnt, bool cos, float abs_tol,
+    float rel_tol, cmp_acc_t* acc)
+{
+    if (cos)
+    {
+        cmp_kernel<T, true>((const T*)ref, (const T*)out, cnt, abs_tol, rel_tol, acc);
+    }
+    else
+    {
+        cmp_kernel<T, false>((const T*)ref, (const T*)out, cnt, abs_tol, rel_tol, acc);
+    }
+}
+
+void init_cmp_option(cmp_option_t* opt)
+{
+    opt->mode = CMP_MODE_EXACT;
+    opt->dtype = TENSOR_DATA_TYPE_U8;
+    opt->abs_tol = 0;
+    opt->rel_tol = 0;
+    opt->min_cosine = 0.999;
+}
+
+int compare_tensor(const void* ref, uint32_t ref_size, const volatile void* out, uint32_t out_size,
+    const cmp_option_t* opt, cmp_result_t* result)
+{
+    uint32_t bytes = 0;
+    uint64_t cnt = 0;
+    bool cos = false;
+    float abs_tol = 0;
+    float rel_tol = 0;
+    cmp_acc_t acc;
+
+    if ((nullptr == opt) || (nullptr == result) || (opt->mode >= CMP_MODE_MAX) ||
+        ((nullptr == ref) && ref_size) || ((nullptr == out) && out_size))
+    {
+        fprintf(stderr, "[TEST ERROR] invalid tensor compare arguments!\n");
+        return -1;
+    }
+
+    memset(result, 0, sizeof(*result));
+    memset(&acc, 0, sizeof(acc));
+    acc.first = -1;
+    bytes = get_dtype_bytes(opt->dtype);
+    cnt = ((ref_size < out_size) ? ref_size : out_size) / bytes;
+    cos = (CMP_MODE_COSINE == opt->mode);
+    if (CMP_MODE_TOLERANCE == opt->mode)
+    {
+        abs_tol = opt->abs_tol;
+        rel_tol = opt->rel_tol;
+    }
+    result->elements = cnt;
+    result->first_mismatch = -1;
+    result->size_match = (ref_size == out_size);
+
+    /* passing tensors take the byte compare only; the others get full statistics */
+    if ((CMP_MODE_EXACT == opt->mode) && is_buffer_equal(out, ref, cnt * bytes))
+    {
+        result->pass = result->size_match;
+        return 0;
+    }
+
+    switch (opt->dtype)
+    {
+    case TENSOR_DATA_TYPE_S8:
+        cmp_dispatch<int8_t>(ref, (const void*)out, cnt, cos, abs_tol, rel_tol, &acc);
+        break;
+    case TENSOR_DATA_TYPE_U16:
+        cmp_dispatch<uint16_t>(ref, (const void*)out, cnt, cos, abs_tol, rel_tol, &acc);
+        break;
+    case TENSOR_DATA_TYPE_S16:
+        cmp_dispatch<int16_t>(ref, (const void*)out, cnt, cos, abs_tol, rel_tol, &acc);
+        break;
+    default:
+        cmp_dispatch<uint8_t>(ref, (const void*)out, cnt, cos, abs_tol, rel_tol, &acc);
+        break;
+    }
+
+    result->mismatches = acc.mismatches;
+    result->first_mismatch = acc.first;
+    result->max_abs_diff = acc.max_diff;
+    result->mean_abs_diff = cnt ? (acc.sum_diff / cnt) : 0;
+    if (cos)
+    {
+        if ((0 == acc.ref_sq) || (0 == acc.out_sq))
+        {
+            result->cosine = (acc.ref_sq == acc.out_sq) ? 1.0 : 0.0;
+        }
+        else
+        {
+            result->cosine = acc.dot / sqrt(acc.ref_sq * acc.out_sq);
+        }
+        result->pass = result->size_match && (result->cosine >= opt->min_cosine);
+    }
+    else
+    {
+        result->pass = result->size_match && (0 == result->mismatches);
+    }
+    return 0;
+}
+
+static void* cmp_thread(void* arg)
+{
+    cmp_pool_t* pool = (cmp_pool_t*)arg;
+    cmp_task_t* task = nullptr;
+    uint32_t idx = 0;
+
+    while (true)
+    {
+        pthread_mutex_lock(&pool->lock);
+        idx = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        if (idx >= pool->tasks->size())
+        {
+            break;
+        }
+
+        task = &(*pool->tasks)[idx];
+        if (compare_tensor(task->ref, task->ref_size, task->out, task->out_size, pool->opt,
+            &task->result))
+        {
+            task->result.pass = false;
+        }
+    }
+
+    return NULL;
+}
+
+int compare_tensors(std::vector<cmp_task_t>& tasks, const cmp_option_t* opt, uint32_t threads)
+{
+    cmp_pool_t pool;
+    std::vector<pthread_t> tids;
+    pthread_t tid;
+
+    if (0 == threads)
+    {
+        threads = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (threads > tasks.size())
+    {
+        threads = tasks.size();
+    }
+
+    pool.tasks = &tasks;
+    pool.opt = opt;
+    pool.next = 0;
+    pthread_mutex_init(&pool.lock, NULL);
+
+    /* the calling thread is one of the workers */
+    for (uint32_t i = 1; i < threads; i++)
+    {
+        if (pthread_create(&tid, NULL, cmp_thread, &pool))
+        {
+            fprintf(stderr, "[TEST ERROR] create compare thread failed!\n");
+            break;
+        }
+        tids.push_back(tid);
+    }
+    cmp_thread(&pool);
+    for (uint32_t i = 0; i < tids.size(); i++)
+    {
+        pthread_join(tids[i], NULL);
+    }
+    pthread_mutex_destroy(&pool.lock);
+
+    for (uint32_t i = 0; i < tasks.size(); i++)
+    {
+        if (!tasks[i].result.pass)
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+const char* get_cmp_mode_name(cmp_mode_t mode)
+{
+    if (CMP_MODE_TOLERANCE == mode)
+    {
+        return "tolerance";
+    }
+    if (CMP_MODE_COSINE == mode)
+    {
+        return "cosine";
+    }
+    return "exact";
+}
+
+const char* get_cmp_dtype_name(aipu_data_type_t dtype)
+{
+    if (TENSOR_DATA_TYPE_S8 == dtype)
+    {
+        return "s8";
+    }
+    if (TENSOR_DATA_TYPE_U16 == dtype)
+    {
+        return "u16";
+    }
+    if (TENSOR_DATA_TYPE_S16 == dtype)
+    {
+        return "s16";
+    }
+    return "u8";
+}
+
+static void dump_json_string(FILE* fp, const std::string& str)
+{
+    fputc('"', fp);
+    for (uint32_t i = 0; i < str.size(); i++)
+    {
+        unsigned char c = str[i];
+        if (('"' == c) || ('\\' == c))
+        {
+            fprintf(fp, "\\%c", c);
+        }
+        else if (c < 0x20)
+        {
+            fprintf(fp, "\\u%04x", c);
+        }
+        else
+        {
+            fputc(c, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+void dump_cmp_json(FILE* fp, const std::vector<cmp_task_t>& tasks, const cmp_option_t* opt,
+    const std::vector<std::string>& unmatched)
+{
+    uint64_t elements = 0;
+    uint64_t mismatches = 0;
+    uint32_t passed = 0;
+
+    fprintf(fp, "{\n  \"mode\": \"%s\",\n  \"dtype\": \"%s\",\n", get_cmp_mode_name(opt->mode),
+        get_cmp_dtype_name(opt->dtype));
+    if (CMP_MODE_TOLERANCE == opt->mode)
+    {
+        fprintf(fp, "  \"abs_tol\": %g,\n  \"rel_tol\": %g,\n", opt->abs_tol, opt->rel_tol);
+    }
+    else if (CMP_MODE_COSINE == opt->mode)
+    {
+        fprintf(fp, "  \"min_cosine\": %.9g,\n", opt->min_cosine);
+    }
+
+    fprintf(fp, "  \"tensors\": [");
+    for (uint32_t i = 0; i < tasks.size(); i++)
+    {
+        const cmp_result_t& result = tasks[i].result;
+
+        fprintf(fp, "%s\n    {\"name\": ", i ? "," : "");
+        dump_json_string(fp, tasks[i].name);
+        fprintf(fp, ", \"ref\": ");
+        dump_json_string(fp, tasks[i].ref_fname);
+        fprintf(fp, ", \"out\": ");
+        dump_json_string(fp, tasks[i].out_fname);
+        fprintf(fp, ",\n     \"ref_size\": %u, \"out_size\": %u, \"elements\": %lu, "
+            "\"mismatches\": %lu, \"mismatch_ratio\": %.9g, \"first_mismatch\": %ld,\n"
+            "     \"max_abs_diff\": %.9g, \"mean_abs_diff\": %.9g",
+            tasks[i].ref_size, tasks[i].out_size, (unsigned long)result.elements,
+            (unsigned long)result.mismatches,
+            result.elements ? ((double)result.mismatches / result.elements) : 0.0,
+            (long)result.first_mismatch, result.max_abs_diff, result.mean_abs_diff);
+        if (CMP_MODE_COSINE == opt->mode)
+        {
+            fprintf(fp, ", \"cosine\": %.9g", result.cosine);
+        }
+        fprintf(fp, ", \"pass\": %s}", result.pass ? "true" : "false");
+
+        elements += result.elements;
+        mismatches += result.mismatches;
+        passed += result.pass;
+    }
+    fprintf(fp, "%s],\n  \"unmatched\": [", tasks.size() ? "\n  " : "");
+    for (uint32_t i = 0; i < unmatched.size(); i++)
+    {
+        fprintf(fp, "%s", i ? ", " : "");
+        dump_json_string(fp, unmatched[i]);
+    }
+    fprintf(fp, "],\n  \"summary\": {\"tensors\": %u, \"passed\": %u, \"failed\": %u, "
+        "\"elements\": %lu, \"mismatches\": %lu, \"pass\": %s}\n}\n",
+        (uint32_t)tasks.size(), passed, (uint32_t)tasks.size() - passed, (unsigned long)elements,
+        (unsigned long)mismatches, (passed == tasks.size()) ? "true" : "false");
+}
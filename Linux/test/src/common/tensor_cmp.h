@@ -0,0 +1,83 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  tensor_cmp.h
+ * @brief AIPU UMD test header file: tensor comparison
+ */
+
+#ifndef _TENSOR_CMP_H_
+#define _TENSOR_CMP_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include "standard_api.h"
+
+typedef enum {
+    CMP_MODE_EXACT,       /**< element equal */
+    CMP_MODE_TOLERANCE,   /**< |out - ref| <= abs_tol + rel_tol * |ref| */
+    CMP_MODE_COSINE,      /**< cosine similarity of ref & out >= min_cosine */
+    CMP_MODE_MAX
+} cmp_mode_t;
+
+typedef struct cmp_option {
+    cmp_mode_t mode;
+    aipu_data_type_t dtype;   /* U8/S8/U16/S16; raw bytes are compared as U8 */
+    double abs_tol;
+    double rel_tol;
+    double min_cosine;
+} cmp_option_t;
+
+typedef struct cmp_result {
+    uint64_t elements;        /* elements compared (of the smaller buffer) */
+    uint64_t mismatches;      /* elements out of tolerance; any difference counts in the other modes */
+    int64_t first_mismatch;   /* element index, -1 if none */
+    double max_abs_diff;
+    double mean_abs_diff;
+    double cosine;            /* computed in cosine mode only */
+    bool size_match;
+    bool pass;
+} cmp_result_t;
+
+typedef struct cmp_task {
+    std::string name;
+    std::string ref_fname;
+    std::string out_fname;
+    const void* ref;
+    const volatile void* out;
+    uint32_t ref_size;
+    uint32_t out_size;
+    cmp_result_t result;
+} cmp_task_t;
+
+/**
+ * exact byte compare with the SIMD kernel of the platform; out may be mapped device memory
+ */
+bool is_buffer_equal(const volatile void* out, const void* ref, uint32_t size);
+void init_cmp_option(cmp_option_t* opt);
+int compare_tensor(const void* ref, uint32_t ref_size, const volatile void* out, uint32_t out_size,
+    const cmp_option_t* opt, cmp_result_t* result);
+/* compares the tasks on <threads> threads (one tensor per thread at a time); -1 if any fails */
+int compare_tensors(std::vector<cmp_task_t>& tasks, const cmp_option_t* opt, uint32_t threads);
+void dump_cmp_json(FILE* fp, const std::vector<cmp_task_t>& tasks, const cmp_option_t* opt,
+    const std::vector<std::string>& unmatched);
+const char* get_cmp_mode_name(cmp_mode_t mode);
+const char* get_cmp_dtype_name(aipu_data_type_t dtype);
+
+#endif /* _TENSOR_CMP_H_ */
@@ -53,6 +53,11 @@ uint32_t dump_flags =
  */
 //uint32_t dump_flags = AIPU_DUMP_MEM_MAP;
 
+/**
+ * To dump into one (compressed) container file per job written by the UMD writer
+ * thread, please add AIPU_DUMP_ASYNC (and AIPU_DUMP_LZ4) to the flags above.
+ */
+
 int main(int argc, char* argv[])
 {
     aipu_status_t ret = AIPU_STATUS_SUCCESS;
@@ -153,6 +158,16 @@ int main(int argc, char* argv[])
         goto clean_job;
     }
 
+    if (dump_flags & AIPU_DUMP_ASYNC)
+    {
+        aipu_dump_stats_t stats;
+        AIPU_sync_dumps(ctx);
+        AIPU_get_dump_stats(ctx, &stats);
+        fprintf(stdout, "[TEST INFO] async dump: %lu bytes dumped, %lu bytes written, %lu error(s).\n",
+            (unsigned long)stats.bytes_dumped, (unsigned long)stats.bytes_written,
+            (unsigned long)stats.write_errors);
+    }
+
     pass = check_result_pass(test_info[0], test_info[0].jobs[0].id);
 
 clean_job:
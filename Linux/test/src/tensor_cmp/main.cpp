@@ -0,0 +1,585 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  main.cpp
+ * @brief AIPU UMD test implementation file: tensor/dump comparison tool
+ *
+ * Compares two dump files, or the sections of two dump dirs (sync dump files and async
+ * .aipudump containers) paired by name, e.g. the after-run dumps of a passing and a failing
+ * frame; or the before-run and after-run dumps in one dir. Tensors are compared on several
+ * threads with the kernels of common/tensor_cmp.cpp and the statistics are written as JSON.
+ * No AIPU or simulator is needed.
+ *
+ * exit code: 0 if all compared sections pass, 1 if any fails, 2 on error
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <map>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include "common/tensor_cmp.h"
+#include "context/dump_writer.h"
+#include "utils/lz4.h"
+
+using namespace std;
+
+typedef struct cmp_section {
+    string fname;          /* dump file (and record) the section is read from */
+    const char* data;
+    uint32_t size;
+} cmp_section_t;
+
+typedef struct cmp_store {
+    vector<pair<char*, uint64_t> > maps;
+    vector<vector<char>*> decoded;
+    map<string, cmp_section_t> sections;   /* keyed by e.g. "After_Run_OutTensor0" */
+} cmp_store_t;
+
+static struct option opts[] = {
+    { "help", no_argument, NULL, 'h' },
+    { "mode", required_argument, NULL, 'm' },
+    { "dtype", required_argument, NULL, 't' },
+    { "abs_tol", required_argument, NULL, 'a' },
+    { "rel_tol", required_argument, NULL, 'r' },
+    { "cosine", required_argument, NULL, 'c' },
+    { "sections", required_argument, NULL, 's' },
+    { "before_after", no_argument, NULL, 'b' },
+    { "threads", required_argument, NULL, 'j' },
+    { "json", required_argument, NULL, 'o' },
+    { NULL, 0, NULL, 0 }
+};
+
+static void show_help_msg()
+{
+    fprintf(stdout,
+        "AIPU UMD tensor compare tool\n"
+        "Usage: aipu_tensor_cmp [options] <ref file|dir> <out file|dir>\n"
+        "       aipu_tensor_cmp [options] --before_after <dir>\n"
+        "Options:\n"
+        "-h, --help\t\tshow the help message\n"
+        "-m, --mode=<mode>\texact (by default), tolerance or cosine\n"
+        "-t, --dtype=<type>\telement type: u8 (by default), s8, u16 or s16\n"
+        "-a, --abs_tol=<val>\tabsolute tolerance of tolerance mode\n"
+        "-r, --rel_tol=<val>\trelative tolerance of tolerance mode (of |ref|)\n"
+        "-c, --cosine=<val>\tminimum cosine similarity of cosine mode (0.999 by default)\n"
+        "-s, --sections=<a,b>\tonly compare the dump sections whose names contain one of them\n"
+        "-b, --before_after\tcompare the before-run and after-run dumps in one dir\n"
+        "-j, --threads=<n>\tcompare threads (CPU number by default)\n"
+        "-o, --json=<file>\twrite the statistics as JSON (<-> for stdout)\n");
+}
+
+static string get_basename(const string& fname)
+{
+    size_t pos = fname.rfind('/');
+    return (string::npos == pos) ? fname : fname.substr(pos + 1);
+}
+
+/**
+ * section key of a sync dump file name
+ * Graph0x<graph>_Job0x<job>_<phase>_<name>_Base0x<base>_Size0x<size>_<suffix>.bin
+ */
+static string get_section_key(const string& fname)
+{
+    string base = get_basename(fname);
+    size_t start = base.find("_Before_Run_");
+    size_t end = string::npos;
+
+    if (string::npos == start)
+    {
+        start = base.find("_After_Run_");
+    }
+    if ((0 != base.compare(0, 7, "Graph0x")) || (string::npos == start))
+    {
+        return "";
+    }
+    end = base.find("_Base0x", start);
+    if (string::npos == end)
+    {
+        return "";
+    }
+    return base.substr(start + 1, end - start - 1);
+}
+
+static bool is_selected(const string& key, const vector<string>& filters)
+{
+    if (filters.empty())
+    {
+        return true;
+    }
+    for (uint32_t i = 0; i < filters.size(); i++)
+    {
+        if (string::npos != key.find(filters[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int map_file(const string& fname, cmp_store_t* store, const char** data, uint64_t* size)
+{
+    int fd = 0;
+    struct stat finfo;
+    void* va = nullptr;
+
+    fd = open(fname.c_str(), O_RDONLY);
+    if ((fd < 0) || fstat(fd, &finfo))
+    {
+        fprintf(stderr, "[CMP ERROR] open file failed: %s! (errno = %d)\n", fname.c_str(), errno);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+
+    *data = nullptr;
+    *size = finfo.st_size;
+    if (finfo.st_size)
+    {
+        va = mmap(NULL, finfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == va)
+        {
+            fprintf(stderr, "[CMP ERROR] map file failed: %s! (errno = %d)\n", fname.c_str(), errno);
+            close(fd);
+            return -1;
+        }
+        store->maps.push_back(make_pair((char*)va, (uint64_t)finfo.st_size));
+        *data = (const char*)va;
+    }
+    close(fd);
+    return 0;
+}
+
+static void add_section(cmp_store_t* store, const string& key, const string& fname,
+    const char* data, uint32_t size)
+{
+    cmp_section_t section;
+
+    if (store->sections.count(key))
+    {
+        fprintf(stderr, "[CMP INFO] skip duplicated section %s in %s (jobs of a dir are not told apart)\n",
+            key.c_str(), fname.c_str());
+        return;
+    }
+    section.fname = fname;
+    section.data = data;
+    section.size = size;
+    store->sections[key] = section;
+}
+
+static int load_container(const string& fname, cmp_store_t* store)
+{
+    AIRT::dump_file_header_t header;
+    AIRT::dump_record_header_t record;
+    const char* data = nullptr;
+    uint64_t size = 0;
+    uint64_t pos = sizeof(header);
+    vector<char>* decoded = nullptr;
+
+    if (map_file(fname, store, &data, &size))
+    {
+        return -1;
+    }
+    if (size < sizeof(header))
+    {
+        goto invalid;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, DUMP_FILE_MAGIC, sizeof(header.magic)) ||
+        (DUMP_FILE_VERSION != header.version))
+    {
+        goto invalid;
+    }
+
+    while (pos + sizeof(record) <= size)
+    {
+        memcpy(&record, data + pos, sizeof(record));
+        pos += sizeof(record);
+        record.name[sizeof(record.name) - 1] = '\0';
+        if (pos + record.stored_size > size)
+        {
+            goto invalid;
+        }
+
+        if (AIRT::DUMP_CODEC_LZ4 == record.codec)
+        {
+            decoded = new vector<char>(record.size);
+            store->decoded.push_back(decoded);
+            if (umd_lz4_decompress(data + pos, record.stored_size, decoded->data(), record.size) !=
+                (int64_t)record.size)
+            {
+                goto invalid;
+            }
+            add_section(store, record.name, fname + ":" + record.name, decoded->data(), record.size);
+        }
+        else if ((AIRT::DUMP_CODEC_NONE == record.codec) && (record.stored_size == record.size))
+        {
+            add_section(store, record.name, fname + ":" + record.name, data + pos, record.size);
+        }
+        else
+        {
+            goto invalid;
+        }
+        pos += record.stored_size;
+    }
+    return 0;
+
+invalid:
+    fprintf(stderr, "[CMP ERROR] invalid dump container: %s!\n", fname.c_str());
+    return -1;
+}
+
+static int load_dir(const string& dir, cmp_store_t* store)
+{
+    DIR* dp = opendir(dir.c_str());
+    struct dirent* entry = nullptr;
+    vector<string> names;
+    const char* data = nullptr;
+    uint64_t size = 0;
+    int ret = 0;
+
+    if (nullptr == dp)
+    {
+        fprintf(stderr, "[CMP ERROR] No such dump file directory exists: %s!\n", dir.c_str());
+        return -1;
+    }
+    while (nullptr != (entry = readdir(dp)))
+    {
+        names.push_back(entry->d_name);
+    }
+    closedir(dp);
+
+    /* sorted, so that the first job of a dir wins duplicated sections */
+    sort(names.begin(), names.end());
+    for (uint32_t i = 0; (i < names.size()) && !ret; i++)
+    {
+        string fname = dir + "/" + names[i];
+        string key = get_section_key(names[i]);
+
+        if ((names[i].size() > 9) && (0 == names[i].compare(names[i].size() - 9, 9, ".aipudump")))
+        {
+            ret = load_container(fname, store);
+        }
+        else if (!key.empty() && (names[i].size() > 4) &&
+            (0 == names[i].compare(names[i].size() - 4, 4, ".bin")))
+        {
+            ret = map_file(fname, store, &data, &size);
+            if (!ret)
+            {
+                add_section(store, key, fname, data, size);
+            }
+        }
+    }
+    return ret;
+}
+
+static void release_store(cmp_store_t* store)
+{
+    for (uint32_t i = 0; i < store->maps.size(); i++)
+    {
+        munmap(store->maps[i].first, store->maps[i].second);
+    }
+    for (uint32_t i = 0; i < store->decoded.size(); i++)
+    {
+        delete store->decoded[i];
+    }
+    store->maps.clear();
+    store->decoded.clear();
+    store->sections.clear();
+}
+
+static void add_task(vector<cmp_task_t>& tasks, const string& name, const cmp_section_t& ref,
+    const cmp_section_t& out)
+{
+    cmp_task_t task;
+
+    task.name = name;
+    task.ref_fname = ref.fname;
+    task.out_fname = out.fname;
+    task.ref = ref.data;
+    task.ref_size = ref.size;
+    task.out = out.data;
+    task.out_size = out.size;
+    memset(&task.result, 0, sizeof(task.result));
+    tasks.push_back(task);
+}
+
+static bool is_dir(const char* path)
+{
+    struct stat finfo;
+    return (0 == stat(path, &finfo)) && S_ISDIR(finfo.st_mode);
+}
+
+int main(int argc, char* argv[])
+{
+    int ret = 0;
+    int c = 0;
+    int opt_idx = 0;
+    cmp_option_t opt;
+    uint32_t threads = 0;
+    bool before_after = false;
+    vector<string> filters;
+    string json_fname;
+    FILE* json_fp = nullptr;
+    cmp_store_t ref_store;
+    cmp_store_t out_store;
+    vector<cmp_task_t> tasks;
+    vector<string> unmatched;
+    map<string, cmp_section_t>::iterator iter;
+    uint32_t passed = 0;
+
+    init_cmp_option(&opt);
+    while (-1 != (c = getopt_long(argc, argv, "hm:t:a:r:c:s:bj:o:", opts, &opt_idx)))
+    {
+        switch (c)
+        {
+        case 'h':
+            show_help_msg();
+            return 0;
+
+        case 'm':
+            if (!strcmp(optarg, "exact"))
+            {
+                opt.mode = CMP_MODE_EXACT;
+            }
+            else if (!strcmp(optarg, "tolerance"))
+            {
+                opt.mode = CMP_MODE_TOLERANCE;
+            }
+            else if (!strcmp(optarg, "cosine"))
+            {
+                opt.mode = CMP_MODE_COSINE;
+            }
+            else
+            {
+                fprintf(stderr, "[CMP ERROR] invalid compare mode: %s!\n", optarg);
+                return 2;
+            }
+            break;
+
+        case 't':
+            opt.dtype = TENSOR_DATA_TYPE_NONE;
+            for (uint32_t i = TENSOR_DATA_TYPE_U8; i <= TENSOR_DATA_TYPE_S16; i++)
+            {
+                if (!strcmp(optarg, get_cmp_dtype_name((aipu_data_type_t)i)))
+                {
+                    opt.dtype = (aipu_data_type_t)i;
+                }
+            }
+            if (TENSOR_DATA_TYPE_NONE == opt.dtype)
+            {
+                fprintf(stderr, "[CMP ERROR] invalid data type: %s!\n", optarg);
+                return 2;
+            }
+            break;
+
+        case 'a':
+            opt.abs_tol = atof(optarg);
+            break;
+
+        case 'r':
+            opt.rel_tol = atof(optarg);
+            break;
+
+        case 'c':
+            opt.min_cosine = atof(optarg);
+            break;
+
+        case 's':
+            for (char* s = strtok(optarg, ","); nullptr != s; s = strtok(NULL, ","))
+            {
+                filters.push_back(s);
+            }
+            break;
+
+        case 'b':
+            before_after = true;
+            break;
+
+        case 'j':
+            threads = atoi(optarg);
+            break;
+
+        case 'o':
+            json_fname = optarg;
+            break;
+
+        default:
+            show_help_msg();
+            return 2;
+        }
+    }
+
+    if ((argc - optind) != (before_after ? 1 : 2))
+    {
+        show_help_msg();
+        return 2;
+    }
+
+    if (before_after)
+    {
+        if (load_dir(argv[optind], &ref_store))
+        {
+            ret = 2;
+            goto finish;
+        }
+        for (iter = ref_store.sections.begin(); iter != ref_store.sections.end(); iter++)
+        {
+            string name = iter->first;
+            if ((0 != name.compare(0, 11, "Before_Run_")) || !is_selected(name, filters))
+            {
+                continue;
+            }
+            name = name.substr(11);
+            if (ref_store.sections.count("After_Run_" + name))
+            {
+                add_task(tasks, name, iter->second, ref_store.sections["After_Run_" + name]);
+            }
+            else
+            {
+                unmatched.push_back(iter->first);
+            }
+        }
+    }
+    else if (is_dir(argv[optind]) && is_dir(argv[optind + 1]))
+    {
+        if (load_dir(argv[optind], &ref_store) || load_dir(argv[optind + 1], &out_store))
+        {
+            ret = 2;
+            goto finish;
+        }
+        for (iter = ref_store.sections.begin(); iter != ref_store.sections.end(); iter++)
+        {
+            if (!is_selected(iter->first, filters))
+            {
+                continue;
+            }
+            if (out_store.sections.count(iter->first))
+            {
+                add_task(tasks, iter->first, iter->second, out_store.sections[iter->first]);
+            }
+            else
+            {
+                unmatched.push_back(iter->first);
+            }
+        }
+        for (iter = out_store.sections.begin(); iter != out_store.sections.end(); iter++)
+        {
+            if (is_selected(iter->first, filters) && !ref_store.sections.count(iter->first))
+            {
+                unmatched.push_back(iter->first);
+            }
+        }
+    }
+    else
+    {
+        cmp_section_t ref;
+        cmp_section_t out;
+        uint64_t ref_size = 0;
+        uint64_t out_size = 0;
+
+        if (map_file(argv[optind], &ref_store, &ref.data, &ref_size) ||
+            map_file(argv[optind + 1], &out_store, &out.data, &out_size))
+        {
+            ret = 2;
+            goto finish;
+        }
+        ref.fname = argv[optind];
+        ref.size = ref_size;
+        out.fname = argv[optind + 1];
+        out.size = out_size;
+        add_task(tasks, get_basename(out.fname), ref, out);
+    }
+
+    if (tasks.empty())
+    {
+        fprintf(stderr, "[CMP ERROR] No dump sections to compare found!\n");
+        ret = 2;
+        goto finish;
+    }
+
+    fprintf(stderr, "[CMP INFO] Comparing %u section(s) (%s, %s)...\n", (uint32_t)tasks.size(),
+        get_cmp_mode_name(opt.mode), get_cmp_dtype_name(opt.dtype));
+    ret = compare_tensors(tasks, &opt, threads) ? 1 : 0;
+    for (uint32_t i = 0; i < tasks.size(); i++)
+    {
+        const cmp_result_t& result = tasks[i].result;
+        if (result.pass)
+        {
+            passed++;
+            fprintf(stderr, "[CMP INFO] %s check PASS!\n", tasks[i].name.c_str());
+        }
+        else
+        {
+            fprintf(stderr, "[CMP ERROR] %s check FAILED! (size 0x%x/0x%x, mismatch %lu/%lu "
+                "from #%ld, max diff %g", tasks[i].name.c_str(), tasks[i].ref_size,
+                tasks[i].out_size, (unsigned long)result.mismatches, (unsigned long)result.elements,
+                (long)result.first_mismatch, result.max_abs_diff);
+            if (CMP_MODE_COSINE == opt.mode)
+            {
+                fprintf(stderr, ", cosine %.6f", result.cosine);
+            }
+            fprintf(stderr, ")\n");
+        }
+    }
+    for (uint32_t i = 0; i < unmatched.size(); i++)
+    {
+        fprintf(stderr, "[CMP INFO] No dump section to compare with: %s\n", unmatched[i].c_str());
+    }
+    if (ret)
+    {
+        fprintf(stderr, "[CMP ERROR] %u/%u section(s) check FAILED!\n",
+            (uint32_t)tasks.size() - passed, (uint32_t)tasks.size());
+    }
+    else
+    {
+        fprintf(stderr, "[CMP INFO] %u/%u section(s) check PASS!\n", passed, (uint32_t)tasks.size());
+    }
+
+    if (!json_fname.empty())
+    {
+        json_fp = (json_fname == "-") ? stdout : fopen(json_fname.c_str(), "w");
+        if (nullptr == json_fp)
+        {
+            fprintf(stderr, "[CMP ERROR] open file failed: %s! (errno = %d)\n", json_fname.c_str(), errno);
+            ret = 2;
+            goto finish;
+        }
+        dump_cmp_json(json_fp, tasks, &opt, unmatched);
+        if (stdout != json_fp)
+        {
+            fclose(json_fp);
+        }
+    }
+
+finish:
+    release_store(&ref_store);
+    release_store(&out_store);
+    return ret;
+}
@@ -0,0 +1,311 @@
+/**********************************************************************************
+ * This file is CONFIDENTIAL and any use by you is subject to the terms of the
+ * agreement between you and Arm China or the terms of the agreement between you
+ * and the party authorised by Arm China to disclose this file to you.
+ * The confidential and proprietary information contained in this file
+ * may only be used by a person authorised under and to the extent permitted
+ * by a subsisting licensing agreement from Arm China.
+ *
+ *        (C) Copyright 2020 Arm Technology (China) Co. Ltd.
+ *                    All rights reserved.
+ *
+ * This entire notice must be reproduced on all copies of this file and copies of
+ * this file may only be made by a person if such person is permitted to do so
+ * under the terms of a subsisting license agreement from Arm China.
+ *
+ *********************************************************************************/
+
+/**
+ * @file  main.cpp
+ * @brief AIPU UMD test implementation file: tensor conversion test
+ *
+ * Microbenchmark of the host <-> device tensor conversion kernels of every instruction set
+ * supported by this CPU. The results of each kernel and of the layout converting APIs are
+ * checked against the scalar kernels bit by bit. No AIPU or simulator is needed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include "standard_api.h"
+#include "tensor_convert/tensor_convert.h"
+
+using namespace std;
+const char* test_case = "tensor convert";
+
+static const char* type_names[] = { "none", "u8", "s8", "u16", "s16" };
+static uint32_t elems = 1 << 20;
+static uint32_t iterations = 20;
+
+static uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static bool get_opt_value(const char* arg, const char* name, const char** value)
+{
+    size_t len = strlen(name);
+
+    if ((strncmp(arg, name, len) == 0) && (arg[len] == '='))
+    {
+        *value = arg + len + 1;
+        return true;
+    }
+    return false;
+}
+
+static int parsing_convert_opts(int argc, char* argv[])
+{
+    const char* value = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (get_opt_value(argv[i], "--elems", &value))
+        {
+            elems = strtoul(value, NULL, 0);
+        }
+        else if (get_opt_value(argv[i], "--iters", &value))
+        {
+            iterations = strtoul(value, NULL, 0);
+        }
+        else
+        {
+            fprintf(stdout, "Tensor convert options:\n");
+            fprintf(stdout, "--elems=<n>\t\telements converted per kernel call (default 1048576)\n");
+            fprintf(stdout, "--iters=<n>\t\tmeasured calls per kernel (default 20)\n");
+            return ((strcmp(argv[i], "-h") == 0) || (strcmp(argv[i], "--help") == 0)) ? 1 : -1;
+        }
+    }
+
+    if ((0 == elems) || (0 == iterations))
+    {
+        fprintf(stderr, "[TEST ERROR] invalid tensor convert options!\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* values over the whole quantized range of every type, plus out-of-range ones to be clamped */
+static void fill_host_data(vector<float>& f32, vector<uint8_t>& u8, vector<uint8_t>& dev)
+{
+    srand(1234);
+    for (uint32_t i = 0; i < f32.size(); i++)
+    {
+        f32[i] = (float)(rand() % 200000 - 100000) / 1000.0f;
+        u8[i] = (uint8_t)rand();
+    }
+    for (uint32_t i = 0; i < dev.size(); i++)
+    {
+        dev[i] = (uint8_t)rand();
+    }
+}
+
+static void report(const char* isa, const char* kernel, const char* type, uint64_t ns,
+    uint64_t bytes)
+{
+    double per_call = (double)ns / iterations;
+
+    fprintf(stdout, "[TEST INFO] %-6s %-14s %-4s %8.3f ns/elem %8.2f GB/s\n", isa, kernel, type,
+        per_call / elems, bytes / per_call);
+}
+
+static int bench_kernels(const AIRT::tensor_kernels_t* kernels, const AIRT::tensor_kernels_t* ref,
+    const vector<float>& f32, const vector<uint8_t>& u8, const vector<uint8_t>& dev)
+{
+    vector<uint8_t> out(elems * sizeof(float));
+    vector<uint8_t> expect(elems * sizeof(float));
+    const float scale = 0.125f;
+    const float zero_point = 3.0f;
+    uint64_t start = 0;
+    int pass = 0;
+
+    for (uint32_t t = TENSOR_DATA_TYPE_U8; t < TENSOR_KERNEL_TYPE_CNT; t++)
+    {
+        uint32_t bytes = AIRT::get_tensor_type_bytes((aipu_data_type_t)t);
+
+        ref->quantize_f32[t](&f32[0], &expect[0], elems, 1.0f / scale, zero_point);
+        start = now_ns();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            kernels->quantize_f32[t](&f32[0], &out[0], elems, 1.0f / scale, zero_point);
+        }
+        report(kernels->name, "quantize f32", type_names[t], now_ns() - start,
+            (uint64_t)elems * (sizeof(float) + bytes));
+        if (memcmp(&out[0], &expect[0], (uint64_t)elems * bytes) != 0)
+        {
+            fprintf(stderr, "[TEST ERROR] %s quantize f32 -> %s mismatch!\n", kernels->name, type_names[t]);
+            pass = -1;
+        }
+
+        ref->quantize_u8[t](&u8[0], &expect[0], elems, 1.0f / scale, zero_point);
+        start = now_ns();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            kernels->quantize_u8[t](&u8[0], &out[0], elems, 1.0f / scale, zero_point);
+        }
+        report(kernels->name, "quantize u8", type_names[t], now_ns() - start,
+            (uint64_t)elems * (sizeof(uint8_t) + bytes));
+        if (memcmp(&out[0], &expect[0], (uint64_t)elems * bytes) != 0)
+        {
+            fprintf(stderr, "[TEST ERROR] %s quantize u8 -> %s mismatch!\n", kernels->name, type_names[t]);
+            pass = -1;
+        }
+
+        ref->dequantize[t](&dev[0], (float*)&expect[0], elems, scale, zero_point);
+        start = now_ns();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            kernels->dequantize[t](&dev[0], (float*)&out[0], elems, scale, zero_point);
+        }
+        report(kernels->name, "dequantize", type_names[t], now_ns() - start,
+            (uint64_t)elems * (bytes + sizeof(float)));
+        if (memcmp(&out[0], &expect[0], (uint64_t)elems * sizeof(float)) != 0)
+        {
+            fprintf(stderr, "[TEST ERROR] %s dequantize %s mismatch!\n", kernels->name, type_names[t]);
+            pass = -1;
+        }
+    }
+
+    return pass;
+}
+
+/* a 224x224x3 image through the public APIs (best kernels) vs. the scalar kernels */
+static int check_layout_convert(const vector<float>& f32, const vector<uint8_t>& u8)
+{
+    const aipu_quant_param_t quant = { 0.05f, -4 };
+    aipu_tensor_desc_t desc;
+    aipu_host_tensor_t host;
+    aipu_host_tensor_t ref_host;
+    aipu_buffer_t buf;
+    vector<uint8_t> dev(224 * 224 * 3);
+    vector<uint8_t> expect(224 * 224 * 3);
+    vector<float> back(224 * 224 * 3);
+    vector<float> back_expect(224 * 224 * 3);
+    const AIRT::tensor_kernels_t* scalar = AIRT::get_tensor_kernels(AIRT::TENSOR_ISA_SCALAR);
+    uint64_t start = 0;
+    int pass = 0;
+
+    memset(&desc, 0, sizeof(desc));
+    desc.size = dev.size();
+    desc.fmt.shape.N = 1;
+    desc.fmt.shape.H = 224;
+    desc.fmt.shape.W = 224;
+    desc.fmt.shape.C = 3;
+    buf.id = 0;
+    buf.va = &dev[0];
+    buf.size = dev.size();
+
+    /* planar f32 into an interleaved s8 device tensor */
+    desc.fmt.layout = TENSOR_LAYOUT_NHWC;
+    desc.fmt.data_type = TENSOR_DATA_TYPE_S8;
+    host.data = (void*)&f32[0];
+    host.data_type = AIPU_HOST_DATA_TYPE_F32;
+    host.layout = TENSOR_LAYOUT_NCHW;
+    if ((AIPU_convert_to_tensor(&desc, &buf, &host, &quant) != AIPU_STATUS_SUCCESS) ||
+        (AIRT::convert_to_device_tensor(desc, &expect[0], host, quant, scalar) != AIPU_STATUS_SUCCESS) ||
+        (memcmp(&dev[0], &expect[0], dev.size()) != 0))
+    {
+        fprintf(stderr, "[TEST ERROR] NCHW f32 -> NHWC s8 conversion mismatch!\n");
+        pass = -1;
+    }
+
+    /* and back into planar f32 */
+    host.data = &back[0];
+    ref_host = host;
+    ref_host.data = &back_expect[0];
+    if ((AIPU_convert_from_tensor(&desc, &buf, &host, &quant) != AIPU_STATUS_SUCCESS) ||
+        (AIRT::convert_from_device_tensor(desc, &expect[0], ref_host, quant, scalar) != AIPU_STATUS_SUCCESS) ||
+        (memcmp(&back[0], &back_expect[0], back.size() * sizeof(float)) != 0))
+    {
+        fprintf(stderr, "[TEST ERROR] NHWC s8 -> NCHW f32 conversion mismatch!\n");
+        pass = -1;
+    }
+
+    start = now_ns();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        host.data = (void*)&f32[0];
+        AIPU_convert_to_tensor(&desc, &buf, &host, &quant);
+        host.data = &back[0];
+        AIPU_convert_from_tensor(&desc, &buf, &host, &quant);
+    }
+    fprintf(stdout, "[TEST INFO] 224x224x3 NCHW f32 -> NHWC s8 -> NCHW f32: %.1f us per round trip\n",
+        (double)(now_ns() - start) / iterations / 1000.0);
+
+    /* interleaved u8 into a planar u8 device tensor */
+    desc.fmt.layout = TENSOR_LAYOUT_NCHW;
+    desc.fmt.data_type = TENSOR_DATA_TYPE_U8;
+    host.data = (void*)&u8[0];
+    host.data_type = AIPU_HOST_DATA_TYPE_U8;
+    host.layout = TENSOR_LAYOUT_NHWC;
+    if ((AIPU_convert_to_tensor(&desc, &buf, &host, &quant) != AIPU_STATUS_SUCCESS) ||
+        (AIRT::convert_to_device_tensor(desc, &expect[0], host, quant, scalar) != AIPU_STATUS_SUCCESS) ||
+        (memcmp(&dev[0], &expect[0], dev.size()) != 0))
+    {
+        fprintf(stderr, "[TEST ERROR] NHWC u8 -> NCHW u8 conversion mismatch!\n");
+        pass = -1;
+    }
+
+    /* dequantizing into a non-f32 host tensor is not supported */
+    if (AIPU_convert_from_tensor(&desc, &buf, &host, &quant) != AIPU_STATUS_ERROR_OP_NOT_SUPPORTED)
+    {
+        fprintf(stderr, "[TEST ERROR] u8 host output tensor should be rejected!\n");
+        pass = -1;
+    }
+
+    return pass;
+}
+
+int main(int argc, char* argv[])
+{
+    int pass = 0;
+    const AIRT::tensor_kernels_t* scalar = AIRT::get_tensor_kernels(AIRT::TENSOR_ISA_SCALAR);
+    const AIRT::tensor_kernels_t* kernels = nullptr;
+    vector<float> f32;
+    vector<uint8_t> u8;
+    vector<uint8_t> dev;
+
+    pass = parsing_convert_opts(argc, argv);
+    if (pass != 0)
+    {
+        pass = (pass > 0) ? 0 : -1;
+        goto finish;
+    }
+
+    /* at least a whole 224x224x3 image for the layout conversion check */
+    f32.resize((elems > 224 * 224 * 3) ? elems : 224 * 224 * 3);
+    u8.resize(f32.size());
+    dev.resize((uint64_t)elems * sizeof(uint16_t));
+    fill_host_data(f32, u8, dev);
+
+    fprintf(stdout, "[TEST INFO] best kernels: %s\n", AIRT::get_best_tensor_kernels()->name);
+    for (uint32_t isa = AIRT::TENSOR_ISA_SCALAR; isa < AIRT::TENSOR_ISA_MAX; isa++)
+    {
+        kernels = AIRT::get_tensor_kernels((AIRT::tensor_isa_t)isa);
+        if ((nullptr != kernels) && (bench_kernels(kernels, scalar, f32, u8, dev) != 0))
+        {
+            pass = -1;
+        }
+    }
+
+    if (check_layout_convert(f32, u8) != 0)
+    {
+        pass = -1;
+    }
+
+finish:
+    if (pass == 0)
+    {
+        fprintf(stdout, "[TEST INFO] Test Result Check PASS! (%s)\n", test_case);
+    }
+    else
+    {
+        fprintf(stderr, "[TEST ERROR] Test Result Check FAILED! (%s)\n", test_case);
+    }
+    return pass;
+}
@@ -1,11 +1,15 @@
 #!/bin/bash
 OUTPUT_DUMP_TOP_DIR=./output
+JSON_FILE=
+# aipu_tensor_cmp built by: ./build.sh -p <platform> -c tensor_cmp
+CMP_TOOL=${CMP_TOOL:-aipu_tensor_cmp}
 
 test_run_help() {
     echo "=====================Driver Test Result Compare Help====================="
     echo "Test Run Options:"
     echo "-h, --help        help"
     echo "-d, --dir         test result dump dir"
+    echo "-o, --json        write the compare statistics into a JSON file"
     echo "========================================================================="
     exit 1
 }
@@ -14,7 +18,7 @@ if [ $# = 0 ]; then
     test_run_help
 fi
 
-ARGS=`getopt -o hd: --long help,dir: -n 'run.sh' -- "$@"`
+ARGS=`getopt -o hd:o: --long help,dir:,json: -n 'cmp.sh' -- "$@"`
 eval set -- "${ARGS}"
 
 while [ -n "$1" ]
@@ -27,6 +31,10 @@ do
          OUTPUT_DUMP_TOP_DIR="$2"
          shift
          ;;
+     -o|--json)
+         JSON_FILE="$2"
+         shift
+         ;;
      --)
          shift ;
          break
@@ -44,42 +52,6 @@ fi
 
 echo "[CMP INFO] Comparing memory section dumps..."
 
-if [ -f $OUTPUT_DUMP_TOP_DIR/*_Before_Run_Code_Section_*.bin ] && \
-   [ -f $OUTPUT_DUMP_TOP_DIR/*_After_Run_Code_Section_*.bin ]; then
-   cmp $OUTPUT_DUMP_TOP_DIR/*_Before_Run_Code_Section_*.bin $OUTPUT_DUMP_TOP_DIR/*_After_Run_Code_Section_*.bin
-   if [ $? = 0 ]; then
-       echo "[CMP INFO] Instruction section dump check PASS!"
-   else
-       echo "[CMP ERROR] Instruction section dump check FAILED!"
-   fi
-else
-   echo "[CMP ERROR] No instruction section dump files found under: $OUTPUT_DUMP_TOP_DIR!"
-fi
-
-if [ -f $OUTPUT_DUMP_TOP_DIR/*_Before_Run_Rodata_Section_*.bin ] && \
-   [ -f $OUTPUT_DUMP_TOP_DIR/*_After_Run_Rodata_Section_*.bin ]; then
-   cmp $OUTPUT_DUMP_TOP_DIR/*_Before_Run_Rodata_Section_*.bin $OUTPUT_DUMP_TOP_DIR/*_After_Run_Rodata_Section_*.bin
-   if [ $? = 0 ]; then
-       echo "[CMP INFO] Rodata section dump check PASS!"
-   else
-       echo "[CMP ERROR] Rodata section dump check FAILED!"
-   fi
-else
-   echo "[CMP ERROR] No rodata section dump files found under: $OUTPUT_DUMP_TOP_DIR!"
-fi
-
-id=0
-fail=0
-while [ -f $OUTPUT_DUMP_TOP_DIR/*_Before_Run_Static_Section"$id"_*.bin ]
-do
-   cmp $OUTPUT_DUMP_TOP_DIR/*_Before_Run_Static_Section${id}_*.bin $OUTPUT_DUMP_TOP_DIR/*_After_Run_Static_Section${id}_*.bin
-   if [ $? != 0 ]; then
-       fail=1
-       echo "[CMP ERROR] Static section $id dump check FAILED!"
-   fi
-   id=`expr $id + 1 `
-done
-
-if [ $fail = 0 ]; then
-    echo "[CMP INFO] Static section dump(s) check PASS! (${id}/${id})"
-fi
\ No newline at end of file
+# instruction, rodata & static sections should not be changed by a run
+$CMP_TOOL --before_after --sections=Text_Section,Rodata_Section,Static_Section \
+    ${JSON_FILE:+--json=$JSON_FILE} $OUTPUT_DUMP_TOP_DIR
@@ -2,6 +2,9 @@
 
 OUTPUT_DUMP_TOP_DIR0=./fail
 OUTPUT_DUMP_TOP_DIR1=./pass
+JSON_FILE=
+# aipu_tensor_cmp built by: ./build.sh -p <platform> -c tensor_cmp
+CMP_TOOL=${CMP_TOOL:-aipu_tensor_cmp}
 
 test_run_help() {
     echo "=====================Driver Test Result Compare Help====================="
@@ -9,6 +12,7 @@ test_run_help() {
     echo "-h, --help        help"
     echo "-p, --dir0       test pass result dump dir"
     echo "-f, --dir1       test fail result dump dir"
+    echo "-o, --json       write the compare statistics into a JSON file"
     echo "========================================================================="
     exit 1
 }
@@ -17,7 +21,7 @@ if [ $# = 0 ]; then
     test_run_help
 fi
 
-ARGS=`getopt -o hd:p:f: --long help,dir0:,dir1: -n 'run.sh' -- "$@"`
+ARGS=`getopt -o hd:p:f:o: --long help,dir0:,dir1:,json: -n 'cmp2frame.sh' -- "$@"`
 eval set -- "${ARGS}"
 
 while [ -n "$1" ]
@@ -34,6 +38,10 @@ do
          OUTPUT_DUMP_TOP_DIR1="$2"
          shift
          ;;
+     -o|--json)
+         JSON_FILE="$2"
+         shift
+         ;;
      --)
          shift ;
          break
@@ -53,85 +61,5 @@ elif [ ! -d $OUTPUT_DUMP_TOP_DIR1 ]; then
 fi
 
 echo "[CMP INFO] Comparing memory section dumps between 2 dirs..."
-#check instruction section dumps
-if [ -f $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Code_Section_*.bin ] && \
-   [ -f $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Code_Section_*.bin ]; then
-   cmp $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Code_Section_*.bin $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Code_Section_*.bin
-   if [ $? = 0 ]; then
-       echo -e "\033[7m[CMP INFO] Instruction section dump after-run check between 2 dirs PASS!\033[0m"
-   else
-       echo -e "\033[7m[CMP ERROR] Instruction section dump after-run check between 2 dirs FAILED!\033[0m"
-   fi
-else
-   echo "[CMP INFO] No instruction section dump files found under: $OUTPUT_DUMP_TOP_DIR0 or $OUTPUT_DUMP_TOP_DIR1!"
-fi
-
-#check stack section dumps
-if [ -f $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Stack_Section_*.bin ] && \
-   [ -f $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Stack_Section_*.bin ]; then
-   cmp $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Stack_Section_*.bin $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Stack_Section_*.bin
-   if [ $? = 0 ]; then
-       echo -e "\033[7m[CMP INFO] Stack section dump after-run check between 2 dirs PASS!\033[0m"
-   else
-       echo -e "\033[7m[CMP ERROR] Stack section dump after-run check between 2 dirs FAILED!\033[0m"
-   fi
-else
-   echo "[CMP INFO] No stack section dump files found under: $OUTPUT_DUMP_TOP_DIR0 or $OUTPUT_DUMP_TOP_DIR1!"
-fi
-
-#check rodata section dumps
-if [ -f $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Rodata_Section_*.bin ] && \
-   [ -f $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Rodata_Section_*.bin ]; then
-   cmp $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Rodata_Section_*.bin $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Rodata_Section_*.bin
-   if [ $? = 0 ]; then
-       echo -e "\033[7m[CMP INFO] Rodata section dump after-run check between 2 dirs check PASS!\033[0m"
-   else
-       echo -e "\033[7m[CMP ERROR] Rodata section dump after-run check between 2 dirs check FAILED!\033[0m"
-   fi
-else
-   echo "[CMP INFO] No rodata section dump after-run files found under: $OUTPUT_DUMP_TOP_DIR0 or $OUTPUT_DUMP_TOP_DIR1!"
-fi
-
-#check static section dumps
-id=0
-fail=0
-while [ -f $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Static_Section"$id"_*.bin ] && \
-      [ -f $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Static_Section"$id"_*.bin ]
-do
-   cmp $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Static_Section${id}_*.bin $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Static_Section${id}_*.bin
-   if [ $? != 0 ]; then
-       fail=1
-       echo -e "\033[7m[CMP ERROR] Static section $id dump after-run check between 2 dirs FAILED!\033[0m"
-   fi
-   id=`expr $id + 1 `
-done
-
-if [ $id = 0 ]; then
-    echo "[CMP INFO] No static section after-run dump file(s) found!"
-else
-    if [ $fail = 0 ]; then
-        echo -e "\033[7m[CMP INFO] Static section after-run dump(s) check between 2 dirs PASS! (${id}/${id})\033[0m"
-    fi
-fi
-
-#check reuse section dumps
-id=0
-fail=0
-while [ -f $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Reuse_Section"$id"_*.bin ] && \
-      [ -f $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Reuse_Section"$id"_*.bin ]
-do
-   cmp $OUTPUT_DUMP_TOP_DIR0/*_After_Run_Reuse_Section${id}_*.bin $OUTPUT_DUMP_TOP_DIR1/*_After_Run_Reuse_Section${id}_*.bin
-   if [ $? != 0 ]; then
-       fail=1
-       echo -e "\033[7m[CMP ERROR] Reuse section $id dump after-run check between 2 dirs FAILED!\033[0m"
-   fi
-   id=`expr $id + 1 `
-done
-
-if [ $id = 0 ]; then
-    echo "[CMP INFO] No reuse section after-run dump file(s) found!"
-else
-    if [ $fail = 0 ]; then
-        echo -e "\033[7m[CMP INFO] Reuse section after-run dump(s) check between 2 dirs PASS! (${id}/${id})\033[0m"
-    fi
-fi
\ No newline at end of file
+$CMP_TOOL --sections=After_Run_Text_Section,After_Run_Stack_Section,After_Run_Rodata_Section,After_Run_Static_Section,After_Run_Reuse_Section \
+    ${JSON_FILE:+--json=$JSON_FILE} $OUTPUT_DUMP_TOP_DIR0 $OUTPUT_DUMP_TOP_DIR1